@@ -24,8 +24,12 @@
 /************************************************************************/
 #include <functional>
 #include "Application.hpp"
+#include "board/Board.hpp"
 #include "board/BoardConfig.hpp"
 #include "utility/Assert/Assert.h"
+#include "utility/PoolAllocator/PoolAllocator.hpp"
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+#include "utility/StaticRtos/StaticRtos.hpp"
 #include "../FreeRTOS/include/FreeRTOS.h"
 #include "../FreeRTOS/include/task.h"
 
@@ -39,10 +43,28 @@ void vBlinkLedBlue(void* pvParam);
 void vMotionData(void* pvParam);
 static TaskHandle_t xMotionData = NULL;
 
+// Task stacks: allocated at link time
+static StaticTask<configMINIMAL_STACK_SIZE> blinkLedGreenTask;
+static StaticTask<configMINIMAL_STACK_SIZE> blinkLedRedTask;
+static StaticTask<configMINIMAL_STACK_SIZE> blinkLedBlueTask;
+static StaticTask<configMINIMAL_STACK_SIZE> motionDataTask;
+
+// Block pools of the FreeRTOS heap and C++ new, sized to the objects created
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+static PoolBlocks<160, 6> pool160;                      // Task control blocks
+static PoolBlocks<512, 6> pool512;                      // Task and idle stacks
+static const PoolClass    poolClasses[] = { pool160.GetClass(), pool512.GetClass() };
+#else
+static PoolBlocks<32, 8>  pool32;                       // C++ new only
+static PoolBlocks<128, 4> pool128;
+static const PoolClass    poolClasses[] = { pool32.GetClass(), pool128.GetClass() };
+#endif
+
 static std::function<void()> callbackLedGreenToggle     = nullptr;
 static std::function<void()> callbackLedRedToggle       = nullptr;
 static std::function<void()> callbackLedBlueToggle      = nullptr;
 static std::function<void()> callbackMotionDataReceived = nullptr;
+static std::function<void(uint32_t expectedIdleTicks)> callbackSuppressTicksAndSleep = nullptr;
 
 
 /************************************************************************/
@@ -68,6 +90,22 @@ static void CallbackMotionDataReceived()
     if (callbackMotionDataReceived) { callbackMotionDataReceived(); }
 }
 
+static void CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks)
+{
+    if (callbackSuppressTicksAndSleep) { callbackSuppressTicksAndSleep(expectedIdleTicks); }
+}
+
+/**
+ * \brief   Failure hook of the block pools: a FreeRTOS object or C++ new did
+ *          not fit, see PoolAllocator::GetStatistics() for the class.
+ * \param   size    The number of bytes requested.
+ */
+static void PoolAllocationFailed(size_t size)
+{
+    (void)(size);
+
+    ASSERT(false);
+}
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -100,6 +138,11 @@ Application::Application() :
  */
 bool Application::Init()
 {
+    // Block pools first: FreeRTOS objects and C++ new allocate from them
+    bool result = PoolAllocator::Init(poolClasses, sizeof(poolClasses) / sizeof(poolClasses[0]));
+    ASSERT(result);
+    PoolAllocator::SetFailureHook(PoolAllocationFailed);
+
     mLedGreen.Set(Level::HIGH);
 
     // Connect callbacks (C to C++ bridge)
@@ -107,13 +150,14 @@ bool Application::Init()
     callbackLedRedToggle       = [this]() { this->CallbackLedRedToggle();       };
     callbackLedBlueToggle      = [this]() { this->CallbackLedBlueToggle();      };
     callbackMotionDataReceived = [this]() { this->CallbackMotionDataReceived(); };
+    callbackSuppressTicksAndSleep = [this](uint32_t expectedIdleTicks) { this->CallbackSuppressTicksAndSleep(expectedIdleTicks); };
 
 
     // Simulate initialization by adding delay
     HAL_Delay(750);
 
     // Actual Init()
-    bool result = mDMA_SPI_Tx.Configure(DMA::Channel::Channel3, DMA::Direction::MemoryToPeripheral, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
+    result = mDMA_SPI_Tx.Configure(DMA::Channel::Channel3, DMA::Direction::MemoryToPeripheral, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
     ASSERT(result);
 
     result = mDMA_SPI_Rx.Configure(DMA::Channel::Channel3, DMA::Direction::PeripheralToMemory, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
@@ -132,6 +176,14 @@ bool Application::Init()
     ASSERT(result);
     mMotionLength = 0;
 
+    // CPU load per task, see RunTimeStats::GetStatistics() once per second
+    result = RunTimeStats::Init(SystemCoreClock);
+    ASSERT(result);
+
+    // Tickless idle: Stop mode while all tasks wait
+    result = mTicklessIdle.Init(TicklessIdle::Config(15, configTICK_RATE_HZ, nullptr));    // Restarts the HSE and PLL itself
+    ASSERT(result);
+
     result = mLIS3DSH.Enable();
     ASSERT(result);
 
@@ -169,13 +221,13 @@ bool Application::CreateTasks()
 {
     bool result = false;
 
-    result = ( xTaskCreate( vBlinkLedGreen,  "Blink Green Task",  configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL) == pdPASS ) ? true : false;
+    result = blinkLedGreenTask.Create( vBlinkLedGreen, "Blink Green Task", NULL, tskIDLE_PRIORITY );
     ASSERT(result);
-    result = ( xTaskCreate( vBlinkLedRed,    "Blink Red Task",    configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL) == pdPASS ) ? true : false;
+    result = blinkLedRedTask.Create(   vBlinkLedRed,   "Blink Red Task",   NULL, tskIDLE_PRIORITY );
     ASSERT(result);
-    result = ( xTaskCreate( vBlinkLedBlue,   "Blink Blue Task",   configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY, NULL) == pdPASS ) ? true : false;
+    result = blinkLedBlueTask.Create(  vBlinkLedBlue,  "Blink Blue Task",  NULL, tskIDLE_PRIORITY );
     ASSERT(result);
-    result = ( xTaskCreate( vMotionData,     "Motion Data Task",  configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, &xMotionData) == pdPASS ) ? true : false;
+    result = motionDataTask.Create(    vMotionData,    "Motion Data Task", NULL, tskIDLE_PRIORITY + 1, &xMotionData );
     ASSERT(result);
 
     return result;
@@ -252,6 +304,16 @@ void Application::CallbackMotionDataReceived()
     }
 }
 
+/**
+ * \brief   Callback for the tickless idle: sleep until the next task is due.
+ * \param   expectedIdleTicks   The number of ticks until the next task is due.
+ * \note    Called from the idle task with the interrupts disabled.
+ */
+void Application::CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks)
+{
+    vTaskStepTick(mTicklessIdle.Sleep(expectedIdleTicks));
+}
+
 
 /************************************************************************/
 /* Tasks                                                                */
@@ -323,11 +385,32 @@ void vMotionData(void *pvParameters)
 }
 
 /**
- * \brief   Application Idle Hook, implements a light sleep mode.
+ * \brief   Application Idle Hook, closes the run time statistics period when
+ *          elapsed. Sleeping is done by the tickless idle, see
+ *          vApplicationSuppressTicksAndSleep().
  */
 extern "C" void vApplicationIdleHook(void)
 {
-    __WFI();
+    RunTimeStats::IdleHook();
+}
+
+/**
+ * \brief   Tickless idle, called by the idle task (portSUPPRESS_TICKS_AND_SLEEP)
+ *          when no task is due for at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP
+ *          ticks.
+ * \param   xExpectedIdleTime   The number of ticks until the next task is due.
+ */
+extern "C" void vApplicationSuppressTicksAndSleep(uint32_t xExpectedIdleTime)
+{
+    __disable_irq();
+
+    // A task may have been made ready, or a context switch pended, meanwhile
+    if (eTaskConfirmSleepModeStatus() != eAbortSleep)
+    {
+        CallbackSuppressTicksAndSleep(xExpectedIdleTime);
+    }
+
+    __enable_irq();
 }
 
 /**
@@ -32,6 +32,7 @@
 #include "drivers/DMA/DMA.hpp"
 #include "drivers/Pin/Pin.hpp"
 #include "drivers/SPI/SPI.hpp"
+#include "utility/TicklessIdle/TicklessIdle.hpp"
 
 
 /************************************************************************/
@@ -72,6 +73,8 @@ private:
     FakeLIS3DSH    mLIS3DSH;
 #endif
 
+    TicklessIdle         mTicklessIdle;
+
     std::atomic<uint8_t> mMotionLength;
 
     void MotionDataReceived(uint8_t length);
@@ -80,6 +83,7 @@ private:
     void CallbackLedRedToggle();
     void CallbackLedBlueToggle();
     void CallbackMotionDataReceived();
+    void CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks);
 };
 
 
@@ -13,8 +13,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/LIS3DSH
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2022
+ * \version 1.2
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -111,6 +111,8 @@ static constexpr uint8_t AXES_ENABLED     = 0x07;
 static constexpr uint8_t AXES_DISABLED    = 0x00;
 static constexpr uint8_t FIFO_EMPTY       = 0x20;
 
+static_assert(READ_BUFFER_SIZE <= LIS3DSH_READ_BUFFER_SIZE, "Read buffer must hold a fifo burst");
+
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -129,7 +131,7 @@ LIS3DSH::LIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPor
     mMotionInt1(motionInt1, PullUpDown::HIGHZ),
     mMotionInt2(motionInt2, PullUpDown::HIGHZ),
     mInitialized(false),
-    mReadBuffer(nullptr),
+    mReadBuffer(),
     mODR(0),
     mUseHardwareFifo(false)
 {
@@ -205,12 +207,6 @@ bool LIS3DSH::Sleep()
 
     mInitialized = false;
 
-    if (mReadBuffer)
-    {
-        delete[] mReadBuffer;
-        mReadBuffer = nullptr;
-    }
-
     return result;
 }
 
@@ -408,26 +404,19 @@ bool LIS3DSH::Configure(const IConfig& config)
 }
 
 /**
- * \brief   Prepare the read buffer by claiming memory on the heap to store
- *          the read fifo data into.
+ * \brief   Prepare the read buffer to store the read fifo data into.
  * \param   bufferSize  Read buffer size.
  * \returns True if the read buffer could be prepared successfully, else false.
  */
 bool LIS3DSH::PrepareReadBuffer(uint8_t bufferSize)
 {
-    // If we had claimed memory before: delete it
-    if (mReadBuffer != nullptr) { delete [] mReadBuffer; }
+    EXPECT(bufferSize <= LIS3DSH_READ_BUFFER_SIZE);
 
-    // Claim new segment in heap memory to retrieve sample data.
-    mReadBuffer = new(std::nothrow) uint8_t[bufferSize];
+    if (bufferSize > LIS3DSH_READ_BUFFER_SIZE) { return false; }
 
     // Clear buffer: fill with 0
-    if (mReadBuffer != nullptr)
-    {
-        std::fill_n(mReadBuffer, bufferSize, 0);
-        return true;
-    }
-    return false;
+    std::fill_n(mReadBuffer, bufferSize, 0);
+    return true;
 }
 
 /**
@@ -640,7 +629,7 @@ void LIS3DSH::CallbackInt1()
 {
     const uint8_t bufferSize = (mUseHardwareFifo) ? READ_BUFFER_SIZE : SAMPLE_LENGTH;
 
-    if ((mReadBuffer != nullptr) && (bufferSize > 0))
+    if (mInitialized && (bufferSize > 0))
     {
         uint8_t reg = (OUT_X_L | READ_MASK);
 
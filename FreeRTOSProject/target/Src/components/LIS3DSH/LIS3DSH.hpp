@@ -16,12 +16,13 @@
  *          the Data Ready signal is used, meaning a sample (X,Y,Z) is
  *          available at the configured sample frequency. Sample is read via
  *          SPI + DMA as well.
+ *          The read buffer is part of the class, no heap memory is used.
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/LIS3DSH
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2022
+ * \version 1.2
+ * \date    10-2026
  */
 
 #ifndef LIS3DSH_HPP_
@@ -37,6 +38,17 @@
 #include "drivers/Pin/Pin.hpp"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     LIS3DSH_READ_BUFFER_SIZE
+ * \brief   Size of the read buffer in bytes: a fifo burst of 25 samples
+ *          X,Y,Z, each int16_t.
+ */
+#define LIS3DSH_READ_BUFFER_SIZE    150
+
+
 /************************************************************************/
 /* Class declaration                                                    */
 /************************************************************************/
@@ -153,7 +165,7 @@ private:
     Pin      mMotionInt1;
     Pin      mMotionInt2;
     bool     mInitialized;
-    uint8_t* mReadBuffer;
+    uint8_t  mReadBuffer[LIS3DSH_READ_BUFFER_SIZE];
     uint8_t  mODR;
     bool     mUseHardwareFifo;
 
@@ -43,7 +43,7 @@ int main()
     HAL_Init();
 
 
-    Application mApp;
+    static Application mApp;       // Not on the main stack: reused by interrupts once the scheduler runs
 
     if (!mApp.Init())
     {
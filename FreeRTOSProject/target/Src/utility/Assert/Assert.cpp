@@ -20,43 +20,29 @@
  *          to only be used by these macros.
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
 #include "Assert.h"
-#include <cstdio>
-//#include "components/Logging.hpp"
 #include "stm32f4xx_hal.h"
 
 
-/************************************************************************/
-/* Constants                                                            */
-/************************************************************************/
-static constexpr uint8_t MAX_LOG_LINE_SIZE = 128;   ///< In bytes, including closing '\0'.
-
-
 /************************************************************************/
 /* Functions                                                            */
 /************************************************************************/
 /**
  * \brief   Handler for expect_log().
- * \details Add log entry of the EXPECT() occurrence with some details.
- * \param   expr    The failing expression, as string.
- * \param   line    The line number at which the expect occurred.
- * \param   file    The file in which the expect occurred.
+ * \details Record the EXPECT() occurrence in the deferred log, it is
+ *          formatted later (DeferredLog::Format()) or on a host.
+ * \param   site    The failing expression, file and line, in flash.
  */
-void _expect_log(const char* expr, int line, const char* file)
+void _expect_log(const DeferredLogSite* site)
 {
-    char messBuff[MAX_LOG_LINE_SIZE] = {};
-    if (snprintf(messBuff, MAX_LOG_LINE_SIZE, "EXPECT: [%s], line: [%d], file: [%s]", expr, line, file))
-    {
-        // ToDo: enable when real logger is implemented...
-//        Logging::Static_Log(LogLevel::ERROR, messBuff);
-    }
+    _deferred_log(site, 0, 0);
 }
 
 /**
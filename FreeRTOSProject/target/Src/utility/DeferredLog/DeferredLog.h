@@ -0,0 +1,163 @@
+/**
+ * \file    DeferredLog.h
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Binary deferred logger: cheap to record, formatted later.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/DeferredLog
+ *
+ * \details A call site records the address of a constant site description
+ *          (text, file and line, placed in flash at compile time), a cycle
+ *          count timestamp and up to DEFERRED_LOG_MAX_ARGS arguments into a
+ *          lock-free ring. No formatting, no copying of strings: usable from
+ *          any interrupt. A low priority task reads the entries and formats
+ *          them (DeferredLog::Format()) or sends them in binary form
+ *          (DeferredLog::Encode()) to a host, which finds the strings with
+ *          the site address in the ELF file.
+ *          Backend of EXPECT() with EXPECT_MODE == HANDLE_BY_LOGGING.
+ *
+ * \note    Implemented with 'C' header and 'C++' implementation to be
+ *          usable from both languages, as Assert.h. Reading is C++ only.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef DEFERRED_LOG_H_
+#define DEFERRED_LOG_H_
+
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <stddef.h>
+#include <stdint.h>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     DEFERRED_LOG_SIZE
+ * \brief   Number of entries in the ring, a power of 2.
+ */
+#define DEFERRED_LOG_SIZE           32
+
+/**
+ * \def     DEFERRED_LOG_MAX_ARGS
+ * \brief   Number of 32 bit arguments recorded per entry.
+ */
+#define DEFERRED_LOG_MAX_ARGS       2
+
+/**
+ * \def     DEFERRED_LOG_RECORD_ID
+ * \brief   First byte of an encoded entry, identifies it in a telemetry stream.
+ */
+#define DEFERRED_LOG_RECORD_ID      'L'
+
+/**
+ * \def     DEFERRED_LOG_RECORD_SIZE
+ * \brief   Size in bytes of an encoded entry: id, site, timestamp, arguments.
+ */
+#define DEFERRED_LOG_RECORD_SIZE    (1 + 4 + 4 + (4 * DEFERRED_LOG_MAX_ARGS))
+
+/**
+ * \def     DEFERRED_LOG_TEXT
+ * \brief   Kind of a site: the text is a printf format for the arguments.
+ */
+#define DEFERRED_LOG_TEXT           0
+
+/**
+ * \def     DEFERRED_LOG_EXPECT
+ * \brief   Kind of a site: the text is the failed expression of an EXPECT().
+ */
+#define DEFERRED_LOG_EXPECT         1
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  DeferredLogSite
+ * \brief   Constant description of a call site, its address is the id.
+ */
+typedef struct
+{
+    const char* text;           ///< printf format (DEFERRED_LOG_TEXT) or expression (DEFERRED_LOG_EXPECT)
+    const char* file;
+    uint16_t    line;
+    uint8_t     kind;           ///< DEFERRED_LOG_TEXT or DEFERRED_LOG_EXPECT
+} DeferredLogSite;
+
+/**
+ * \struct  DeferredLogEntry
+ * \brief   A recorded entry.
+ */
+typedef struct
+{
+    const DeferredLogSite* site;
+    uint32_t               timestamp;                   ///< DWT cycle counter when recorded
+    uint32_t               args[DEFERRED_LOG_MAX_ARGS];
+} DeferredLogEntry;
+
+
+/************************************************************************/
+/* Function declarations                                                */
+/************************************************************************/
+void _deferred_log(const DeferredLogSite* site, uint32_t arg0, uint32_t arg1);
+
+
+/************************************************************************/
+/* Macros                                                               */
+/************************************************************************/
+/**
+ * \brief   Record a log entry: a printf format (string literal) and up to
+ *          DEFERRED_LOG_MAX_ARGS arguments, stored as uint32_t (format them
+ *          with %u, %d or %x). Missing arguments are recorded as 0.
+ * \note    Do not pass pointers to strings: only the value is recorded.
+ */
+#define DEFERRED_LOG(format, ...)                                                               \
+    do {                                                                                        \
+        static const DeferredLogSite _deferred_log_site = { (format), __FILE__, __LINE__, DEFERRED_LOG_TEXT }; \
+        _deferred_log(&_deferred_log_site, DEFERRED_LOG_ARGS_(0, ##__VA_ARGS__, 0, 0, 0));     \
+    } while (0)
+
+#define DEFERRED_LOG_ARGS_(dummy, arg0, arg1, ...)  (uint32_t)(arg0), (uint32_t)(arg1)
+
+
+#ifdef __cplusplus
+}
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class DeferredLog
+{
+public:
+    static void Init();
+
+    static bool Read(DeferredLogEntry& entry);
+    static uint16_t Format(const DeferredLogEntry& entry, char* buffer, uint16_t size);
+    static uint16_t Encode(const DeferredLogEntry& entry, uint8_t* buffer, uint16_t size);
+
+    static uint32_t GetPending();
+    static uint32_t GetDropped();
+};
+
+#endif  // __cplusplus
+
+
+#endif  // DEFERRED_LOG_H_
@@ -0,0 +1,302 @@
+/**
+ * \file    PoolAllocator.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   PoolAllocator
+ *
+ * \brief   Fixed block allocator with a few size classes, O(1) allocate and
+ *          free, with usage statistics per class.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/PoolAllocator
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/PoolAllocator/PoolAllocator.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  FreeBlock
+ * \brief   A free block holds the link to the next free block.
+ */
+struct FreeBlock
+{
+    FreeBlock* next;
+};
+
+/**
+ * \struct  Pool
+ * \brief   Administration of a size class.
+ */
+struct Pool
+{
+    uint8_t*   start;
+    uint8_t*   end;
+    FreeBlock* freeList;
+    PoolStats  stats;
+};
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static Pool     pools[POOL_ALLOCATOR_MAX_CLASSES] = {};
+static uint8_t  poolCount    = 0;
+static uint32_t failureCount = 0;
+static void   (*failureHook)(size_t size) = nullptr;
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Check a size class can be used.
+ * \param   poolClass   The size class to check.
+ * \param   previous    Block size of the previous class, 0 for the first.
+ * \returns True if the class is valid, else false.
+ */
+static bool IsValid(const PoolClass& poolClass, uint16_t previous)
+{
+    const uintptr_t address = reinterpret_cast<uintptr_t>(poolClass.memory);
+
+    if (poolClass.memory == nullptr)                            { return false; }
+    if ((address % POOL_ALLOCATOR_ALIGNMENT) != 0)              { return false; }
+    if (poolClass.blockSize < sizeof(FreeBlock))                { return false; }
+    if ((poolClass.blockSize % POOL_ALLOCATOR_ALIGNMENT) != 0)  { return false; }
+    if (poolClass.blockSize <= previous)                        { return false; }
+    if (poolClass.blockCount == 0)                              { return false; }
+    return true;
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Set up the size classes, all blocks are free.
+ * \param   classes     The size classes, in order of increasing block size.
+ * \param   count       The number of size classes, 1..POOL_ALLOCATOR_MAX_CLASSES.
+ * \returns True if the size classes are valid, else false.
+ * \note    Call before the first allocation: blocks allocated before are
+ *          lost.
+ */
+bool PoolAllocator::Init(const PoolClass* classes, uint8_t count)
+{
+    EXPECT(classes);
+    EXPECT(count > 0);
+    EXPECT(count <= POOL_ALLOCATOR_MAX_CLASSES);
+
+    if (classes == nullptr)                 { return false; }
+    if (count == 0)                         { return false; }
+    if (count > POOL_ALLOCATOR_MAX_CLASSES) { return false; }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        const bool valid = IsValid(classes[i], (i > 0) ? classes[i - 1].blockSize : 0);
+        EXPECT(valid);
+        if (!valid) { return false; }
+    }
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < count; i++)
+    {
+        Pool& pool = pools[i];
+        pool.start    = static_cast<uint8_t*>(classes[i].memory);
+        pool.end      = pool.start + (classes[i].blockSize * classes[i].blockCount);
+        pool.freeList = nullptr;
+        pool.stats    = PoolStats();
+        pool.stats.blockSize  = classes[i].blockSize;
+        pool.stats.blockCount = classes[i].blockCount;
+
+        // Link the blocks back to front: the first block is handed out first
+        for (uint16_t n = pool.stats.blockCount; n > 0; n--)
+        {
+            FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(pool.start + ((n - 1) * pool.stats.blockSize));
+            freeBlock->next = pool.freeList;
+            pool.freeList   = freeBlock;
+        }
+    }
+    poolCount    = count;
+    failureCount = 0;
+    ExitCritical(prim);
+
+    return true;
+}
+
+/**
+ * \brief   Set the method called when an allocation fails.
+ * \param   hook    The method, with the size requested. Called with
+ *                  interrupts enabled (if they were). nullptr to remove.
+ */
+void PoolAllocator::SetFailureHook(void (*hook)(size_t size))
+{
+    failureHook = hook;
+}
+
+/**
+ * \brief   Allocate a block from the smallest size class that fits.
+ * \param   size    The number of bytes needed.
+ * \returns The block, aligned to POOL_ALLOCATOR_ALIGNMENT, nullptr if no
+ *          class is large enough or the class is exhausted.
+ */
+void* PoolAllocator::Allocate(size_t size)
+{
+    if (size == 0) { return nullptr; }
+
+    FreeBlock* block = nullptr;
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < poolCount; i++)
+    {
+        Pool& pool = pools[i];
+        if (size > pool.stats.blockSize) { continue; }
+
+        block = pool.freeList;
+        if (block != nullptr)
+        {
+            pool.freeList = block->next;
+            pool.stats.inUse++;
+            pool.stats.allocations++;
+            if (pool.stats.inUse > pool.stats.highWater) { pool.stats.highWater = pool.stats.inUse; }
+        }
+        else
+        {
+            pool.stats.failures++;
+        }
+        break;
+    }
+    if (block == nullptr) { failureCount++; }
+    ExitCritical(prim);
+
+    if ((block == nullptr) && (failureHook != nullptr))
+    {
+        failureHook(size);
+    }
+    return block;
+}
+
+/**
+ * \brief   Return a block to its size class.
+ * \param   block   The block, as returned by Allocate(). nullptr is ignored.
+ * \returns True if the block was freed (or nullptr), false if it is not a
+ *          block of one of the size classes.
+ */
+bool PoolAllocator::Free(void* block)
+{
+    if (block == nullptr) { return true; }
+
+    uint8_t* address = static_cast<uint8_t*>(block);
+    bool     result  = false;
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < poolCount; i++)
+    {
+        Pool& pool = pools[i];
+        if ((address < pool.start) || (address >= pool.end)) { continue; }
+
+        // Inside the class, but not the start of a block, or none in use
+        if ((((address - pool.start) % pool.stats.blockSize) != 0) || (pool.stats.inUse == 0)) { break; }
+
+        FreeBlock* freeBlock = reinterpret_cast<FreeBlock*>(block);
+        freeBlock->next = pool.freeList;
+        pool.freeList   = freeBlock;
+        pool.stats.inUse--;
+        result = true;
+        break;
+    }
+    ExitCritical(prim);
+
+    EXPECT(result);
+    return result;
+}
+
+/**
+ * \brief   Get the number of size classes.
+ * \returns The number of size classes.
+ */
+uint8_t PoolAllocator::GetClassCount()
+{
+    return poolCount;
+}
+
+/**
+ * \brief   Get the usage of a size class.
+ * \param   index   The size class, in order of increasing block size.
+ * \param   stats   Receives the usage.
+ * \returns True if the size class exists, else false.
+ */
+bool PoolAllocator::GetStatistics(uint8_t index, PoolStats& stats)
+{
+    if (index >= poolCount) { return false; }
+
+    const uint32_t prim = EnterCritical();
+    stats = pools[index].stats;
+    ExitCritical(prim);
+
+    return true;
+}
+
+/**
+ * \brief   Get the number of failed allocations: exhausted classes and
+ *          requests larger than the largest block.
+ * \returns The number of failed allocations.
+ */
+uint32_t PoolAllocator::GetFailureCount()
+{
+    return failureCount;
+}
+
+/**
+ * \brief   Get the number of bytes in free blocks, over all classes.
+ * \returns The number of bytes in free blocks.
+ */
+size_t PoolAllocator::GetFreeBytes()
+{
+    size_t bytes = 0;
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < poolCount; i++)
+    {
+        const PoolStats& stats = pools[i].stats;
+        bytes += static_cast<size_t>(stats.blockCount - stats.inUse) * stats.blockSize;
+    }
+    ExitCritical(prim);
+
+    return bytes;
+}
+
+/**
+ * \brief   Get the lowest number of bytes in free blocks, from the high-water
+ *          marks of the classes.
+ * \returns The lowest number of bytes in free blocks.
+ */
+size_t PoolAllocator::GetMinimumEverFreeBytes()
+{
+    size_t bytes = 0;
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < poolCount; i++)
+    {
+        const PoolStats& stats = pools[i].stats;
+        bytes += static_cast<size_t>(stats.blockCount - stats.highWater) * stats.blockSize;
+    }
+    ExitCritical(prim);
+
+    return bytes;
+}
@@ -0,0 +1,134 @@
+/**
+ * \file    PoolAllocator.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   PoolAllocator
+ *
+ * \brief   Fixed block allocator with a few size classes, O(1) allocate and
+ *          free, with usage statistics per class.
+ *
+ * \details Each size class is a pool of equally sized blocks in static
+ *          memory (see PoolBlocks), the free blocks form a linked list. A
+ *          request is served from the smallest class with large enough
+ *          blocks: the time taken does not depend on earlier allocations
+ *          and there is no fragmentation. An exhausted class does not spill
+ *          into a larger class, the failure shows which class is too small.
+ *          Per class the blocks in use, the high-water mark and the number
+ *          of allocations and failures are kept. On a failure an optional
+ *          hook is called.
+ *          PoolAllocatorHooks.cpp makes it the FreeRTOS heap (pvPortMalloc())
+ *          and the allocator of C++ new, replacing heap_4.c.
+ *
+ * \note    Safe to use from tasks and interrupts: the free lists are
+ *          updated with interrupts disabled.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/PoolAllocator
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef POOL_ALLOCATOR_HPP_
+#define POOL_ALLOCATOR_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstddef>
+#include <cstdint>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     POOL_ALLOCATOR_MAX_CLASSES
+ * \brief   Maximum number of size classes.
+ */
+#define POOL_ALLOCATOR_MAX_CLASSES      4
+
+/**
+ * \def     POOL_ALLOCATOR_ALIGNMENT
+ * \brief   Alignment of the blocks in bytes, as portBYTE_ALIGNMENT.
+ */
+#define POOL_ALLOCATOR_ALIGNMENT        8
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  PoolClass
+ * \brief   Configuration of a size class, see PoolBlocks::GetClass().
+ */
+struct PoolClass
+{
+    void*    memory;                ///< Memory of the blocks, aligned to POOL_ALLOCATOR_ALIGNMENT
+    uint16_t blockSize;             ///< Size of a block in bytes, multiple of POOL_ALLOCATOR_ALIGNMENT
+    uint16_t blockCount;            ///< Number of blocks
+};
+
+/**
+ * \struct  PoolStats
+ * \brief   Usage of a size class.
+ */
+struct PoolStats
+{
+    uint16_t blockSize   = 0;       ///< Size of a block in bytes
+    uint16_t blockCount  = 0;       ///< Number of blocks
+    uint16_t inUse       = 0;       ///< Blocks allocated now
+    uint16_t highWater   = 0;       ///< Most blocks allocated at the same time
+    uint32_t allocations = 0;       ///< Successful allocations
+    uint32_t failures    = 0;       ///< Requests for this class while it was exhausted
+};
+
+
+/************************************************************************/
+/* Class declarations                                                   */
+/************************************************************************/
+/**
+ * \class   PoolBlocks
+ * \brief   Static memory of a size class: BLOCK_COUNT blocks of BLOCK_SIZE
+ *          bytes.
+ */
+template <uint16_t BLOCK_SIZE, uint16_t BLOCK_COUNT>
+class PoolBlocks
+{
+    static_assert((BLOCK_SIZE % POOL_ALLOCATOR_ALIGNMENT) == 0, "Block size must be a multiple of the alignment");
+    static_assert(BLOCK_COUNT > 0, "At least 1 block is needed");
+
+public:
+    /**
+     * \brief   Get the size class, to pass to PoolAllocator::Init().
+     * \returns The size class of this memory.
+     */
+    PoolClass GetClass() { return PoolClass { mMemory, BLOCK_SIZE, BLOCK_COUNT }; }
+
+private:
+    alignas(POOL_ALLOCATOR_ALIGNMENT) uint8_t mMemory[BLOCK_SIZE * BLOCK_COUNT];
+};
+
+class PoolAllocator
+{
+public:
+    static bool Init(const PoolClass* classes, uint8_t count);
+    static void SetFailureHook(void (*hook)(size_t size));
+
+    static void* Allocate(size_t size);
+    static bool Free(void* block);
+
+    static uint8_t GetClassCount();
+    static bool GetStatistics(uint8_t index, PoolStats& stats);
+    static uint32_t GetFailureCount();
+    static size_t GetFreeBytes();
+    static size_t GetMinimumEverFreeBytes();
+};
+
+
+#endif  // POOL_ALLOCATOR_HPP_
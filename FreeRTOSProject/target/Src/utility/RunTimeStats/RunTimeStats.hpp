@@ -0,0 +1,156 @@
+/**
+ * \file    RunTimeStats.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   RunTimeStats
+ *
+ * \brief   Per task and per ISR CPU load, measured with the DWT cycle counter.
+ *
+ * \details The FreeRTOS trace hooks report the task switches, ISRs are
+ *          bracketed with IsrEnter() and IsrExit(). The time spent in an ISR
+ *          is not charged to the task it interrupted. Per period the load of
+ *          each task and ISR (in permille), the number of times it ran, the
+ *          number of context switches and the idle load are kept.
+ *          The period is closed from the idle hook, after which a compact
+ *          binary report can be retrieved.
+ *          The cycle counter does not count while the core sleeps: with
+ *          tickless idle the slept cycles are added with Slept(), charged to
+ *          the idle task and the period.
+ *
+ *          Report layout, little endian:
+ *          - uint8_t  RUNTIME_STATS_REPORT_ID
+ *          - uint8_t  number of entries
+ *          - uint16_t idle load in permille
+ *          - uint32_t period length in cycles
+ *          - uint32_t context switches in the period
+ *          - per entry:
+ *            - uint8_t  id (registration order)
+ *            - uint8_t  kind (RunTimeKind)
+ *            - uint16_t load in permille
+ *            - uint32_t times switched in (task) or called (ISR)
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/RunTimeStats
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+#ifndef RUNTIME_STATS_HPP_
+#define RUNTIME_STATS_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     RUNTIME_STATS_MAX_ENTRIES
+ * \brief   Maximum number of tasks (including idle) and ISRs measured.
+ */
+#define RUNTIME_STATS_MAX_ENTRIES       12
+
+/**
+ * \def     RUNTIME_STATS_INVALID
+ * \brief   Id returned if no more entries are available.
+ */
+#define RUNTIME_STATS_INVALID           0xFF
+
+/**
+ * \def     RUNTIME_STATS_REPORT_ID
+ * \brief   First byte of the binary report.
+ */
+#define RUNTIME_STATS_REPORT_ID         0x52
+
+/**
+ * \def     RUNTIME_STATS_REPORT_SIZE
+ * \brief   Size in bytes of a binary report with the given number of entries.
+ */
+#define RUNTIME_STATS_REPORT_SIZE(n)    (12 + (8 * (n)))
+
+
+/************************************************************************/
+/* Enums                                                                */
+/************************************************************************/
+/**
+ * \enum    RunTimeKind
+ * \brief   What an entry measures.
+ */
+enum class RunTimeKind : uint8_t
+{
+    Task = 0,
+    Idle = 1,
+    Isr  = 2
+};
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  RunTimeEntryStats
+ * \brief   Load of a task or ISR over the last completed period.
+ */
+struct RunTimeEntryStats
+{
+    const char* name     = nullptr;             ///< Task or ISR name
+    RunTimeKind kind     = RunTimeKind::Task;   ///< Task, idle task or ISR
+    uint32_t    cycles   = 0;                   ///< Cycles spent in the period
+    uint32_t    count    = 0;                   ///< Times switched in (task) or called (ISR)
+    uint16_t    permille = 0;                   ///< Share of the period
+};
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class RunTimeStats
+{
+public:
+    static bool Init(uint32_t periodCycles);
+
+    static uint8_t RegisterIsr(const char* name);
+    static void IsrEnter(uint8_t id);
+    static void IsrExit(uint8_t id);
+
+    static void TaskSwitchedIn(const void* handle, const char* name);
+    static void TaskSwitchedOut();
+
+    static void IdleHook();
+    static void Slept(uint32_t cycles);
+    static void Update();
+
+    static bool IsUpdated();
+    static uint8_t GetEntryCount();
+    static bool GetStatistics(uint8_t id, RunTimeEntryStats& stats);
+    static uint16_t GetIdlePermille();
+    static uint32_t GetContextSwitches();
+    static uint16_t GetReport(uint8_t* dest, uint16_t length);
+};
+
+
+/************************************************************************/
+/* FreeRTOS hooks                                                       */
+/************************************************************************/
+/**
+ * \brief   C functions for the FreeRTOSConfig.h macros, see the README.
+ */
+extern "C" {
+    void     RunTimeStats_ConfigureCounter(void);
+    uint32_t RunTimeStats_GetCounter(void);
+    void     RunTimeStats_TaskSwitchedIn(const void* handle, const char* name);
+    void     RunTimeStats_TaskSwitchedOut(void);
+}
+
+
+#endif  // RUNTIME_STATS_HPP_
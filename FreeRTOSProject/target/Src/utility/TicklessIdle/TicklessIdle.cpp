@@ -0,0 +1,637 @@
+/**
+ * \file    TicklessIdle.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   TicklessIdle
+ *
+ * \brief   Tickless idle for FreeRTOS: suppress the SysTick interrupt while
+ *          idle, in Sleep or Stop mode.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/TicklessIdle
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.2
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/TicklessIdle/TicklessIdle.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+#include "stm32f4xx_hal_rtc.h"
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+static constexpr uint32_t RTC_NOMINAL_LSI   = 32000;    // Typical LSI frequency in Hz
+static constexpr uint32_t RTC_ASYNC_PREDIV  = 7;        // Sub seconds of 250 us at 32 kHz
+static constexpr uint32_t RTC_WAKEUP_DIV    = 16;       // RTC_WAKEUPCLOCK_RTCCLK_DIV16
+static constexpr uint32_t RTC_WAKEUP_MAX    = 0xFFFF;   // 16 bit wakeup counter
+static constexpr uint32_t RTC_MEASURE_EDGES = 32;       // Sub second changes counted to measure the LSI
+static constexpr uint32_t WAIT_POLLS        = 100000;   // Register reads before giving up, over 6 ms at 16 MHz (HSI)
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static RTC_HandleTypeDef* rtcHandle = nullptr;
+
+static DMA_Stream_TypeDef* const dmaStreams[] =
+{
+    DMA1_Stream0, DMA1_Stream1, DMA1_Stream2, DMA1_Stream3,
+    DMA1_Stream4, DMA1_Stream5, DMA1_Stream6, DMA1_Stream7,
+    DMA2_Stream0, DMA2_Stream1, DMA2_Stream2, DMA2_Stream3,
+    DMA2_Stream4, DMA2_Stream5, DMA2_Stream6, DMA2_Stream7
+};
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Split the time since the start of the current tick period in
+ *          completed ticks and the cycles left until the next tick.
+ * \param   sinceTick       Cycles since the start of the tick period in which
+ *                          the sleep started.
+ * \param   cyclesPerTick   Cycles per tick.
+ * \param   expectedTicks   The number of ticks the sleep was planned for.
+ * \param   nextTick        Cycles until the next tick.
+ * \returns The number of completed ticks, at most expectedTicks - 1: the tick
+ *          interrupt processes the last one.
+ */
+static uint32_t StepTicks(uint64_t sinceTick, uint32_t cyclesPerTick, uint32_t expectedTicks, uint32_t& nextTick)
+{
+    uint32_t completed = static_cast<uint32_t>(sinceTick / cyclesPerTick);
+    nextTick = cyclesPerTick - static_cast<uint32_t>(sinceTick % cyclesPerTick);
+
+    if (completed >= expectedTicks)
+    {
+        // Overslept (woke late from Stop): let the tick follow right away
+        completed = expectedTicks - 1;
+        nextTick  = TICKLESS_MISSED_COUNTS;
+    }
+    return completed;
+}
+
+/**
+ * \brief   Wait for the RTC sub seconds to change.
+ * \param   rtc             The RTC instance.
+ * \param   timeoutCycles   Cycles to wait at most.
+ * \returns True if the sub seconds changed, false if timed out.
+ */
+static bool WaitForSubSecond(RTC_TypeDef* rtc, uint32_t timeoutCycles)
+{
+    const uint32_t start = DWT->CYCCNT;
+    const uint32_t ssr   = rtc->SSR;
+    (void)rtc->DR;      // Unlock the shadow registers
+
+    while (rtc->SSR == ssr)
+    {
+        (void)rtc->DR;
+        if ((DWT->CYCCNT - start) > timeoutCycles) { return false; }
+    }
+    (void)rtc->DR;
+    return true;
+}
+
+/**
+ * \brief   Wait for bits in a register to reach a value, for a bounded number
+ *          of reads: with the interrupts disabled HAL_GetTick() does not
+ *          advance, the HAL timeouts would never expire.
+ * \param   reg     The register to poll.
+ * \param   mask    The bits to check.
+ * \param   value   The expected value of the bits.
+ * \returns True if the bits reached the value, false if timed out.
+ */
+static bool WaitForBits(const volatile uint32_t& reg, uint32_t mask, uint32_t value)
+{
+    for (uint32_t i = 0; i < WAIT_POLLS; i++)
+    {
+        if ((reg & mask) == value) { return true; }
+    }
+    return false;
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Initialize the tickless idle: configure the RTC and its wakeup
+ *          interrupt, enable the DWT cycle counter.
+ * \param   config  Reference to the configuration struct.
+ * \returns True if the tickless idle could be initialized, else false.
+ * \note    The system clock must be configured (SystemCoreClock), and the
+ *          LSI running and backup domain access enabled: Board::InitClock()
+ *          does both.
+ */
+bool TicklessIdle::Init(const Config& config)
+{
+    EXPECT(config.mTickRateHz > 0);
+    EXPECT(config.mStopThresholdTicks >= 2);
+
+    if (config.mTickRateHz == 0)                  { return false; }
+    if (config.mStopThresholdTicks < 2)           { return false; }
+    if (SystemCoreClock < config.mTickRateHz)     { return false; }
+
+    mInitialized   = false;
+    mRestoreClock  = config.mRestoreClock;
+    mTickRateHz    = config.mTickRateHz;
+    mCyclesPerTick = SystemCoreClock / config.mTickRateHz;
+    mMaxSleepTicks = SysTick_LOAD_RELOAD_Msk / mCyclesPerTick;
+    mStopThreshold = config.mStopThresholdTicks;
+
+    // The DWT measures the time awake
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    uint32_t rtcClockHz = config.mRtcClockHz;
+    if (rtcClockHz == 0)
+    {
+        // Run at the nominal LSI frequency first, then measure it
+        if (!ConfigureRtc(RTC_NOMINAL_LSI)) { return false; }
+        rtcClockHz = MeasureRtcClock();
+    }
+    if (!ConfigureRtc(rtcClockHz)) { return false; }
+
+    rtcHandle = &mRtc;
+    __HAL_RTC_WAKEUPTIMER_EXTI_ENABLE_IT();
+    __HAL_RTC_WAKEUPTIMER_EXTI_ENABLE_RISING_EDGE();
+    HAL_NVIC_DisableIRQ(RTC_WKUP_IRQn);
+    HAL_NVIC_ClearPendingIRQ(RTC_WKUP_IRQn);
+    HAL_NVIC_SetPriority(RTC_WKUP_IRQn, config.mInterruptPriority, 0);
+    HAL_NVIC_EnableIRQ(RTC_WKUP_IRQn);
+
+    mWakeCycle       = DWT->CYCCNT;
+    mAwakeCycles     = 0;
+    mAsleepCycles    = 0;
+    mCounting        = {};
+    mStats           = {};
+    mUpdateAvailable = false;
+    mInitialized     = true;
+    return true;
+}
+
+/**
+ * \brief   Sleep for (at most) the expected number of idle ticks, with the
+ *          SysTick interrupt suppressed. Stop mode is used if the expected
+ *          idle time reaches the threshold, no DMA transfer is running and
+ *          Stop mode is not locked, else Sleep mode.
+ * \param   expectedIdleTicks   The number of ticks the scheduler expects to
+ *                              be idle.
+ * \returns The number of completed ticks, for vTaskStepTick().
+ * \note    Must be called with the interrupts disabled, after the scheduler
+ *          confirmed the sleep (eTaskConfirmSleepModeStatus()). An interrupt
+ *          wakes the CPU early, it is handled when the interrupts are
+ *          enabled again.
+ * \note    The HAL tick (HAL_GetTick()) does not advance while sleeping:
+ *          the Stop mode path only uses register access with bounded waits.
+ * \note    The DWT cycle counter does not count while sleeping: the slept
+ *          cycles are credited to the idle task in RunTimeStats.
+ */
+uint32_t TicklessIdle::Sleep(uint32_t expectedIdleTicks)
+{
+    if (!mInitialized)          { return 0; }
+    if (expectedIdleTicks == 0) { return 0; }
+
+    mAwakeCycles += DWT->CYCCNT - mWakeCycle;
+
+    uint64_t sleptCycles = 0;
+    uint32_t completed   = 0;
+
+    HAL_SuspendTick();
+    if (IsStopAllowed(expectedIdleTicks))
+    {
+        completed = EnterStop(expectedIdleTicks, sleptCycles);
+        mCounting.stopCount++;
+    }
+    else
+    {
+        completed = EnterSleep(expectedIdleTicks, sleptCycles);
+        mCounting.sleepCount++;
+    }
+    HAL_ResumeTick();
+
+    mWakeCycle = DWT->CYCCNT;
+    mCounting.suppressedTicks += completed;
+    UpdateStatistics(sleptCycles);
+    RunTimeStats::Slept((sleptCycles > UINT32_MAX) ? UINT32_MAX : static_cast<uint32_t>(sleptCycles));
+
+    return completed;
+}
+
+/**
+ * \brief   Prevent Stop mode, for instance while a peripheral without DMA
+ *          is transferring. Calls are counted: each must be followed by
+ *          UnlockStop().
+ */
+void TicklessIdle::LockStop()
+{
+    const uint32_t prim = EnterCritical();
+    mStopLocks++;
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Allow Stop mode again, see LockStop().
+ */
+void TicklessIdle::UnlockStop()
+{
+    const uint32_t prim = EnterCritical();
+    EXPECT(mStopLocks > 0);
+    if (mStopLocks > 0) { mStopLocks--; }
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Get the RTC clock frequency, as given or measured during Init().
+ * \returns The RTC clock frequency in Hz.
+ */
+uint32_t TicklessIdle::GetRtcClock() const
+{
+    return mRtcClockHz;
+}
+
+/**
+ * \brief   Check if there are updated TicklessStats available.
+ * \returns True if an update is available, else false.
+ */
+bool TicklessIdle::IsUpdated() const
+{
+    return mUpdateAvailable;
+}
+
+/**
+ * \brief   Get the updated TicklessStats, clears the update flag.
+ * \returns Updated TicklessStats as struct.
+ */
+TicklessStats TicklessIdle::GetStatistics()
+{
+    const uint32_t prim = EnterCritical();
+    const TicklessStats stats = mStats;
+    mUpdateAvailable = false;
+    ExitCritical(prim);
+
+    return stats;
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Configure the RTC, clocked from the LSI. The sub seconds are used
+ *          to measure the time in Stop mode, the wakeup timer to end it.
+ * \param   rtcClockHz  The LSI frequency in Hz.
+ * \returns True if the RTC could be configured, else false.
+ */
+bool TicklessIdle::ConfigureRtc(uint32_t rtcClockHz)
+{
+    const uint32_t subSecondHz = rtcClockHz / (RTC_ASYNC_PREDIV + 1);
+
+    EXPECT(subSecondHz > 1);
+    if (subSecondHz <= 1) { return false; }
+
+    __HAL_RCC_PWR_CLK_ENABLE();
+    HAL_PWR_EnableBkUpAccess();
+    __HAL_RCC_RTC_CONFIG(RCC_RTCCLKSOURCE_LSI);
+    __HAL_RCC_RTC_ENABLE();
+
+    mRtc.Instance                = RTC;
+    mRtc.Init.HourFormat         = RTC_HOURFORMAT_24;
+    mRtc.Init.AsynchPrediv       = RTC_ASYNC_PREDIV;
+    mRtc.Init.SynchPrediv        = subSecondHz - 1;
+    mRtc.Init.OutPut             = RTC_OUTPUT_DISABLE;
+    mRtc.Init.OutPutPolarity     = RTC_OUTPUT_POLARITY_HIGH;
+    mRtc.Init.OutPutType         = RTC_OUTPUT_TYPE_OPENDRAIN;
+
+    if (HAL_RTC_Init(&mRtc) != HAL_OK) { return false; }
+
+    mRtcClockHz   = rtcClockHz;
+    mSubSecondHz  = subSecondHz;
+    mWakeUpHz     = rtcClockHz / RTC_WAKEUP_DIV;
+    mMaxStopTicks = static_cast<uint32_t>((static_cast<uint64_t>(RTC_WAKEUP_MAX) * mTickRateHz) / mWakeUpHz);
+    return true;
+}
+
+/**
+ * \brief   Measure the LSI frequency against the core clock, by timing the
+ *          sub second changes of the RTC.
+ * \returns The LSI frequency in Hz, 0 if the RTC does not run.
+ * \note    The RTC must run with RTC_ASYNC_PREDIV, takes about 8 ms.
+ */
+uint32_t TicklessIdle::MeasureRtcClock() const
+{
+    // A sub second should take 250 us, wait for 10 ms at most
+    const uint32_t timeout = SystemCoreClock / 100;
+
+    // Align to a change first
+    if (!WaitForSubSecond(mRtc.Instance, timeout)) { return 0; }
+
+    const uint32_t start = DWT->CYCCNT;
+    for (uint32_t i = 0; i < RTC_MEASURE_EDGES; i++)
+    {
+        if (!WaitForSubSecond(mRtc.Instance, timeout)) { return 0; }
+    }
+    const uint32_t cycles = DWT->CYCCNT - start;
+
+    return static_cast<uint32_t>((static_cast<uint64_t>(RTC_MEASURE_EDGES) * (RTC_ASYNC_PREDIV + 1) * SystemCoreClock) / cycles);
+}
+
+/**
+ * \brief   Check if Stop mode can be used.
+ * \param   expectedIdleTicks   The number of ticks expected to be idle.
+ * \returns True if Stop mode can be used, else false.
+ * \note    In Stop mode all clocks except the LSI and LSE are stopped: a
+ *          running DMA transfer would stall.
+ */
+bool TicklessIdle::IsStopAllowed(uint32_t expectedIdleTicks) const
+{
+    if (expectedIdleTicks < mStopThreshold) { return false; }
+    if (mStopLocks > 0)                     { return false; }
+
+    for (const DMA_Stream_TypeDef* stream : dmaStreams)
+    {
+        if (stream->CR & DMA_SxCR_EN) { return false; }
+    }
+    return true;
+}
+
+/**
+ * \brief   Sleep mode: the SysTick is reloaded to fire at the expected wake
+ *          time, as vPortSuppressTicksAndSleep() of the FreeRTOS port.
+ * \param   expectedIdleTicks   The number of ticks expected to be idle.
+ * \param   sleptCycles         The number of cycles slept.
+ * \returns The number of completed ticks.
+ */
+uint32_t TicklessIdle::EnterSleep(uint32_t expectedIdleTicks, uint64_t& sleptCycles)
+{
+    const uint32_t ticks     = (expectedIdleTicks > mMaxSleepTicks) ? mMaxSleepTicks : expectedIdleTicks;
+    const uint32_t remaining = StopSysTick();
+
+    uint32_t reload = remaining + (mCyclesPerTick * (ticks - 1));
+    if (reload > TICKLESS_MISSED_COUNTS) { reload -= TICKLESS_MISSED_COUNTS; }
+
+    SysTick->LOAD  = reload;
+    SysTick->VAL   = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+
+    __DSB();
+    __WFI();
+    __ISB();
+
+    // Reading CTRL clears COUNTFLAG
+    const uint32_t ctrl = SysTick->CTRL;
+    SysTick->CTRL = ctrl & ~(SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_COUNTFLAG_Msk);
+    const uint32_t value = SysTick->VAL;
+
+    uint32_t completed = 0;
+    uint32_t nextTick  = 0;
+
+    if (ctrl & SysTick_CTRL_COUNTFLAG_Msk)
+    {
+        // Woken by the SysTick: its interrupt is pending and processes the last tick
+        completed   = ticks - 1;
+        sleptCycles = static_cast<uint64_t>(reload) + (reload - value);
+        nextTick    = (mCyclesPerTick - 1) - (reload - value);
+        if ((nextTick <= TICKLESS_MISSED_COUNTS) || (nextTick > mCyclesPerTick))
+        {
+            nextTick = mCyclesPerTick - 1;
+        }
+    }
+    else
+    {
+        // Woken by another interrupt
+        sleptCycles = reload - value;
+        completed   = StepTicks((static_cast<uint64_t>(ticks) * mCyclesPerTick) - value, mCyclesPerTick, ticks, nextTick);
+    }
+
+    RestartSysTick(nextTick);
+    return completed;
+}
+
+/**
+ * \brief   Stop mode: woken by the RTC wakeup timer (or an EXTI interrupt).
+ *          The time in Stop mode is measured with the RTC sub seconds.
+ * \param   expectedIdleTicks   The number of ticks expected to be idle.
+ * \param   sleptCycles         The number of cycles slept, in core clock cycles.
+ * \returns The number of completed ticks.
+ */
+uint32_t TicklessIdle::EnterStop(uint32_t expectedIdleTicks, uint64_t& sleptCycles)
+{
+    const uint32_t ticks     = (expectedIdleTicks > mMaxStopTicks) ? mMaxStopTicks : expectedIdleTicks;
+    const uint32_t remaining = StopSysTick();
+
+    // Wake a tick early: restoring the clock takes time, the SysTick covers the remainder
+    uint32_t counter = static_cast<uint32_t>((static_cast<uint64_t>(ticks - 1) * mWakeUpHz) / mTickRateHz);
+    if (counter < 1) { counter = 1; }
+
+    if (!StartWakeUpTimer(counter - 1))
+    {
+        sleptCycles = 0;
+        RestartSysTick(remaining);
+        return 0;
+    }
+
+    const uint32_t before = ReadRtc();
+    const uint32_t clock  = RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON);
+    const uint32_t source = RCC->CFGR & RCC_CFGR_SW;
+
+    HAL_PWR_EnterSTOPMode(PWR_LOWPOWERREGULATOR_ON, PWR_STOPENTRY_WFI);
+
+    // Woken: running from the HSI, the PLL and HSE are off
+    if (mRestoreClock != nullptr) { (void)mRestoreClock(); }
+    else
+    {
+        const bool restored = RestoreClock(clock, source);
+        EXPECT(restored);
+        (void)restored;
+    }
+    StopWakeUpTimer();
+
+    // The shadow registers are not updated in Stop mode: if not synchronized
+    // (LSI stopped) the old time is read, the sleep counts as 0 ticks
+    (void)SynchronizeRtc();
+
+    const uint32_t minute  = 60 * mSubSecondHz;
+    const uint32_t elapsed = (ReadRtc() + minute - before) % minute;
+
+    sleptCycles = (static_cast<uint64_t>(elapsed) * mCyclesPerTick * mTickRateHz) / mSubSecondHz;
+
+    uint32_t nextTick = 0;
+    const uint32_t completed = StepTicks((mCyclesPerTick - remaining) + sleptCycles, mCyclesPerTick, ticks, nextTick);
+
+    RestartSysTick(nextTick);
+    return completed;
+}
+
+/**
+ * \brief   Start the RTC wakeup timer, with its interrupt.
+ * \param   counter     The wakeup counter, the timer fires after counter + 1
+ *                      periods of the RTC clock / 16.
+ * \returns True if the wakeup timer is started, false if the wakeup timer
+ *          could not be written.
+ */
+bool TicklessIdle::StartWakeUpTimer(uint32_t counter)
+{
+    RTC_TypeDef* const rtc = mRtc.Instance;
+
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&mRtc);
+    rtc->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+
+    if (!WaitForBits(rtc->ISR, RTC_ISR_WUTWF, RTC_ISR_WUTWF))
+    {
+        __HAL_RTC_WRITEPROTECTION_ENABLE(&mRtc);
+        return false;
+    }
+
+    rtc->WUTR = counter;
+    rtc->CR   = (rtc->CR & ~RTC_CR_WUCKSEL) | RTC_WAKEUPCLOCK_RTCCLK_DIV16;
+    rtc->ISR &= ~RTC_ISR_WUTF;
+    __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG();
+    rtc->CR  |= RTC_CR_WUTIE | RTC_CR_WUTE;
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&mRtc);
+    return true;
+}
+
+/**
+ * \brief   Stop the RTC wakeup timer. A pending wakeup interrupt is still
+ *          handled, it only clears the flags.
+ */
+void TicklessIdle::StopWakeUpTimer()
+{
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&mRtc);
+    mRtc.Instance->CR &= ~(RTC_CR_WUTE | RTC_CR_WUTIE);
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&mRtc);
+}
+
+/**
+ * \brief   Wait for the RTC shadow registers to be updated, after Stop mode.
+ * \returns True if synchronized, false if timed out.
+ */
+bool TicklessIdle::SynchronizeRtc()
+{
+    RTC_TypeDef* const rtc = mRtc.Instance;
+
+    __HAL_RTC_WRITEPROTECTION_DISABLE(&mRtc);
+    rtc->ISR &= ~RTC_ISR_RSF;
+    __HAL_RTC_WRITEPROTECTION_ENABLE(&mRtc);
+
+    return WaitForBits(rtc->ISR, RTC_ISR_RSF, RTC_ISR_RSF);
+}
+
+/**
+ * \brief   Restore the system clock after Stop mode: restart the HSE and PLL
+ *          if they ran before, then select the clock source again. The PLL
+ *          configuration, prescalers and flash latency are kept in Stop mode.
+ * \param   clock   The RCC_CR_HSEON and RCC_CR_PLLON bits before Stop mode.
+ * \param   source  The RCC_CFGR_SW bits before Stop mode.
+ * \returns True if the clock is restored, false if an oscillator or the PLL
+ *          did not start: the system keeps running from the HSI.
+ */
+bool TicklessIdle::RestoreClock(uint32_t clock, uint32_t source)
+{
+    if (clock & RCC_CR_HSEON)
+    {
+        RCC->CR |= RCC_CR_HSEON;
+        if (!WaitForBits(RCC->CR, RCC_CR_HSERDY, RCC_CR_HSERDY)) { return false; }
+    }
+    if (clock & RCC_CR_PLLON)
+    {
+        RCC->CR |= RCC_CR_PLLON;
+        if (!WaitForBits(RCC->CR, RCC_CR_PLLRDY, RCC_CR_PLLRDY)) { return false; }
+    }
+
+    RCC->CFGR = (RCC->CFGR & ~RCC_CFGR_SW) | source;
+    return WaitForBits(RCC->CFGR, RCC_CFGR_SWS, source << RCC_CFGR_SWS_Pos);
+}
+
+/**
+ * \brief   Stop the SysTick.
+ * \returns The cycles left until the next tick.
+ */
+uint32_t TicklessIdle::StopSysTick()
+{
+    SysTick->CTRL &= ~SysTick_CTRL_ENABLE_Msk;
+
+    const uint32_t value = SysTick->VAL;
+    return (value == 0) ? mCyclesPerTick : value;
+}
+
+/**
+ * \brief   Restart the SysTick: the next tick after the given number of
+ *          cycles, the ticks after that at the regular period.
+ * \param   nextTickCycles  Cycles until the next tick.
+ */
+void TicklessIdle::RestartSysTick(uint32_t nextTickCycles)
+{
+    SysTick->LOAD  = nextTickCycles;
+    SysTick->VAL   = 0;
+    SysTick->CTRL |= SysTick_CTRL_ENABLE_Msk;
+    SysTick->LOAD  = mCyclesPerTick - 1;
+}
+
+/**
+ * \brief   Read the RTC time, in sub seconds within the minute.
+ * \returns The time in sub seconds, 0 to (60 * sub seconds per second) - 1.
+ * \note    Reading SSR locks TR and DR until DR is read.
+ */
+uint32_t TicklessIdle::ReadRtc() const
+{
+    const uint32_t ssr = mRtc.Instance->SSR;
+    const uint32_t tr  = mRtc.Instance->TR;
+    (void)mRtc.Instance->DR;
+
+    const uint32_t seconds = (((tr & RTC_TR_ST) >> RTC_TR_ST_Pos) * 10) + (tr & RTC_TR_SU);
+
+    // SSR counts down from SynchPrediv
+    return (seconds * mSubSecondHz) + (mRtc.Init.SynchPrediv - ssr);
+}
+
+/**
+ * \brief   Add the slept cycles, once per second (awake and asleep together)
+ *          publish the statistics.
+ * \param   sleptCycles     The cycles slept.
+ */
+void TicklessIdle::UpdateStatistics(uint64_t sleptCycles)
+{
+    mAsleepCycles += sleptCycles;
+
+    const uint64_t total = mAwakeCycles + mAsleepCycles;
+    if (total >= (mCyclesPerTick * mTickRateHz))
+    {
+        mCounting.wakePercentage  = mAwakeCycles * 100.0f;
+        mCounting.wakePercentage /= total;
+
+        mStats           = mCounting;
+        mUpdateAvailable = true;
+
+        mCounting        = {};
+        mAwakeCycles     = 0;
+        mAsleepCycles    = 0;
+    }
+}
+
+
+/************************************************************************/
+/* Interrupts                                                           */
+/************************************************************************/
+/**
+ * \brief   ISR: clear the RTC wakeup flags, it only ends Stop mode.
+ */
+extern "C" void RTC_WKUP_IRQHandler(void)
+{
+    if (rtcHandle != nullptr)
+    {
+        HAL_RTCEx_WakeUpTimerIRQHandler(rtcHandle);
+    }
+}
@@ -9,10 +9,11 @@ extern "C" {
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
+#include "utility/DeferredLog/DeferredLog.h"
 #include <stdlib.h>
 
 
-void _expect_log(const char* expr, int line, const char* file);
+void _expect_log(const DeferredLogSite* site);
 void _expect_breakpoint();
 void _assert_breakpoint();
 void _assert_reset(const char* expr, int line, const char* file);
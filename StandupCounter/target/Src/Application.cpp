@@ -15,8 +15,8 @@
  * \details StandupCounter with 8x8 LED display and buzzer.
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -35,6 +35,8 @@
 static constexpr uint32_t MAX_LOOP_COUNT = 10;      // Do not set above 10, display logic can represent only a single digit!
 static constexpr uint32_t LONG_DELAY_MS  = 105000;
 
+static_assert(MAX_LOOP_COUNT <= (sizeof(glyph_digits) / sizeof(glyph_digits[0])), "Countdown can only display single digits");
+
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -119,19 +121,7 @@ void Application::Process()
         {
             // Display digit - countdown
             uint32_t j = MAX_LOOP_COUNT - i - 1;
-            switch (j) {
-                case 0: { result = mMatrix.WriteDigits(digit_zero);  } break;
-                case 1: { result = mMatrix.WriteDigits(digit_one);   } break;
-                case 2: { result = mMatrix.WriteDigits(digit_two);   } break;
-                case 3: { result = mMatrix.WriteDigits(digit_three); } break;
-                case 4: { result = mMatrix.WriteDigits(digit_four);  } break;
-                case 5: { result = mMatrix.WriteDigits(digit_five);  } break;
-                case 6: { result = mMatrix.WriteDigits(digit_six);   } break;
-                case 7: { result = mMatrix.WriteDigits(digit_seven); } break;
-                case 8: { result = mMatrix.WriteDigits(digit_eight); } break;
-                case 9: { result = mMatrix.WriteDigits(digit_nine);  } break;
-                default: break;
-            };
+            result = mMatrix.WriteDigits(glyph_digits[j]);
             EXPECT(result);
 
             // Short beep
@@ -11,11 +11,15 @@
  * \brief   Library of constants representing contents for the HI-M1388AR 8x8
  *          LED matrix display.
  *
+ * \details Each item is 8 lines, line 0 is the bottom line. Bit 0 of a line
+ *          is the leftmost column. The glyph tables and GetGlyph() look up
+ *          items at compile time, instead of a switch per character.
+ *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef HI_M1388AR_LIB_HPP_
@@ -30,7 +34,12 @@
 /************************************************************************/
 /* Constants                                                            */
 /************************************************************************/
-constexpr uint8_t MATRIX_SIZE = 8;
+/**
+ * \brief   Helper constant indicating the rows of the 8x8 matrix display.
+ */
+static constexpr uint8_t MATRIX_SIZE = 8;
+
+#ifndef DOXYGEN_SHOULD_SKIP_THIS
 
 // Digits
 constexpr uint8_t digit_one[MATRIX_SIZE]   = { 0x7E, 0x18, 0x18, 0x18, 0x1C, 0x18, 0x18, 0x00 };
@@ -73,37 +82,71 @@ constexpr uint8_t letter_Y[MATRIX_SIZE] = { 0x18, 0x18, 0x18, 0x3C, 0x66, 0x66,
 constexpr uint8_t letter_Z[MATRIX_SIZE] = { 0x7E, 0x06, 0x0C, 0x18, 0x30, 0x60, 0x7E, 0x00 };
 
 // Letters - small caps
-constexpr uint8_t letter_a[MATRIX_SIZE] = { 0x7C, 0x66, 0x7C, 0x60, 0x3C, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_b[MATRIX_SIZE] = { 0x3E, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x06, 0X00 };
-constexpr uint8_t letter_c[MATRIX_SIZE] = { 0x3C, 0x66, 0x06, 0x66, 0x3C, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_d[MATRIX_SIZE] = { 0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0X00 };
-constexpr uint8_t letter_e[MATRIX_SIZE] = { 0x3C, 0x06, 0x7E, 0x66, 0x3C, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_f[MATRIX_SIZE] = { 0x0C, 0x0C, 0x3E, 0x0C, 0x0C, 0x6C, 0x38, 0X00 };
-constexpr uint8_t letter_g[MATRIX_SIZE] = { 0x3C, 0x60, 0x7C, 0x66, 0x66, 0x7C, 0x00, 0X00 };
-constexpr uint8_t letter_h[MATRIX_SIZE] = { 0x66, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x06, 0X00 };
-constexpr uint8_t letter_i[MATRIX_SIZE] = { 0x3C, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00, 0X00 };
-constexpr uint8_t letter_j[MATRIX_SIZE] = { 0x1C, 0x36, 0x36, 0x30, 0x30, 0x00, 0x30, 0X00 };
-constexpr uint8_t letter_k[MATRIX_SIZE] = { 0x66, 0x36, 0x1E, 0x36, 0x66, 0x06, 0x06, 0X00 };
-constexpr uint8_t letter_l[MATRIX_SIZE] = { 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0X00 };
-constexpr uint8_t letter_m[MATRIX_SIZE] = { 0xD6, 0xD6, 0xFE, 0xEE, 0xC6, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_n[MATRIX_SIZE] = { 0x66, 0x66, 0x66, 0x7E, 0x3E, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_o[MATRIX_SIZE] = { 0x3C, 0x66, 0x66, 0x66, 0x3C, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_p[MATRIX_SIZE] = { 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3E, 0x00, 0X00 };
-constexpr uint8_t letter_q[MATRIX_SIZE] = { 0xF0, 0xB0, 0x3C, 0x36, 0x36, 0x3C, 0x00, 0X00 };
-constexpr uint8_t letter_r[MATRIX_SIZE] = { 0x06, 0x06, 0x66, 0x66, 0x3E, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_s[MATRIX_SIZE] = { 0x3E, 0x40, 0x3C, 0x02, 0x7C, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_t[MATRIX_SIZE] = { 0x18, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x00, 0X00 };
-constexpr uint8_t letter_u[MATRIX_SIZE] = { 0x7C, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_v[MATRIX_SIZE] = { 0x18, 0x3C, 0x66, 0x66, 0x00, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_w[MATRIX_SIZE] = { 0x7C, 0xD6, 0xD6, 0xD6, 0xC6, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_x[MATRIX_SIZE] = { 0x66, 0x3C, 0x18, 0x3C, 0x66, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_y[MATRIX_SIZE] = { 0x3C, 0x60, 0x7C, 0x66, 0x66, 0x00, 0x00, 0X00 };
-constexpr uint8_t letter_z[MATRIX_SIZE] = { 0x3C, 0x0C, 0x18, 0x30, 0x3C, 0x00, 0x00, 0X00 };
+constexpr uint8_t letter_a[MATRIX_SIZE] = { 0x7C, 0x66, 0x7C, 0x60, 0x3C, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_b[MATRIX_SIZE] = { 0x3E, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x06, 0x00 };
+constexpr uint8_t letter_c[MATRIX_SIZE] = { 0x3C, 0x66, 0x06, 0x66, 0x3C, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_d[MATRIX_SIZE] = { 0x7C, 0x66, 0x66, 0x7C, 0x60, 0x60, 0x60, 0x00 };
+constexpr uint8_t letter_e[MATRIX_SIZE] = { 0x3C, 0x06, 0x7E, 0x66, 0x3C, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_f[MATRIX_SIZE] = { 0x0C, 0x0C, 0x3E, 0x0C, 0x0C, 0x6C, 0x38, 0x00 };
+constexpr uint8_t letter_g[MATRIX_SIZE] = { 0x3C, 0x60, 0x7C, 0x66, 0x66, 0x7C, 0x00, 0x00 };
+constexpr uint8_t letter_h[MATRIX_SIZE] = { 0x66, 0x66, 0x66, 0x3E, 0x06, 0x06, 0x06, 0x00 };
+constexpr uint8_t letter_i[MATRIX_SIZE] = { 0x3C, 0x18, 0x18, 0x18, 0x00, 0x18, 0x00, 0x00 };
+constexpr uint8_t letter_j[MATRIX_SIZE] = { 0x1C, 0x36, 0x36, 0x30, 0x30, 0x00, 0x30, 0x00 };
+constexpr uint8_t letter_k[MATRIX_SIZE] = { 0x66, 0x36, 0x1E, 0x36, 0x66, 0x06, 0x06, 0x00 };
+constexpr uint8_t letter_l[MATRIX_SIZE] = { 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x18, 0x00 };
+constexpr uint8_t letter_m[MATRIX_SIZE] = { 0xD6, 0xD6, 0xFE, 0xEE, 0xC6, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_n[MATRIX_SIZE] = { 0x66, 0x66, 0x66, 0x7E, 0x3E, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_o[MATRIX_SIZE] = { 0x3C, 0x66, 0x66, 0x66, 0x3C, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_p[MATRIX_SIZE] = { 0x06, 0x06, 0x3E, 0x66, 0x66, 0x3E, 0x00, 0x00 };
+constexpr uint8_t letter_q[MATRIX_SIZE] = { 0xF0, 0xB0, 0x3C, 0x36, 0x36, 0x3C, 0x00, 0x00 };
+constexpr uint8_t letter_r[MATRIX_SIZE] = { 0x06, 0x06, 0x66, 0x66, 0x3E, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_s[MATRIX_SIZE] = { 0x3E, 0x40, 0x3C, 0x02, 0x7C, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_t[MATRIX_SIZE] = { 0x18, 0x18, 0x18, 0x7E, 0x18, 0x18, 0x00, 0x00 };
+constexpr uint8_t letter_u[MATRIX_SIZE] = { 0x7C, 0x66, 0x66, 0x66, 0x66, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_v[MATRIX_SIZE] = { 0x18, 0x3C, 0x66, 0x66, 0x00, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_w[MATRIX_SIZE] = { 0x7C, 0xD6, 0xD6, 0xD6, 0xC6, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_x[MATRIX_SIZE] = { 0x66, 0x3C, 0x18, 0x3C, 0x66, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_y[MATRIX_SIZE] = { 0x3C, 0x60, 0x7C, 0x66, 0x66, 0x00, 0x00, 0x00 };
+constexpr uint8_t letter_z[MATRIX_SIZE] = { 0x3C, 0x0C, 0x18, 0x30, 0x3C, 0x00, 0x00, 0x00 };
 
 // Symbols
 constexpr uint8_t symbol_smiley[MATRIX_SIZE]        = { 0x3C, 0x42, 0x99, 0xA5, 0x81, 0xA5, 0x42, 0x3C };
 constexpr uint8_t symbol_sadface[MATRIX_SIZE]       = { 0x3C, 0x42, 0xA5, 0x99, 0x81, 0xA5, 0x42, 0x3C };
 constexpr uint8_t symbol_question_mark[MATRIX_SIZE] = { 0x18, 0x00, 0x18, 0x38, 0x60, 0x66, 0x3C, 0x00 };
+constexpr uint8_t symbol_blank[MATRIX_SIZE]         = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+// Glyph tables
+constexpr const uint8_t* glyph_digits[10] = { digit_zero, digit_one, digit_two, digit_three, digit_four,
+                                              digit_five, digit_six, digit_seven, digit_eight, digit_nine };
+
+constexpr const uint8_t* glyph_capitals[26] = { letter_A, letter_B, letter_C, letter_D, letter_E, letter_F, letter_G,
+                                                letter_H, letter_I, letter_J, letter_K, letter_L, letter_M, letter_N,
+                                                letter_O, letter_P, letter_Q, letter_R, letter_S, letter_T, letter_U,
+                                                letter_V, letter_W, letter_X, letter_Y, letter_Z };
+
+constexpr const uint8_t* glyph_small[26] = { letter_a, letter_b, letter_c, letter_d, letter_e, letter_f, letter_g,
+                                             letter_h, letter_i, letter_j, letter_k, letter_l, letter_m, letter_n,
+                                             letter_o, letter_p, letter_q, letter_r, letter_s, letter_t, letter_u,
+                                             letter_v, letter_w, letter_x, letter_y, letter_z };
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+/**
+ * \brief   Get the item to display for a character.
+ * \param   c   The character: digit, letter, '?' or space.
+ * \returns The item for the character, symbol_blank if not available.
+ */
+constexpr const uint8_t* GetGlyph(char c)
+{
+    return ((c >= '0') && (c <= '9')) ? glyph_digits[c - '0']   :
+           ((c >= 'A') && (c <= 'Z')) ? glyph_capitals[c - 'A'] :
+           ((c >= 'a') && (c <= 'z')) ? glyph_small[c - 'a']    :
+           (c == '?')                 ? symbol_question_mark    : symbol_blank;
+}
 
 
 #endif  // HI_M1388AR_LIB_HPP_
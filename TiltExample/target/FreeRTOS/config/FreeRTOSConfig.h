@@ -48,7 +48,7 @@
 #endif
 
 #define configUSE_PREEMPTION                       1
-#define configUSE_TICKLESS_IDLE                    0
+#define configUSE_TICKLESS_IDLE                    2
 #define configCPU_CLOCK_HZ                         ( SystemCoreClock )
 #define configTICK_RATE_HZ                         ( ( TickType_t ) 1000 )
 #define configMAX_PRIORITIES                       5
@@ -70,10 +70,21 @@
 #define configSTACK_DEPTH_TYPE                     uint16_t
 #define configMESSAGE_BUFFER_LENGTH_TYPE           size_t
 
-/* Memory allocation related definitions. */
-#define configSUPPORT_STATIC_ALLOCATION            0
-#define configSUPPORT_DYNAMIC_ALLOCATION           1
-#define configTOTAL_HEAP_SIZE                      ( ( size_t ) ( 8 * 1024 ) )
+/* Memory allocation related definitions. With STATIC_ALLOCATION 1 (CMake
+option STATIC_ALLOCATION, default ON) all task stacks, queues and stream buffers
+are allocated at link time, see utility/StaticRtos. With 0 they are allocated
+from the block pools set up by the application, see utility/PoolAllocator: no
+FreeRTOS heap (heap_x.c) is linked. */
+#ifndef STATIC_ALLOCATION
+   #define STATIC_ALLOCATION                       1
+#endif
+#if (STATIC_ALLOCATION == 1)
+   #define configSUPPORT_STATIC_ALLOCATION         1
+   #define configSUPPORT_DYNAMIC_ALLOCATION        0
+#else
+   #define configSUPPORT_STATIC_ALLOCATION         0
+   #define configSUPPORT_DYNAMIC_ALLOCATION        1
+#endif
 #define configAPPLICATION_ALLOCATED_HEAP           0
 #define configSTACK_ALLOCATION_FROM_SEPARATE_HEAP  0
 
@@ -85,10 +96,45 @@
 #define configUSE_DAEMON_TASK_STARTUP_HOOK         0
 
 /* Run time and task stats gathering related definitions. */
-#define configGENERATE_RUN_TIME_STATS              0
-#define configUSE_TRACE_FACILITY                   0
+#define configGENERATE_RUN_TIME_STATS              1
+#define configUSE_TRACE_FACILITY                   1
 #define configUSE_STATS_FORMATTING_FUNCTIONS       0
 
+/* Run time stats and task switch tracing with the DWT cycle counter, see
+utility/RunTimeStats. The counter wraps after 2^32 cycles: the totals kept by
+FreeRTOS itself wrap as well, RunTimeStats reports per period. */
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+   #ifdef __cplusplus
+   extern "C" {
+   #endif
+   void     RunTimeStats_ConfigureCounter(void);
+   uint32_t RunTimeStats_GetCounter(void);
+   void     RunTimeStats_TaskSwitchedIn(const void* handle, const char* name);
+   void     RunTimeStats_TaskSwitchedOut(void);
+   #ifdef __cplusplus
+   }
+   #endif
+#endif
+#define portCONFIGURE_TIMER_FOR_RUN_TIME_STATS()   RunTimeStats_ConfigureCounter()
+#define portGET_RUN_TIME_COUNTER_VALUE()           RunTimeStats_GetCounter()
+#define traceTASK_SWITCHED_IN()                    RunTimeStats_TaskSwitchedIn( pxCurrentTCB, pxCurrentTCB->pcTaskName )
+#define traceTASK_SWITCHED_OUT()                   RunTimeStats_TaskSwitchedOut()
+
+/* Tickless idle in Sleep or Stop mode, see utility/TicklessIdle. The tick is
+only suppressed if at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP ticks are idle,
+Stop mode needs more (TICKLESS_STOP_THRESHOLD). */
+#define configEXPECTED_IDLE_TIME_BEFORE_SLEEP      2
+#if defined(__ICCARM__) || defined(__CC_ARM) || defined(__GNUC__)
+   #ifdef __cplusplus
+   extern "C" {
+   #endif
+   void     vApplicationSuppressTicksAndSleep(uint32_t xExpectedIdleTime);
+   #ifdef __cplusplus
+   }
+   #endif
+#endif
+#define portSUPPRESS_TICKS_AND_SLEEP( xExpectedIdleTime )  vApplicationSuppressTicksAndSleep( xExpectedIdleTime )
+
 /* Co-routine related definitions. */
 #define configUSE_CO_ROUTINES                      0
 #define configMAX_CO_ROUTINE_PRIORITIES            1
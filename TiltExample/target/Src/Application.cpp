@@ -22,13 +22,20 @@
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
-#include <math.h>
+#include <algorithm>
 #include <functional>
 #include "Application.hpp"
+#include "board/Board.hpp"
 #include "board/BoardConfig.hpp"
 #include "utility/Assert/Assert.h"
+#include "utility/DeferredLog/DeferredLog.h"
+#include "utility/PoolAllocator/PoolAllocator.hpp"
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+#include "utility/StackPainting/stack_monitor.h"
+#include "utility/StaticRtos/StaticRtos.hpp"
 #include "../FreeRTOS/include/FreeRTOS.h"
 #include "../FreeRTOS/include/queue.h"
+#include "../FreeRTOS/include/stream_buffer.h"
 #include "../FreeRTOS/include/task.h"
 
 
@@ -36,9 +43,21 @@
 /* Constants                                                            */
 /************************************************************************/
 static const uint16_t MOTION_SAMPLE_SIZE = 3 * 2;   // X,Y,Z, each 16 bit signed int
+static const uint8_t  MOTION_BURST_SIZE  = LIS3DSH_READ_SLOT_SIZE / MOTION_SAMPLE_SIZE;    // Samples in a full FIFO burst
 
-// Perform scaling --> (4000/65535) milli-G per digit for +/-2g full scale when using the 16-bit output
-static constexpr float K = 4.0 / UINT16_MAX;        // K expressed in G (m/s2), not milli-G
+// Usart stream buffer holds 2 full bursts: the producer never waits on the Usart
+static const size_t   USART_STREAM_SIZE  = 2 * MOTION_BURST_SIZE * sizeof(MotionSampleRaw);
+
+// Pitch and roll thresholds of the display, in Q15 of 180 degrees
+static constexpr int16_t ANGLE_10 = MotionMath::DegreesToAngle(10);
+static constexpr int16_t ANGLE_20 = MotionMath::DegreesToAngle(20);
+static constexpr int16_t ANGLE_30 = MotionMath::DegreesToAngle(30);
+static constexpr int16_t ANGLE_40 = MotionMath::DegreesToAngle(40);
+
+// Task stack depths in words, the stack report shows the headroom left
+static constexpr uint16_t MOTION_DATA_STACK_DEPTH = 300;
+static constexpr uint16_t MATRIX_STACK_DEPTH      = 300;
+static constexpr uint16_t USART_STACK_DEPTH       = configMINIMAL_STACK_SIZE;
 
 // 8x8 Led Matrix display
 static constexpr uint8_t MATRIX_NR_COLUMNS = 8;
@@ -53,13 +72,36 @@ void vMatrix(void* pvParam);
 void vUsart(void* pvParam);
 
 static TaskHandle_t xMotionData = NULL;
+static TaskHandle_t xMatrix     = NULL;
+static TaskHandle_t xUsart      = NULL;
+static uint8_t      isrMotion   = RUNTIME_STATS_INVALID;    // Motion data handler, not the whole IRQ
 
 static std::function<void()> callbackMotionDataReceived                              = nullptr;
 static std::function<void(const MotionSample &sample)> callbackUpdateDisplay         = nullptr;
-static std::function<void(const MotionSampleRaw &sample)> callbackSendSampleViaUsart = nullptr;
-
-static QueueHandle_t displayQueue = nullptr;
-static QueueHandle_t usartQueue   = nullptr;
+static std::function<void(const MotionSampleRaw *samples, size_t count)> callbackSendSamplesViaUsart = nullptr;
+static std::function<void(uint32_t expectedIdleTicks)> callbackSuppressTicksAndSleep = nullptr;
+
+static QueueHandle_t        displayQueue = nullptr;     // Mailbox: most recent sample only
+static StreamBufferHandle_t usartStream  = nullptr;     // Lossless: whole bursts of raw samples
+
+// Task stacks, queue and stream buffer: allocated at link time
+static StaticTask<MOTION_DATA_STACK_DEPTH>   motionDataTask;
+static StaticTask<MATRIX_STACK_DEPTH>        matrixTask;
+static StaticTask<USART_STACK_DEPTH>         usartTask;
+static StaticQueue<MotionSample, 1>          displayQueueMemory;
+static StaticStreamBuffer<USART_STREAM_SIZE> usartStreamMemory;
+
+// Block pools of the FreeRTOS heap and C++ new, sized to the objects created
+#if (configSUPPORT_DYNAMIC_ALLOCATION == 1)
+static PoolBlocks<160, 6>  pool160;                     // Task control blocks, display queue
+static PoolBlocks<512, 4>  pool512;                     // Usart and idle stack, usart stream buffer
+static PoolBlocks<1280, 2> pool1280;                    // Motion data and matrix stack
+static const PoolClass     poolClasses[] = { pool160.GetClass(), pool512.GetClass(), pool1280.GetClass() };
+#else
+static PoolBlocks<32, 8>   pool32;                      // C++ new only
+static PoolBlocks<128, 4>  pool128;
+static const PoolClass     poolClasses[] = { pool32.GetClass(), pool128.GetClass() };
+#endif
 
 
 /************************************************************************/
@@ -75,9 +117,26 @@ static void CallbackUpdateDisplay(const MotionSample &sample)
     if (callbackUpdateDisplay) { callbackUpdateDisplay(sample); }
 }
 
-static void CallbackSendSampleViaUsart(const MotionSampleRaw &sample)
+static void CallbackSendSamplesViaUsart(const MotionSampleRaw *samples, size_t count)
 {
-    if (callbackSendSampleViaUsart) { callbackSendSampleViaUsart(sample); }
+    if (callbackSendSamplesViaUsart) { callbackSendSamplesViaUsart(samples, count); }
+}
+
+static void CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks)
+{
+    if (callbackSuppressTicksAndSleep) { callbackSuppressTicksAndSleep(expectedIdleTicks); }
+}
+
+/**
+ * \brief   Failure hook of the block pools: a FreeRTOS object or C++ new did
+ *          not fit, see PoolAllocator::GetStatistics() for the class.
+ * \param   size    The number of bytes requested.
+ */
+static void PoolAllocationFailed(size_t size)
+{
+    (void)(size);
+
+    ASSERT(false);
 }
 
 /**
@@ -120,9 +179,12 @@ Application::Application() :
     mUsart(UsartInstance::USART_2),
     mDMA_SPI_Tx(DMA::Stream::Dma2_Stream3),
     mDMA_SPI_Rx(DMA::Stream::Dma2_Stream0),
+    mDMA_Usart_Tx(DMA::Stream::Dma1_Stream6),
     mMatrix(mSPIMatrix, PIN_SPI2_CS),
-    mLIS3DSH(mSPIMotion, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2),
-    mMotionLength(0)
+    mLIS3DSH(mSPIMotion, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2, mMotionReadBuffer, sizeof(mMotionReadBuffer)),
+    mTelemetry(mUsart, mCrc),
+    mDisplayDecimation(0),
+    mStatistics{}
 {
     // Note: button conflicts with the accelerometer int1 pin. This is a board layout issue.
     mLIS3DSH.SetHandler( [this](uint8_t length) { this->MotionDataReceived(length); } );
@@ -135,15 +197,21 @@ Application::Application() :
  */
 bool Application::Init()
 {
+    // Block pools first: FreeRTOS objects and C++ new allocate from them
+    bool result = PoolAllocator::Init(poolClasses, sizeof(poolClasses) / sizeof(poolClasses[0]));
+    ASSERT(result);
+    PoolAllocator::SetFailureHook(PoolAllocationFailed);
+
     mLedGreen.Set(Level::HIGH);
 
     // Connect callbacks (C to C++ bridge)
     callbackMotionDataReceived = [this]()                              { this->CallbackMotionDataReceived();       };
     callbackUpdateDisplay      = [this](const MotionSample &sample)    { this->CallbackUpdateDisplay(sample);      };
-    callbackSendSampleViaUsart = [this](const MotionSampleRaw &sample) { this->CallbackSendSampleViaUsart(sample); };
+    callbackSendSamplesViaUsart = [this](const MotionSampleRaw *samples, size_t count) { this->CallbackSendSamplesViaUsart(samples, count); };
+    callbackSuppressTicksAndSleep = [this](uint32_t expectedIdleTicks) { this->CallbackSuppressTicksAndSleep(expectedIdleTicks); };
 
     // Actual Init()
-    bool result = mDMA_SPI_Tx.Configure(DMA::Channel::Channel3, DMA::Direction::MemoryToPeripheral, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
+    result = mDMA_SPI_Tx.Configure(DMA::Channel::Channel3, DMA::Direction::MemoryToPeripheral, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
     ASSERT(result);
 
     result = mDMA_SPI_Rx.Configure(DMA::Channel::Channel3, DMA::Direction::PeripheralToMemory, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
@@ -160,7 +228,6 @@ bool Application::Init()
 
     result = mLIS3DSH.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz));
     ASSERT(result);
-    mMotionLength = 0;
 
 
     result = mSPIMatrix.Init(SPI::Config(11, SPI::Mode::_3, 1000000));
@@ -170,9 +237,28 @@ bool Application::Init()
     ASSERT(result);
 
 
+    result = mDMA_Usart_Tx.Configure(DMA::Channel::Channel4, DMA::Direction::MemoryToPeripheral, DMA::BufferMode::Normal, DMA::DataWidth::Byte, DMA::Priority::Low, DMA::HalfBufferInterrupt::Disabled);
+    ASSERT(result);
+
+    result = mDMA_Usart_Tx.Link(mUsart.GetPeripheralHandle(), mUsart.GetDmaTxHandle());
+    ASSERT(result);
+
     result = mUsart.Init(Usart::Config(10, false, Usart::Baudrate::_115K2));
     ASSERT(result);
 
+    result = mCrc.Init();
+    ASSERT(result);
+
+
+    // CPU load per task and ISR, reported once per second
+    result = RunTimeStats::Init(SystemCoreClock);
+    ASSERT(result);
+    isrMotion = RunTimeStats::RegisterIsr("Motion handler");
+
+    // Tickless idle: Stop mode between the accelerometer bursts
+    result = mTicklessIdle.Init(TicklessIdle::Config(15, configTICK_RATE_HZ, nullptr));    // Restarts the HSE and PLL itself
+    ASSERT(result);
+
 
     result = mLIS3DSH.Enable();
     ASSERT(result);
@@ -214,17 +300,28 @@ bool Application::CreateTasks()
 {
     bool result = false;
 
-    result = ( xTaskCreate( vMotionData,     "Motion Data Task",  300,                      NULL, tskIDLE_PRIORITY + 1, &xMotionData) == pdPASS ) ? true : false;
+    result = motionDataTask.Create( vMotionData, "Motion Data Task", NULL, tskIDLE_PRIORITY + 1, &xMotionData );
     ASSERT(result);
-    result = ( xTaskCreate( vMatrix,         "Matrix Task",       300,                      NULL, tskIDLE_PRIORITY + 1, NULL) == pdPASS ) ? true : false;
+    result = matrixTask.Create(     vMatrix,     "Matrix Task",      NULL, tskIDLE_PRIORITY + 1, &xMatrix );
     ASSERT(result);
-    result = ( xTaskCreate( vUsart,          "Usart Task",        configMINIMAL_STACK_SIZE, NULL, tskIDLE_PRIORITY + 1, NULL) == pdPASS ) ? true : false;
+    result = usartTask.Create(      vUsart,      "Usart Task",       NULL, tskIDLE_PRIORITY + 1, &xUsart );
     ASSERT(result);
 
-    displayQueue = xQueueCreate( 1, sizeof(MotionSample) );
+    // Stack headroom of the tasks and the main stack, scanned from the idle hook
+    stack_monitor_init();
+    result = stack_monitor_add_task(xMotionData, MOTION_DATA_STACK_DEPTH);
+    ASSERT(result);
+    result = stack_monitor_add_task(xMatrix, MATRIX_STACK_DEPTH);
+    ASSERT(result);
+    result = stack_monitor_add_task(xUsart, USART_STACK_DEPTH);
+    ASSERT(result);
+    result = stack_monitor_add_main();
+    ASSERT(result);
+
+    displayQueue = displayQueueMemory.Create();
     ASSERT(displayQueue);
-    usartQueue   = xQueueCreate( 1, sizeof(MotionSampleRaw) );
-    ASSERT(usartQueue);
+    usartStream  = usartStreamMemory.Create( sizeof(MotionSampleRaw) );
+    ASSERT(usartStream);
 
     return result;
 }
@@ -238,6 +335,24 @@ void Application::StartTasks()
     vTaskStartScheduler();
 }
 
+/**
+ * \brief   Get the statistics of the motion sample handoff.
+ * \returns The number of samples received and dropped per consumer.
+ */
+MotionStatistics Application::GetMotionStatistics() const
+{
+    return mStatistics;
+}
+
+/**
+ * \brief   Get the throughput and backpressure of the telemetry stream.
+ * \returns The telemetry statistics.
+ */
+TelemetryStats Application::GetTelemetryStatistics() const
+{
+    return mTelemetry.GetStatistics();
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -248,41 +363,24 @@ void Application::StartTasks()
  */
 void Application::MotionDataReceived(uint8_t length)
 {
+    RunTimeStats::IsrEnter(isrMotion);
+
     BaseType_t xHigherPriorityTaskWoken = pdFALSE;
 
-    mMotionLength = length;
+    UNUSED(length);     // The task takes the data (and length) from the driver
 
     vTaskNotifyGiveIndexedFromISR( xMotionData, 0, &xHigherPriorityTaskWoken );
 
-    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
-}
-
-/**
- * \brief   Convert to G (m/s2) and calculate the pith and roll.
- * \param   sampleRaw   The motion sample to convert.
- * \returns Converted motion sample.
- */
-MotionSample Application::CalculateMotionSample(const MotionSampleRaw &sampleRaw)
-{
-    MotionSample sample;
-
-    // Convert to G (m/s2)
-    sample.X = sampleRaw.X * K;
-    sample.Y = sampleRaw.Y * K;
-    sample.Z = sampleRaw.Z * K;
+    RunTimeStats::IsrExit(isrMotion);
 
-    // Calculate the pith and roll in degrees
-    sample.pitch = 180 * atan2(sample.Y, sample.Z) / M_PI;
-    sample.roll  = 180 * atan2(sample.X, sample.Z) / M_PI;
-
-    return sample;
+    portYIELD_FROM_ISR( xHigherPriorityTaskWoken );
 }
 
 /**
  * \brief   Calculate the pixel to display on the matrix display based upon the
  *          pitch and roll.
  * \param   dest    The destination pixel array (8 bytes) to fill.
- * \param   sample  Motion sample with pitch and roll in degrees.
+ * \param   sample  Motion sample with pitch and roll in Q15 of 180 degrees.
  * \param   invert  Flag, indicate if the display should be inverted or not.
  */
 void Application::CalculatePixel(uint8_t *dest, const MotionSample &sample, bool invert /* = false */)
@@ -290,28 +388,28 @@ void Application::CalculatePixel(uint8_t *dest, const MotionSample &sample, bool
     if (dest != nullptr)
     {
         uint8_t columnPitch = 0;
-             if (sample.pitch >  40.0) { columnPitch = 0x0F; }     // Special case: row
-        else if (sample.pitch >  30.0) { columnPitch = 7;    }
-        else if (sample.pitch >  20.0) { columnPitch = 6;    }
-        else if (sample.pitch >  10.0) { columnPitch = 5;    }
-        else if (sample.pitch >=  0.0) { columnPitch = 4;    }
-        else if (sample.pitch > -10.0) { columnPitch = 3;    }
-        else if (sample.pitch > -20.0) { columnPitch = 2;    }
-        else if (sample.pitch > -30.0) { columnPitch = 1;    }
-        else if (sample.pitch > -40.0) { columnPitch = 0;    }
-        else                           { columnPitch = 0xF0; }     // Special case: row
+             if (sample.pitch >  ANGLE_40) { columnPitch = 0x0F; }     // Special case: row
+        else if (sample.pitch >  ANGLE_30) { columnPitch = 7;    }
+        else if (sample.pitch >  ANGLE_20) { columnPitch = 6;    }
+        else if (sample.pitch >  ANGLE_10) { columnPitch = 5;    }
+        else if (sample.pitch >=        0) { columnPitch = 4;    }
+        else if (sample.pitch > -ANGLE_10) { columnPitch = 3;    }
+        else if (sample.pitch > -ANGLE_20) { columnPitch = 2;    }
+        else if (sample.pitch > -ANGLE_30) { columnPitch = 1;    }
+        else if (sample.pitch > -ANGLE_40) { columnPitch = 0;    }
+        else                               { columnPitch = 0xF0; }     // Special case: row
 
         uint8_t rowRoll = 0;
-             if (sample.roll >  40.0) { rowRoll = 0x0F; }          // Special case: column
-        else if (sample.roll >  30.0) { rowRoll = 7;    }
-        else if (sample.roll >  20.0) { rowRoll = 6;    }
-        else if (sample.roll >  10.0) { rowRoll = 5;    }
-        else if (sample.roll >=  0.0) { rowRoll = 4;    }
-        else if (sample.roll > -10.0) { rowRoll = 3;    }
-        else if (sample.roll > -20.0) { rowRoll = 2;    }
-        else if (sample.roll > -30.0) { rowRoll = 1;    }
-        else if (sample.roll > -40.0) { rowRoll = 0;    }
-        else                          { rowRoll = 0xF0; }          // Special case: column
+             if (sample.roll >  ANGLE_40) { rowRoll = 0x0F; }          // Special case: column
+        else if (sample.roll >  ANGLE_30) { rowRoll = 7;    }
+        else if (sample.roll >  ANGLE_20) { rowRoll = 6;    }
+        else if (sample.roll >  ANGLE_10) { rowRoll = 5;    }
+        else if (sample.roll >=        0) { rowRoll = 4;    }
+        else if (sample.roll > -ANGLE_10) { rowRoll = 3;    }
+        else if (sample.roll > -ANGLE_20) { rowRoll = 2;    }
+        else if (sample.roll > -ANGLE_30) { rowRoll = 1;    }
+        else if (sample.roll > -ANGLE_40) { rowRoll = 0;    }
+        else                              { rowRoll = 0xF0; }          // Special case: column
 
         uint8_t pixel = 0;
              if (columnPitch == 0x0F) { for (uint8_t i = 0; i < MATRIX_NR_COLUMNS; i++ ) { dest[i] = 0x80; } }
@@ -331,36 +429,94 @@ void Application::CalculatePixel(uint8_t *dest, const MotionSample &sample, bool
 
 /**
  * \brief   Callback for the motion data received event.
+ * \details Takes every read the driver holds, oldest first, straight from
+ *          its read buffer slot: the slot cannot be overwritten by the next
+ *          read until it is released.
  */
 void Application::CallbackMotionDataReceived()
 {
-    static uint8_t motionArray[MOTION_SAMPLE_SIZE] = {};
+    static MotionSampleRaw samplesRaw[MOTION_BURST_SIZE] = {};
+    static MotionSample    samples[MOTION_BURST_SIZE] = {};
 
-    if (mMotionLength > 0)
+    LIS3DSH::AxesData axesData;
+    while (mLIS3DSH.AcquireAxesData(axesData))
     {
         mLedOrange.Toggle();
 
-        bool retrieveResult = mLIS3DSH.RetrieveAxesData(motionArray, mMotionLength);
-        EXPECT(retrieveResult);
-        (void)(retrieveResult);
-
         // Deinterleave to X,Y,Z samples
-        for (size_t i = 0; ((i < sizeof(motionArray)) && (i + MOTION_SAMPLE_SIZE <= mMotionLength)); i += MOTION_SAMPLE_SIZE)
+        const uint8_t count = std::min<uint8_t>(axesData.length / MOTION_SAMPLE_SIZE, MOTION_BURST_SIZE);
+        for (uint8_t i = 0; i < count; i++)
+        {
+            const uint8_t* src = &axesData.data[i * MOTION_SAMPLE_SIZE];
+            samplesRaw[i].X = (src[1] << 8) | src[0];
+            samplesRaw[i].Y = (src[3] << 8) | src[2];
+            samplesRaw[i].Z = (src[5] << 8) | src[4];
+        }
+
+        bool releaseResult = mLIS3DSH.ReleaseAxesData(axesData);
+        EXPECT(releaseResult);
+        (void)(releaseResult);
+
+        // Pitch and roll for the whole burst at once
+        MotionMath::CalculateMotionSamples(samplesRaw, samples, count);
+
+        mStatistics.samples += count;
+
+        PublishToDisplay(samples, count);
+        PublishToUsart(samplesRaw, count);
+    }
+}
+
+/**
+ * \brief   Hand a burst of samples to the display: only every n-th sample
+ *          (MOTION_DISPLAY_DECIMATION) is used, of those only the most recent
+ *          is shown. Single kernel call per burst.
+ * \param   samples The converted samples of the burst.
+ * \param   count   The number of samples in the burst.
+ */
+void Application::PublishToDisplay(const MotionSample* samples, uint8_t count)
+{
+    const MotionSample* latest = nullptr;
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (++mDisplayDecimation >= MOTION_DISPLAY_DECIMATION)
         {
-            MotionSampleRaw sampleRaw;
-            sampleRaw.X = (motionArray[i + 1] << 8) | motionArray[i + 0];
-            sampleRaw.Y = (motionArray[i + 3] << 8) | motionArray[i + 2];
-            sampleRaw.Z = (motionArray[i + 5] << 8) | motionArray[i + 4];
-
-            MotionSample sample = CalculateMotionSample(sampleRaw);
-
-            // Put converted samples to queue(s)
-            BaseType_t result = xQueueSend(displayQueue, &sample, 0);
-            EXPECT(result == pdPASS);
-            result = xQueueSend(usartQueue, &sampleRaw, 0);
-            EXPECT(result == pdPASS);
+            mDisplayDecimation = 0;
+
+            if (latest != nullptr) { mStatistics.displayDropped++; }
+            latest = &samples[i];
         }
     }
+
+    if (latest != nullptr)
+    {
+        // Previous sample not yet shown: replaced by the newer one
+        if (uxQueueMessagesWaiting(displayQueue) > 0) { mStatistics.displayDropped++; }
+
+        xQueueOverwrite(displayQueue, latest);
+    }
+}
+
+/**
+ * \brief   Hand a burst of samples to the Usart: all samples, in a single
+ *          write to the stream buffer. Samples are only dropped if the Usart
+ *          did not keep up and the stream buffer is full.
+ * \param   samples The raw samples of the burst.
+ * \param   count   The number of samples in the burst.
+ */
+void Application::PublishToUsart(const MotionSampleRaw* samples, uint8_t count)
+{
+    const size_t space = xStreamBufferSpacesAvailable(usartStream) / sizeof(MotionSampleRaw);
+    const size_t fits  = (count < space) ? count : space;
+
+    if (fits > 0)
+    {
+        // Whole samples only, the Usart task never sees a partial sample
+        xStreamBufferSend(usartStream, samples, fits * sizeof(MotionSampleRaw), 0);
+    }
+
+    mStatistics.usartDropped += count - fits;
 }
 
 /**
@@ -377,23 +533,72 @@ void Application::CallbackUpdateDisplay(const MotionSample &sample)
 
 /**
  * \brief   Callback for the send via Usart event.
+ * \details The samples are added to the telemetry stream, the frame is sent
+ *          with DMA when the previous frame is sent: never blocks. Once per
+ *          period the run time report and the stack report are sent first,
+ *          in a frame of their own. Else recorded log entries (EXPECT()) are
+ *          sent first, encoded, in a frame of their own.
+ * \param   samples The raw samples to send.
+ * \param   count   The number of samples.
  */
-void Application::CallbackSendSampleViaUsart(const MotionSampleRaw &sample)
+void Application::CallbackSendSamplesViaUsart(const MotionSampleRaw *samples, size_t count)
 {
     mLedBlue.Set(Level::HIGH);
 
-    // Wrap the sample in '<' SAMPLE '>' packet format to allow receiving side
-    // to unpack it properly.
-    uint8_t packet[8] = {};
-    packet[0] = '<';
-    packet[7] = '>';
-    std::memcpy(&packet[1], reinterpret_cast<const uint8_t*>(&sample), MOTION_SAMPLE_SIZE);
-    bool result = mUsart.WriteBlocking(packet, sizeof(packet));
-    EXPECT(result);
+    if (RunTimeStats::IsUpdated() && !mTelemetry.IsBusy() && (mTelemetry.GetPending() == 0))
+    {
+        uint8_t report[RUNTIME_STATS_REPORT_SIZE(RUNTIME_STATS_MAX_ENTRIES)];
+        uint16_t length = RunTimeStats::GetReport(report, sizeof(report));
+        if (length > 0)
+        {
+            mTelemetry.Write(report, length);
+        }
+
+        uint8_t stackReport[STACK_MONITOR_REPORT_SIZE(STACK_MONITOR_MAX_ENTRIES)];
+        length = stack_monitor_get_report(stackReport, sizeof(stackReport));
+        if (length > 0)
+        {
+            mTelemetry.Write(stackReport, length);
+        }
+        mTelemetry.Flush();
+    }
+    else if ((DeferredLog::GetPending() > 0) && !mTelemetry.IsBusy() && (mTelemetry.GetPending() == 0))
+    {
+        DeferredLogEntry entry;
+        uint8_t record[DEFERRED_LOG_RECORD_SIZE];
+        for (uint8_t i = 0; (i < (TELEMETRY_PAYLOAD_SIZE / DEFERRED_LOG_RECORD_SIZE)) && DeferredLog::Read(entry); i++)
+        {
+            const uint16_t length = DeferredLog::Encode(entry, record, sizeof(record));
+            mTelemetry.Write(record, length);
+        }
+        mTelemetry.Flush();
+    }
+
+    for (size_t i = 0; i < count; i++)
+    {
+        mTelemetry.Write(reinterpret_cast<const uint8_t*>(&samples[i]), MOTION_SAMPLE_SIZE);
+    }
+    mTelemetry.Flush();     // If still busy: sent with the next burst
 
     mLedBlue.Set(Level::LOW);
 }
 
+/**
+ * \brief   Callback for the tickless idle: sleep until the next task is due.
+ * \details Stop mode is not used while a telemetry frame is sent: the DMA
+ *          stream completes before the last bytes left the Usart.
+ * \param   expectedIdleTicks   The number of ticks until the next task is due.
+ * \note    Called from the idle task with the interrupts disabled.
+ */
+void Application::CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks)
+{
+    const bool sending = mTelemetry.IsBusy();
+
+    if (sending) { mTicklessIdle.LockStop(); }
+    vTaskStepTick(mTicklessIdle.Sleep(expectedIdleTicks));
+    if (sending) { mTicklessIdle.UnlockStop(); }
+}
+
 
 /************************************************************************/
 /* Tasks                                                                */
@@ -439,29 +644,50 @@ void vMatrix(void *pvParameters)
 
 /**
  * \brief   Usart task.
- * \details Sends raw motion data towards PC.
+ * \details Sends raw motion data towards PC, in telemetry frames.
  */
 void vUsart(void *pvParameters)
 {
     while (true)
     {
-        // While data in queue: send to Usart (towards PC)
-        MotionSampleRaw sample;
-        if ( xQueueReceive(usartQueue, &sample, portMAX_DELAY) == pdPASS )
-        {
-            CallbackSendSampleViaUsart(sample);
-        }
+        // While data in stream buffer: send to Usart (towards PC)
+        static MotionSampleRaw samples[MOTION_BURST_SIZE];
+        const size_t length = xStreamBufferReceive(usartStream, samples, sizeof(samples), portMAX_DELAY);
+
+        CallbackSendSamplesViaUsart(samples, length / sizeof(MotionSampleRaw));
     }
 
     vTaskDelete( NULL );
 }
 
 /**
- * \brief   Application Idle Hook, implements a light sleep mode.
+ * \brief   Application Idle Hook, closes the run time statistics period when
+ *          elapsed. Sleeping is done by the tickless idle, see
+ *          vApplicationSuppressTicksAndSleep().
  */
 extern "C" void vApplicationIdleHook(void)
 {
-    __WFI();
+    RunTimeStats::IdleHook();
+    stack_monitor_idle_hook();
+}
+
+/**
+ * \brief   Tickless idle, called by the idle task (portSUPPRESS_TICKS_AND_SLEEP)
+ *          when no task is due for at least configEXPECTED_IDLE_TIME_BEFORE_SLEEP
+ *          ticks.
+ * \param   xExpectedIdleTime   The number of ticks until the next task is due.
+ */
+extern "C" void vApplicationSuppressTicksAndSleep(uint32_t xExpectedIdleTime)
+{
+    __disable_irq();
+
+    // A task may have been made ready, or a context switch pended, meanwhile
+    if (eTaskConfirmSleepModeStatus() != eAbortSleep)
+    {
+        CallbackSuppressTicksAndSleep(xExpectedIdleTime);
+    }
+
+    __enable_irq();
 }
 
 /**
@@ -25,43 +25,33 @@
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
-#include <atomic>
 #include "config.h"
 #include "components/HI-M1388AR/HI-M1388AR.hpp"
 #include "components/HI-M1388AR/FakeHI-M1388AR.hpp"
 #include "components/LIS3DSH/LIS3DSH.hpp"
 #include "components/LIS3DSH/FakeLIS3DSH.hpp"
+#include "drivers/Crc/CRC.hpp"
 #include "drivers/DMA/DMA.hpp"
 #include "drivers/Pin/Pin.hpp"
 #include "drivers/SPI/SPI.hpp"
 #include "drivers/Usart/Usart.hpp"
+#include "utility/MotionMath/MotionMath.hpp"
+#include "utility/TelemetryStreamer/TelemetryStreamer.hpp"
+#include "utility/TicklessIdle/TicklessIdle.hpp"
 
 
 /************************************************************************/
 /* Structs                                                              */
 /************************************************************************/
 /**
- * \struct  MotionSampleRaw
- * \brief   Raw motion sensor values.
+ * \struct  MotionStatistics
+ * \brief   Statistics of the motion sample handoff to the consumers.
  */
-struct MotionSampleRaw
+struct MotionStatistics
 {
-    int16_t X;  ///< Raw sensor X value
-    int16_t Y;  ///< Raw sensor Y value
-    int16_t Z;  ///< Raw sensor Z value
-};
-
-/**
- * \struct  MotionSample
- * \brief   Motion sensor values in G's (m/s2), pitch and roll in degrees.
- */
-struct MotionSample
-{
-    float X;        ///< Sensor value X in G (m/s2)
-    float Y;        ///< Sensor value Y in G (m/s2)
-    float Z;        ///< Sensor value Z in G (m/s2)
-    float pitch;    ///< Sensor pitch value in degrees
-    float roll;     ///< Sensor roll value in degrees
+    uint32_t samples;           ///< Samples received from the accelerometer
+    uint32_t displayDropped;    ///< Samples for the display replaced before being shown
+    uint32_t usartDropped;      ///< Samples for the Usart dropped, stream buffer full
 };
 
 
@@ -83,6 +73,9 @@ public:
     bool CreateTasks();
     void StartTasks();
 
+    MotionStatistics GetMotionStatistics() const;
+    TelemetryStats GetTelemetryStatistics() const;
+
 private:
     Pin mLedGreen;
     Pin mLedOrange;
@@ -96,9 +89,11 @@ private:
     SPI   mSPIMotion;
     SPI   mSPIMatrix;
     Usart mUsart;
+    Crc   mCrc;
 
     DMA mDMA_SPI_Tx;
     DMA mDMA_SPI_Rx;
+    DMA mDMA_Usart_Tx;
 
 #if (HI_M1388AR_DISPLAY == REAL_HI_M1388AR)
     HI_M1388AR     mMatrix;
@@ -106,22 +101,31 @@ private:
     FakeHI_M1388AR mMatrix;
 #endif
 
+    uint8_t        mMotionReadBuffer[LIS3DSH_READ_BUFFER_SIZE(false, 2)];    // Data Ready, 2 read slots
+
 #if (LIS3DSH_ACCELEROMETER == REAL_LIS3DSH)
     LIS3DSH        mLIS3DSH;
 #else
     FakeLIS3DSH    mLIS3DSH;
 #endif
 
-    std::atomic<uint8_t> mMotionLength;
+    TelemetryStreamer    mTelemetry;
+    TicklessIdle         mTicklessIdle;
+
+    uint8_t              mDisplayDecimation;
+    MotionStatistics     mStatistics;
 
     void MotionDataReceived(uint8_t length);
 
-    MotionSample CalculateMotionSample(const MotionSampleRaw &sampleRaw);
     void CalculatePixel(uint8_t *dest, const MotionSample &sample, bool invert = false);
 
+    void PublishToDisplay(const MotionSample* samples, uint8_t count);
+    void PublishToUsart(const MotionSampleRaw* samples, uint8_t count);
+
     void CallbackMotionDataReceived();
     void CallbackUpdateDisplay(const MotionSample &sample);
-    void CallbackSendSampleViaUsart(const MotionSampleRaw &sample);
+    void CallbackSendSamplesViaUsart(const MotionSampleRaw *samples, size_t count);
+    void CallbackSuppressTicksAndSleep(uint32_t expectedIdleTicks);
 };
 
 
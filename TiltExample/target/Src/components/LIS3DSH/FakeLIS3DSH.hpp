@@ -11,16 +11,17 @@
  *
  * \brief   FakeDriver for the LIS3DSH accelerometer.
  *
- * \details Need to call RetrieveAxesData manually, since no the accelerometer
- *          chip is simulated and does not generate a pin interrupt.
+ * \details Need to call RetrieveAxesData or AcquireAxesData manually, since
+ *          no the accelerometer chip is simulated and does not generate a
+ *          pin interrupt.
  *          Also fill in a size which is divisable by 6 for proper samples.
  *          When sawtooths are not used the data is returned as 0.
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/LIS3DSH
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    06-2021
+ * \version 1.2
+ * \date    10-2026
  */
 
 #ifndef FakeLIS3DSH_HPP_
@@ -31,10 +32,11 @@
 /************************************************************************/
 #include <cstdint>
 #include <cstring>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "drivers/Pin/Pin.hpp"
+#include "components/LIS3DSH/LIS3DSH.hpp"
 #if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
 #   include "utility/Sawtooth/Sawtooth.hpp"
 #endif
@@ -132,7 +134,9 @@ public:
         AntiAliasingFilter mAntiAliasingFilter;     ///< Anti-aliasing filter bandwidth.
     };
 
-    FakeLIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2) :
+    using AxesData = LIS3DSH::AxesData;
+
+    FakeLIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2, uint8_t* readBuffer, uint16_t readBufferSize) :
         mInitialized(false)
 #if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
         , mXaxisSawTooth(100,  8)  // 0..99 in  8 steps of 12
@@ -144,6 +148,8 @@ public:
         UNUSED(chipSelect);
         UNUSED(motionInt1);
         UNUSED(motionInt2);
+        UNUSED(readBuffer);
+        UNUSED(readBufferSize);
     }
     virtual ~FakeLIS3DSH() {}
 
@@ -154,12 +160,55 @@ public:
     bool Enable() { std::memset(mMotionArray, 0, sizeof(mMotionArray)); return mInitialized; }
     bool Disable() { return mInitialized; }
 
-    void SetHandler(const std::function<void(uint8_t length)>& handler) { UNUSED(handler); }
+    void SetHandler(const Delegate<void(uint8_t length)>& handler) { UNUSED(handler); }
     bool RetrieveAxesData(uint8_t* dest, uint8_t length)
     {
         if (dest == nullptr) { return false; }
         if (length == 0)     { return false; }
         if (length % 6 != 0) { return false; }
+        if (length > sizeof(mMotionArray)) { return false; }
+
+        Generate(length);
+        std::memcpy(dest, mMotionArray, length);
+
+        return true;
+    }
+
+    bool AcquireAxesData(AxesData& axesData)
+    {
+        if (mAcquired) { return false; }
+
+        Generate(sizeof(mMotionArray));
+        axesData.data   = mMotionArray;
+        axesData.length = sizeof(mMotionArray);
+        axesData.slot   = 0;
+        mAcquired = true;
+
+        return true;
+    }
+
+    bool ReleaseAxesData(const AxesData& axesData)
+    {
+        if (!mAcquired || (axesData.data != mMotionArray)) { return false; }
+
+        mAcquired = false;
+        return true;
+    }
+
+private:
+    bool mInitialized;
+    bool mAcquired = false;
+    uint8_t mMotionArray[150] = {};
+
+#if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
+    Sawtooth mXaxisSawTooth;
+    Sawtooth mYaxisSawTooth;
+    Sawtooth mZaxisSawTooth;
+#endif
+
+    void Generate(uint8_t length)
+    {
+        UNUSED(length);
 
 #if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
         uint32_t i = 0;
@@ -177,22 +226,7 @@ public:
             mMotionArray[i++] = static_cast<uint8_t>((Z & 0x00FF)     );
         }
 #endif
-        std::memcpy(dest, mMotionArray, length);
-
-        return true;
     }
-
-private:
-    bool mInitialized;
-    uint8_t mMotionArray[150] = {};
-
-    std::function<void(uint8_t length)> mHandler;
-
-#if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
-    Sawtooth mXaxisSawTooth;
-    Sawtooth mYaxisSawTooth;
-    Sawtooth mZaxisSawTooth;
-#endif
 };
 
 
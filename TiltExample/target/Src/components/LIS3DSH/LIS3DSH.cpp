@@ -13,8 +13,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/LIS3DSH
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2022
+ * \version 1.4
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -22,6 +22,8 @@
 /************************************************************************/
 #include "components/LIS3DSH/LIS3DSH.hpp"
 #include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include "utility/CycleProfiler/CycleProfiler.hpp"
 #include <algorithm>
 #include <cstring>
 
@@ -105,11 +107,19 @@ static constexpr uint8_t OUTS2       = 0x7F;
 static constexpr uint8_t IDENTIFIER       = 0x3F;
 static constexpr uint8_t READ_MASK        = 0x80;
 static constexpr uint8_t SAMPLE_LENGTH    = 0x06;                               // X,Y,Z * int16_t
-static constexpr uint8_t WATERMARK_LEVEL  = 0x19;                               // 25 samples X,Y,Z default - fifo size max = 32
-static constexpr uint8_t READ_BUFFER_SIZE = SAMPLE_LENGTH * WATERMARK_LEVEL;    // X,Y,Z * int16_t * 25 samples (in fifo)
+static constexpr uint8_t FIFO_SIZE        = 0x20;                               // 32 samples X,Y,Z
+static constexpr uint8_t READ_BUFFER_SIZE = SAMPLE_LENGTH * FIFO_SIZE;          // X,Y,Z * int16_t * 32 samples (full fifo)
 static constexpr uint8_t AXES_ENABLED     = 0x07;
 static constexpr uint8_t AXES_DISABLED    = 0x00;
+static constexpr uint8_t FIFO_SAMPLES     = 0x1F;
 static constexpr uint8_t FIFO_EMPTY       = 0x20;
+static constexpr uint8_t FIFO_OVERRUN     = 0x40;
+static constexpr uint8_t FIFO_WATERMARK   = 0x1F;
+static constexpr uint8_t NO_SLOT          = 0xFF;
+static constexpr uint8_t ADAPT_GROW_READS = 4;                                  // Reads within latency target before the watermark grows
+
+static_assert(READ_BUFFER_SIZE == LIS3DSH_READ_SLOT_SIZE, "Read buffer slot must hold a full fifo");
+static_assert(SAMPLE_LENGTH == LIS3DSH_SAMPLE_SIZE, "Read buffer slot must hold a sample");
 
 
 /************************************************************************/
@@ -122,23 +132,48 @@ static constexpr uint8_t FIFO_EMPTY       = 0x20;
  *                      within this class.
  * \param   motionInt1  Pin INT1, toggled by LIS3DSH.
  * \param   motionInt2  Pin INT2, toggled by LIS3DSH.
+ * \param   readBuffer      Memory for the read buffer slots, must remain
+ *                          valid for the lifetime of the class.
+ * \param   readBufferSize  Size of the read buffer in bytes, at least
+ *                          LIS3DSH_READ_BUFFER_SIZE() of the configuration
+ *                          passed to Init().
  */
-LIS3DSH::LIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2) :
+LIS3DSH::LIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2, uint8_t* readBuffer, uint16_t readBufferSize) :
     mSpi(spi),
     mChipSelect(chipSelect, Level::HIGH),
     mMotionInt1(motionInt1, PullUpDown::HIGHZ),
     mMotionInt2(motionInt2, PullUpDown::HIGHZ),
     mInitialized(false),
-    mReadBuffer(nullptr),
+    mReadBuffer(readBuffer),
+    mReadBufferSize(readBufferSize),
     mODR(0),
-    mUseHardwareFifo(false)
+    mUseHardwareFifo(false),
+    mReadAddress(OUT_X_L | READ_MASK),
+    mSlotSize(0),
+    mSlotCount(0),
+    mReadSlot(NO_SLOT),
+    mLastSlot(0),
+    mSequence(0),
+    mOverrunCount(0),
+    mFifoSource(0),
+    mFifoCommand{FIFO_CTRL, 0},
+    mReadLength(0),
+    mWatermark(0),
+    mMaxWatermark(0),
+    mAdaptive(false),
+    mWatermarkChanged(false),
+    mSlotWasFree(true),
+    mGoodReads(0),
+    mSampleFrequency(0)
 {
+    ResetSlots();
+
     mMotionInt1.Interrupt(Trigger::RISING, [this]() { this-> CallbackInt1(); }, false );
     mMotionInt2.Interrupt(Trigger::RISING, [this]() { this-> CallbackInt2(); }, false );
 }
 
 /**
- * \brief   Destructor, configures pins to HIGHZ, deletes read buffer.
+ * \brief   Destructor, configures pins to HIGHZ, releases the read buffer slots.
  */
 LIS3DSH::~LIS3DSH()
 {
@@ -186,7 +221,7 @@ bool LIS3DSH::IsInit() const
 
 /**
  * \brief   Puts the LIS3DSH module in sleep mode.
- * \details Configures pins to HIGHZ, deletes read buffer.
+ * \details Configures pins to HIGHZ, releases the read buffer slots.
  * \returns True if the LIS3DSH module could be put in sleep mode, else false.
  */
 bool LIS3DSH::Sleep()
@@ -205,11 +240,9 @@ bool LIS3DSH::Sleep()
 
     mInitialized = false;
 
-    if (mReadBuffer)
-    {
-        delete[] mReadBuffer;
-        mReadBuffer = nullptr;
-    }
+    mSlotSize  = 0;
+    mSlotCount = 0;
+    ResetSlots();
 
     return result;
 }
@@ -228,7 +261,7 @@ bool LIS3DSH::Enable()
             uint8_t val = 0;
             if ( ReadRegister(FIFO_CTRL, &val, 1) )
             {
-                val = val & 0x1F;       // Clear mode: sets it to 'bypass'
+                val = val & FIFO_WATERMARK;     // Clear mode: sets it to 'bypass'
                 uint8_t FMODE = GetFifoModeAsFMODE(FifoMode::Stream);
                 val = (val | FMODE);    // Now apply a mode again to start acquisition
 
@@ -262,7 +295,7 @@ bool LIS3DSH::Disable()
             uint8_t val = 0;
             if ( ReadRegister(FIFO_CTRL, &val, 1) )
             {
-                val = val & 0x1F;       // Clear mode: sets it to 'bypass'
+                val = val & FIFO_WATERMARK;     // Clear mode: sets it to 'bypass'
 
                 mMotionInt1.InterruptDisable();
                 mMotionInt2.InterruptDisable();
@@ -284,35 +317,160 @@ bool LIS3DSH::Disable()
  * \brief   Set handler to call when data is available.
  * \param   handler  Handler to call when data is available.
  */
-void LIS3DSH::SetHandler(const std::function<void(uint8_t length)>& handler)
+void LIS3DSH::SetHandler(const Delegate<void(uint8_t length)>& handler)
 {
     mHandler = handler;
 }
 
 /**
  * \brief   Retrieve axes data retrieved from LIS3DSH fifo.
+ * \details Copies the oldest unread data and releases its slot. If no
+ *          unread data is available the data of the last read is copied.
  * \param   dest    The buffer to copy the retrieved axes data into.
  * \param   length  The number of bytes to copy. This is intended to be the
  *                  number acquired when the data available handler is triggered.
  * \note    Asserts if dest is nullptr or length invalid.
+ * \note    Prefer AcquireAxesData(), which does not copy.
  */
 bool LIS3DSH::RetrieveAxesData(uint8_t* dest, uint8_t length)
 {
-    const uint8_t maxLength = (mUseHardwareFifo) ? READ_BUFFER_SIZE : SAMPLE_LENGTH;
-
     EXPECT(dest);
     EXPECT(length > 0);
-    EXPECT(length <= maxLength);
+    EXPECT(length <= mSlotSize);
+
+    if (dest == nullptr)        { return false; }
+    if (length == 0)            { return false; }
+    if (length > mSlotSize)     { return false; }
+    if (mSlotCount == 0)        { return false; }
+
+    AxesData axesData;
+    if (AcquireAxesData(axesData))
+    {
+        std::memcpy(dest, axesData.data, length);
+        return ReleaseAxesData(axesData);
+    }
+
+    std::memcpy(dest, &mReadBuffer[mLastSlot * mSlotSize], length);
+    return true;
+}
+
+/**
+ * \brief   Acquire the oldest unread axes data, without copying.
+ * \details The slot holding the data is not used for new reads until it is
+ *          released with ReleaseAxesData().
+ * \param   axesData    View on the axes data, filled in if data is available.
+ * \returns True if unread data is available, else false.
+ */
+bool LIS3DSH::AcquireAxesData(AxesData& axesData)
+{
+    const uint32_t prim = EnterCritical();
 
-    if (dest == nullptr)    { return false; }
-    if (length == 0)        { return false; }
-    if (length > maxLength) { return false; }
+    const uint8_t slot = FindOldestSlot(SlotState::Filled);
+    if (slot != NO_SLOT)
+    {
+        mSlotState[slot] = SlotState::Acquired;
+    }
+
+    ExitCritical(prim);
 
-    std::memcpy(dest, mReadBuffer, length);
+    if (slot == NO_SLOT) { return false; }
 
+    axesData.data   = &mReadBuffer[slot * mSlotSize];
+    axesData.length = mSlotLength[slot];
+    axesData.slot   = slot;
     return true;
 }
 
+/**
+ * \brief   Release axes data acquired with AcquireAxesData(), the slot can
+ *          be used for new reads again.
+ * \param   axesData    View on the axes data to release.
+ * \returns True if the axes data could be released, else false.
+ * \note    Asserts if the axes data was not acquired.
+ */
+bool LIS3DSH::ReleaseAxesData(const AxesData& axesData)
+{
+    EXPECT(axesData.slot < mSlotCount);
+
+    if (axesData.slot >= mSlotCount) { return false; }
+
+    const uint32_t prim = EnterCritical();
+
+    const bool acquired = (mSlotState[axesData.slot] == SlotState::Acquired);
+    if (acquired)
+    {
+        mSlotState[axesData.slot] = SlotState::Free;
+    }
+
+    ExitCritical(prim);
+
+    EXPECT(acquired);
+    return acquired;
+}
+
+/**
+ * \brief   Get the number of reads which could not be delivered, because
+ *          no read buffer slot was available or the previous read was
+ *          still ongoing.
+ * \returns The number of overruns since Init().
+ */
+uint32_t LIS3DSH::GetOverrunCount() const
+{
+    return mOverrunCount;
+}
+
+/**
+ * \brief   Set the fifo watermark: the number of samples in the fifo which
+ *          triggers a read.
+ * \details A lower watermark lowers the latency, a higher watermark lowers
+ *          the number of SPI transactions (and interrupts). With a latency
+ *          target configured this sets the upper limit of the adaptive
+ *          watermark instead.
+ * \param   watermark   The watermark in samples (1..31).
+ * \returns True if the watermark could be set, else false.
+ * \note    Only valid when the hardware fifo is used. Writes the register
+ *          blocking, call it from thread context.
+ */
+bool LIS3DSH::SetWatermark(uint8_t watermark)
+{
+    EXPECT(watermark > 0);
+    EXPECT(watermark <= FIFO_WATERMARK);
+
+    if (watermark == 0)              { return false; }
+    if (watermark > FIFO_WATERMARK)  { return false; }
+    if (!mInitialized)               { return false; }
+    if (!mUseHardwareFifo)           { return false; }
+
+    uint8_t val = 0;
+    if ( ! ReadRegister(FIFO_CTRL, &val, 1) ) { return false; }
+
+    const uint32_t prim = EnterCritical();
+    if (mAdaptive)
+    {
+        mMaxWatermark = watermark;
+        mWatermark    = std::min(mWatermark, watermark);
+    }
+    else
+    {
+        mWatermark    = watermark;
+    }
+    mWatermarkChanged = false;
+    mGoodReads        = 0;
+    ExitCritical(prim);
+
+    val = (val & ~FIFO_WATERMARK) | mWatermark;     // Keep the fifo mode
+    return WriteRegister(FIFO_CTRL, &val, 1);
+}
+
+/**
+ * \brief   Get the fifo watermark currently in use.
+ * \returns The watermark in samples, 0 if the hardware fifo is not used.
+ */
+uint8_t LIS3DSH::GetWatermark() const
+{
+    return (mUseHardwareFifo) ? mWatermark : 0;
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -359,11 +517,28 @@ bool LIS3DSH::Configure(const IConfig& config)
 {
     const Config& cfg = reinterpret_cast<const Config&>(config);
 
+    EXPECT(cfg.mReadSlots > 0);
+    EXPECT(cfg.mReadSlots <= LIS3DSH_MAX_READ_SLOTS);
+
+    EXPECT(cfg.mWatermark > 0);
+    EXPECT(cfg.mWatermark <= FIFO_WATERMARK);
+
+    if (cfg.mReadSlots == 0)                     { return false; }
+    if (cfg.mReadSlots > LIS3DSH_MAX_READ_SLOTS) { return false; }
+    if (cfg.mWatermark == 0)                     { return false; }
+    if (cfg.mWatermark > FIFO_WATERMARK)         { return false; }
+
     uint8_t ODR    = GetSampleFrequencyAsODR(cfg.mSampleFrequency);
     uint8_t FSCALE = GetScaleAsFSCALE(cfg.mScale);
     uint8_t BW     = GetAntiAliasingFilterAsBW(cfg.mAntiAliasingFilter);
 
-    mUseHardwareFifo = cfg.mUseHardwareFifo;
+    mUseHardwareFifo  = cfg.mUseHardwareFifo;
+    mSampleFrequency  = GetSampleFrequencyInMilliHz(cfg.mSampleFrequency);
+    mAdaptive         = mUseHardwareFifo && (cfg.mLatencyTarget > 0);
+    mMaxWatermark     = (mAdaptive) ? std::min(cfg.mWatermark, GetMaxWatermark(cfg.mLatencyTarget)) : cfg.mWatermark;
+    mWatermark        = mMaxWatermark;
+    mWatermarkChanged = false;
+    mGoodReads        = 0;
 
     const uint8_t BDU = (mUseHardwareFifo) ? 0 : 1;     // 0: disabled (default if fifo is used), 1: enabled
 
@@ -377,7 +552,7 @@ bool LIS3DSH::Configure(const IConfig& config)
 
     if (mUseHardwareFifo)
     {
-        result &= PrepareReadBuffer(READ_BUFFER_SIZE);
+        result &= PrepareReadBuffer(READ_BUFFER_SIZE, cfg.mReadSlots);
         EXPECT(result);
 
         src = 0x68;                                     // INT1 enabled, active high, pulsed
@@ -390,7 +565,7 @@ bool LIS3DSH::Configure(const IConfig& config)
     }
     else
     {
-        result &= PrepareReadBuffer(SAMPLE_LENGTH);     // X,Y,Z * int16_t
+        result &= PrepareReadBuffer(SAMPLE_LENGTH, cfg.mReadSlots);     // X,Y,Z * int16_t
         EXPECT(result);
 
         src = 0xE8;                                     // DR enabled (on INT1), active high, pulsed
@@ -399,8 +574,7 @@ bool LIS3DSH::Configure(const IConfig& config)
     }
 
     // Leave fifo in 'bypass' mode: setting another mode enables acquisition.
-    EXPECT(WATERMARK_LEVEL <= 32);                  // Fifo only 32 samples big
-    src = WATERMARK_LEVEL;                          // FIFO mode (disabled), watermark level (default 25 samples X,Y,Z)
+    src = mWatermark;                               // FIFO mode (disabled), watermark level (default 25 samples X,Y,Z)
     result &= WriteRegister(FIFO_CTRL, &src, 1);
     EXPECT(result);
 
@@ -408,26 +582,191 @@ bool LIS3DSH::Configure(const IConfig& config)
 }
 
 /**
- * \brief   Prepare the read buffer by claiming memory on the heap to store
- *          the read fifo data into.
- * \param   bufferSize  Read buffer size.
+ * \brief   Prepare the read buffer slots to store the read fifo data into.
+ * \param   slotSize    Size of a single read buffer slot.
+ * \param   slotCount   Number of read buffer slots.
  * \returns True if the read buffer could be prepared successfully, else false.
  */
-bool LIS3DSH::PrepareReadBuffer(uint8_t bufferSize)
+bool LIS3DSH::PrepareReadBuffer(uint8_t slotSize, uint8_t slotCount)
 {
-    // If we had claimed memory before: delete it
-    if (mReadBuffer != nullptr) { delete [] mReadBuffer; }
+    const uint16_t size = slotSize * slotCount;
+
+    EXPECT(slotSize <= LIS3DSH_READ_SLOT_SIZE);
+    EXPECT(slotCount <= LIS3DSH_MAX_READ_SLOTS);
+    EXPECT(mReadBuffer != nullptr);
+    EXPECT(size <= mReadBufferSize);
 
-    // Claim new segment in heap memory to retrieve sample data.
-    mReadBuffer = new(std::nothrow) uint8_t[bufferSize];
+    if (slotSize > LIS3DSH_READ_SLOT_SIZE)  { return false; }
+    if (slotCount > LIS3DSH_MAX_READ_SLOTS) { return false; }
+    if (mReadBuffer == nullptr)             { return false; }
+    if (size > mReadBufferSize)             { return false; }
+
+    mSlotSize  = slotSize;
+    mSlotCount = slotCount;
+    ResetSlots();
 
     // Clear buffer: fill with 0
-    if (mReadBuffer != nullptr)
+    std::fill_n(mReadBuffer, size, 0);
+    return true;
+}
+
+/**
+ * \brief   Mark all read buffer slots free, reset the overrun counter.
+ */
+void LIS3DSH::ResetSlots()
+{
+    for (uint8_t i = 0; i < LIS3DSH_MAX_READ_SLOTS; i++)
     {
-        std::fill_n(mReadBuffer, bufferSize, 0);
-        return true;
+        mSlotState[i]    = SlotState::Free;
+        mSlotLength[i]   = 0;
+        mSlotSequence[i] = 0;
     }
-    return false;
+
+    mReadSlot     = NO_SLOT;
+    mLastSlot     = 0;
+    mSequence     = 0;
+    mOverrunCount = 0;
+}
+
+/**
+ * \brief   ISR: find the slot to read the next data into.
+ * \details Uses a free slot, else the oldest unread slot is overwritten.
+ *          Both overwriting and not finding a slot count as overrun.
+ * \returns The slot to read into, NO_SLOT if none is available.
+ */
+uint8_t LIS3DSH::ClaimReadSlot()
+{
+    if (mReadSlot != NO_SLOT)               // Previous read still ongoing
+    {
+        mOverrunCount++;
+        return NO_SLOT;
+    }
+
+    uint8_t slot = FindOldestSlot(SlotState::Free);
+    if (slot == NO_SLOT)
+    {
+        slot = FindOldestSlot(SlotState::Filled);
+        mOverrunCount++;
+    }
+
+    if (slot != NO_SLOT)
+    {
+        mSlotState[slot] = SlotState::Reading;
+        mReadSlot        = slot;
+    }
+    return slot;
+}
+
+/**
+ * \brief   Find the slot in the given state which was filled the longest ago.
+ * \param   state   The state of the slot to find.
+ * \returns The slot found, NO_SLOT if no slot is in the given state.
+ */
+uint8_t LIS3DSH::FindOldestSlot(SlotState state) const
+{
+    uint8_t slot = NO_SLOT;
+
+    for (uint8_t i = 0; i < mSlotCount; i++)
+    {
+        if (mSlotState[i] != state) { continue; }
+
+        if ((slot == NO_SLOT) || (static_cast<int32_t>(mSlotSequence[i] - mSlotSequence[slot]) < 0))
+        {
+            slot = i;
+        }
+    }
+    return slot;
+}
+
+/**
+ * \brief   ISR: start the asynchronous read of a register into the slot
+ *          being read.
+ * \param   reg     The register to start reading from.
+ * \param   dest    Pointer to the buffer to store read data into.
+ * \param   length  Length of the data to read in bytes.
+ * \param   handler Handler to call when the read is done, with the result.
+ * \returns True if the read could be started, else false.
+ */
+bool LIS3DSH::StartRead(uint8_t reg, uint8_t* dest, uint8_t length, const Delegate<void(bool)>& handler)
+{
+    mReadAddress     = (reg | READ_MASK);
+    mReadSegments[0] = SPISegment::ChipSelectAssert(mChipSelect);
+    mReadSegments[1] = SPISegment::Write(&mReadAddress, 1);
+    mReadSegments[2] = SPISegment::Read(dest, length);
+    mReadSegments[3] = SPISegment::ChipSelectDeassert(mChipSelect);
+
+    return mSpi.Transfer(mReadSegments, 4, handler);
+}
+
+/**
+ * \brief   ISR: abort the read ongoing, frees the slot read into.
+ * \param   overrun     True if the abort loses data, counted as overrun.
+ */
+void LIS3DSH::AbortRead(bool overrun)
+{
+    if (mReadSlot != NO_SLOT)
+    {
+        mSlotState[mReadSlot] = SlotState::Free;
+        mReadSlot             = NO_SLOT;
+    }
+
+    if (overrun)
+    {
+        mOverrunCount++;
+    }
+}
+
+/**
+ * \brief   ISR: adapt the fifo watermark to the latency target.
+ * \details The latency target is missed if the fifo overran or held more
+ *          samples than the maximum watermark: the watermark is halved. If
+ *          no free slot was left for the read the consumer is too slow: more
+ *          interrupts would not help it, the watermark grows by one sample
+ *          (backpressure). After a number of reads within the latency target
+ *          the watermark grows by one sample as well. It never grows beyond
+ *          the maximum watermark. The new watermark is written after the
+ *          read.
+ * \param   nrSamples   The number of samples in the fifo.
+ * \param   fifoOverrun True if the fifo overran.
+ */
+void LIS3DSH::Adapt(uint8_t nrSamples, bool fifoOverrun)
+{
+    uint8_t watermark = mWatermark;
+
+    if (fifoOverrun || (nrSamples > mMaxWatermark))
+    {
+        watermark  = std::max<uint8_t>(watermark / 2, 1);
+        mGoodReads = 0;
+    }
+    else if (!mSlotWasFree)
+    {
+        watermark  = std::min<uint8_t>(watermark + 1, mMaxWatermark);
+        mGoodReads = 0;
+    }
+    else if (++mGoodReads >= ADAPT_GROW_READS)
+    {
+        watermark  = std::min<uint8_t>(watermark + 1, mMaxWatermark);
+        mGoodReads = 0;
+    }
+
+    if (watermark != mWatermark)
+    {
+        mWatermark        = watermark;
+        mWatermarkChanged = true;
+    }
+}
+
+/**
+ * \brief   Get the largest watermark which meets the latency target: the
+ *          number of samples acquired within the latency target.
+ * \param   latencyTarget   Latency target in ms.
+ * \returns The largest watermark (1..31).
+ */
+uint8_t LIS3DSH::GetMaxWatermark(uint16_t latencyTarget) const
+{
+    const uint32_t samples = (static_cast<uint32_t>(latencyTarget) * mSampleFrequency) / 1000000UL;     // ms * mHz
+
+    return static_cast<uint8_t>(std::min<uint32_t>(std::max<uint32_t>(samples, 1), FIFO_WATERMARK));
 }
 
 /**
@@ -494,6 +833,31 @@ uint8_t LIS3DSH::GetSampleFrequencyAsODR(SampleFrequency sampleFrequency)
     return odrValue;
 }
 
+/**
+ * \brief   Return the sample frequency in mHz.
+ * \param   sampleFrequency     Sample frequency for accelerometer data.
+ * \returns The sample frequency in mHz.
+ */
+uint32_t LIS3DSH::GetSampleFrequencyInMilliHz(SampleFrequency sampleFrequency)
+{
+    uint32_t frequency = 0;
+
+    switch (sampleFrequency)
+    {
+        case SampleFrequency::_3_125_Hz: frequency =    3125; break;
+        case SampleFrequency::_6_25_Hz:  frequency =    6250; break;
+        case SampleFrequency::_12_5_Hz:  frequency =   12500; break;
+        case SampleFrequency::_25_Hz:    frequency =   25000; break;
+        case SampleFrequency::_50_Hz:    frequency =   50000; break;
+        case SampleFrequency::_100_Hz:   frequency =  100000; break;
+        case SampleFrequency::_400_Hz:   frequency =  400000; break;
+        case SampleFrequency::_800_Hz:   frequency =  800000; break;
+        case SampleFrequency::_1600_Hz:  frequency = 1600000; break;
+    }
+
+    return frequency;
+}
+
 /**
  * \brief   Return the sample frequency as FSCALE setting in register, CTRL_REG5.
  * \param   scale   Scale of the accelerometer data.
@@ -557,24 +921,115 @@ uint8_t LIS3DSH::GetFifoModeAsFMODE(FifoMode fifoMode)
     return fmodeVal;
 }
 
+/**
+ * \brief   Handler for read fifo source done event.
+ * \details Starts reading exactly the number of samples in the fifo into
+ *          the slot claimed. An empty fifo releases the slot again, as does
+ *          a failed read (counted as overrun).
+ * \param   result  True if the fifo source register is read, else false.
+ */
+void LIS3DSH::FifoSourceRead(bool result)
+{
+    PROFILE_DRIVER_SCOPE("LIS3DSH FifoSourceRead");
+
+    const uint8_t slot = mReadSlot;
+    if (slot == NO_SLOT) { return; }
+
+    if (!result)
+    {
+        AbortRead(true);
+        return;
+    }
+
+    const bool fifoOverrun = (mFifoSource & FIFO_OVERRUN);
+    uint8_t nrSamples      = (mFifoSource & FIFO_SAMPLES);
+
+    if (fifoOverrun)
+    {
+        nrSamples = FIFO_SIZE;                      // FSS only counts to 31
+        mOverrunCount++;
+    }
+    else if (mFifoSource & FIFO_EMPTY)
+    {
+        nrSamples = 0;
+    }
+
+    if (nrSamples == 0)
+    {
+        AbortRead(false);                           // Nothing to read, nothing lost
+        return;
+    }
+
+    if (mAdaptive)
+    {
+        Adapt(nrSamples, fifoOverrun);
+    }
+
+    mReadLength = SAMPLE_LENGTH * nrSamples;
+
+    result = StartRead(OUT_X_L, &mReadBuffer[slot * mSlotSize], mReadLength, [this](bool result) { this->ReadAxesCompleted(result); } );
+    EXPECT(result);
+
+    if (!result)
+    {
+        AbortRead(true);
+    }
+}
+
 /**
  * \brief   Handler for read fifo done event.
- * \details Sets ChipSelect high, then calls handler for data available event.
+ * \details Marks the slot read into as filled, then calls handler for data
+ *          available event. ChipSelect is already released by the SPI
+ *          transaction. A changed (adaptive) watermark is written first.
+ *          A failed read releases the slot, counted as overrun.
+ * \param   result  True if the axes data is read, else false.
  */
-void LIS3DSH::ReadAxesCompleted()
+void LIS3DSH::ReadAxesCompleted(bool result)
 {
-    mChipSelect.Set(Level::HIGH);
+    const uint8_t slot = mReadSlot;
+    if (slot == NO_SLOT) { return; }
+
+    if (!result)
+    {
+        AbortRead(true);
+        return;
+    }
+
+    if (mWatermarkChanged)
+    {
+        WriteWatermark();
+    }
+
+    mSlotLength[slot]   = mReadLength;
+    mSlotSequence[slot] = ++mSequence;
+    mSlotState[slot]    = SlotState::Filled;
+    mLastSlot           = slot;
+    mReadSlot           = NO_SLOT;
 
     if (mHandler)
     {
-        if (mUseHardwareFifo)
-        {
-            mHandler(READ_BUFFER_SIZE);
-        }
-        else
-        {
-            mHandler(SAMPLE_LENGTH);
-        }
+        mHandler(mSlotLength[slot]);
+    }
+}
+
+/**
+ * \brief   ISR: write the (adapted) watermark to the fifo control register,
+ *          keeping the fifo in 'stream' mode.
+ * \details If the bus is not available, or the write fails, the write is
+ *          retried after the next read.
+ */
+void LIS3DSH::WriteWatermark()
+{
+    mFifoCommand[0]   = FIFO_CTRL;
+    mFifoCommand[1]   = GetFifoModeAsFMODE(FifoMode::Stream) | mWatermark;
+    mWriteSegments[0] = SPISegment::ChipSelectAssert(mChipSelect);
+    mWriteSegments[1] = SPISegment::Write(mFifoCommand, sizeof(mFifoCommand));
+    mWriteSegments[2] = SPISegment::ChipSelectDeassert(mChipSelect);
+
+    mWatermarkChanged = false;
+    if (!mSpi.Transfer(mWriteSegments, 3, [this](bool result) { if (!result) { this->mWatermarkChanged = true; } }))
+    {
+        mWatermarkChanged = true;
     }
 }
 
@@ -634,28 +1089,36 @@ bool LIS3DSH::ReadRegister(uint8_t reg, uint8_t* dest, uint16_t length)
 
 /**
  * \brief   INT1 pin interrupt handler.
- * \details Starts reading data from LIS3DSH fifo into read buffer asynchronously.
+ * \details Starts reading data from LIS3DSH into a free read buffer slot as
+ *          an asynchronous SPI transaction: ChipSelect, register address,
+ *          burst read and ChipSelect release are chained from the DMA
+ *          interrupts. With the hardware fifo the fifo source register is
+ *          read first, to read exactly the samples in the fifo.
  */
 void LIS3DSH::CallbackInt1()
 {
-    const uint8_t bufferSize = (mUseHardwareFifo) ? READ_BUFFER_SIZE : SAMPLE_LENGTH;
+    if (mSlotCount == 0) { return; }
+
+    mSlotWasFree = (FindOldestSlot(SlotState::Free) != NO_SLOT);
+
+    const uint8_t slot = ClaimReadSlot();
+    if (slot == NO_SLOT) { return; }
 
-    if ((mReadBuffer != nullptr) && (bufferSize > 0))
+    bool result = false;
+    if (mUseHardwareFifo)
+    {
+        result = StartRead(FIFO_SRC, &mFifoSource, 1, [this](bool result) { this->FifoSourceRead(result); } );
+    }
+    else
     {
-        uint8_t reg = (OUT_X_L | READ_MASK);
+        mReadLength = SAMPLE_LENGTH;
+        result = StartRead(OUT_X_L, &mReadBuffer[slot * mSlotSize], mReadLength, [this](bool result) { this->ReadAxesCompleted(result); } );
+    }
+    EXPECT(result);
 
-        mChipSelect.Set(Level::LOW);
-        bool result = mSpi.WriteBlocking(&reg, 1);
-        EXPECT(result);
-        if (result)
-        {
-            result &= mSpi.ReadDMA(mReadBuffer, bufferSize, [this]() { this->ReadAxesCompleted(); } );
-            EXPECT(result);
-        }
-        else
-        {
-            mChipSelect.Set(Level::HIGH);
-        }
+    if (!result)
+    {
+        AbortRead(true);
     }
 }
 
@@ -67,6 +67,10 @@ static const char versionString[] = "Tilt Example v0.1";
 // Configuration of the simulated sensor output data
 #define SIMULATED_SENSOR_OUTPUT_DATA    SAWTOOTH_SIGNAL
 
+// Configuration of the motion sample handoff: the display uses every n-th
+// sample (1 uses all), the Usart uses all samples
+#define MOTION_DISPLAY_DECIMATION       5
+
 
 #ifdef __cplusplus
 }
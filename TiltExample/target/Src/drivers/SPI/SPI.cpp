@@ -11,20 +11,23 @@
  *
  * \brief   SPI peripheral driver class - Master only.
  *
- * \note    The ChipSelect must be toggled outside this driver.
+ * \note    The ChipSelect must be toggled outside this driver, or by using
+ *          ChipSelect segments in a Transfer.
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/SPI
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.3
+ * \date    10-2026
  */
 
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
 #include "drivers/SPI/SPI.hpp"
+#include "drivers/Pin/Pin.hpp"
 #include "utility/Assert/Assert.h"
+#include "utility/CycleProfiler/CycleProfiler.hpp"
 #include "stm32f4xx_hal_spi.h"
 
 
@@ -63,6 +66,18 @@ static void CallbackTxRxDone(const SPICallbacks& spi_callbacks)
     }
 }
 
+/**
+ * \brief   Call the callbackError, if configured.
+ * \param   spi_callbacks   Structure containing the callbackError to call.
+ */
+static void CallbackError(const SPICallbacks& spi_callbacks)
+{
+    if (spi_callbacks.callbackError)
+    {
+        spi_callbacks.callbackError();
+    }
+}
+
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -74,11 +89,16 @@ static void CallbackTxRxDone(const SPICallbacks& spi_callbacks)
 SPI::SPI(const SPIInstance& instance) :
     mInstance(instance),
     mSPICallbacks( (instance == SPIInstance::SPI_1) ? (spi1_callbacks) : ( (instance == SPIInstance::SPI_2) ? (spi2_callbacks) : (spi3_callbacks) ) ),
-    mInitialized(false)
+    mInitialized(false),
+    mSegments(nullptr),
+    mSegmentCount(0),
+    mSegmentIndex(0),
+    mTransferBusy(false)
 {
     SetInstance(instance);
 
-    mSPICallbacks.callbackIRQ = [this]() { this->CallbackIRQ(); };
+    mSPICallbacks.callbackIRQ   = [this]() { this->CallbackIRQ(); };
+    mSPICallbacks.callbackError = [this]() { this->SegmentFailed(); };
 }
 
 /**
@@ -137,7 +157,8 @@ bool SPI::IsInit() const
 
 /**
  * \brief   Puts the SPI module in sleep mode.
- * \details Aborts ongoing transfers.
+ * \details Aborts ongoing transfers, the handler of an ongoing Transfer is
+ *          called with false.
  * \returns True if SPI module could be put in sleep mode, else false.
  */
 bool SPI::Sleep()
@@ -146,6 +167,7 @@ bool SPI::Sleep()
     HAL_SPI_Abort(&mHandle);
 
     mInitialized = false;
+    SegmentFailed();
 
     if (HAL_SPI_DeInit(&mHandle) == HAL_OK)
     {
@@ -186,6 +208,55 @@ DMA_HandleTypeDef*& SPI::GetDmaRxHandle()
     return mHandle.hdmarx;
 }
 
+/**
+ * \brief   Execute a list of segments as a single non-blocking transaction.
+ * \details Segments are executed back-to-back: ChipSelect segments are
+ *          handled directly, data segments are started with DMA and the next
+ *          segment is started from the DMA completion interrupt. The handler
+ *          is called when the last segment is done.
+ * \param   segments    Pointer to the list of segments to execute.
+ * \param   count       Number of segments in the list.
+ * \param   handler     Callback to call when the Transfer is done: with true
+ *                      if all segments are done, with false if a segment
+ *                      failed to start or the HAL reported an error.
+ * \returns True if the transaction could be started, else false. Returns
+ *          false if a previous transaction is still busy, a segment is
+ *          invalid, there is no data segment or no DMA is setup for the
+ *          data segments.
+ * \note    Asserts if segments is nullptr or count invalid.
+ * \note    The segments and their buffers must remain valid until the
+ *          handler is called. If a segment fails, the remaining
+ *          ChipSelectDeassert segments are still executed. When this returns
+ *          true the handler is called exactly once, when it returns false
+ *          it is not called. A Transfer holds at least one data segment, so
+ *          the handler is always called from the DMA interrupt, never from
+ *          within Transfer().
+ */
+bool SPI::Transfer(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler)
+{
+    EXPECT(segments);
+    EXPECT(count > 0);
+
+    if (segments == nullptr)                    { return false; }
+    if (count == 0)                             { return false; }
+    if (!mInitialized)                          { return false; }
+    if (mTransferBusy)                          { return false; }
+    if (!SPISegment::HasData(segments, count))  { return false; }
+
+    for (uint8_t i = 0; i < count; i++)
+    {
+        if (!IsValidSegment(segments[i])) { return false; }
+    }
+
+    mSegments        = segments;
+    mSegmentCount    = count;
+    mSegmentIndex    = 0;
+    mTransferHandler = handler;
+    mTransferBusy    = true;
+
+    return RunSegments();
+}
+
 /**
  * \brief   Write data using DMA.
  * \param   src         Pointer to buffer with data to write.
@@ -194,7 +265,7 @@ DMA_HandleTypeDef*& SPI::GetDmaRxHandle()
  * \returns True if the transaction could be started, else false. Returns false if no DMA is setup for Tx.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool SPI::WriteDMA(const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool SPI::WriteDMA(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -222,7 +293,7 @@ bool SPI::WriteDMA(const uint8_t* src, uint16_t length, const std::function<void
  * \note    Write and Read happen at the same time, hence both buffers are the
  *          same sime.
  */
-bool SPI::WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool SPI::WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(dest);
@@ -250,7 +321,7 @@ bool SPI::WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const
  *          if no DMA is setup for Rx.
  * \note    Asserts if dest is nullptr or length invalid.
  */
-bool SPI::ReadDMA(uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool SPI::ReadDMA(uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(dest);
     EXPECT(length > 0);
@@ -274,7 +345,7 @@ bool SPI::ReadDMA(uint8_t* dest, uint16_t length, const std::function<void()>& h
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool SPI::WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool SPI::WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -300,7 +371,7 @@ bool SPI::WriteInterrupt(const uint8_t* src, uint16_t length, const std::functio
  * \note    Write and Read happen at the same time, hence both buffers are the
  *          same sime.
  */
-bool SPI::WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool SPI::WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(dest);
@@ -325,7 +396,7 @@ bool SPI::WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length,
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if dest is nullptr or length invalid.
  */
-bool SPI::ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool SPI::ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(dest);
     EXPECT(length > 0);
@@ -564,6 +635,150 @@ void SPI::CallbackIRQ()
     HAL_SPI_IRQHandler(&mHandle);
 }
 
+/**
+ * \brief   Check if a Transfer segment can be executed.
+ * \param   segment     The segment to check.
+ * \returns True if the segment is valid, else false.
+ */
+bool SPI::IsValidSegment(const SPISegment& segment) const
+{
+    switch (segment.type)
+    {
+        case SPISegment::Type::Write:
+            return ((segment.src != nullptr) && (segment.length > 0) && (mHandle.hdmatx != nullptr));
+        case SPISegment::Type::Read:
+            return ((segment.dest != nullptr) && (segment.length > 0) && (mHandle.hdmarx != nullptr));
+        case SPISegment::Type::WriteRead:
+            return ((segment.src != nullptr) && (segment.dest != nullptr) && (segment.length > 0) &&
+                    (mHandle.hdmatx != nullptr) && (mHandle.hdmarx != nullptr));
+        case SPISegment::Type::ChipSelectAssert:
+        case SPISegment::Type::ChipSelectDeassert:
+            return (segment.chipSelect != nullptr);
+        default:
+            return false;
+    }
+}
+
+/**
+ * \brief   Execute the Transfer segments, starting at the current index.
+ * \details ChipSelect segments are handled directly. Returns when a data
+ *          segment is started, the Transfer continues in SegmentCompleted().
+ *          When no segments are left the Transfer handler is called. If a
+ *          data segment fails to start the Transfer is aborted, the caller
+ *          reports the failure.
+ * \returns True if the segments could be executed or started, else false.
+ */
+bool SPI::RunSegments()
+{
+    PROFILE_DRIVER_SCOPE("SPI RunSegments");
+
+    while (mSegmentIndex < mSegmentCount)
+    {
+        const SPISegment& segment = mSegments[mSegmentIndex];
+
+        switch (segment.type)
+        {
+            case SPISegment::Type::ChipSelectAssert:   segment.chipSelect->Set(Level::LOW);  break;
+            case SPISegment::Type::ChipSelectDeassert: segment.chipSelect->Set(Level::HIGH); break;
+            default:
+                if (StartSegment(segment))
+                {
+                    return true;        // Continued from DMA completion interrupt
+                }
+                AbortSegments();
+                return false;
+        }
+
+        mSegmentIndex++;
+    }
+
+    FinishTransfer(true);
+    return true;
+}
+
+/**
+ * \brief   Start the DMA transaction of a Transfer data segment.
+ * \param   segment     The data segment to start.
+ * \returns True if the DMA transaction could be started, else false.
+ */
+bool SPI::StartSegment(const SPISegment& segment)
+{
+    mSPICallbacks.callbackTxRx = [this]() { this->SegmentCompleted(); };
+
+    switch (segment.type)
+    {
+        case SPISegment::Type::Write:     return (HAL_SPI_Transmit_DMA(&mHandle, const_cast<uint8_t*>(segment.src), segment.length) == HAL_OK);
+        case SPISegment::Type::Read:      return (HAL_SPI_Receive_DMA(&mHandle, segment.dest, segment.length) == HAL_OK);
+        case SPISegment::Type::WriteRead: return (HAL_SPI_TransmitReceive_DMA(&mHandle, const_cast<uint8_t*>(segment.src), segment.dest, segment.length) == HAL_OK);
+        default: return false;
+    }
+}
+
+/**
+ * \brief   ISR: a Transfer data segment is done, continue with the next.
+ */
+void SPI::SegmentCompleted()
+{
+    PROFILE_DRIVER_SCOPE("SPI SegmentCompleted");
+
+    if (mTransferBusy)
+    {
+        mSegmentIndex++;
+
+        if (!RunSegments())
+        {
+            FinishTransfer(false);      // Already aborted, report it
+        }
+    }
+}
+
+/**
+ * \brief   ISR: the HAL reported an error (or the SPI is put to sleep),
+ *          abort the Transfer ongoing and report it.
+ */
+void SPI::SegmentFailed()
+{
+    if (mTransferBusy)
+    {
+        AbortSegments();
+        FinishTransfer(false);
+    }
+}
+
+/**
+ * \brief   Abort the Transfer. The remaining ChipSelectDeassert segments are
+ *          executed to release the bus.
+ */
+void SPI::AbortSegments()
+{
+    for (uint8_t i = mSegmentIndex; i < mSegmentCount; i++)
+    {
+        if (mSegments[i].type == SPISegment::Type::ChipSelectDeassert)
+        {
+            mSegments[i].chipSelect->Set(Level::HIGH);
+        }
+    }
+
+    mTransferBusy = false;
+}
+
+/**
+ * \brief   End the Transfer and call its handler with the result.
+ * \param   result  True if all segments are done, false if the Transfer
+ *                  failed.
+ */
+void SPI::FinishTransfer(bool result)
+{
+    mTransferBusy = false;
+
+    // Copy: the handler may start the next Transfer, replacing the stored one
+    const Delegate<void(bool)> handler = mTransferHandler;
+    if (handler)
+    {
+        handler(result);
+    }
+}
+
 
 /************************************************************************/
 /* Interrupts                                                           */
@@ -577,8 +792,6 @@ void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* handle)
 {
     ASSERT(handle);
 
-    // ToDo: check for error
-
     if (handle->Instance == SPI1) { CallbackTxRxDone(spi1_callbacks); }
     if (handle->Instance == SPI2) { CallbackTxRxDone(spi2_callbacks); }
     if (handle->Instance == SPI3) { CallbackTxRxDone(spi3_callbacks); }
@@ -593,13 +806,39 @@ void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* handle)
 {
     ASSERT(handle);
 
-    // ToDo: check for error
+    if (handle->Instance == SPI1) { CallbackTxRxDone(spi1_callbacks); }
+    if (handle->Instance == SPI2) { CallbackTxRxDone(spi2_callbacks); }
+    if (handle->Instance == SPI3) { CallbackTxRxDone(spi3_callbacks); }
+}
+
+/**
+ * \brief   ISR: handler to dispatch the SPI TX/RX completed interrupt into a
+ *          TX/RX callback.
+ * \param   handle  The SPI handle from which the TX/RX ISR came.
+ */
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* handle)
+{
+    ASSERT(handle);
 
     if (handle->Instance == SPI1) { CallbackTxRxDone(spi1_callbacks); }
     if (handle->Instance == SPI2) { CallbackTxRxDone(spi2_callbacks); }
     if (handle->Instance == SPI3) { CallbackTxRxDone(spi3_callbacks); }
 }
 
+/**
+ * \brief   ISR: handler to dispatch the SPI (or its DMA) error interrupt into
+ *          an error callback. The HAL has stopped the transfer.
+ * \param   handle  The SPI handle from which the error ISR came.
+ */
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    if (handle->Instance == SPI1) { CallbackError(spi1_callbacks); }
+    if (handle->Instance == SPI2) { CallbackError(spi2_callbacks); }
+    if (handle->Instance == SPI3) { CallbackError(spi3_callbacks); }
+}
+
 /**
  * \brief   ISR: route SPI1 interrupts to 'CallbackIRQ'.
  */
@@ -0,0 +1,38 @@
+/**
+ * \file    ICRC.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \brief   Generic interface for Crc peripheral.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/interfaces
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    06-2021
+ */
+
+#ifndef ICRC_HPP_
+#define ICRC_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class ICRC
+{
+public:
+    virtual uint32_t Calculate(uint32_t* buffer, uint32_t length) = 0;
+};
+
+
+#endif  // ICRC_HPP_
@@ -18,14 +18,24 @@
  *          Sending a length of 0 is permitted, but is to return false.
  *          When not initialized, all write/read calls are to return false.
  *
+ *          A Transfer executes a list of segments back-to-back, the next
+ *          segment is started from the completion interrupt of the previous
+ *          one. The segments (and their buffers) must remain valid until
+ *          the handler is called. Once a Transfer is accepted its handler
+ *          is always called, exactly once: with true when all segments are
+ *          done, with false when a segment failed to start or the bus
+ *          reported an error. A Transfer without data segments (only
+ *          ChipSelect) is to return false: the handler is never called
+ *          from within Transfer().
+ *
  *          Bus arbitration is not specified, but assumed to be implemented
  *          in low level drivers.
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/interfaces
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.2
+ * \date    10-2026
  */
 
 #ifndef ISPI_HPP_
@@ -35,7 +45,62 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
+
+
+/************************************************************************/
+/* Forward declarations                                                 */
+/************************************************************************/
+class Pin;
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  SPISegment
+ * \brief   Single step of a SPI Transfer: data or ChipSelect handling.
+ */
+struct SPISegment
+{
+    /**
+     * \enum    Type
+     * \brief   Available segment types.
+     */
+    enum class Type : uint8_t
+    {
+        Write,              ///< Write 'length' bytes from 'src'.
+        Read,               ///< Read 'length' bytes into 'dest'.
+        WriteRead,          ///< Write 'src' and read 'dest' at the same time.
+        ChipSelectAssert,   ///< Set 'chipSelect' low.
+        ChipSelectDeassert  ///< Set 'chipSelect' high.
+    };
+
+    Type           type;        ///< Type of the segment.
+    const uint8_t* src;         ///< Data to write, Write and WriteRead only.
+    uint8_t*       dest;        ///< Buffer to read into, Read and WriteRead only.
+    uint16_t       length;      ///< Number of bytes, data segments only.
+    Pin*           chipSelect;  ///< ChipSelect pin, ChipSelect segments only.
+
+    static SPISegment Write(const uint8_t* src, uint16_t length)                     { return { Type::Write,              src,     nullptr, length, nullptr     }; }
+    static SPISegment Read(uint8_t* dest, uint16_t length)                           { return { Type::Read,               nullptr, dest,    length, nullptr     }; }
+    static SPISegment WriteRead(const uint8_t* src, uint8_t* dest, uint16_t length)  { return { Type::WriteRead,          src,     dest,    length, nullptr     }; }
+    static SPISegment ChipSelectAssert(Pin& chipSelect)                              { return { Type::ChipSelectAssert,   nullptr, nullptr, 0,      &chipSelect }; }
+    static SPISegment ChipSelectDeassert(Pin& chipSelect)                            { return { Type::ChipSelectDeassert, nullptr, nullptr, 0,      &chipSelect }; }
+
+    /**
+     * \brief   Check if a list of segments holds a data segment, a Transfer
+     *          without is rejected.
+     */
+    static bool HasData(const SPISegment* segments, uint8_t count)
+    {
+        for (uint8_t i = 0; i < count; i++)
+        {
+            if ((segments[i].type == Type::Write) || (segments[i].type == Type::Read) || (segments[i].type == Type::WriteRead)) { return true; }
+        }
+        return false;
+    }
+};
 
 
 /************************************************************************/
@@ -44,13 +109,15 @@
 class ISPI
 {
 public:
-    virtual bool WriteDMA(const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadDMA(uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
+    virtual bool Transfer(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler) = 0;
+
+    virtual bool WriteDMA(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadDMA(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
 
-    virtual bool WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
+    virtual bool WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
 
     virtual bool WriteBlocking(const uint8_t* src, uint16_t length) = 0;
     virtual bool WriteReadBlocking(const uint8_t* src, uint8_t* dest, uint16_t length) = 0;
@@ -27,6 +27,7 @@
 #include "stm32f4xx_hal.h"
 #include "board/Board.hpp"
 #include "Application.hpp"
+#include "utility/StackPainting/stack_painting.h"
 
 
 /************************************************************************/
@@ -38,6 +39,8 @@
  */
 int main()
 {
+    paint_stack();          // First: the stack monitor scans the main stack for this paint
+
     Board::InitPins();
     Board::InitClock();     // ignore result?
 
@@ -45,7 +48,7 @@ int main()
     HAL_Init();
 
 
-    Application mApp;
+    static Application mApp;       // Not on the main stack: reused by interrupts once the scheduler runs
 
     if (!mApp.Init())
     {
@@ -0,0 +1,60 @@
+/**
+ * \file    Critical.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Short critical sections on PRIMASK, shared by the drivers and
+ *          utilities which hand data between a task and an ISR.
+ *
+ * \details The interrupt state is saved and restored, so a critical section
+ *          can be nested and entered from an ISR or with the interrupts
+ *          already disabled. All interrupts are masked: keep the sections to
+ *          a few instructions.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/Critical
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef CRITICAL_HPP_
+#define CRITICAL_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+/**
+ * \brief   Start of critical section, disables global interrupts.
+ * \returns The interrupt state before, to pass to 'ExitCritical'.
+ */
+static inline uint32_t EnterCritical()
+{
+    const uint32_t prim = __get_PRIMASK();
+    __disable_irq();
+    return prim;
+}
+
+/**
+ * \brief   End of critical section, restores global interrupts.
+ * \param   prim    The interrupt state returned by 'EnterCritical'.
+ */
+static inline void ExitCritical(uint32_t prim)
+{
+    if (!prim) { __enable_irq(); }
+}
+
+
+#endif  // CRITICAL_HPP_
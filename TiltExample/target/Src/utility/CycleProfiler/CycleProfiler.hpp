@@ -0,0 +1,179 @@
+/**
+ * \file    CycleProfiler.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   CycleProfiler
+ *
+ * \brief   Cycle accurate profiling of code zones, using the DWT cycle counter.
+ *
+ * \details Zones are registered once by name and get an id. The duration of a
+ *          zone is measured with a ProfileScope (RAII, for a block of code) or
+ *          with Enter() and Exit() (for instance at the start and end of an
+ *          ISR). Per zone the count, minimum, maximum, total and a histogram
+ *          of the durations are kept in a fixed size table: no allocation,
+ *          constant time per measurement.
+ *          The histogram has power of 2 bins: bin 0 counts durations below
+ *          PROFILER_HISTOGRAM_BASE cycles, bin n durations from
+ *          PROFILER_HISTOGRAM_BASE * 2^(n-1) up to twice that. The last bin
+ *          counts everything above.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/CycleProfiler
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.2
+ * \date    10-2026
+ */
+
+#ifndef CYCLE_PROFILER_HPP_
+#define CYCLE_PROFILER_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     PROFILER_MAX_ZONES
+ * \brief   Maximum number of zones which can be registered.
+ */
+#define PROFILER_MAX_ZONES          16
+
+/**
+ * \def     PROFILER_HISTOGRAM_BINS
+ * \brief   Number of histogram bins per zone.
+ */
+#define PROFILER_HISTOGRAM_BINS     12
+
+/**
+ * \def     PROFILER_HISTOGRAM_BASE
+ * \brief   Upper limit of the first histogram bin in cycles, must be a power
+ *          of 2.
+ */
+#define PROFILER_HISTOGRAM_BASE     32
+
+/**
+ * \def     PROFILER_INVALID_ZONE
+ * \brief   Zone id returned if a zone could not be registered, measurements
+ *          on it are ignored.
+ */
+#define PROFILER_INVALID_ZONE       0xFF
+
+/**
+ * \def     PROFILE_SCOPE
+ * \brief   Measure the remainder of the enclosing block as the given zone.
+ *          Compiles to nothing if PROFILER_DISABLED is defined.
+ */
+#ifdef PROFILER_DISABLED
+    #define PROFILE_SCOPE(zone)
+    #define PROFILE_ENTER(zone)
+    #define PROFILE_EXIT(zone)
+#else
+    #define PROFILE_CONCAT_(a, b)   a##b
+    #define PROFILE_CONCAT(a, b)    PROFILE_CONCAT_(a, b)
+    #define PROFILE_SCOPE(zone)     ProfileScope PROFILE_CONCAT(profileScope, __LINE__)(zone)
+    #define PROFILE_ENTER(zone)     CycleProfiler::Enter(zone)
+    #define PROFILE_EXIT(zone)      CycleProfiler::Exit(zone)
+#endif
+
+/**
+ * \def     PROFILE_DRIVER_SCOPE
+ * \brief   Measure the remainder of the enclosing block as the zone with the
+ *          given name, registered at its first use after Init(). For the
+ *          zones inside the drivers: only if PROFILE_DRIVERS is defined, else
+ *          compiles to nothing.
+ */
+#if defined(PROFILE_DRIVERS) && !defined(PROFILER_DISABLED)
+    #define PROFILE_DRIVER_SCOPE(name)  static ProfilerZoneCache PROFILE_CONCAT(profileZone, __LINE__) = { PROFILER_INVALID_ZONE, 0 }; \
+                                        PROFILE_SCOPE(CycleProfiler::Register(name, PROFILE_CONCAT(profileZone, __LINE__)))
+#else
+    #define PROFILE_DRIVER_SCOPE(name)
+#endif
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  ProfilerZoneStats
+ * \brief   Measured durations of a zone, in CPU cycles.
+ */
+struct ProfilerZoneStats
+{
+    const char* name  = nullptr;                        ///< Name of the zone
+    uint32_t    count = 0;                              ///< Number of measurements
+    uint32_t    min   = 0;                              ///< Shortest duration
+    uint32_t    max   = 0;                              ///< Longest duration
+    uint32_t    mean  = 0;                              ///< Average duration
+    uint64_t    total = 0;                              ///< Sum of the durations
+    uint32_t    histogram[PROFILER_HISTOGRAM_BINS] = {};   ///< Durations per bin, see CycleProfiler
+};
+
+/**
+ * \struct  ProfilerZoneCache
+ * \brief   Zone id of a name, kept by the caller: valid as long as the zones
+ *          are not removed by Init().
+ */
+struct ProfilerZoneCache
+{
+    uint8_t     zone;                                   ///< Id as returned by Register()
+    uint32_t    epoch;                                  ///< Init() the id belongs to, 0 for none
+};
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class CycleProfiler
+{
+public:
+    static bool Init();
+
+    static uint8_t Register(const char* name);
+    static uint8_t Register(const char* name, ProfilerZoneCache& cache);
+
+    /**
+     * \brief   Get the current cycle count.
+     * \returns The DWT cycle counter.
+     */
+    static inline uint32_t Now() { return DWT->CYCCNT; }
+
+    static void Enter(uint8_t zone);
+    static void Exit(uint8_t zone);
+    static void Record(uint8_t zone, uint32_t cycles);
+
+    static uint8_t GetZoneCount();
+    static bool GetStatistics(uint8_t zone, ProfilerZoneStats& stats);
+    static uint32_t GetOverhead();
+    static void Reset();
+};
+
+/**
+ * \class   ProfileScope
+ * \brief   Measures its own lifetime as a zone of the CycleProfiler.
+ */
+class ProfileScope
+{
+public:
+    explicit ProfileScope(uint8_t zone) : mZone(zone), mStart(CycleProfiler::Now()) {}
+    ~ProfileScope() { CycleProfiler::Record(mZone, CycleProfiler::Now() - mStart); }
+
+    ProfileScope(const ProfileScope&) = delete;
+    ProfileScope& operator=(const ProfileScope&) = delete;
+
+private:
+    uint8_t  mZone;
+    uint32_t mStart;
+};
+
+
+#endif  // CYCLE_PROFILER_HPP_
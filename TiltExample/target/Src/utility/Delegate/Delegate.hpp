@@ -0,0 +1,175 @@
+/**
+ * \file    Delegate.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   Delegate
+ *
+ * \brief   Fixed-size, non-allocating, type-erased callback.
+ *
+ * \details Intended as replacement of std::function for callbacks which are
+ *          stored in the static callback tables of the drivers and called
+ *          from ISR context. The callable is copied into an internal buffer
+ *          of 'StorageSize' bytes, a callable which does not fit is rejected
+ *          at compile time. Since only trivially copyable callables are
+ *          accepted (function pointers, lambdas capturing 'this' or a few
+ *          pointers/values), copying a Delegate is a plain copy of the buffer
+ *          and the invoker pointer: no heap, no virtual call, no destructor.
+ *
+ * \note    Mutable lambdas are not supported, the callable is invoked as const.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/Delegate
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+#ifndef DELEGATE_HPP_
+#define DELEGATE_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstddef>
+#include <new>
+#include <type_traits>
+#include <utility>
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+/**
+ * \brief   Default storage size of a Delegate: enough for a lambda capturing
+ *          'this' and one additional pointer or value.
+ */
+static constexpr size_t DELEGATE_DEFAULT_STORAGE_SIZE = 2 * sizeof(void*);
+
+
+/************************************************************************/
+/* Template Class                                                       */
+/************************************************************************/
+template <typename Signature, size_t StorageSize = DELEGATE_DEFAULT_STORAGE_SIZE>
+class Delegate;
+
+template <typename Result, typename... Args, size_t StorageSize>
+class Delegate<Result(Args...), StorageSize>
+{
+public:
+    /**
+     * \brief   Constructor, creates an empty Delegate.
+     */
+    Delegate() : mInvoker(nullptr) {}
+
+    /**
+     * \brief   Constructor, creates an empty Delegate.
+     * \note    Allows 'callback = nullptr' as used with std::function.
+     */
+    Delegate(std::nullptr_t) : mInvoker(nullptr) {}
+
+    /**
+     * \brief   Constructor, stores a copy of the given callable.
+     * \param   callable    Function pointer or lambda to store.
+     * \note    Fails to compile if the callable is too large for the storage
+     *          or is not trivially copyable.
+     */
+    template <typename Callable,
+              typename = typename std::enable_if<!std::is_same<typename std::decay<Callable>::type, Delegate>::value>::type>
+    Delegate(Callable callable)
+    {
+        static_assert(sizeof(Callable) <= StorageSize, "Callable too large for Delegate storage, increase StorageSize");
+        static_assert(alignof(Callable) <= alignof(Storage), "Callable alignment not supported by Delegate storage");
+        static_assert(std::is_trivially_copyable<Callable>::value, "Delegate only accepts trivially copyable callables");
+
+        new (&mStorage) Callable(callable);
+        mInvoker = &InvokeCallable<Callable>;
+    }
+
+    /**
+     * \brief   Create a Delegate calling a member method on an object.
+     * \details The method is bound at compile time, only the object pointer
+     *          is stored: Delegate::Create<Application, &Application::Done>(this).
+     * \param   object  The object to call the method on.
+     * \returns The Delegate bound to object and method.
+     */
+    template <typename Object, Result (Object::*Method)(Args...)>
+    static Delegate Create(Object* object)
+    {
+        Delegate delegate;
+        new (&delegate.mStorage) Object*(object);
+        delegate.mInvoker = &InvokeMethod<Object, Method>;
+        return delegate;
+    }
+
+    /**
+     * \brief   Create a Delegate calling a const member method on an object.
+     * \details As Create() above, for const methods and const objects:
+     *          Delegate::Create<Sensor, &Sensor::IsReady>(this).
+     * \param   object  The object to call the method on.
+     * \returns The Delegate bound to object and method.
+     */
+    template <typename Object, Result (Object::*Method)(Args...) const>
+    static Delegate Create(const Object* object)
+    {
+        Delegate delegate;
+        new (&delegate.mStorage) const Object*(object);
+        delegate.mInvoker = &InvokeConstMethod<Object, Method>;
+        return delegate;
+    }
+
+    /**
+     * \brief   Call the stored callable.
+     * \note    Calling an empty Delegate is not allowed, check before use.
+     */
+    Result operator()(Args... args) const
+    {
+        return mInvoker(&mStorage, std::forward<Args>(args)...);
+    }
+
+    /**
+     * \brief   Indicate if a callable is stored.
+     * \returns True if a callable is stored, else false.
+     */
+    explicit operator bool() const
+    {
+        return (mInvoker != nullptr);
+    }
+
+    bool operator== (std::nullptr_t) const { return (mInvoker == nullptr); }
+    bool operator!= (std::nullptr_t) const { return (mInvoker != nullptr); }
+
+private:
+    using Storage = typename std::aligned_storage<StorageSize, alignof(void*)>::type;
+    using Invoker = Result (*)(const void* storage, Args... args);
+
+    Storage mStorage;
+    Invoker mInvoker;
+
+    template <typename Callable>
+    static Result InvokeCallable(const void* storage, Args... args)
+    {
+        return (*static_cast<const Callable*>(storage))(std::forward<Args>(args)...);
+    }
+
+    template <typename Object, Result (Object::*Method)(Args...)>
+    static Result InvokeMethod(const void* storage, Args... args)
+    {
+        Object* object = *static_cast<Object* const*>(storage);
+        return (object->*Method)(std::forward<Args>(args)...);
+    }
+
+    template <typename Object, Result (Object::*Method)(Args...) const>
+    static Result InvokeConstMethod(const void* storage, Args... args)
+    {
+        const Object* object = *static_cast<const Object* const*>(storage);
+        return (object->*Method)(std::forward<Args>(args)...);
+    }
+};
+
+
+#endif  // DELEGATE_HPP_
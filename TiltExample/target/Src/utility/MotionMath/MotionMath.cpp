@@ -0,0 +1,113 @@
+/**
+ * \file    MotionMath.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Fixed-point (Q15) motion math: pitch and roll for a batch of
+ *          accelerometer samples.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/TiltExample/target/Src/utility/MotionMath
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/MotionMath/MotionMath.hpp"
+#include "utility/Assert/Assert.h"
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+static constexpr int32_t ONE         = 0x8000;          // 1.0 in Q15, 180 degrees for angles
+static constexpr int32_t ANGLE_90    = ONE / 2;
+static constexpr int32_t ANGLE_180   = ONE;
+static constexpr int32_t ANGLE_MAX   = ONE - 1;
+
+// atan(r) / pi = r/4 + r(1 - r)(C0 + C1 * r), for r in [0..1], error < 0.09 degrees
+static constexpr int32_t C0          = 2559;            // 0.0781 in Q15
+static constexpr int32_t C1          = 690;             // 0.0211 in Q15
+
+
+/************************************************************************/
+/* Static Functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Arc tangent of the first octant.
+ * \param   r   The ratio in Q15, [0..1].
+ * \returns The angle in Q15 of 180 degrees, [0..45] degrees.
+ */
+static inline int32_t AtanOctant(int32_t r)
+{
+    const int32_t t = (r * (ONE - r)) >> 15;
+    const int32_t c = C0 + ((C1 * r) >> 15);
+
+    return (r >> 2) + ((t * c) >> 15);
+}
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+namespace MotionMath
+{
+    /**
+     * \brief   Arc tangent of y/x, using the signs to determine the quadrant.
+     * \param   y   The y coordinate.
+     * \param   x   The x coordinate.
+     * \returns The angle in Q15 of 180 degrees. Returns 0 for (0, 0), 180
+     *          degrees is returned as the largest positive angle.
+     */
+    int16_t Atan2(int16_t y, int16_t x)
+    {
+        const int32_t ax = (x < 0) ? -x : x;
+        const int32_t ay = (y < 0) ? -y : y;
+
+        if ((ax | ay) == 0) { return 0; }
+
+        // Reduce to the first octant: the ratio is in [0..1]
+        int32_t angle = (ay <= ax) ? AtanOctant((ay << 15) / ax)
+                                   : ANGLE_90 - AtanOctant((ax << 15) / ay);
+
+        if (x < 0) { angle = ANGLE_180 - angle; }
+        if (angle > ANGLE_MAX) { angle = ANGLE_MAX; }
+        if (y < 0) { angle = -angle; }
+
+        return static_cast<int16_t>(angle);
+    }
+
+    /**
+     * \brief   Calculate pitch and roll for a batch of samples.
+     * \param   src     The raw samples, for instance a FIFO burst.
+     * \param   dest    The destination, at least 'count' samples.
+     * \param   count   The number of samples to convert.
+     */
+    void CalculateMotionSamples(const MotionSampleRaw* src, MotionSample* dest, size_t count)
+    {
+        EXPECT(src);
+        EXPECT(dest);
+
+        if (src == nullptr)  { return; }
+        if (dest == nullptr) { return; }
+
+        for (size_t i = 0; i < count; i++)
+        {
+            const MotionSampleRaw raw = src[i];
+
+            dest[i].X     = raw.X;
+            dest[i].Y     = raw.Y;
+            dest[i].Z     = raw.Z;
+            dest[i].pitch = Atan2(raw.Y, raw.Z);
+            dest[i].roll  = Atan2(raw.X, raw.Z);
+        }
+    }
+}
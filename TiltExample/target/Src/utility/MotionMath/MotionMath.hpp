@@ -0,0 +1,112 @@
+/**
+ * \file    MotionMath.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Fixed-point (Q15) motion math: pitch and roll for a batch of
+ *          accelerometer samples.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/TiltExample/target/Src/utility/MotionMath
+ *
+ * \details The axes are kept as read from the LIS3DSH: a 16-bit signed value
+ *          is a Q15 fraction of the full scale (+/-2 G), no conversion needed.
+ *          Angles are Q15 fractions of 180 degrees: 0x4000 is 90 degrees,
+ *          -0x8000 is -180 degrees. One LSB is 0.0055 degrees.
+ *
+ *          The angle is calculated with an integer atan2 approximation: octant
+ *          reduction, one division and a second order polynomial. The maximum
+ *          error is below 0.1 degree (see MOTION_MATH_MAX_ERROR). No FPU, no
+ *          libm: per angle a single SDIV and a handful of MUL/MLA, single
+ *          cycle instructions on the Cortex-M4. Both angles share the Z axis.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef MOTION_MATH_HPP_
+#define MOTION_MATH_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include <cstddef>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     MOTION_MATH_MAX_ERROR
+ * \brief   Maximum error of the calculated angles, in degrees.
+ */
+#define MOTION_MATH_MAX_ERROR       0.1
+
+
+/************************************************************************/
+/* Structs                                                              */
+/************************************************************************/
+/**
+ * \struct  MotionSampleRaw
+ * \brief   Raw motion sensor values.
+ */
+struct MotionSampleRaw
+{
+    int16_t X;  ///< Raw sensor X value
+    int16_t Y;  ///< Raw sensor Y value
+    int16_t Z;  ///< Raw sensor Z value
+};
+
+/**
+ * \struct  MotionSample
+ * \brief   Motion sensor values in Q15 of the full scale (+/-2 G), pitch and
+ *          roll in Q15 of 180 degrees.
+ */
+struct MotionSample
+{
+    int16_t X;      ///< Sensor value X in Q15 of the full scale
+    int16_t Y;      ///< Sensor value Y in Q15 of the full scale
+    int16_t Z;      ///< Sensor value Z in Q15 of the full scale
+    int16_t pitch;  ///< Sensor pitch value in Q15 of 180 degrees
+    int16_t roll;   ///< Sensor roll value in Q15 of 180 degrees
+};
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+namespace MotionMath
+{
+    /**
+     * \brief   Convert degrees to an angle in Q15 of 180 degrees.
+     * \param   degrees     The angle in degrees, [-180..180).
+     * \returns The angle in Q15 of 180 degrees.
+     */
+    constexpr int16_t DegreesToAngle(int16_t degrees)
+    {
+        return static_cast<int16_t>((static_cast<int32_t>(degrees) * 0x8000) / 180);
+    }
+
+    /**
+     * \brief   Convert an angle in Q15 of 180 degrees to degrees.
+     * \param   angle   The angle in Q15 of 180 degrees.
+     * \returns The angle in degrees.
+     */
+    constexpr float AngleToDegrees(int16_t angle)
+    {
+        return angle * (180.0f / 0x8000);
+    }
+
+    int16_t Atan2(int16_t y, int16_t x);
+
+    void CalculateMotionSamples(const MotionSampleRaw* src, MotionSample* dest, size_t count);
+}
+
+
+#endif  // MOTION_MATH_HPP_
@@ -0,0 +1,138 @@
+/**
+ * \file    PoolAllocatorHooks.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   The PoolAllocator as FreeRTOS heap and as allocator of C++ new.
+ *
+ * \details Replaces heap_4.c: do not link another FreeRTOS heap. With
+ *          configUSE_MALLOC_FAILED_HOOK vApplicationMallocFailedHook() is
+ *          called on a failed pvPortMalloc(), as with heap_4.c. The failure
+ *          hook of the PoolAllocator is called for all failed allocations.
+ *          Exceptions are disabled: a failed plain C++ new cannot return
+ *          nullptr, it asserts and aborts. Only the nothrow variants return
+ *          nullptr.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/PoolAllocator
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdlib>
+#include <new>
+#include "utility/PoolAllocator/PoolAllocator.hpp"
+#include "utility/Assert/Assert.h"
+#include "FreeRTOS.h"
+
+
+/************************************************************************/
+/* FreeRTOS heap                                                        */
+/************************************************************************/
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+extern "C" void vApplicationMallocFailedHook(void);
+#endif
+
+extern "C" void* pvPortMalloc(size_t xWantedSize)
+{
+    void* block = PoolAllocator::Allocate(xWantedSize);
+
+#if (configUSE_MALLOC_FAILED_HOOK == 1)
+    if (block == nullptr) { vApplicationMallocFailedHook(); }
+#endif
+
+    return block;
+}
+
+extern "C" void vPortFree(void* pv)
+{
+    PoolAllocator::Free(pv);
+}
+
+extern "C" size_t xPortGetFreeHeapSize(void)
+{
+    return PoolAllocator::GetFreeBytes();
+}
+
+extern "C" size_t xPortGetMinimumEverFreeHeapSize(void)
+{
+    return PoolAllocator::GetMinimumEverFreeBytes();
+}
+
+extern "C" void vPortInitialiseBlocks(void)
+{
+    // Blocks are set up by PoolAllocator::Init()
+}
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Allocate for a plain C++ new, which may not return nullptr.
+ * \param   size    The number of bytes requested.
+ * \returns Pointer to the block, does not return if the pools are exhausted.
+ * \note    The failure hook is called by the PoolAllocator before the assert.
+ */
+static void* AllocateOrAbort(size_t size)
+{
+    void* block = PoolAllocator::Allocate((size > 0) ? size : 1);
+
+    ASSERT(block != nullptr);
+    if (block == nullptr) { std::abort(); }     // ASSERT may be configured to ignore
+
+    return block;
+}
+
+
+/************************************************************************/
+/* C++ new and delete                                                   */
+/************************************************************************/
+void* operator new(size_t size)
+{
+    return AllocateOrAbort(size);
+}
+
+void* operator new[](size_t size)
+{
+    return AllocateOrAbort(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept
+{
+    return PoolAllocator::Allocate((size > 0) ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept
+{
+    return PoolAllocator::Allocate((size > 0) ? size : 1);
+}
+
+void operator delete(void* block) noexcept
+{
+    PoolAllocator::Free(block);
+}
+
+void operator delete[](void* block) noexcept
+{
+    PoolAllocator::Free(block);
+}
+
+void operator delete(void* block, size_t) noexcept
+{
+    PoolAllocator::Free(block);
+}
+
+void operator delete[](void* block, size_t) noexcept
+{
+    PoolAllocator::Free(block);
+}
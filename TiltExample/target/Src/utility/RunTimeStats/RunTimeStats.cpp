@@ -0,0 +1,489 @@
+/**
+ * \file    RunTimeStats.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   RunTimeStats
+ *
+ * \brief   Per task and per ISR CPU load, measured with the DWT cycle counter.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/RunTimeStats
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  Entry
+ * \brief   Administration of a task or ISR in the running period.
+ */
+struct Entry
+{
+    const void* handle;     ///< Task handle, nullptr for an ISR
+    const char* name;
+    RunTimeKind kind;
+    uint32_t    start;      ///< Cycle count at IsrEnter()
+    uint32_t    cycles;
+    uint32_t    count;
+};
+
+/**
+ * \struct  Result
+ * \brief   Measurements of a task or ISR over the last completed period.
+ */
+struct Result
+{
+    uint32_t    cycles;
+    uint32_t    count;
+};
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static Entry    entries[RUNTIME_STATS_MAX_ENTRIES] = {};
+static Result   results[RUNTIME_STATS_MAX_ENTRIES] = {};
+static uint8_t  entryCount   = 0;
+
+static uint8_t  current      = RUNTIME_STATS_INVALID;   // Running task
+static uint32_t sliceStart   = 0;                       // Cycle count at switch in of the running task
+static uint32_t isrInSlice   = 0;                       // Cycles spent in ISRs since the switch in
+static uint8_t  isrDepth     = 0;                       // Nesting level of the ISRs
+static uint32_t isrStart     = 0;                       // Cycle count at entry of the outermost ISR
+
+static uint32_t period       = 0;
+static uint32_t periodStart  = 0;
+static uint32_t switches     = 0;
+
+static uint8_t  resultCount    = 0;
+static uint32_t resultPeriod   = 0;
+static uint32_t resultSwitches = 0;
+static volatile bool updated   = false;
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+static inline uint32_t Now()
+{
+    return DWT->CYCCNT;
+}
+
+static inline uint16_t ToPermille(uint32_t cycles, uint32_t total)
+{
+    return (total > 0) ? static_cast<uint16_t>((static_cast<uint64_t>(cycles) * 1000) / total) : 0;
+}
+
+static inline void Put16(uint8_t*& dest, uint16_t value)
+{
+    *dest++ = static_cast<uint8_t>(value);
+    *dest++ = static_cast<uint8_t>(value >> 8);
+}
+
+static inline void Put32(uint8_t*& dest, uint32_t value)
+{
+    Put16(dest, static_cast<uint16_t>(value));
+    Put16(dest, static_cast<uint16_t>(value >> 16));
+}
+
+/**
+ * \brief   Get the cycles spent in the idle task in the last period.
+ * \returns The idle cycles.
+ * \note    Must be called with the interrupts disabled.
+ */
+static uint32_t IdleCycles()
+{
+    uint32_t idle = 0;
+
+    for (uint8_t i = 0; i < resultCount; i++)
+    {
+        if (entries[i].kind == RunTimeKind::Idle) { idle += results[i].cycles; }
+    }
+    return idle;
+}
+
+/**
+ * \brief   Add an entry.
+ * \param   handle  The task handle, nullptr for an ISR.
+ * \param   name    The name of the task or ISR.
+ * \param   kind    Task or ISR.
+ * \returns The id of the entry, RUNTIME_STATS_INVALID if full.
+ * \note    Must be called with the interrupts disabled.
+ */
+static uint8_t AddEntry(const void* handle, const char* name, RunTimeKind kind)
+{
+    if (entryCount >= RUNTIME_STATS_MAX_ENTRIES) { return RUNTIME_STATS_INVALID; }
+
+    Entry& entry = entries[entryCount];
+    entry.handle = handle;
+    entry.name   = name;
+    entry.kind   = kind;
+    entry.start  = 0;
+    entry.cycles = 0;
+    entry.count  = 0;
+    results[entryCount] = {};
+
+    return entryCount++;
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Enable the DWT cycle counter and remove all entries.
+ * \param   periodCycles    The length of a period in cycles, for instance
+ *                          SystemCoreClock for 1 second. Must be less than
+ *                          2^31.
+ * \returns True if the cycle counter is enabled and the period is valid,
+ *          else false.
+ * \note    Call before the scheduler is started.
+ */
+bool RunTimeStats::Init(uint32_t periodCycles)
+{
+    EXPECT(periodCycles > 0);
+    EXPECT(periodCycles < 0x80000000);
+    if ((periodCycles == 0) || (periodCycles >= 0x80000000)) { return false; }
+
+    RunTimeStats_ConfigureCounter();
+
+    const uint32_t prim = EnterCritical();
+    entryCount     = 0;
+    current        = RUNTIME_STATS_INVALID;
+    sliceStart     = Now();
+    isrInSlice     = 0;
+    isrDepth       = 0;
+    period         = periodCycles;
+    periodStart    = sliceStart;
+    switches       = 0;
+    resultCount    = 0;
+    resultPeriod   = 0;
+    resultSwitches = 0;
+    updated        = false;
+    ExitCritical(prim);
+
+    return ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0);
+}
+
+/**
+ * \brief   Register an ISR to measure.
+ * \param   name    The name of the ISR, must remain valid (string literal).
+ * \returns The id to use with IsrEnter() and IsrExit(), RUNTIME_STATS_INVALID
+ *          if no more entries are available.
+ * \note    Tasks are registered automatically at their first switch in.
+ */
+uint8_t RunTimeStats::RegisterIsr(const char* name)
+{
+    const uint32_t prim = EnterCritical();
+    const uint8_t id = AddEntry(nullptr, name, RunTimeKind::Isr);
+    ExitCritical(prim);
+
+    EXPECT(id != RUNTIME_STATS_INVALID);
+    return id;
+}
+
+/**
+ * \brief   Mark the start of an ISR, call as first statement of the handler.
+ * \param   id      The id as returned by RegisterIsr().
+ */
+void RunTimeStats::IsrEnter(uint8_t id)
+{
+    if (id >= entryCount) { return; }
+
+    const uint32_t now = Now();
+    entries[id].start = now;
+
+    // A nested ISR is restored before the outer one continues: no lock needed
+    if (isrDepth++ == 0) { isrStart = now; }
+}
+
+/**
+ * \brief   Mark the end of an ISR, call as last statement of the handler.
+ * \details The time of the outermost ISR is not charged to the interrupted
+ *          task. The time of a nested ISR is included in the ISR it
+ *          interrupted.
+ * \param   id      The id as returned by RegisterIsr().
+ */
+void RunTimeStats::IsrExit(uint8_t id)
+{
+    if ((id >= entryCount) || (isrDepth == 0)) { return; }
+
+    const uint32_t now = Now();
+    entries[id].cycles += now - entries[id].start;
+    entries[id].count++;
+
+    if (--isrDepth == 0) { isrInSlice += now - isrStart; }
+}
+
+/**
+ * \brief   A task is switched in, called from the FreeRTOS trace hook.
+ * \param   handle  The handle of the task.
+ * \param   name    The name of the task.
+ * \note    Finds the task with a linear search, adds it if it is new.
+ */
+void RunTimeStats::TaskSwitchedIn(const void* handle, const char* name)
+{
+    const uint32_t now = Now();
+
+    uint8_t id = RUNTIME_STATS_INVALID;
+    for (uint8_t i = 0; i < entryCount; i++)
+    {
+        if (entries[i].handle == handle) { id = i; break; }
+    }
+
+    if (id == RUNTIME_STATS_INVALID) { id = AddEntry(handle, name, RunTimeKind::Task); }
+    if (id != RUNTIME_STATS_INVALID) { entries[id].count++; }
+
+    current    = id;
+    sliceStart = now;
+    isrInSlice = 0;
+    switches++;
+}
+
+/**
+ * \brief   The running task is switched out, called from the FreeRTOS trace
+ *          hook. Charges the time since the switch in, minus the time spent
+ *          in ISRs, to the task.
+ */
+void RunTimeStats::TaskSwitchedOut()
+{
+    if (current != RUNTIME_STATS_INVALID)
+    {
+        entries[current].cycles += Now() - sliceStart - isrInSlice;
+    }
+    current = RUNTIME_STATS_INVALID;
+}
+
+/**
+ * \brief   To be called from vApplicationIdleHook(): marks the running task
+ *          as the idle task and closes the period when it has elapsed.
+ */
+void RunTimeStats::IdleHook()
+{
+    if (current != RUNTIME_STATS_INVALID) { entries[current].kind = RunTimeKind::Idle; }
+
+    Update();
+}
+
+/**
+ * \brief   Add the cycles the core slept, called by TicklessIdle when woken:
+ *          the cycle counter does not count while sleeping.
+ * \details The sleep is charged to the running task, the idle task, and
+ *          lengthens the period: the next Update() closes a period of the
+ *          actual duration.
+ * \param   cycles  The slept cycles, in core clock cycles.
+ * \note    A sleep making the period last over 2^31 cycles is cut off there.
+ */
+void RunTimeStats::Slept(uint32_t cycles)
+{
+    if (period == 0) { return; }
+
+    const uint32_t prim = EnterCritical();
+
+    const uint32_t elapsed = Now() - periodStart;
+    if (elapsed < 0x80000000)
+    {
+        if (cycles > (0x80000000 - elapsed)) { cycles = 0x80000000 - elapsed; }
+
+        // Moving the starts back charges the slept cycles
+        sliceStart  -= cycles;
+        periodStart -= cycles;
+    }
+
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Close the period when it has elapsed: the measurements become
+ *          available with GetStatistics() and GetReport().
+ * \note    Call from task context, at least once per period.
+ */
+void RunTimeStats::Update()
+{
+    const uint32_t now = Now();
+    if ((period == 0) || ((now - periodStart) < period)) { return; }
+
+    const uint32_t prim = EnterCritical();
+
+    // Charge the running task up to now, it continues in the next period
+    if (current != RUNTIME_STATS_INVALID)
+    {
+        entries[current].cycles += now - sliceStart - isrInSlice;
+    }
+    sliceStart = now;
+    isrInSlice = 0;
+
+    for (uint8_t i = 0; i < entryCount; i++)
+    {
+        results[i].cycles = entries[i].cycles;
+        results[i].count  = entries[i].count;
+        entries[i].cycles = 0;
+        entries[i].count  = 0;
+    }
+
+    resultCount    = entryCount;
+    resultPeriod   = now - periodStart;
+    resultSwitches = switches;
+    periodStart    = now;
+    switches       = 0;
+    updated        = true;
+
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Check if the measurements of a new period are available.
+ * \returns True if a period was closed since the last GetReport(), else false.
+ */
+bool RunTimeStats::IsUpdated()
+{
+    return updated;
+}
+
+/**
+ * \brief   Get the number of entries: tasks (including idle) and ISRs.
+ * \returns The number of entries, ids are 0 up to this number.
+ */
+uint8_t RunTimeStats::GetEntryCount()
+{
+    return entryCount;
+}
+
+/**
+ * \brief   Get the measurements of a task or ISR over the last period.
+ * \param   id      The id of the entry.
+ * \param   stats   Filled with the measurements.
+ * \returns True if the id is valid, else false.
+ */
+bool RunTimeStats::GetStatistics(uint8_t id, RunTimeEntryStats& stats)
+{
+    EXPECT(id < entryCount);
+    if (id >= entryCount) { return false; }
+
+    const uint32_t prim = EnterCritical();
+    stats.name     = entries[id].name;
+    stats.kind     = entries[id].kind;
+    stats.cycles   = results[id].cycles;
+    stats.count    = results[id].count;
+    stats.permille = ToPermille(results[id].cycles, resultPeriod);
+    ExitCritical(prim);
+
+    return true;
+}
+
+/**
+ * \brief   Get the load of the idle task over the last period.
+ * \returns The idle load in permille.
+ */
+uint16_t RunTimeStats::GetIdlePermille()
+{
+    const uint32_t prim = EnterCritical();
+    const uint16_t permille = ToPermille(IdleCycles(), resultPeriod);
+    ExitCritical(prim);
+
+    return permille;
+}
+
+/**
+ * \brief   Get the number of context switches in the last period.
+ * \returns The number of task switches.
+ */
+uint32_t RunTimeStats::GetContextSwitches()
+{
+    return resultSwitches;
+}
+
+/**
+ * \brief   Write the binary report of the last period, see the header for
+ *          the layout. Marks the period as read, see IsUpdated().
+ * \param   dest    Destination buffer.
+ * \param   length  Size of the destination buffer.
+ * \returns The number of bytes written, 0 if the buffer is too small.
+ */
+uint16_t RunTimeStats::GetReport(uint8_t* dest, uint16_t length)
+{
+    EXPECT(dest != nullptr);
+    if (dest == nullptr) { return 0; }
+
+    const uint32_t prim = EnterCritical();
+
+    const uint16_t size = RUNTIME_STATS_REPORT_SIZE(resultCount);
+    if (length < size)
+    {
+        ExitCritical(prim);
+        return 0;
+    }
+
+    uint8_t* ptr = dest;
+    *ptr++ = RUNTIME_STATS_REPORT_ID;
+    *ptr++ = resultCount;
+    Put16(ptr, ToPermille(IdleCycles(), resultPeriod));
+    Put32(ptr, resultPeriod);
+    Put32(ptr, resultSwitches);
+
+    for (uint8_t i = 0; i < resultCount; i++)
+    {
+        *ptr++ = i;
+        *ptr++ = static_cast<uint8_t>(entries[i].kind);
+        Put16(ptr, ToPermille(results[i].cycles, resultPeriod));
+        Put32(ptr, results[i].count);
+    }
+
+    updated = false;
+    ExitCritical(prim);
+
+    return size;
+}
+
+
+/************************************************************************/
+/* FreeRTOS hooks                                                       */
+/************************************************************************/
+/**
+ * \brief   Enable the DWT cycle counter, for portCONFIGURE_TIMER_FOR_RUN_TIME_STATS().
+ */
+extern "C" void RunTimeStats_ConfigureCounter(void)
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+}
+
+/**
+ * \brief   Get the DWT cycle counter, for portGET_RUN_TIME_COUNTER_VALUE().
+ */
+extern "C" uint32_t RunTimeStats_GetCounter(void)
+{
+    return Now();
+}
+
+/**
+ * \brief   For traceTASK_SWITCHED_IN().
+ */
+extern "C" void RunTimeStats_TaskSwitchedIn(const void* handle, const char* name)
+{
+    RunTimeStats::TaskSwitchedIn(handle, name);
+}
+
+/**
+ * \brief   For traceTASK_SWITCHED_OUT().
+ */
+extern "C" void RunTimeStats_TaskSwitchedOut(void)
+{
+    RunTimeStats::TaskSwitchedOut();
+}
@@ -0,0 +1,57 @@
+/**
+ * \file    stack_painting.h
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \brief   Stack painting functions for ST Cortex-M4.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/utility/StackPainting
+ *
+ * \author  Terry Louwers (terry.louwers@fourtress.nl)
+ * \version 1.1
+ * \date    10-2026
+ */
+
+#ifndef STACK_PAINTING_H_
+#define STACK_PAINTING_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <stdint.h>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     STACK_PAINT_VALUE
+ * \brief   Value the main stack is painted with by paint_stack().
+ */
+#define STACK_PAINT_VALUE   0xC5C5C5C5
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+void paint_stack(void);
+
+uint32_t get_total_stack(void);
+uint32_t get_used_stack(void);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif  // STACK_PAINTING_H_
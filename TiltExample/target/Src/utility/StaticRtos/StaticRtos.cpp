@@ -0,0 +1,66 @@
+/**
+ * \file    StaticRtos.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Memory of the FreeRTOS idle (and timer) task with static
+ *          allocation.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/TiltExample/target/Src/utility/StaticRtos
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/StaticRtos/StaticRtos.hpp"
+
+
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static StaticTask_t idleTaskTcb;
+static StackType_t  idleTaskStack[configMINIMAL_STACK_SIZE];
+
+#if (configUSE_TIMERS == 1)
+static StaticTask_t timerTaskTcb;
+static StackType_t  timerTaskStack[configTIMER_TASK_STACK_DEPTH];
+#endif
+
+
+/************************************************************************/
+/* FreeRTOS hooks                                                       */
+/************************************************************************/
+/**
+ * \brief   Provide the memory of the idle task, called by the scheduler.
+ */
+extern "C" void vApplicationGetIdleTaskMemory(StaticTask_t** ppxIdleTaskTCBBuffer, StackType_t** ppxIdleTaskStackBuffer, uint32_t* pulIdleTaskStackSize)
+{
+    *ppxIdleTaskTCBBuffer   = &idleTaskTcb;
+    *ppxIdleTaskStackBuffer = idleTaskStack;
+    *pulIdleTaskStackSize   = configMINIMAL_STACK_SIZE;
+}
+
+#if (configUSE_TIMERS == 1)
+/**
+ * \brief   Provide the memory of the timer task, called by the scheduler.
+ */
+extern "C" void vApplicationGetTimerTaskMemory(StaticTask_t** ppxTimerTaskTCBBuffer, StackType_t** ppxTimerTaskStackBuffer, uint32_t* pulTimerTaskStackSize)
+{
+    *ppxTimerTaskTCBBuffer   = &timerTaskTcb;
+    *ppxTimerTaskStackBuffer = timerTaskStack;
+    *pulTimerTaskStackSize   = configTIMER_TASK_STACK_DEPTH;
+}
+#endif
+
+#endif  // configSUPPORT_STATIC_ALLOCATION
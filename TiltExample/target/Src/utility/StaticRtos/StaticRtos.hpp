@@ -0,0 +1,141 @@
+/**
+ * \file    StaticRtos.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   FreeRTOS tasks, queues and stream buffers with their memory
+ *          allocated at link time.
+ *
+ * \details Each object holds the memory FreeRTOS needs: the stack and task
+ *          control block, the queue or stream buffer storage. Sizes are
+ *          template parameters, placed in static memory the RAM used is known
+ *          at link time and shows in the map file per object.
+ *          With configSUPPORT_STATIC_ALLOCATION 0 the objects hold no memory
+ *          and Create() allocates from the FreeRTOS heap instead, the
+ *          application code is the same for both.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/TiltExample/target/Src/utility/StaticRtos
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef STATIC_RTOS_HPP_
+#define STATIC_RTOS_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstddef>
+#include <cstdint>
+#include "FreeRTOS.h"
+#include "queue.h"
+#include "stream_buffer.h"
+#include "task.h"
+
+
+/************************************************************************/
+/* Class declarations                                                   */
+/************************************************************************/
+/**
+ * \class   StaticTask
+ * \brief   Task with a stack of STACK_DEPTH words.
+ */
+template <configSTACK_DEPTH_TYPE STACK_DEPTH>
+class StaticTask
+{
+public:
+    /**
+     * \brief   Create the task, only once.
+     * \param   function    The task function.
+     * \param   name        Name of the task.
+     * \param   parameters  Parameter passed to the task function.
+     * \param   priority    Priority of the task.
+     * \param   handle      Optional, the handle of the created task.
+     * \returns True if the task could be created, else false.
+     */
+    bool Create(TaskFunction_t function, const char* name, void* parameters, UBaseType_t priority, TaskHandle_t* handle = nullptr)
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+        TaskHandle_t task = xTaskCreateStatic(function, name, STACK_DEPTH, parameters, priority, mStack, &mTcb);
+        if (handle != nullptr) { *handle = task; }
+        return (task != nullptr);
+#else
+        return (xTaskCreate(function, name, STACK_DEPTH, parameters, priority, handle) == pdPASS);
+#endif
+    }
+
+private:
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    StackType_t  mStack[STACK_DEPTH];
+    StaticTask_t mTcb;
+#endif
+};
+
+/**
+ * \class   StaticQueue
+ * \brief   Queue of LENGTH items of type T.
+ */
+template <typename T, UBaseType_t LENGTH>
+class StaticQueue
+{
+public:
+    /**
+     * \brief   Create the queue, only once.
+     * \returns The handle of the queue, nullptr if it could not be created.
+     */
+    QueueHandle_t Create()
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+        return xQueueCreateStatic(LENGTH, sizeof(T), mStorage, &mQueue);
+#else
+        return xQueueCreate(LENGTH, sizeof(T));
+#endif
+    }
+
+private:
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    uint8_t       mStorage[LENGTH * sizeof(T)];
+    StaticQueue_t mQueue;
+#endif
+};
+
+/**
+ * \class   StaticStreamBuffer
+ * \brief   Stream buffer of SIZE bytes.
+ */
+template <size_t SIZE>
+class StaticStreamBuffer
+{
+public:
+    /**
+     * \brief   Create the stream buffer, only once.
+     * \param   triggerLevel    Number of bytes in the stream buffer before a
+     *                          blocked reader is woken.
+     * \returns The handle of the stream buffer, nullptr if it could not be
+     *          created.
+     */
+    StreamBufferHandle_t Create(size_t triggerLevel)
+    {
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+        return xStreamBufferCreateStatic(SIZE, triggerLevel, mStorage, &mStreamBuffer);
+#else
+        return xStreamBufferCreate(SIZE, triggerLevel);
+#endif
+    }
+
+private:
+#if (configSUPPORT_STATIC_ALLOCATION == 1)
+    uint8_t              mStorage[SIZE + 1];    // FreeRTOS needs 1 byte more than SIZE
+    StaticStreamBuffer_t mStreamBuffer;
+#endif
+};
+
+
+#endif  // STATIC_RTOS_HPP_
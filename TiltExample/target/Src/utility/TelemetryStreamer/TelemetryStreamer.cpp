@@ -0,0 +1,188 @@
+/**
+ * \file    TelemetryStreamer.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   TelemetryStreamer
+ *
+ * \brief   Non-blocking binary telemetry stream over a USART, using DMA.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/TelemetryStreamer
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/TelemetryStreamer/TelemetryStreamer.hpp"
+#include "utility/Assert/Assert.h"
+#include <cstring>
+
+
+/************************************************************************/
+/* Static assertions                                                    */
+/************************************************************************/
+static_assert((TELEMETRY_FRAME_SIZE % sizeof(uint32_t)) == 0, "Frame must be a multiple of 4 bytes");
+static_assert(TELEMETRY_FRAME_SIZE <= UINT16_MAX, "Frame must fit a single DMA transfer");
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Constructor.
+ * \param   usart   The (initialized) USART to send the frames with. Must
+ *                  have DMA configured for Tx.
+ * \param   crc     The (initialized) CRC unit to calculate the frame CRC with.
+ */
+TelemetryStreamer::TelemetryStreamer(IUSART& usart, ICRC& crc) :
+    mUsart(usart),
+    mCrc(crc),
+    mFrames{},
+    mFill(0),
+    mLength(0),
+    mSequence(0),
+    mSending(false),
+    mStats()
+{ }
+
+/**
+ * \brief   Add a record to the stream. Records are never split over frames:
+ *          if the record does not fit the frame being filled, that frame is
+ *          sent first.
+ * \param   src     The record to add.
+ * \param   length  The length of the record in bytes, at most
+ *                  TELEMETRY_PAYLOAD_SIZE.
+ * \returns True if the record is added, false if it is invalid or dropped
+ *          because the previous frame is still being sent.
+ */
+bool TelemetryStreamer::Write(const uint8_t* src, uint16_t length)
+{
+    EXPECT(src);
+    EXPECT(length > 0);
+    EXPECT(length <= TELEMETRY_PAYLOAD_SIZE);
+
+    if (src == nullptr)                     { return false; }
+    if (length == 0)                        { return false; }
+    if (length > TELEMETRY_PAYLOAD_SIZE)    { return false; }
+
+    if ((mLength + length) > TELEMETRY_PAYLOAD_SIZE)
+    {
+        if (!Flush())
+        {
+            mStats.recordsDropped++;
+            mStats.bytesDropped += length;
+            return false;
+        }
+    }
+
+    uint8_t* payload = reinterpret_cast<uint8_t*>(mFrames[mFill]) + TELEMETRY_HEADER_SIZE;
+    std::memcpy(&payload[mLength], src, length);
+    mLength += length;
+
+    return true;
+}
+
+/**
+ * \brief   Send the frame being filled (if any), filling continues in the
+ *          other buffer.
+ * \returns True if the frame is being sent or there is nothing to send, false
+ *          if the previous frame is still being sent or the transfer could
+ *          not be started. Records are kept to be sent with a next flush.
+ * \note    Not to be called from ISR.
+ */
+bool TelemetryStreamer::Flush()
+{
+    if (mLength == 0) { return true; }
+
+    if (mSending)
+    {
+        mStats.busyFlushes++;
+        return false;
+    }
+
+    uint32_t* frame = mFrames[mFill];
+    const uint16_t size = CloseFrame(frame);
+
+    mSending = true;
+    if (!mUsart.WriteDma(reinterpret_cast<const uint8_t*>(frame), size, [this]() { this->TransmitDone(); }))
+    {
+        mSending = false;
+        return false;
+    }
+
+    mFill     ^= 1;
+    mLength    = 0;
+    mSequence++;
+
+    mStats.framesSent++;
+    mStats.bytesSent += size;
+    return true;
+}
+
+/**
+ * \brief   Indicate if a frame is being sent.
+ * \returns True if a frame is being sent, else false.
+ */
+bool TelemetryStreamer::IsBusy() const
+{
+    return mSending;
+}
+
+/**
+ * \brief   Get the number of payload bytes waiting in the frame being filled.
+ * \returns The number of bytes not yet sent.
+ */
+uint16_t TelemetryStreamer::GetPending() const
+{
+    return mLength;
+}
+
+/**
+ * \brief   Get the throughput and backpressure statistics.
+ * \returns The statistics since construction.
+ */
+TelemetryStats TelemetryStreamer::GetStatistics() const
+{
+    return mStats;
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Complete a frame: header, padding and CRC.
+ * \param   frame   The frame buffer, payload filled in.
+ * \returns The size of the frame in bytes.
+ */
+uint16_t TelemetryStreamer::CloseFrame(uint32_t* frame)
+{
+    const uint16_t padded = (mLength + 3) & ~3;
+    const uint16_t words  = (TELEMETRY_HEADER_SIZE + padded) / sizeof(uint32_t);
+
+    frame[0] = TELEMETRY_SYNC | (static_cast<uint32_t>(mLength) << 16);
+    frame[1] = mSequence;
+
+    uint8_t* payload = reinterpret_cast<uint8_t*>(frame) + TELEMETRY_HEADER_SIZE;
+    std::memset(&payload[mLength], 0, padded - mLength);
+
+    frame[words] = mCrc.Calculate(frame, words);
+
+    return (words * sizeof(uint32_t)) + TELEMETRY_CRC_SIZE;
+}
+
+/**
+ * \brief   ISR: frame sent, the buffer can be filled again.
+ */
+void TelemetryStreamer::TransmitDone()
+{
+    mSending = false;
+}
@@ -0,0 +1,129 @@
+/**
+ * \file    TelemetryStreamer.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   TelemetryStreamer
+ *
+ * \brief   Non-blocking binary telemetry stream over a USART, using DMA.
+ *
+ * \details Records (for instance samples) are collected into a frame. A
+ *          frame is sent with DMA when it is full or when flushed, while the
+ *          next frame is filled in the second buffer. Producers never block:
+ *          if both buffers are in use the record is dropped and counted.
+ *
+ *          Frame layout, little endian, 4 byte aligned:
+ *          | Offset | Size   | Contents                                      |
+ *          | ------ | ------ | --------------------------------------------- |
+ *          | 0      | 2      | Sync: TELEMETRY_SYNC                          |
+ *          | 2      | 2      | Length of the payload in bytes                |
+ *          | 4      | 4      | Sequence number, incremented per frame        |
+ *          | 8      | n      | Payload, zero padded to a multiple of 4 bytes |
+ *          | 8 + n  | 4      | CRC-32 (hardware CRC) over the words before   |
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/TelemetryStreamer
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef TELEMETRY_STREAMER_HPP_
+#define TELEMETRY_STREAMER_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "interfaces/ICRC.hpp"
+#include "interfaces/IUSART.hpp"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     TELEMETRY_FRAME_SIZE
+ * \brief   Size of a frame buffer in bytes, including header and CRC. Must be
+ *          a multiple of 4. Two buffers are used.
+ */
+#define TELEMETRY_FRAME_SIZE        256
+
+/**
+ * \def     TELEMETRY_SYNC
+ * \brief   First 2 bytes of each frame.
+ */
+#define TELEMETRY_SYNC              0xA55A
+
+/**
+ * \def     TELEMETRY_HEADER_SIZE
+ * \brief   Size of the frame header (sync, length and sequence number).
+ */
+#define TELEMETRY_HEADER_SIZE       8
+
+/**
+ * \def     TELEMETRY_CRC_SIZE
+ * \brief   Size of the CRC at the end of the frame.
+ */
+#define TELEMETRY_CRC_SIZE          4
+
+/**
+ * \def     TELEMETRY_PAYLOAD_SIZE
+ * \brief   Maximum payload of a frame in bytes.
+ */
+#define TELEMETRY_PAYLOAD_SIZE      (TELEMETRY_FRAME_SIZE - TELEMETRY_HEADER_SIZE - TELEMETRY_CRC_SIZE)
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  TelemetryStats
+ * \brief   Throughput and backpressure of the telemetry stream.
+ */
+struct TelemetryStats
+{
+    uint32_t framesSent     = 0;    ///< Frames handed to the USART
+    uint32_t bytesSent      = 0;    ///< Bytes handed to the USART, including header and CRC
+    uint32_t recordsDropped = 0;    ///< Records dropped, both buffers in use
+    uint32_t bytesDropped   = 0;    ///< Bytes of the dropped records
+    uint32_t busyFlushes    = 0;    ///< Flushes postponed, previous frame still being sent
+};
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class TelemetryStreamer
+{
+public:
+    TelemetryStreamer(IUSART& usart, ICRC& crc);
+    virtual ~TelemetryStreamer() {};
+
+    bool Write(const uint8_t* src, uint16_t length);
+    bool Flush();
+
+    bool IsBusy() const;
+    uint16_t GetPending() const;
+    TelemetryStats GetStatistics() const;
+
+private:
+    IUSART&           mUsart;
+    ICRC&             mCrc;
+    uint32_t          mFrames[2][TELEMETRY_FRAME_SIZE / sizeof(uint32_t)];
+    uint8_t           mFill;
+    uint16_t          mLength;
+    uint32_t          mSequence;
+    volatile bool     mSending;
+    TelemetryStats    mStats;
+
+    uint16_t CloseFrame(uint32_t* frame);
+    void TransmitDone();
+};
+
+
+#endif  // TELEMETRY_STREAMER_HPP_
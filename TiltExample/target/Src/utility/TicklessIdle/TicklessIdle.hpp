@@ -0,0 +1,173 @@
+/**
+ * \file    TicklessIdle.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   TicklessIdle
+ *
+ * \brief   Tickless idle for FreeRTOS: suppress the SysTick interrupt while
+ *          idle, in Sleep or Stop mode.
+ *
+ * \details Called from portSUPPRESS_TICKS_AND_SLEEP() with the number of
+ *          ticks the scheduler expects to be idle. Short periods are slept in
+ *          Sleep mode with the SysTick reloaded to the expected wake time.
+ *          Longer periods, with no DMA transfer running, are slept in Stop
+ *          mode with the RTC wakeup timer (clocked from the LSI) as wake
+ *          source. On wake the number of completed ticks is returned, to step
+ *          the tick count with vTaskStepTick(), and the SysTick is aligned to
+ *          the next tick.
+ *          The wake percentage and the number of sleeps are kept, like
+ *          CpuWakeCounter, and made available roughly once per second.
+ *          The slept cycles are credited to the idle task in RunTimeStats,
+ *          the DWT cycle counter does not count while sleeping.
+ *
+ * \note    Uses the SysTick, the RTC and the DWT cycle counter. Not to be
+ *          combined with the Rtc driver, both configure the RTC.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/TicklessIdle
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.2
+ * \date    10-2026
+ */
+
+#ifndef TICKLESS_IDLE_HPP_
+#define TICKLESS_IDLE_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     TICKLESS_STOP_THRESHOLD
+ * \brief   Default minimum number of idle ticks to enter Stop mode. Waking
+ *          from Stop restarts the HSE and PLL, which takes about 2 ms.
+ */
+#define TICKLESS_STOP_THRESHOLD     10
+
+/**
+ * \def     TICKLESS_MISSED_COUNTS
+ * \brief   SysTick counts lost while the SysTick is stopped to reload it, as
+ *          portMISSED_COUNTS_FACTOR in the FreeRTOS port.
+ */
+#define TICKLESS_MISSED_COUNTS      45
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  TicklessStats
+ * \brief   Data structure containing statistics about the tickless idle.
+ * \note    Assumed this is updated every second.
+ */
+struct TicklessStats
+{
+    float    wakePercentage  = 0.0f;    ///< Percentage the CPU was awake (per second)
+    uint32_t sleepCount      = 0;       ///< Number of times Sleep mode was entered (per second)
+    uint32_t stopCount       = 0;       ///< Number of times Stop mode was entered (per second)
+    uint32_t suppressedTicks = 0;       ///< Tick interrupts not taken (per second)
+};
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class TicklessIdle
+{
+public:
+    /**
+     * \struct  Config
+     * \brief   Configuration struct for TicklessIdle.
+     */
+    struct Config
+    {
+        /**
+         * \brief   Constructor of the TicklessIdle configuration struct.
+         * \param   interruptPriority   Interrupt priority of the RTC wakeup interrupt.
+         * \param   tickRateHz          The FreeRTOS tick rate (configTICK_RATE_HZ).
+         * \param   restoreClock        Method restoring the system clock after
+         *                              Stop mode, nullptr to restart the HSE and
+         *                              PLL as they ran before. Called with the
+         *                              interrupts disabled: must not wait on
+         *                              HAL_GetTick(), as the HAL RCC methods do.
+         * \param   stopThresholdTicks  Minimum number of idle ticks to enter Stop mode.
+         *                              Default TICKLESS_STOP_THRESHOLD.
+         * \param   rtcClockHz          Frequency of the LSI in Hz, 0 to measure
+         *                              it during Init(). Default 0.
+         */
+        Config(uint8_t interruptPriority, uint32_t tickRateHz, bool (*restoreClock)(),
+               uint16_t stopThresholdTicks = TICKLESS_STOP_THRESHOLD, uint32_t rtcClockHz = 0) :
+            mInterruptPriority(interruptPriority),
+            mTickRateHz(tickRateHz),
+            mRestoreClock(restoreClock),
+            mStopThresholdTicks(stopThresholdTicks),
+            mRtcClockHz(rtcClockHz)
+        { }
+
+        uint8_t  mInterruptPriority;    ///< Interrupt priority of the RTC wakeup interrupt.
+        uint32_t mTickRateHz;           ///< The FreeRTOS tick rate.
+        bool   (*mRestoreClock)();      ///< Restores the system clock after Stop mode.
+        uint16_t mStopThresholdTicks;   ///< Minimum number of idle ticks to enter Stop mode.
+        uint32_t mRtcClockHz;           ///< Frequency of the LSI in Hz, 0 to measure it.
+    };
+
+    bool Init(const Config& config);
+
+    uint32_t Sleep(uint32_t expectedIdleTicks);
+
+    void LockStop();
+    void UnlockStop();
+
+    uint32_t GetRtcClock() const;
+    bool IsUpdated() const;
+    TicklessStats GetStatistics();
+
+private:
+    RTC_HandleTypeDef mRtc               = {};
+    bool            (*mRestoreClock)()   = nullptr;
+    uint32_t          mTickRateHz        = 0;
+    uint32_t          mCyclesPerTick     = 0;
+    uint32_t          mMaxSleepTicks     = 0;
+    uint32_t          mMaxStopTicks      = 0;
+    uint32_t          mStopThreshold     = 0;
+    uint32_t          mRtcClockHz        = 0;
+    uint32_t          mSubSecondHz       = 0;
+    uint32_t          mWakeUpHz          = 0;
+    volatile uint32_t mStopLocks         = 0;
+    bool              mInitialized       = false;
+
+    uint32_t          mWakeCycle         = 0;
+    uint64_t          mAwakeCycles       = 0;
+    uint64_t          mAsleepCycles      = 0;
+    TicklessStats     mCounting          = {};
+    TicklessStats     mStats             = {};
+    bool              mUpdateAvailable   = false;
+
+    bool ConfigureRtc(uint32_t rtcClockHz);
+    uint32_t MeasureRtcClock() const;
+    bool IsStopAllowed(uint32_t expectedIdleTicks) const;
+    uint32_t EnterSleep(uint32_t expectedIdleTicks, uint64_t& sleptCycles);
+    uint32_t EnterStop(uint32_t expectedIdleTicks, uint64_t& sleptCycles);
+    bool StartWakeUpTimer(uint32_t counter);
+    void StopWakeUpTimer();
+    bool SynchronizeRtc();
+    bool RestoreClock(uint32_t clock, uint32_t source);
+    uint32_t StopSysTick();
+    void RestartSysTick(uint32_t nextTickCycles);
+    uint32_t ReadRtc() const;
+    void UpdateStatistics(uint64_t sleptCycles);
+};
+
+
+#endif  // TICKLESS_IDLE_HPP_
@@ -0,0 +1,157 @@
+# RAM usage per component, from the map file written by the linker.
+#
+# Usage (post build step):
+#   cmake -DMAP_FILE=<file.map> [-DREPORT_FILE=<file.txt>] -P ram-report.cmake
+#
+# Sums the input sections placed in the .data and .bss output sections per
+# component: the directory of the object file relative to the project (Src/
+# left out), or the library for archive members. The heap and main stack
+# reserved by the linker script are listed separately.
+
+# Define the minimum CMake version to use (math with hexadecimal input)
+cmake_minimum_required(VERSION 3.13.0 FATAL_ERROR)
+
+if(NOT MAP_FILE)
+    message(FATAL_ERROR "ram-report: MAP_FILE not given")
+endif()
+
+# Only the lines of interest: the start of the memory map, output sections,
+# input sections and input section sizes wrapped onto the next line
+file(STRINGS ${MAP_FILE} MAP_LINES REGEX "^(Linker script and memory map|\\.|  ?[^ ]| +0x[0-9a-fA-F]+ +0x)")
+
+set(IN_MEMORY_MAP FALSE)
+set(OUTPUT_SECTION "")
+set(PENDING_SECTION "")
+set(COMPONENTS "")
+set(TOTAL_DATA 0)
+set(TOTAL_BSS 0)
+
+foreach(LINE IN LISTS MAP_LINES)
+    if(LINE STREQUAL "Linker script and memory map")
+        set(IN_MEMORY_MAP TRUE)
+        continue()
+    endif()
+    if(NOT IN_MEMORY_MAP)
+        continue()
+    endif()
+
+    # Output section: '.bss            0x20000100      0x2f0', the size on
+    # the next line when the name is long
+    if(LINE MATCHES "^(\\.[^ ]+)")
+        set(OUTPUT_SECTION ${CMAKE_MATCH_1})
+    endif()
+    if(OUTPUT_SECTION STREQUAL "._user_heap_stack" AND NOT DEFINED HEAP_STACK)
+        if(LINE MATCHES "^[^ ]* +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+)")
+            math(EXPR HEAP_STACK "0x${CMAKE_MATCH_1}")
+        endif()
+    endif()
+    if(LINE MATCHES "^\\.")
+        continue()
+    endif()
+
+    if(NOT (OUTPUT_SECTION STREQUAL ".data" OR OUTPUT_SECTION STREQUAL ".bss"))
+        continue()
+    endif()
+
+    # Input section, the name on its own line when it is long:
+    # ' .bss.mBuffer   0x20000100       0x40 CMakeFiles/x.dir/Src/utility/Foo/Foo.cpp.obj'
+    if(LINE MATCHES "^ \\*\\(")
+        continue()
+    elseif(LINE MATCHES "^ ([^ ]+)$")
+        set(PENDING_SECTION ${CMAKE_MATCH_1})
+        continue()
+    elseif(LINE MATCHES "^ ([^ ]+) +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+) ?(.*)$")
+        set(SIZE ${CMAKE_MATCH_2})
+        set(OBJECT ${CMAKE_MATCH_3})
+    elseif(PENDING_SECTION AND LINE MATCHES "^ +0x[0-9a-fA-F]+ +0x([0-9a-fA-F]+) ?(.*)$")
+        set(SIZE ${CMAKE_MATCH_1})
+        set(OBJECT ${CMAKE_MATCH_2})
+    else()
+        continue()
+    endif()
+    set(PENDING_SECTION "")
+
+    math(EXPR SIZE "0x${SIZE}")
+    if(SIZE EQUAL 0)
+        continue()
+    endif()
+
+    # Component: library of an archive member, else directory of the object
+    string(STRIP "${OBJECT}" OBJECT)
+    if(OBJECT STREQUAL "")
+        set(COMPONENT "(alignment)")
+    elseif(OBJECT MATCHES "([^/]+\\.a)\\(")
+        set(COMPONENT ${CMAKE_MATCH_1})
+    elseif(IS_ABSOLUTE "${OBJECT}" AND NOT OBJECT MATCHES "\\.dir/")
+        get_filename_component(COMPONENT "${OBJECT}" NAME)
+    else()
+        string(REGEX REPLACE "^.*\\.dir/" "" COMPONENT "${OBJECT}")
+        get_filename_component(COMPONENT "${COMPONENT}" DIRECTORY)
+        string(REGEX REPLACE "^Src/?" "" COMPONENT "${COMPONENT}")
+        string(REGEX REPLACE "/Src$" "" COMPONENT "${COMPONENT}")
+        if(COMPONENT STREQUAL "")
+            set(COMPONENT "Src")
+        endif()
+    endif()
+    string(MAKE_C_IDENTIFIER "${COMPONENT}" KEY)
+
+    if(NOT DEFINED DATA_${KEY})
+        list(APPEND COMPONENTS ${KEY})
+        set(NAME_${KEY} "${COMPONENT}")
+        set(DATA_${KEY} 0)
+        set(BSS_${KEY} 0)
+    endif()
+    if(OUTPUT_SECTION STREQUAL ".data")
+        math(EXPR DATA_${KEY} "${DATA_${KEY}} + ${SIZE}")
+        math(EXPR TOTAL_DATA "${TOTAL_DATA} + ${SIZE}")
+    else()
+        math(EXPR BSS_${KEY} "${BSS_${KEY}} + ${SIZE}")
+        math(EXPR TOTAL_BSS "${TOTAL_BSS} + ${SIZE}")
+    endif()
+endforeach()
+
+# Right align a number in a column of 8
+function(pad NUMBER RESULT)
+    set(TEXT "${NUMBER}")
+    string(LENGTH "${TEXT}" LENGTH)
+    while(LENGTH LESS 8)
+        set(TEXT " ${TEXT}")
+        math(EXPR LENGTH "${LENGTH} + 1")
+    endwhile()
+    set(${RESULT} "${TEXT}" PARENT_SCOPE)
+endfunction()
+
+# Sort on total size, largest first: the key is prefixed with the zero padded size
+set(SORTED "")
+foreach(KEY IN LISTS COMPONENTS)
+    math(EXPR TOTAL "${DATA_${KEY}} + ${BSS_${KEY}}")
+    math(EXPR TOTAL "100000000 + ${TOTAL}")
+    list(APPEND SORTED "${TOTAL}|${KEY}")
+endforeach()
+list(SORT SORTED)
+list(REVERSE SORTED)
+
+set(REPORT "RAM usage per component (bytes)\n    data     bss   total  component\n")
+foreach(ENTRY IN LISTS SORTED)
+    string(REGEX REPLACE "^[0-9]+\\|" "" KEY "${ENTRY}")
+    math(EXPR TOTAL "${DATA_${KEY}} + ${BSS_${KEY}}")
+    pad(${DATA_${KEY}} DATA)
+    pad(${BSS_${KEY}} BSS)
+    pad(${TOTAL} TOTAL)
+    string(APPEND REPORT "${DATA}${BSS}${TOTAL}  ${NAME_${KEY}}\n")
+endforeach()
+
+math(EXPR TOTAL "${TOTAL_DATA} + ${TOTAL_BSS}")
+pad(${TOTAL_DATA} DATA)
+pad(${TOTAL_BSS} BSS)
+pad(${TOTAL} TOTAL)
+string(APPEND REPORT "${DATA}${BSS}${TOTAL}  total static\n")
+if(DEFINED HEAP_STACK)
+    pad(${HEAP_STACK} HEAP_STACK)
+    string(APPEND REPORT "                ${HEAP_STACK}  heap and main stack (linker script)\n")
+endif()
+
+message("${REPORT}")
+if(REPORT_FILE)
+    file(WRITE ${REPORT_FILE} "${REPORT}")
+endif()
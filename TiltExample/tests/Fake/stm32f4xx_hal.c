@@ -7,4 +7,15 @@
 // __NOP() formally part of CMSIS, only available for ARM.
 void __NOP(void) { ; }
 
+// Interrupt masking, formally part of CMSIS: only the PRIMASK state is kept.
+static uint32_t primask = 0;
+
+uint32_t __get_PRIMASK(void) { return primask; }
+void __disable_irq(void)     { primask = 1; }
+void __enable_irq(void)      { primask = 0; }
+
 void HAL_Delay(uint32_t Delay) { ; }
+
+// Register memory of the DWT cycle counter and CoreDebug.
+DWT_Type       FakeHal_DwtRegisters;
+CoreDebug_Type FakeHal_CoreDebugRegisters;
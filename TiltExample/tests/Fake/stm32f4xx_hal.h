@@ -183,8 +183,39 @@ typedef enum
 
 void __NOP(void);
 
+uint32_t __get_PRIMASK(void);
+void __disable_irq(void);
+void __enable_irq(void);
+
 void HAL_Delay(uint32_t Delay);
 
+/**
+ * @brief Data Watchpoint and Trace, only the cycle counter.
+ */
+typedef struct
+{
+    volatile uint32_t CTRL;     ///< Control Register,      Address offset: 0x00
+    volatile uint32_t CYCCNT;   ///< Cycle Count Register,  Address offset: 0x04
+} DWT_Type;
+
+/**
+ * @brief Core Debug, only the exception and monitor control register.
+ */
+typedef struct
+{
+    volatile uint32_t DEMCR;    ///< Debug Exception and Monitor Control Register
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (0x00000001U)
+#define CoreDebug_DEMCR_TRCENA_Msk      (0x01000000U)
+
+// Backed by memory, for the CycleProfiler zones in the drivers.
+extern DWT_Type       FakeHal_DwtRegisters;
+extern CoreDebug_Type FakeHal_CoreDebugRegisters;
+
+#define DWT             (&FakeHal_DwtRegisters)
+#define CoreDebug       (&FakeHal_CoreDebugRegisters)
+
 #define UNUSED(X) (void)X      /* To avoid gcc/g++ warnings */
 
 
@@ -1,7 +1,7 @@
 #include "Assert.h"
 
 
-void _expect_log(const char* expr, int line, const char* file) { ; }
+void _expect_log(const DeferredLogSite* site) { ; }
 void _expect_breakpoint() { ; }
 void _assert_breakpoint() { ; }
 void _assert_reset(const char* expr, int line, const char* file) { ; }
@@ -25,6 +25,9 @@ public:
 
     Mock_SPI()
     {
+        ON_CALL(*this, Transfer(_, _, _))
+            .WillByDefault(Return(true));
+
         ON_CALL(*this, WriteDMA(_, _, _))
             .WillByDefault(Return(true));
         ON_CALL(*this, WriteReadDMA(_, _, _, _))
@@ -47,13 +50,15 @@ public:
         //    .WillByDefault(Return(true));
     }
 
-    MOCK_METHOD3(WriteDMA, bool(const uint8_t* src, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD4(WriteReadDMA, bool(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD3(ReadDMA, bool(uint8_t* dest, uint16_t length, const std::function<void()>& handler));
+    MOCK_METHOD3(Transfer, bool(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler));
+
+    MOCK_METHOD3(WriteDMA, bool(const uint8_t* src, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD4(WriteReadDMA, bool(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD3(ReadDMA, bool(uint8_t* dest, uint16_t length, const Delegate<void()>& handler));
 
-    MOCK_METHOD3(WriteInterrupt, bool(const uint8_t* src, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD4(WriteReadInterrupt, bool (const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD3(ReadInterrupt, bool(uint8_t* dest, uint16_t length, const std::function<void()>& handler));
+    MOCK_METHOD3(WriteInterrupt, bool(const uint8_t* src, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD4(WriteReadInterrupt, bool (const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD3(ReadInterrupt, bool(uint8_t* dest, uint16_t length, const Delegate<void()>& handler));
 
     MOCK_METHOD2(WriteBlocking, bool(const uint8_t* src, uint16_t length));
     MOCK_METHOD3(WriteReadBlocking, bool(const uint8_t* src, uint8_t* dest, uint16_t length));
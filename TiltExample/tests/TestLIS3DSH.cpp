@@ -19,9 +19,10 @@ class LIS3DSH_Test : public ::testing::Test
 {
 protected:
     Mock_SPI spi;
+    uint8_t  mReadBuffer[LIS3DSH_READ_BUFFER_SIZE(true, 2)];
 
     LIS3DSH_Test() :
-        mSubject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2)
+        mSubject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2, mReadBuffer, sizeof(mReadBuffer))
     {
         // Initialize test matter
     }
@@ -34,9 +35,9 @@ TEST_F(LIS3DSH_Test, Init_IsInit_Sleep)
 {
     EXPECT_FALSE(mSubject.IsInit());
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.IsInit());
 
@@ -49,9 +50,9 @@ TEST_F(LIS3DSH_Test, Enable)
 {
     EXPECT_FALSE(mSubject.Enable());   // Not initialized yet
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.Enable());
 }
@@ -60,18 +61,18 @@ TEST_F(LIS3DSH_Test, Disable)
 {
     EXPECT_FALSE(mSubject.Disable());   // Not initialized yet
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.Disable());
 }
 
 TEST_F(LIS3DSH_Test, RetrieveAxesData)
 {
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true,  LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     uint8_t motionArray[25 * 3 * 2] = {};       // 25 samples, X,Y,Z, 2 bytes/sample -- FIFO size
     uint8_t motionLength = sizeof(motionArray); // Normally returned from interupt when data received
@@ -0,0 +1,183 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/MotionMath/MotionMath.hpp"
+
+// Supporting files
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <vector>
+
+
+namespace {
+
+
+// Reference: the float implementation as used by the application before.
+static constexpr float K = 4.0 / UINT16_MAX;
+
+static float ReferencePitch(const MotionSampleRaw& raw)
+{
+    return 180 * atan2(raw.Y * K, raw.Z * K) / M_PI;
+}
+
+static float ReferenceRoll(const MotionSampleRaw& raw)
+{
+    return 180 * atan2(raw.X * K, raw.Z * K) / M_PI;
+}
+
+// Difference in degrees, +180 and -180 degrees are the same angle.
+static double AngleError(int16_t angle, double reference)
+{
+    double error = std::fabs(MotionMath::AngleToDegrees(angle) - reference);
+    return (error > 180.0) ? 360.0 - error : error;
+}
+
+// Samples on a sphere (as seen by the accelerometer) of the given magnitude.
+static std::vector<MotionSampleRaw> SphereSamples(double magnitude, uint16_t steps)
+{
+    std::vector<MotionSampleRaw> samples;
+
+    for (uint16_t i = 0; i < steps; i++)
+    {
+        const double theta = M_PI * i / steps;
+        for (uint16_t j = 0; j < 2 * steps; j++)
+        {
+            const double phi = M_PI * j / steps;
+
+            MotionSampleRaw raw;
+            raw.X = static_cast<int16_t>(magnitude * std::sin(theta) * std::cos(phi));
+            raw.Y = static_cast<int16_t>(magnitude * std::sin(theta) * std::sin(phi));
+            raw.Z = static_cast<int16_t>(magnitude * std::cos(theta));
+            samples.push_back(raw);
+        }
+    }
+    return samples;
+}
+
+
+TEST(MotionMath_Test, DegreesToAngle)
+{
+    EXPECT_EQ(0,       MotionMath::DegreesToAngle(0));
+    EXPECT_EQ(0x4000,  MotionMath::DegreesToAngle(90));
+    EXPECT_EQ(-0x4000, MotionMath::DegreesToAngle(-90));
+    EXPECT_EQ(-0x8000, MotionMath::DegreesToAngle(-180));
+
+    EXPECT_FLOAT_EQ(45.0f, MotionMath::AngleToDegrees(0x2000));
+}
+
+TEST(MotionMath_Test, Atan2_quadrants)
+{
+    EXPECT_EQ(0,       MotionMath::Atan2(0, 0));
+    EXPECT_EQ(0,       MotionMath::Atan2(0, 1000));
+    EXPECT_EQ(0x2000,  MotionMath::Atan2(1000, 1000));
+    EXPECT_EQ(0x4000,  MotionMath::Atan2(1000, 0));
+    EXPECT_EQ(0x6000,  MotionMath::Atan2(1000, -1000));
+    EXPECT_EQ(0x7FFF,  MotionMath::Atan2(0, -1000));      // 180 degrees
+    EXPECT_EQ(-0x6000, MotionMath::Atan2(-1000, -1000));
+    EXPECT_EQ(-0x4000, MotionMath::Atan2(-1000, 0));
+    EXPECT_EQ(-0x2000, MotionMath::Atan2(-1000, 1000));
+
+    // Full scale does not overflow
+    EXPECT_EQ(0x2000,  MotionMath::Atan2(INT16_MIN, INT16_MIN) + 0x8000);
+    EXPECT_EQ(0x2000,  MotionMath::Atan2(INT16_MAX, INT16_MAX));
+}
+
+TEST(MotionMath_Test, Atan2_error_bound)
+{
+    double maxError = 0.0;
+
+    for (int32_t y = INT16_MIN; y <= INT16_MAX; y += 97)
+    {
+        for (int32_t x = INT16_MIN; x <= INT16_MAX; x += 89)
+        {
+            const int16_t angle = MotionMath::Atan2(static_cast<int16_t>(y), static_cast<int16_t>(x));
+            const double  error = AngleError(angle, 180.0 * std::atan2(y, x) / M_PI);
+
+            if (error > maxError) { maxError = error; }
+        }
+    }
+
+    EXPECT_LT(maxError, MOTION_MATH_MAX_ERROR);
+}
+
+TEST(MotionMath_Test, CalculateMotionSamples_matches_float)
+{
+    // 1 G (Z down, flat) and 0.25 G (free falling, small values)
+    for (double magnitude : { 16384.0, 4096.0 })
+    {
+        const std::vector<MotionSampleRaw> raw = SphereSamples(magnitude, 64);
+        std::vector<MotionSample> samples(raw.size());
+
+        MotionMath::CalculateMotionSamples(raw.data(), samples.data(), raw.size());
+
+        for (size_t i = 0; i < raw.size(); i++)
+        {
+            EXPECT_EQ(raw[i].X, samples[i].X);
+            EXPECT_EQ(raw[i].Y, samples[i].Y);
+            EXPECT_EQ(raw[i].Z, samples[i].Z);
+            EXPECT_LT(AngleError(samples[i].pitch, ReferencePitch(raw[i])), MOTION_MATH_MAX_ERROR);
+            EXPECT_LT(AngleError(samples[i].roll,  ReferenceRoll(raw[i])),  MOTION_MATH_MAX_ERROR);
+        }
+    }
+}
+
+TEST(MotionMath_Test, CalculateMotionSamples_invalid)
+{
+    MotionSampleRaw raw = { 0, 0, 16384 };
+    MotionSample sample = { 1, 1, 1, 1, 1 };
+
+    MotionMath::CalculateMotionSamples(nullptr, &sample, 1);
+    EXPECT_EQ(1, sample.pitch);
+
+    MotionMath::CalculateMotionSamples(&raw, nullptr, 1);
+    MotionMath::CalculateMotionSamples(&raw, &sample, 0);
+    EXPECT_EQ(1, sample.pitch);
+}
+
+// Host side benchmark: fixed-point batch versus the float implementation.
+// Prints the time per sample, does not fail on timing. Disabled: run with
+// --gtest_also_run_disabled_tests.
+TEST(MotionMath_Test, DISABLED_Benchmark)
+{
+    static constexpr uint8_t  BURST       = 25;     // FIFO watermark
+    static constexpr uint32_t REPETITIONS = 1000;
+
+    const std::vector<MotionSampleRaw> raw = SphereSamples(16384.0, 32);
+    const size_t bursts = raw.size() / BURST;
+    std::vector<MotionSample> samples(raw.size());
+    volatile float sink = 0.0f;
+
+    const auto startFloat = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < REPETITIONS; r++)
+    {
+        float sum = 0.0f;
+        for (size_t i = 0; i < bursts * BURST; i++)
+        {
+            sum += ReferencePitch(raw[i]) + ReferenceRoll(raw[i]);
+        }
+        sink = sink + sum;
+    }
+    const auto startFixed = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < REPETITIONS; r++)
+    {
+        for (size_t b = 0; b < bursts; b++)
+        {
+            MotionMath::CalculateMotionSamples(&raw[b * BURST], &samples[b * BURST], BURST);
+        }
+        sink = sink + samples[r % samples.size()].pitch;
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double count = static_cast<double>(REPETITIONS) * bursts * BURST;
+    const double nsFloat = std::chrono::duration<double, std::nano>(startFixed - startFloat).count() / count;
+    const double nsFixed = std::chrono::duration<double, std::nano>(end - startFixed).count() / count;
+
+    std::printf("[ BENCH    ] float: %.1f ns/sample, Q15 batch: %.1f ns/sample\n", nsFloat, nsFixed);
+    RecordProperty("ns_per_sample_float", std::to_string(nsFloat));
+    RecordProperty("ns_per_sample_q15",   std::to_string(nsFixed));
+}
+
+
+} // namespace
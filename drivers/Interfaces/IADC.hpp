@@ -23,7 +23,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 
 
 /************************************************************************/
@@ -33,7 +33,7 @@ class IADC
 {
 public:
     virtual bool GetValue(uint16_t& value) = 0;
-    virtual bool GetValueInterrupt(const std::function<void(uint16_t)>& handler) = 0;
+    virtual bool GetValueInterrupt(const Delegate<void(uint16_t)>& handler) = 0;
 };
 
 
@@ -23,7 +23,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 
 
 /************************************************************************/
@@ -32,7 +32,7 @@
 class IGenericTimer
 {
 public:
-    virtual bool Start(const std::function<void()>& handler) = 0;
+    virtual bool Start(const Delegate<void()>& handler) = 0;
     virtual bool IsStarted() const = 0;
     virtual bool Stop() = 0;
 };
@@ -35,7 +35,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 
 
 /************************************************************************/
@@ -44,11 +44,11 @@
 class II2C
 {
 public:
-    virtual bool WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
+    virtual bool WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
 
-    virtual bool WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler) = 0;
+    virtual bool WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) = 0;
 
     virtual bool WriteBlocking(uint8_t slave, const uint8_t* src, uint16_t length) = 0;
     virtual bool ReadBlocking(uint8_t slave, uint8_t* dest, uint16_t length) = 0;
@@ -35,7 +35,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 
 
 /************************************************************************/
@@ -44,11 +44,11 @@
 class IUSART
 {
 public:
-    virtual bool WriteDma(const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadDma(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true) = 0;
+    virtual bool WriteDma(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadDma(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true) = 0;
 
-    virtual bool WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler) = 0;
-    virtual bool ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true) = 0;
+    virtual bool WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) = 0;
+    virtual bool ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true) = 0;
 
     virtual bool WriteBlocking(const uint8_t* src, uint16_t length) = 0;
     virtual bool ReadBlocking(uint8_t* dest, uint16_t length) = 0;
@@ -0,0 +1,605 @@
+/**
+ * \file    SPI_arbiter.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   SPI_arbiter
+ *
+ * \brief   Priority-aware arbiter to share a SPI (master) bus between
+ *          multiple clients.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/arbiters/SPI
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 2.2
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "arbiters/SPI/SPI_arbiter.hpp"
+#include "drivers/Pin/Pin.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Constructor, registers the client at the arbiter.
+ * \param   arbiter     The arbiter of the bus the device is on.
+ * \param   priority    The priority class of the client.
+ * \param   chipSelect  ChipSelect of the device, set low when the client is
+ *                      granted the bus. Use nullptr if the client handles
+ *                      the ChipSelect itself (for example with Transfer
+ *                      ChipSelect segments).
+ * \note    Asserts if more than SPI_ARBITER_MAX_CLIENTS are registered.
+ */
+SPI_arbiter::Client::Client(SPI_arbiter& arbiter, Priority priority, Pin* chipSelect) :
+    mArbiter(arbiter),
+    mPriority(priority),
+    mChipSelect(chipSelect),
+    mStatistics(),
+    mPending(false),
+    mType(RequestType::Invalid),
+    mSrc(nullptr),
+    mDest(nullptr),
+    mLength(0),
+    mSegments(nullptr),
+    mCount(0),
+    mSequence(0),
+    mRequestTime(0),
+    mRequestGrants(0)
+{
+    bool result = mArbiter.Register(*this);
+    ASSERT(result);
+}
+
+/**
+ * \brief   Get the priority class of the client.
+ * \returns The priority class of the client.
+ */
+SPI_arbiter::Priority SPI_arbiter::Client::GetPriority() const
+{
+    return mPriority;
+}
+
+/**
+ * \brief   Get the counters of the client.
+ * \returns The counters of the client.
+ */
+const SPI_arbiter::Statistics& SPI_arbiter::Client::GetStatistics() const
+{
+    return mStatistics;
+}
+
+/**
+ * \brief   Reset the counters of the client.
+ */
+void SPI_arbiter::Client::ResetStatistics()
+{
+    const uint32_t prim = EnterCritical();
+    mStatistics = {};
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Queue a Transfer, started when the client is granted the bus.
+ * \param   segments    Pointer to the list of segments to execute.
+ * \param   count       Number of segments in the list.
+ * \param   handler     Callback to call when the Transfer is done, with true
+ *                      if all segments are done, else false.
+ * \returns True if the request is accepted, else false. Returns false if a
+ *          previous request of this client is still pending, or the list
+ *          has no data segment.
+ * \note    Once accepted the handler is always called, also when the
+ *          Transfer could not be started after waiting for the bus: then
+ *          with false.
+ */
+bool SPI_arbiter::Client::Transfer(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler)
+{
+    EXPECT(segments);
+    EXPECT(count > 0);
+
+    if (segments == nullptr)                    { return false; }
+    if (count == 0)                             { return false; }
+    if (!SPISegment::HasData(segments, count))  { return false; }
+    if (mPending)                               { mStatistics.rejected++; return false; }
+
+    mSegments        = segments;
+    mCount           = count;
+    mTransferHandler = handler;
+
+    return Request(RequestType::Transfer, nullptr, nullptr, 0, nullptr);
+}
+
+/**
+ * \brief   Queue a WriteDMA, started when the client is granted the bus.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   length      Length of the data to write in bytes.
+ * \param   handler     Callback to call when write completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::WriteDMA(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::WriteDMA, src, nullptr, length, handler);
+}
+
+/**
+ * \brief   Queue a WriteReadDMA, started when the client is granted the bus.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to write and read in bytes.
+ * \param   handler     Callback to call when write and read completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::WriteReadDMA, src, dest, length, handler);
+}
+
+/**
+ * \brief   Queue a ReadDMA, started when the client is granted the bus.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to read in bytes.
+ * \param   handler     Callback to call when read completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::ReadDMA(uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::ReadDMA, nullptr, dest, length, handler);
+}
+
+/**
+ * \brief   Queue a WriteInterrupt, started when the client is granted the bus.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   length      Length of the data to write in bytes.
+ * \param   handler     Callback to call when write completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::WriteInterrupt, src, nullptr, length, handler);
+}
+
+/**
+ * \brief   Queue a WriteReadInterrupt, started when the client is granted the bus.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to write and read in bytes.
+ * \param   handler     Callback to call when write and read completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::WriteReadInterrupt, src, dest, length, handler);
+}
+
+/**
+ * \brief   Queue a ReadInterrupt, started when the client is granted the bus.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to read in bytes.
+ * \param   handler     Callback to call when read completed.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
+{
+    return Request(RequestType::ReadInterrupt, nullptr, dest, length, handler);
+}
+
+/**
+ * \brief   Write data, blocking. Waits until the bus is free.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   length      Length of the data to write in bytes.
+ * \returns True if the data could be written, else false.
+ */
+bool SPI_arbiter::Client::WriteBlocking(const uint8_t* src, uint16_t length)
+{
+    mArbiter.Claim(*this);
+    bool result = mArbiter.mSpi.WriteBlocking(src, length);
+    mArbiter.Release();
+
+    return result;
+}
+
+/**
+ * \brief   Write and read data, blocking. Waits until the bus is free.
+ * \param   src         Pointer to buffer with data to write.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to write and read in bytes.
+ * \returns True if the data could be written and read, else false.
+ */
+bool SPI_arbiter::Client::WriteReadBlocking(const uint8_t* src, uint8_t* dest, uint16_t length)
+{
+    mArbiter.Claim(*this);
+    bool result = mArbiter.mSpi.WriteReadBlocking(src, dest, length);
+    mArbiter.Release();
+
+    return result;
+}
+
+/**
+ * \brief   Read data, blocking. Waits until the bus is free.
+ * \param   dest        Pointer to buffer to store the read data.
+ * \param   length      Length of the data to read in bytes.
+ * \returns True if the data could be read, else false.
+ */
+bool SPI_arbiter::Client::ReadBlocking(uint8_t* dest, uint16_t length)
+{
+    mArbiter.Claim(*this);
+    bool result = mArbiter.mSpi.ReadBlocking(dest, length);
+    mArbiter.Release();
+
+    return result;
+}
+
+/**
+ * \brief   Constructor, prepares the arbiter for use.
+ * \param   spi     The (initialized) SPI bus to share.
+ * \param   clock   Optional clock to measure the wait time of requests
+ *                  with, for example returning DWT->CYCCNT or HAL_GetTick().
+ */
+SPI_arbiter::SPI_arbiter(ISPI& spi, const Delegate<uint32_t()>& clock) :
+    mSpi(spi),
+    mClock(clock),
+    mClients(),
+    mClientCount(0),
+    mActive(nullptr),
+    mBusy(false),
+    mSequence(0),
+    mGrants(0),
+    mMaxQueueDepth(0)
+{}
+
+/**
+ * \brief   Indicate if the bus is in use.
+ * \returns True if a client is granted the bus, else false.
+ */
+bool SPI_arbiter::IsBusy() const
+{
+    return mBusy;
+}
+
+/**
+ * \brief   Get the number of requests waiting for the bus.
+ * \returns The number of requests waiting for the bus.
+ */
+uint8_t SPI_arbiter::GetQueueDepth() const
+{
+    uint8_t depth = 0;
+
+    for (uint8_t i = 0; i < mClientCount; i++)
+    {
+        if (mClients[i]->mPending && (mClients[i] != mActive)) { depth++; }
+    }
+    return depth;
+}
+
+/**
+ * \brief   Get the highest number of requests waiting for the bus.
+ * \returns The highest number of requests waiting for the bus.
+ */
+uint8_t SPI_arbiter::GetMaxQueueDepth() const
+{
+    return mMaxQueueDepth;
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Store the request of the client and queue it.
+ * \param   type        The type of request.
+ * \param   src         Pointer to buffer with data to write, if any.
+ * \param   dest        Pointer to buffer to store the read data, if any.
+ * \param   length      Length of the data in bytes.
+ * \param   handler     Callback to call when the request is done.
+ * \returns True if the request is accepted, else false.
+ */
+bool SPI_arbiter::Client::Request(RequestType type, const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
+{
+    if (type != RequestType::Transfer)
+    {
+        EXPECT(length > 0);
+
+        if (length == 0) { return false; }
+        if (mPending)    { mStatistics.rejected++; return false; }
+
+        mTransferHandler = nullptr;
+    }
+
+    mType    = type;
+    mSrc     = src;
+    mDest    = dest;
+    mLength  = length;
+    mHandler = handler;
+
+    return mArbiter.Enqueue(*this);
+}
+
+/**
+ * \brief   Add a client to the administration.
+ * \param   client  The client to add.
+ * \returns True if the client could be added, else false.
+ */
+bool SPI_arbiter::Register(Client& client)
+{
+    if (mClientCount >= SPI_ARBITER_MAX_CLIENTS) { return false; }
+
+    mClients[mClientCount++] = &client;
+    return true;
+}
+
+/**
+ * \brief   Queue the request of a client, start it if the bus is free.
+ * \param   client  The client with a new request.
+ * \returns True if the request is queued or started, else false. Returns
+ *          false if the request could not be started on the free bus.
+ */
+bool SPI_arbiter::Enqueue(Client& client)
+{
+    const uint32_t prim = EnterCritical();
+
+    client.mPending       = true;
+    client.mSequence      = mSequence++;
+    client.mRequestTime   = Now();
+    client.mRequestGrants = mGrants;
+
+    const bool startNow = !mBusy;
+    if (startNow)
+    {
+        mBusy   = true;
+        mActive = &client;
+    }
+
+    const uint8_t depth = GetQueueDepth();
+    if (depth > mMaxQueueDepth) { mMaxQueueDepth = depth; }
+
+    ExitCritical(prim);
+
+    if (startNow)
+    {
+        Grant(client);
+        if (!Start(client))
+        {
+            Abort(client);
+            Dispatch(Advance());
+            return false;
+        }
+    }
+    return true;
+}
+
+/**
+ * \brief   Wait until the bus is free, then grant it to the client.
+ * \param   client  The client doing a blocking call.
+ */
+void SPI_arbiter::Claim(Client& client)
+{
+    client.mRequestTime   = Now();
+    client.mRequestGrants = mGrants;
+
+    for (;;)
+    {
+        const uint32_t prim = EnterCritical();
+        if (!mBusy)
+        {
+            mBusy   = true;
+            mActive = &client;
+            ExitCritical(prim);
+            break;
+        }
+        ExitCritical(prim);
+
+        __NOP();    // Blocking wait until we can use the bus, prevent loop from being optimized away.
+    }
+
+    Grant(client);
+}
+
+/**
+ * \brief   Release the bus after a blocking call, start the next request.
+ */
+void SPI_arbiter::Release()
+{
+    if (mActive->mChipSelect != nullptr)
+    {
+        mActive->mChipSelect->Set(Level::HIGH);
+    }
+
+    Dispatch(Advance());
+}
+
+/**
+ * \brief   Find the request to grant the bus to next.
+ * \details Highest priority first, of equal priority the oldest request.
+ * \returns The client to grant the bus to, nullptr if none is waiting.
+ */
+SPI_arbiter::Client* SPI_arbiter::SelectNext() const
+{
+    Client* next = nullptr;
+
+    for (uint8_t i = 0; i < mClientCount; i++)
+    {
+        Client* client = mClients[i];
+
+        if (!client->mPending) { continue; }
+
+        if ((next == nullptr) ||
+            (client->mPriority < next->mPriority) ||
+            ((client->mPriority == next->mPriority) && (static_cast<int32_t>(client->mSequence - next->mSequence) < 0)))
+        {
+            next = client;
+        }
+    }
+    return next;
+}
+
+/**
+ * \brief   Hand the bus to the next waiting request, or mark it free.
+ * \returns The client granted the bus, nullptr if the bus is free.
+ */
+SPI_arbiter::Client* SPI_arbiter::Advance()
+{
+    const uint32_t prim = EnterCritical();
+
+    Client* next = SelectNext();
+
+    mActive = next;
+    mBusy   = (next != nullptr);
+
+    ExitCritical(prim);
+
+    return next;
+}
+
+/**
+ * \brief   Update the counters of the client granted the bus and set its
+ *          ChipSelect low.
+ * \param   client  The client granted the bus.
+ */
+void SPI_arbiter::Grant(Client& client)
+{
+    Statistics& statistics = client.mStatistics;
+
+    const uint32_t wait       = Now() - client.mRequestTime;
+    const uint32_t waitGrants = mGrants - client.mRequestGrants;
+
+    statistics.requests++;
+    statistics.totalWait += wait;
+    if (wait > statistics.maxWait)             { statistics.maxWait = wait; }
+    if (waitGrants > statistics.maxWaitGrants) { statistics.maxWaitGrants = waitGrants; }
+
+    mGrants++;
+
+    if (client.mChipSelect != nullptr)
+    {
+        client.mChipSelect->Set(Level::LOW);
+    }
+}
+
+/**
+ * \brief   Start queued requests until one is running or none is left.
+ * \param   client  The client granted the bus, nullptr if the bus is free.
+ */
+void SPI_arbiter::Dispatch(Client* client)
+{
+    while (client != nullptr)
+    {
+        Grant(*client);
+        if (Start(*client)) { return; }
+
+        Abort(*client);
+
+        // An accepted request is always finished: report it failed
+        const Delegate<void()>     handler         = client->mHandler;
+        const Delegate<void(bool)> transferHandler = client->mTransferHandler;
+        if (transferHandler)
+        {
+            transferHandler(false);
+        }
+        else if (handler)
+        {
+            handler();
+        }
+
+        client = Advance();
+    }
+}
+
+/**
+ * \brief   Start the request of the client on the bus.
+ * \param   client  The client granted the bus.
+ * \returns True if the request could be started, else false.
+ */
+bool SPI_arbiter::Start(Client& client)
+{
+    // Reroute the done callback to the arbiter
+    switch (client.mType)
+    {
+        case Client::RequestType::Transfer:           return mSpi.Transfer(client.mSegments, client.mCount, [this](bool result) { this->Completed(result); });
+        case Client::RequestType::WriteDMA:           return mSpi.WriteDMA(client.mSrc, client.mLength, [this]() { this->Completed(true); });
+        case Client::RequestType::WriteReadDMA:       return mSpi.WriteReadDMA(client.mSrc, client.mDest, client.mLength, [this]() { this->Completed(true); });
+        case Client::RequestType::ReadDMA:            return mSpi.ReadDMA(client.mDest, client.mLength, [this]() { this->Completed(true); });
+        case Client::RequestType::WriteInterrupt:     return mSpi.WriteInterrupt(client.mSrc, client.mLength, [this]() { this->Completed(true); });
+        case Client::RequestType::WriteReadInterrupt: return mSpi.WriteReadInterrupt(client.mSrc, client.mDest, client.mLength, [this]() { this->Completed(true); });
+        case Client::RequestType::ReadInterrupt:      return mSpi.ReadInterrupt(client.mDest, client.mLength, [this]() { this->Completed(true); });
+        default: EXPECT(false); return false;   // Invalid request type
+    }
+}
+
+/**
+ * \brief   Drop the request of the client which could not be started, for
+ *          instance after a bus error: counted as failed.
+ * \details The handler of the client is not called here: it is called by
+ *          Dispatch() when the request was queued. Started directly the
+ *          request returns false instead.
+ * \param   client  The client granted the bus.
+ */
+void SPI_arbiter::Abort(Client& client)
+{
+    if (client.mChipSelect != nullptr)
+    {
+        client.mChipSelect->Set(Level::HIGH);
+    }
+
+    client.mStatistics.failed++;
+    client.mPending = false;
+}
+
+/**
+ * \brief   ISR: the request granted the bus is done.
+ * \details Sets the ChipSelect high and calls the handler of the client,
+ *          then grants the bus to the next waiting request. A request done
+ *          from the handler is queued with the others.
+ * \param   result  True if the request succeeded, false if a Transfer
+ *                  failed.
+ */
+void SPI_arbiter::Completed(bool result)
+{
+    Client* client = mActive;
+    if (client == nullptr) { return; }
+
+    if (client->mChipSelect != nullptr)
+    {
+        client->mChipSelect->Set(Level::HIGH);
+    }
+
+    if (!result)
+    {
+        client->mStatistics.failed++;
+    }
+
+    const Delegate<void()>     handler         = client->mHandler;
+    const Delegate<void(bool)> transferHandler = client->mTransferHandler;
+    client->mPending = false;
+    mActive = nullptr;      // Bus stays busy until Advance()
+
+    if (transferHandler)
+    {
+        transferHandler(result);
+    }
+    else if (handler)
+    {
+        handler();
+    }
+
+    Dispatch(Advance());
+}
+
+/**
+ * \brief   Get the current time of the clock.
+ * \returns The current time, 0 if no clock is set.
+ */
+uint32_t SPI_arbiter::Now() const
+{
+    return (mClock) ? mClock() : 0;
+}
@@ -0,0 +1,206 @@
+/**
+ * \file    SPI_arbiter.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   SPI_arbiter
+ *
+ * \brief   Priority-aware arbiter to share a SPI (master) bus between
+ *          multiple clients.
+ *
+ * \details Each device on the bus gets a SPI_arbiter::Client, which
+ *          implements ISPI and can be handed to a component (like LIS3DSH)
+ *          as if it were the bus itself. A client has a priority class and
+ *          (optionally) owns its ChipSelect: the arbiter sets it low when the
+ *          client is granted the bus and high when its request is done.
+ *
+ *          Each client can have one asynchronous request pending. When the
+ *          bus becomes free the pending request of the client with the
+ *          highest priority is started, requests of the same priority are
+ *          started in order of arrival. The bus is not preempted: the worst
+ *          case wait of a High priority client is one transaction of
+ *          another client, keep requests of Low priority clients short to
+ *          bound that latency.
+ *
+ *          An accepted request is always finished with its handler, also
+ *          when it could not be started after waiting for the bus: a
+ *          Transfer handler is called with false, other requests count as
+ *          failed in the Statistics.
+ *
+ *          Per client the number of requests, the wait from request to bus
+ *          grant (in ticks of an optional clock) and the number of other
+ *          transactions granted while waiting are counted.
+ *
+ * \note    Blocking calls wait (spin) until the bus is free, do not call them
+ *          from ISR context.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/arbiters/SPI
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 2.1
+ * \date    10-2026
+ */
+
+#ifndef SPI_ARBITER_HPP_
+#define SPI_ARBITER_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "interfaces/ISPI.hpp"
+#include "utility/Delegate/Delegate.hpp"
+
+
+/************************************************************************/
+/* Forward declarations                                                 */
+/************************************************************************/
+class Pin;
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     SPI_ARBITER_MAX_CLIENTS
+ * \brief   Maximum number of clients sharing one SPI bus.
+ */
+#define SPI_ARBITER_MAX_CLIENTS     4
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class SPI_arbiter
+{
+public:
+    /**
+     * \enum    Priority
+     * \brief   Priority class of a client, High is granted the bus first.
+     */
+    enum class Priority : uint8_t
+    {
+        High,
+        Normal,
+        Low
+    };
+
+    /**
+     * \struct  Statistics
+     * \brief   Counters kept per client.
+     */
+    struct Statistics
+    {
+        uint32_t requests;          ///< Number of requests granted the bus.
+        uint32_t rejected;          ///< Requests rejected, previous request still pending.
+        uint32_t failed;            ///< Requests which could not be started on the bus, or Transfers which failed.
+        uint32_t maxWait;           ///< Longest wait from request to bus grant, in clock ticks.
+        uint32_t totalWait;         ///< Sum of all waits, in clock ticks.
+        uint32_t maxWaitGrants;     ///< Most transactions of other clients granted while waiting.
+    };
+
+    /**
+     * \class   Client
+     * \brief   Access to the shared bus for a single device.
+     */
+    class Client final : public ISPI
+    {
+    public:
+        Client(SPI_arbiter& arbiter, Priority priority, Pin* chipSelect = nullptr);
+        virtual ~Client() {};
+
+        Priority GetPriority() const;
+        const Statistics& GetStatistics() const;
+        void ResetStatistics();
+
+        bool Transfer(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler) override;
+
+        bool WriteDMA(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+        bool WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+        bool ReadDMA(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+
+        bool WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+        bool WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+        bool ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+
+        bool WriteBlocking(const uint8_t* src, uint16_t length) override;
+        bool WriteReadBlocking(const uint8_t* src, uint8_t* dest, uint16_t length) override;
+        bool ReadBlocking(uint8_t* dest, uint16_t length) override;
+
+    private:
+        friend class SPI_arbiter;
+
+        /**
+         * \enum    RequestType
+         * \brief   Available request types for SPI.
+         */
+        enum class RequestType : uint8_t
+        {
+            Invalid,
+            Transfer,
+            WriteDMA,
+            WriteReadDMA,
+            ReadDMA,
+            WriteInterrupt,
+            WriteReadInterrupt,
+            ReadInterrupt,
+        };
+
+        SPI_arbiter&         mArbiter;
+        Priority             mPriority;
+        Pin*                 mChipSelect;
+        Statistics           mStatistics;
+        bool                 mPending;
+        RequestType          mType;
+        const uint8_t*       mSrc;
+        uint8_t*             mDest;
+        uint16_t             mLength;
+        const SPISegment*    mSegments;
+        uint8_t              mCount;
+        Delegate<void()>     mHandler;
+        Delegate<void(bool)> mTransferHandler;
+        uint32_t             mSequence;
+        uint32_t             mRequestTime;
+        uint32_t             mRequestGrants;
+
+        bool Request(RequestType type, const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler);
+    };
+
+    explicit SPI_arbiter(ISPI& spi, const Delegate<uint32_t()>& clock = nullptr);
+    virtual ~SPI_arbiter() {};
+
+    bool IsBusy() const;
+    uint8_t GetQueueDepth() const;
+    uint8_t GetMaxQueueDepth() const;
+
+private:
+    ISPI&                mSpi;
+    Delegate<uint32_t()> mClock;
+    Client*              mClients[SPI_ARBITER_MAX_CLIENTS];
+    uint8_t              mClientCount;
+    Client*              mActive;
+    volatile bool        mBusy;
+    uint32_t             mSequence;
+    uint32_t             mGrants;
+    uint8_t              mMaxQueueDepth;
+
+    bool Register(Client& client);
+    bool Enqueue(Client& client);
+    void Claim(Client& client);
+    void Release();
+    Client* SelectNext() const;
+    Client* Advance();
+    void Grant(Client& client);
+    void Dispatch(Client* client);
+    bool Start(Client& client);
+    void Abort(Client& client);
+    void Completed(bool result);
+    uint32_t Now() const;
+};
+
+
+#endif  // SPI_ARBITER_HPP_
@@ -14,8 +14,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    06-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef FAKE_HI_M1388AR_HPP_
@@ -25,7 +25,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "drivers/Pin/Pin.hpp"
@@ -75,6 +75,16 @@ public:
         }
         return false;
     }
+    bool WriteFrameAsync(const uint8_t* src, const Delegate<void()>& handler = nullptr)
+    {
+        if ((src != nullptr) && mInitialized)
+        {
+            if (handler) { handler(); }
+            return true;
+        }
+        return false;
+    }
+    bool IsBusy() const { return false; }
 
 private:
     bool mInitialized;
@@ -14,8 +14,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -30,13 +30,13 @@
 /************************************************************************/
 //static constexpr uint8_t NO_OP        = 0x00;
 static constexpr uint8_t DIGIT_0      = 0x01;
-static constexpr uint8_t DIGIT_1      = 0x02;
-static constexpr uint8_t DIGIT_2      = 0x03;
-static constexpr uint8_t DIGIT_3      = 0x04;
-static constexpr uint8_t DIGIT_4      = 0x05;
-static constexpr uint8_t DIGIT_5      = 0x06;
-static constexpr uint8_t DIGIT_6      = 0x07;
-static constexpr uint8_t DIGIT_7      = 0x08;
+//static constexpr uint8_t DIGIT_1      = 0x02;
+//static constexpr uint8_t DIGIT_2      = 0x03;
+//static constexpr uint8_t DIGIT_3      = 0x04;
+//static constexpr uint8_t DIGIT_4      = 0x05;
+//static constexpr uint8_t DIGIT_5      = 0x06;
+//static constexpr uint8_t DIGIT_6      = 0x07;
+//static constexpr uint8_t DIGIT_7      = 0x08;
 static constexpr uint8_t DECODE_MODE  = 0x09;
 static constexpr uint8_t INTENSITY    = 0x0A;
 static constexpr uint8_t SCAN_LIMIT   = 0x0B;
@@ -56,7 +56,12 @@ static constexpr uint8_t SHUTDOWN     = 0x0C;
 HI_M1388AR::HI_M1388AR(ISPI& spi, PinIdPort chipSelect) :
     mSpi(spi),
     mChipSelect(chipSelect, Level::HIGH),
-    mInitialized(false)
+    mInitialized(false),
+    mShadow{},
+    mValidLines(0),
+    mFrame{},
+    mFrameLines(0),
+    mFrameBusy(false)
 { }
 
 /**
@@ -76,6 +81,8 @@ bool HI_M1388AR::Init(const IConfig& config)
 {
     mChipSelect.Configure(Level::HIGH);
 
+    mValidLines = 0;                            // Display content unknown
+
     bool result = Configure(config);
     EXPECT(result);
 
@@ -114,6 +121,7 @@ bool HI_M1388AR::Sleep()
     mChipSelect.Configure(PullUpDown::HIGHZ);
 
     mInitialized = false;
+    mValidLines  = 0;
 
     return result;
 }
@@ -138,9 +146,11 @@ bool HI_M1388AR::ClearDisplay()
 
 /**
  * \brief   Write all 8 lines of the 8x8 matrix to the display.
- * \details Buffer of length 8, has 1 line per byte.
+ * \details Buffer of length 8, has 1 line per byte. Only the lines which
+ *          differ from the lines last written are sent (blocking).
  * \param   src     Pointer to 8 byte long buffer with digit values.
  * \returns True if lines could be written, else false.
+ * \note    Returns false while a WriteFrameAsync() is ongoing.
  */
 bool HI_M1388AR::WriteDigits(const uint8_t* src)
 {
@@ -148,24 +158,92 @@ bool HI_M1388AR::WriteDigits(const uint8_t* src)
 
     if (src == nullptr) { return false; }
 
-    if (mInitialized)
+    if (mInitialized && !mFrameBusy)
     {
-        bool result = false;
-
-        result  = WriteRegister(DIGIT_0, *src++);
-        result &= WriteRegister(DIGIT_1, *src++);
-        result &= WriteRegister(DIGIT_2, *src++);
-        result &= WriteRegister(DIGIT_3, *src++);
-        result &= WriteRegister(DIGIT_4, *src++);
-        result &= WriteRegister(DIGIT_5, *src++);
-        result &= WriteRegister(DIGIT_6, *src++);
-        result &= WriteRegister(DIGIT_7, *src  );
+        bool result = true;
+
+        const uint8_t lines = PrepareFrame(src);
+        for (uint8_t i = 0; i < lines; i++)
+        {
+            const uint8_t reg   = mFrame[i * 2];
+            const uint8_t value = mFrame[i * 2 + 1];
+            const uint8_t line  = reg - DIGIT_0;
+
+            if (WriteRegister(reg, value))
+            {
+                mShadow[line] = value;
+                mValidLines  |= (1 << line);
+            }
+            else
+            {
+                mValidLines  &= ~(1 << line);   // Unknown, rewrite next time
+                result = false;
+            }
+        }
 
         return result;
     }
     return false;
 }
 
+/**
+ * \brief   Write all 8 lines of the 8x8 matrix to the display, asynchronous.
+ * \details Buffer of length 8, has 1 line per byte. Only the lines which
+ *          differ from the lines last written are sent, as one SPI Transfer
+ *          (DMA). The lines are copied: src can be reused directly.
+ * \param   src     Pointer to 8 byte long buffer with digit values.
+ * \param   handler Handler to call when the frame is done, can be nullptr.
+ *                  Called directly if no line changed. Also called if the
+ *                  SPI Transfer failed: the lines are then written again
+ *                  with the next frame.
+ * \returns True if the frame could be written or started, else false.
+ * \note    Returns false while a previous frame is still being written.
+ */
+bool HI_M1388AR::WriteFrameAsync(const uint8_t* src, const Delegate<void()>& handler)
+{
+    EXPECT(src);
+
+    if (src == nullptr) { return false; }
+    if (!mInitialized)  { return false; }
+    if (mFrameBusy)     { return false; }
+
+    const uint8_t lines = PrepareFrame(src);
+    if (lines == 0)
+    {
+        if (handler) { handler(); }
+        return true;
+    }
+
+    for (uint8_t i = 0; i < lines; i++)
+    {
+        mFrameSegments[i * 3]     = SPISegment::ChipSelectAssert(mChipSelect);
+        mFrameSegments[i * 3 + 1] = SPISegment::Write(&mFrame[i * 2], 2);
+        mFrameSegments[i * 3 + 2] = SPISegment::ChipSelectDeassert(mChipSelect);   // Latches the line
+    }
+
+    mFrameLines   = lines;
+    mFrameHandler = handler;
+    mFrameBusy    = true;
+
+    bool result = mSpi.Transfer(mFrameSegments, lines * 3, [this](bool written) { this->FrameCompleted(written); } );
+    EXPECT(result);
+
+    if (!result)
+    {
+        mFrameBusy = false;
+    }
+    return result;
+}
+
+/**
+ * \brief   Indicate if a frame is being written asynchronously.
+ * \returns True if a frame is being written, else false.
+ */
+bool HI_M1388AR::IsBusy() const
+{
+    return mFrameBusy;
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -205,6 +283,62 @@ bool HI_M1388AR::Configure(const IConfig& config)
     return result;
 }
 
+/**
+ * \brief   Collect the lines which differ from the lines last written as
+ *          register/value pairs.
+ * \param   src     Pointer to 8 byte long buffer with digit values.
+ * \returns The number of lines to write.
+ */
+uint8_t HI_M1388AR::PrepareFrame(const uint8_t* src)
+{
+    uint8_t lines = 0;
+
+    for (uint8_t line = 0; line < HI_M1388AR_LINES; line++)
+    {
+        const bool valid = (mValidLines & (1 << line));
+        if (valid && (mShadow[line] == src[line])) { continue; }
+
+        mFrame[lines * 2]     = DIGIT_0 + line;
+        mFrame[lines * 2 + 1] = src[line];
+        lines++;
+    }
+
+    return lines;
+}
+
+/**
+ * \brief   ISR: frame written, update the shadow lines and call the handler.
+ * \details If the Transfer failed the lines are unknown: they are marked
+ *          invalid, the next frame writes them again.
+ * \param   written     True if the Transfer succeeded, else false.
+ */
+void HI_M1388AR::FrameCompleted(bool written)
+{
+    for (uint8_t i = 0; i < mFrameLines; i++)
+    {
+        const uint8_t line = mFrame[i * 2] - DIGIT_0;
+
+        if (written)
+        {
+            mShadow[line] = mFrame[i * 2 + 1];
+            mValidLines  |= (1 << line);
+        }
+        else
+        {
+            mValidLines  &= ~(1 << line);
+        }
+    }
+
+    const Delegate<void()> handler = mFrameHandler;
+    mFrameLines = 0;
+    mFrameBusy  = false;
+
+    if (handler)
+    {
+        handler();
+    }
+}
+
 /**
  * \brief   Write value to register using blocking SPI call.
  * \param   reg     The register to write to.
@@ -11,11 +11,16 @@
  *
  * \brief   Driver for the HI-M1388AR 8x8 LED matrix display.
  *
+ * \details A shadow copy of the 8 lines (digit registers) last sent is kept,
+ *          only lines which differ from it are written. WriteFrameAsync()
+ *          writes the changed lines as a single (DMA) SPI Transfer, each
+ *          line with its own ChipSelect pulse to latch the register.
+ *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef HI_M1388AR_HPP_
@@ -25,12 +30,22 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "drivers/Pin/Pin.hpp"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     HI_M1388AR_LINES
+ * \brief   Number of lines (digit registers) of the 8x8 matrix.
+ */
+#define HI_M1388AR_LINES        8
+
+
 /************************************************************************/
 /* Class declaration                                                    */
 /************************************************************************/
@@ -63,13 +78,24 @@ public:
 
     bool ClearDisplay();
     bool WriteDigits(const uint8_t* src);
+    bool WriteFrameAsync(const uint8_t* src, const Delegate<void()>& handler = nullptr);
+    bool IsBusy() const;
 
 private:
-    ISPI& mSpi;
-    Pin   mChipSelect;
-    bool  mInitialized;
+    ISPI&            mSpi;
+    Pin              mChipSelect;
+    bool             mInitialized;
+    uint8_t          mShadow[HI_M1388AR_LINES];
+    uint8_t          mValidLines;
+    uint8_t          mFrame[HI_M1388AR_LINES * 2];
+    SPISegment       mFrameSegments[HI_M1388AR_LINES * 3];
+    uint8_t          mFrameLines;
+    volatile bool    mFrameBusy;
+    Delegate<void()> mFrameHandler;
 
     bool Configure(const IConfig& config);
+    uint8_t PrepareFrame(const uint8_t* src);
+    void FrameCompleted(bool written);
 
     bool WriteRegister(uint8_t reg, uint8_t value);
 };
@@ -0,0 +1,360 @@
+/**
+ * \file    HI-M1388AR_Animation.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   HI_M1388AR_Animation
+ *
+ * \brief   Frame based animations for the HI-M1388AR 8x8 LED matrix display.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "components/HI-M1388AR/HI-M1388AR_Animation.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include <cstring>
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+static constexpr uint16_t TRANSITION_STEPS = MATRIX_SIZE + 1;   // From, 7 in between, to
+static constexpr uint32_t MAX_STEPS        = 0xFFFF;
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Constructor.
+ * \param   display     The (initialized) display to show the frames on.
+ */
+HI_M1388AR_Animation::HI_M1388AR_Animation(HI_M1388AR& display) :
+    mDisplay(display),
+    mTimer(nullptr),
+    mFrames{},
+    mRendered(0),
+    mShown(0),
+    mMissedTicks(0),
+    mRenderDone(true),
+    mType(Type::None),
+    mTransition(Transition::Cut),
+    mFrom(nullptr),
+    mTo(nullptr),
+    mText(nullptr),
+    mTextLength(0),
+    mSequence(nullptr),
+    mStep(0),
+    mStepCount(0),
+    mRepeat(false)
+{ }
+
+/**
+ * \brief   Start showing frames, one frame per tick of the timer.
+ * \param   timer   Timer (initialized) with the frame rate as period.
+ * \returns True if the timer could be started, else false.
+ */
+bool HI_M1388AR_Animation::Start(IGenericTimer& timer)
+{
+    mTimer = &timer;
+    return mTimer->Start( [this]() { this->Tick(); } );
+}
+
+/**
+ * \brief   Stop showing frames, the display keeps the last frame shown.
+ * \returns True if the timer could be stopped, else false.
+ */
+bool HI_M1388AR_Animation::Stop()
+{
+    if (mTimer == nullptr) { return false; }
+
+    return mTimer->Stop();
+}
+
+/**
+ * \brief   Show a single item.
+ * \param   glyph   The item to show, 8 lines. Must remain valid while shown.
+ * \returns True if the item is accepted, else false.
+ */
+bool HI_M1388AR_Animation::ShowGlyph(const uint8_t* glyph)
+{
+    EXPECT(glyph);
+
+    if (glyph == nullptr) { return false; }
+
+    mTo = glyph;
+    return Play(Type::Glyph, 1, false);
+}
+
+/**
+ * \brief   Scroll text from right to left over the display, one column per
+ *          frame. The text starts and ends with a blank display.
+ * \param   text    Null terminated text (see GetGlyph()). Must remain valid
+ *                  while playing.
+ * \param   repeat  True to repeat the text, else false.
+ * \returns True if the text is accepted, else false.
+ */
+bool HI_M1388AR_Animation::ScrollText(const char* text, bool repeat)
+{
+    EXPECT(text);
+
+    if (text == nullptr) { return false; }
+
+    // Blank, text, blank: shifted column by column
+    const uint32_t length = std::strlen(text);
+    const uint32_t steps  = (length + 1) * MATRIX_SIZE + ((repeat) ? 0 : 1);
+    if (steps > MAX_STEPS) { return false; }
+
+    mText       = text;
+    mTextLength = static_cast<uint16_t>(length);
+    return Play(Type::Text, static_cast<uint16_t>(steps), repeat);
+}
+
+/**
+ * \brief   Play a transition from one item to the next.
+ * \param   from        The item shown first.
+ * \param   to          The item shown last.
+ * \param   transition  The transition to use.
+ * \returns True if the transition is accepted, else false.
+ */
+bool HI_M1388AR_Animation::PlayTransition(const uint8_t* from, const uint8_t* to, Transition transition)
+{
+    EXPECT(from);
+    EXPECT(to);
+
+    if (from == nullptr) { return false; }
+    if (to == nullptr)   { return false; }
+
+    mFrom       = from;
+    mTo         = to;
+    mTransition = transition;
+    return Play(Type::Transition, (transition == Transition::Cut) ? 1 : TRANSITION_STEPS, false);
+}
+
+/**
+ * \brief   Play a sequence of frames, one frame per tick.
+ * \param   frames  The frames to play. Must remain valid while playing.
+ * \param   count   The number of frames.
+ * \param   repeat  True to repeat the sequence, else false.
+ * \returns True if the sequence is accepted, else false.
+ */
+bool HI_M1388AR_Animation::PlaySequence(const uint8_t (*frames)[MATRIX_SIZE], uint8_t count, bool repeat)
+{
+    EXPECT(frames);
+    EXPECT(count > 0);
+
+    if (frames == nullptr) { return false; }
+    if (count == 0)        { return false; }
+
+    mSequence = frames;
+    return Play(Type::Sequence, count, repeat);
+}
+
+/**
+ * \brief   Render frames ahead into the free frame buffers.
+ * \details To be called often from the application loop, not from ISR.
+ */
+void HI_M1388AR_Animation::Render()
+{
+    while ((mType != Type::None) && ((mRendered - mShown) < HI_M1388AR_ANIMATION_FRAMES))
+    {
+        if (mStep >= mStepCount)
+        {
+            mStep = 0;                          // Repeat
+        }
+
+        RenderFrame(mStep, mFrames[mRendered % HI_M1388AR_ANIMATION_FRAMES]);
+        mStep++;
+        mRendered = mRendered + 1;
+
+        if ((mStep >= mStepCount) && !mRepeat)
+        {
+            mType       = Type::None;           // Last frame rendered
+            mRenderDone = true;
+        }
+    }
+}
+
+/**
+ * \brief   ISR: timer tick, hand the oldest rendered frame to the display.
+ */
+void HI_M1388AR_Animation::Tick()
+{
+    if (mShown == mRendered)
+    {
+        if (!mRenderDone)
+        {
+            mMissedTicks = mMissedTicks + 1;    // Render() did not keep up
+        }
+        return;
+    }
+
+    if (mDisplay.WriteFrameAsync(mFrames[mShown % HI_M1388AR_ANIMATION_FRAMES]))
+    {
+        mShown = mShown + 1;
+    }
+    else
+    {
+        mMissedTicks = mMissedTicks + 1;        // Display still busy, retry next tick
+    }
+}
+
+/**
+ * \brief   Indicate if the animation is done: all frames are shown.
+ * \returns True if the animation is done, else false. Repeating animations
+ *          are never done.
+ */
+bool HI_M1388AR_Animation::IsDone() const
+{
+    return mRenderDone && (mShown == mRendered);
+}
+
+/**
+ * \brief   Get the number of ticks on which no frame could be shown while
+ *          the animation was playing.
+ * \returns The number of missed ticks.
+ */
+uint32_t HI_M1388AR_Animation::GetMissedTicks() const
+{
+    return mMissedTicks;
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Start playing an animation: frames rendered for the previous
+ *          animation are dropped, the first frames are rendered.
+ * \param   type        The type of the animation.
+ * \param   stepCount   The number of frames of the animation.
+ * \param   repeat      True to repeat the animation, else false.
+ * \returns True.
+ */
+bool HI_M1388AR_Animation::Play(Type type, uint16_t stepCount, bool repeat)
+{
+    const uint32_t prim = EnterCritical();
+    mRendered   = mShown;
+    mRenderDone = false;
+    ExitCritical(prim);
+
+    mType      = type;
+    mStep      = 0;
+    mStepCount = stepCount;
+    mRepeat    = repeat;
+
+    Render();
+    return true;
+}
+
+/**
+ * \brief   Render a single frame of the animation playing.
+ * \param   step    The frame of the animation to render.
+ * \param   frame   The frame buffer to render into.
+ */
+void HI_M1388AR_Animation::RenderFrame(uint16_t step, uint8_t* frame) const
+{
+    switch (mType)
+    {
+        case Type::Glyph:      std::memcpy(frame, mTo, MATRIX_SIZE);             break;
+        case Type::Text:       RenderText(step, frame);                         break;
+        case Type::Transition: RenderTransition(step, frame);                   break;
+        case Type::Sequence:   std::memcpy(frame, mSequence[step], MATRIX_SIZE); break;
+        default: break;
+    }
+}
+
+/**
+ * \brief   Render a frame of scrolling text: the window 'step' columns into
+ *          the text, with a blank item before and after the text.
+ * \param   step    The frame of the animation to render.
+ * \param   frame   The frame buffer to render into.
+ */
+void HI_M1388AR_Animation::RenderText(uint16_t step, uint8_t* frame) const
+{
+    const uint16_t item    = step / MATRIX_SIZE;
+    const uint8_t  columns = step % MATRIX_SIZE;
+
+    Shift(GetTextItem(item), GetTextItem(item + 1), columns, frame);
+}
+
+/**
+ * \brief   Get an item of the scrolling text.
+ * \param   item    The item: 0 is the leading blank, then the characters of
+ *                  the text, followed by blanks.
+ * \returns The item to display.
+ */
+const uint8_t* HI_M1388AR_Animation::GetTextItem(uint16_t item) const
+{
+    if ((item == 0) || (item > mTextLength)) { return symbol_blank; }
+
+    return GetGlyph(mText[item - 1]);
+}
+
+/**
+ * \brief   Render a frame of a transition.
+ * \param   step    The frame of the animation to render, 0 is the first item.
+ * \param   frame   The frame buffer to render into.
+ */
+void HI_M1388AR_Animation::RenderTransition(uint16_t step, uint8_t* frame) const
+{
+    if ((mTransition == Transition::Cut) || (step >= MATRIX_SIZE))
+    {
+        std::memcpy(frame, mTo, MATRIX_SIZE);
+        return;
+    }
+
+    switch (mTransition)
+    {
+        case Transition::SlideLeft:
+            Shift(mFrom, mTo, step, frame);
+            break;
+        case Transition::SlideUp:
+            // Line 0 is the bottom line: the first item moves up 'step' lines
+            for (uint8_t line = 0; line < MATRIX_SIZE; line++)
+            {
+                frame[line] = (line >= step) ? mFrom[line - step] : mTo[line + MATRIX_SIZE - step];
+            }
+            break;
+        case Transition::Wipe:
+        {
+            const uint8_t mask = static_cast<uint8_t>((1 << step) - 1);     // Bit 0 is the leftmost column
+            for (uint8_t line = 0; line < MATRIX_SIZE; line++)
+            {
+                frame[line] = (mTo[line] & mask) | (mFrom[line] & ~mask);
+            }
+            break;
+        }
+        default:
+            break;
+    }
+}
+
+/**
+ * \brief   Render the window 'columns' to the right into two items next to
+ *          each other.
+ * \param   left    The left item.
+ * \param   right   The right item.
+ * \param   columns Number of columns to shift (0..7), 0 shows the left item.
+ * \param   frame   The frame buffer to render into.
+ */
+void HI_M1388AR_Animation::Shift(const uint8_t* left, const uint8_t* right, uint8_t columns, uint8_t* frame)
+{
+    for (uint8_t line = 0; line < MATRIX_SIZE; line++)
+    {
+        const uint16_t strip = left[line] | (right[line] << MATRIX_SIZE);  // Bit 0 is the leftmost column
+        frame[line] = static_cast<uint8_t>(strip >> columns);
+    }
+}
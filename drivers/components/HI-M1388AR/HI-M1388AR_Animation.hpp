@@ -0,0 +1,129 @@
+/**
+ * \file    HI-M1388AR_Animation.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   HI_M1388AR_Animation
+ *
+ * \brief   Frame based animations for the HI-M1388AR 8x8 LED matrix display.
+ *
+ * \details Animations (scrolling text, transitions, frame sequences) are
+ *          rendered ahead of time by Render(), called from the application
+ *          loop, into a ring of frame buffers. A timer tick hands the oldest
+ *          rendered frame to the display (WriteFrameAsync()): the cost in
+ *          the interrupt is a single frame handoff, independent of the
+ *          animation.
+ *
+ *          If no frame is rendered in time the tick is missed: the display
+ *          keeps the previous frame and the missed tick is counted.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef HI_M1388AR_ANIMATION_HPP_
+#define HI_M1388AR_ANIMATION_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "components/HI-M1388AR/HI-M1388AR.hpp"
+#include "components/HI-M1388AR/HI-M1388AR_Lib.hpp"
+#include "interfaces/IGenericTimer.hpp"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     HI_M1388AR_ANIMATION_FRAMES
+ * \brief   Number of frames rendered ahead, size of the ring of frame buffers.
+ */
+#define HI_M1388AR_ANIMATION_FRAMES     4
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class HI_M1388AR_Animation
+{
+public:
+    /**
+     * \enum    Transition
+     * \brief   Available transitions from one item to the next.
+     */
+    enum class Transition : uint8_t
+    {
+        Cut,                ///< Show the next item directly.
+        SlideLeft,          ///< Next item pushes in from the right, one column per frame.
+        SlideUp,            ///< Next item pushes in from the bottom, one line per frame.
+        Wipe                ///< Next item is revealed from the left, one column per frame.
+    };
+
+    explicit HI_M1388AR_Animation(HI_M1388AR& display);
+    virtual ~HI_M1388AR_Animation() {};
+
+    bool Start(IGenericTimer& timer);
+    bool Stop();
+
+    bool ShowGlyph(const uint8_t* glyph);
+    bool ScrollText(const char* text, bool repeat = false);
+    bool PlayTransition(const uint8_t* from, const uint8_t* to, Transition transition);
+    bool PlaySequence(const uint8_t (*frames)[MATRIX_SIZE], uint8_t count, bool repeat = false);
+
+    void Render();
+    void Tick();
+
+    bool IsDone() const;
+    uint32_t GetMissedTicks() const;
+
+private:
+    /**
+     * \enum    Type
+     * \brief   Type of the animation playing.
+     */
+    enum class Type : uint8_t
+    {
+        None,
+        Glyph,
+        Text,
+        Transition,
+        Sequence
+    };
+
+    HI_M1388AR&        mDisplay;
+    IGenericTimer*     mTimer;
+    uint8_t            mFrames[HI_M1388AR_ANIMATION_FRAMES][MATRIX_SIZE];
+    volatile uint32_t  mRendered;
+    volatile uint32_t  mShown;
+    volatile uint32_t  mMissedTicks;
+    volatile bool      mRenderDone;
+    Type               mType;
+    Transition         mTransition;
+    const uint8_t*     mFrom;
+    const uint8_t*     mTo;
+    const char*        mText;
+    uint16_t           mTextLength;
+    const uint8_t    (*mSequence)[MATRIX_SIZE];
+    uint16_t           mStep;
+    uint16_t           mStepCount;
+    bool               mRepeat;
+
+    bool Play(Type type, uint16_t stepCount, bool repeat);
+    void RenderFrame(uint16_t step, uint8_t* frame) const;
+    void RenderText(uint16_t step, uint8_t* frame) const;
+    const uint8_t* GetTextItem(uint16_t item) const;
+    void RenderTransition(uint16_t step, uint8_t* frame) const;
+    static void Shift(const uint8_t* left, const uint8_t* right, uint8_t columns, uint8_t* frame);
+};
+
+
+#endif  // HI_M1388AR_ANIMATION_HPP_
@@ -11,11 +11,15 @@
  * \brief   Library of constants representing contents for the HI-M1388AR 8x8
  *          LED matrix display.
  *
+ * \details Each item is 8 lines, line 0 is the bottom line. Bit 0 of a line
+ *          is the leftmost column. The glyph tables and GetGlyph() look up
+ *          items at compile time, instead of a switch per character.
+ *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/HI-M1388AR
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef HI_M1388AR_LIB_HPP_
@@ -109,8 +113,40 @@ constexpr uint8_t letter_z[MATRIX_SIZE] = { 0x3C, 0x0C, 0x18, 0x30, 0x3C, 0x00,
 constexpr uint8_t symbol_smiley[MATRIX_SIZE]        = { 0x3C, 0x42, 0x99, 0xA5, 0x81, 0xA5, 0x42, 0x3C };
 constexpr uint8_t symbol_sadface[MATRIX_SIZE]       = { 0x3C, 0x42, 0xA5, 0x99, 0x81, 0xA5, 0x42, 0x3C };
 constexpr uint8_t symbol_question_mark[MATRIX_SIZE] = { 0x18, 0x00, 0x18, 0x38, 0x60, 0x66, 0x3C, 0x00 };
+constexpr uint8_t symbol_blank[MATRIX_SIZE]         = { 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00, 0x00 };
+
+// Glyph tables
+constexpr const uint8_t* glyph_digits[10] = { digit_zero, digit_one, digit_two, digit_three, digit_four,
+                                              digit_five, digit_six, digit_seven, digit_eight, digit_nine };
+
+constexpr const uint8_t* glyph_capitals[26] = { letter_A, letter_B, letter_C, letter_D, letter_E, letter_F, letter_G,
+                                                letter_H, letter_I, letter_J, letter_K, letter_L, letter_M, letter_N,
+                                                letter_O, letter_P, letter_Q, letter_R, letter_S, letter_T, letter_U,
+                                                letter_V, letter_W, letter_X, letter_Y, letter_Z };
+
+constexpr const uint8_t* glyph_small[26] = { letter_a, letter_b, letter_c, letter_d, letter_e, letter_f, letter_g,
+                                             letter_h, letter_i, letter_j, letter_k, letter_l, letter_m, letter_n,
+                                             letter_o, letter_p, letter_q, letter_r, letter_s, letter_t, letter_u,
+                                             letter_v, letter_w, letter_x, letter_y, letter_z };
+
+#endif // DOXYGEN_SHOULD_SKIP_THIS
 
-#endif DOXYGEN_SHOULD_SKIP_THIS
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+/**
+ * \brief   Get the item to display for a character.
+ * \param   c   The character: digit, letter, '?' or space.
+ * \returns The item for the character, symbol_blank if not available.
+ */
+constexpr const uint8_t* GetGlyph(char c)
+{
+    return ((c >= '0') && (c <= '9')) ? glyph_digits[c - '0']   :
+           ((c >= 'A') && (c <= 'Z')) ? glyph_capitals[c - 'A'] :
+           ((c >= 'a') && (c <= 'z')) ? glyph_small[c - 'a']    :
+           (c == '?')                 ? symbol_question_mark    : symbol_blank;
+}
 
 
 #endif  // HI_M1388AR_LIB_HPP_
@@ -31,7 +31,7 @@
 /************************************************************************/
 #include <cstdint>
 #include <cstring>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "drivers/Pin/Pin.hpp"
@@ -154,7 +154,7 @@ public:
     bool Enable() { std::memset(mMotionArray, 0, sizeof(mMotionArray)); return mInitialized; }
     bool Disable() { return mInitialized; }
 
-    void SetHandler(const std::function<void(uint8_t length)>& handler) { UNUSED(handler); }
+    void SetHandler(const Delegate<void(uint8_t length)>& handler) { UNUSED(handler); }
     bool RetrieveAxesData(uint8_t* dest, uint8_t length)
     {
         if (dest == nullptr) { return false; }
@@ -186,7 +186,7 @@ private:
     bool mInitialized;
     uint8_t mMotionArray[150] = {};
 
-    std::function<void(uint8_t length)> mHandler;
+    Delegate<void(uint8_t length)> mHandler;
 
 #if (SIMULATED_SENSOR_OUTPUT_DATA == SAWTOOTH_SIGNAL)
     Sawtooth mXaxisSawTooth;
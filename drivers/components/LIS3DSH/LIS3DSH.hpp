@@ -17,11 +17,25 @@
  *          available at the configured sample frequency. Sample is read via
  *          SPI + DMA as well.
  *
+ *          Each read lands in a free slot of a ring of read buffers. The
+ *          consumer acquires the oldest filled slot without copying and
+ *          releases it when done, meanwhile the next reads use other slots.
+ *          If no slot is free the oldest unread slot is overwritten and the
+ *          overrun counter is incremented. The memory of the read buffer
+ *          slots is provided by the caller, sized for the configured number
+ *          of slots with LIS3DSH_READ_BUFFER_SIZE(). No heap memory is used.
+ *
+ *          With the hardware FIFO the number of samples in the FIFO is read
+ *          first, then exactly that number of samples is read. The FIFO
+ *          watermark (1..31 samples) is configurable. When a latency target
+ *          is given the watermark adapts: it grows while the consumer keeps
+ *          up and is halved when the latency target is missed.
+ *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/components/LIS3DSH
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2022
+ * \version 1.4
+ * \date    10-2026
  */
 
 #ifndef LIS3DSH_HPP_
@@ -31,12 +45,44 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "drivers/Pin/Pin.hpp"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     LIS3DSH_MAX_READ_SLOTS
+ * \brief   Maximum number of read buffer slots.
+ */
+#define LIS3DSH_MAX_READ_SLOTS      4
+
+/**
+ * \def     LIS3DSH_READ_SLOT_SIZE
+ * \brief   Size of a read buffer slot in bytes: a full FIFO of 32 samples
+ *          X,Y,Z, each int16_t.
+ */
+#define LIS3DSH_READ_SLOT_SIZE      192
+
+/**
+ * \def     LIS3DSH_SAMPLE_SIZE
+ * \brief   Size of a single sample in bytes: X,Y,Z, each int16_t.
+ */
+#define LIS3DSH_SAMPLE_SIZE         6
+
+/**
+ * \def     LIS3DSH_READ_BUFFER_SIZE
+ * \brief   Size of the read buffer in bytes to provide for the given number of
+ *          read buffer slots: a full FIFO per slot if the hardware FIFO is
+ *          used, else a single sample per slot.
+ */
+#define LIS3DSH_READ_BUFFER_SIZE(useHardwareFifo, readSlots)  \
+    ((readSlots) * ((useHardwareFifo) ? LIS3DSH_READ_SLOT_SIZE : LIS3DSH_SAMPLE_SIZE))
+
+
 /************************************************************************/
 /* Class declaration                                                    */
 /************************************************************************/
@@ -116,25 +162,50 @@ public:
          * \param   sampleFrequency     Sample frequency for accelerometer data.
          * \param   scale               Scale of the accelerometer data. Default +/- 2G.
          * \param   antiAliasingFilter  Anti-aliasing filter bandwidth. Default 200 Hz.
+         * \param   readSlots           Number of read buffer slots (1..LIS3DSH_MAX_READ_SLOTS). Default 2 (ping-pong).
+         * \param   watermark           FIFO watermark in samples (1..31), hardware FIFO only. Default 25.
+         * \param   latencyTarget       Latency target in ms, hardware FIFO only. Default 0: fixed watermark,
+         *                              else the watermark adapts (1..watermark) to meet the target.
          *
          */
         explicit Config(bool useHardwareFifo,
                         SampleFrequency sampleFrequency,
                         Scale scale = Scale::_2_G,
-                        AntiAliasingFilter antiAliasingFilter = AntiAliasingFilter::_200_Hz) :
+                        AntiAliasingFilter antiAliasingFilter = AntiAliasingFilter::_200_Hz,
+                        uint8_t readSlots = 2,
+                        uint8_t watermark = 25,
+                        uint16_t latencyTarget = 0) :
             mUseHardwareFifo(useHardwareFifo),
             mSampleFrequency(sampleFrequency),
             mScale(scale),
-            mAntiAliasingFilter(antiAliasingFilter)
+            mAntiAliasingFilter(antiAliasingFilter),
+            mReadSlots(readSlots),
+            mWatermark(watermark),
+            mLatencyTarget(latencyTarget)
         { }
 
         bool               mUseHardwareFifo;        ///< Flag indicating hardware FIFO is to be used.
         SampleFrequency    mSampleFrequency;        ///< Sample frequency for accelerometer data.
         Scale              mScale;                  ///< Scale of the accelerometer data.
         AntiAliasingFilter mAntiAliasingFilter;     ///< Anti-aliasing filter bandwidth.
+        uint8_t            mReadSlots;              ///< Number of read buffer slots.
+        uint8_t            mWatermark;              ///< FIFO watermark in samples.
+        uint16_t           mLatencyTarget;          ///< Latency target in ms, 0 for a fixed watermark.
+    };
+
+    /**
+     * \struct  AxesData
+     * \brief   Zero-copy view on the axes data of a single read, see
+     *          AcquireAxesData().
+     */
+    struct AxesData
+    {
+        const uint8_t* data;    ///< Samples X,Y,Z * int16_t, interleaved.
+        uint8_t        length;  ///< Length of the data in bytes.
+        uint8_t        slot;    ///< Slot holding the data, used by ReleaseAxesData().
     };
 
-    LIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2);
+    LIS3DSH(ISPI& spi, PinIdPort chipSelect, PinIdPort motionInt1, PinIdPort motionInt2, uint8_t* readBuffer, uint16_t readBufferSize);
     virtual ~LIS3DSH();
 
     bool Init(const IConfig& config) override;
@@ -144,31 +215,83 @@ public:
     bool Enable();
     bool Disable();
 
-    void SetHandler(const std::function<void(uint8_t length)>& handler);
+    void SetHandler(const Delegate<void(uint8_t length)>& handler);
     bool RetrieveAxesData(uint8_t* dest, uint8_t length);
 
+    bool AcquireAxesData(AxesData& axesData);
+    bool ReleaseAxesData(const AxesData& axesData);
+    uint32_t GetOverrunCount() const;
+
+    bool SetWatermark(uint8_t watermark);
+    uint8_t GetWatermark() const;
+
 private:
-    ISPI&    mSpi;
-    Pin      mChipSelect;
-    Pin      mMotionInt1;
-    Pin      mMotionInt2;
-    bool     mInitialized;
-    uint8_t* mReadBuffer;
-    uint8_t  mODR;
-    bool     mUseHardwareFifo;
+    /**
+     * \enum    SlotState
+     * \brief   State of a read buffer slot.
+     */
+    enum class SlotState : uint8_t
+    {
+        Free,
+        Reading,            ///< DMA read ongoing.
+        Filled,
+        Acquired            ///< In use by the consumer.
+    };
+
+    ISPI&             mSpi;
+    Pin               mChipSelect;
+    Pin               mMotionInt1;
+    Pin               mMotionInt2;
+    bool              mInitialized;
+    uint8_t*          mReadBuffer;
+    uint16_t          mReadBufferSize;
+    uint8_t           mODR;
+    bool              mUseHardwareFifo;
+    uint8_t           mReadAddress;
+    SPISegment        mReadSegments[4];
+    uint8_t           mSlotSize;
+    uint8_t           mSlotCount;
+    uint8_t           mReadSlot;
+    uint8_t           mLastSlot;
+    SlotState         mSlotState[LIS3DSH_MAX_READ_SLOTS];
+    uint8_t           mSlotLength[LIS3DSH_MAX_READ_SLOTS];
+    uint32_t          mSlotSequence[LIS3DSH_MAX_READ_SLOTS];
+    uint32_t          mSequence;
+    volatile uint32_t mOverrunCount;
+    SPISegment        mWriteSegments[3];
+    uint8_t           mFifoSource;
+    uint8_t           mFifoCommand[2];
+    uint8_t           mReadLength;
+    uint8_t           mWatermark;
+    uint8_t           mMaxWatermark;
+    bool              mAdaptive;
+    bool              mWatermarkChanged;
+    bool              mSlotWasFree;
+    uint8_t           mGoodReads;
+    uint32_t          mSampleFrequency;
 
-    std::function<void(uint8_t length)> mHandler;
+    Delegate<void(uint8_t length)> mHandler;
 
     bool SelfTest();
     bool Configure(const IConfig& config);
-    bool PrepareReadBuffer(uint8_t bufferSize);
+    bool PrepareReadBuffer(uint8_t slotSize, uint8_t slotCount);
+    void ResetSlots();
+    uint8_t ClaimReadSlot();
+    uint8_t FindOldestSlot(SlotState state) const;
+    bool StartRead(uint8_t reg, uint8_t* dest, uint8_t length, const Delegate<void(bool)>& handler);
+    void AbortRead(bool overrun);
+    void Adapt(uint8_t nrSamples, bool fifoOverrun);
+    uint8_t GetMaxWatermark(uint16_t latencyTarget) const;
+    uint32_t GetSampleFrequencyInMilliHz(SampleFrequency sampleFrequency);
     bool ClearFifo();
     uint8_t GetSampleFrequencyAsODR(SampleFrequency sampleFrequency);
     uint8_t GetScaleAsFSCALE(Scale scale);
     uint8_t GetAntiAliasingFilterAsBW(AntiAliasingFilter antiAliasingFilter);
     uint8_t GetFifoModeAsFMODE(FifoMode fifoMode);
 
-    void ReadAxesCompleted();
+    void FifoSourceRead(bool result);
+    void ReadAxesCompleted(bool result);
+    void WriteWatermark();
 
     bool WriteRegister(uint8_t reg, const uint8_t* src, uint16_t length);
     bool ReadRegister(uint8_t reg, uint8_t* dest, uint16_t length);
@@ -16,9 +16,16 @@
  * \note    Using right alignment only to be consistent with all resolutions.
  *          GetValue uses: ADC(input) = value * (Vref / (ADC(resolution) + 1) ) - for 12-bit: ADC(input) = value * (3.3V / (0xFFF + 1) --> var = (value * (0xFFF + 1)) / 3.3V
  *
+ * \note    Streaming: the DMA transfers each conversion, the CPU is only
+ *          involved once per half buffer. The sample rate is set by the
+ *          trigger: a timer, or continuous conversion at
+ *          ADCCLK / ((sample time + resolution cycles) * channels).
+ *          As master of an InterleavedAdc the stream uses the multi ADC DMA:
+ *          two samples per (word) transfer from the common data register.
+ *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.3
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -64,6 +71,34 @@ static void CallbackEndOfConversion(const ADCCallbacks& adc_callbacks, uint16_t
     }
 }
 
+/**
+ * \brief   Call the callbackBlock, if configured (streaming).
+ * \param   adc_callbacks   Structure containing the callbackBlock to call.
+ * \param   half            The half of the stream buffer filled: 0 or 1.
+ * \returns True if the callbackBlock is called, else false.
+ */
+static bool CallbackBlock(const ADCCallbacks& adc_callbacks, uint8_t half)
+{
+    if (adc_callbacks.callbackBlock)
+    {
+        adc_callbacks.callbackBlock(half);
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief   Call the callbackOverrun, if configured (streaming).
+ * \param   adc_callbacks   Structure containing the callbackOverrun to call.
+ */
+static void CallbackOverrun(const ADCCallbacks& adc_callbacks)
+{
+    if (adc_callbacks.callbackOverrun)
+    {
+        adc_callbacks.callbackOverrun();
+    }
+}
+
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -74,7 +109,14 @@ static void CallbackEndOfConversion(const ADCCallbacks& adc_callbacks, uint16_t
 Adc::Adc(const ADCInstance& instance) :
     mInstance(instance),
     mADCCallbacks( (instance == ADCInstance::ADC_1) ? (adc1_callbacks) : ( (instance == ADCInstance::ADC_2) ? (adc2_callbacks) : (adc3_callbacks) ) ),
-    mInitialized(false)
+    mInitialized(false),
+    mChannelCount(0),
+    mTrigger(Trigger::SOFTWARE),
+    mMultiMode(false),
+    mStreamBuffer(nullptr),
+    mStreamLength(0),
+    mBlockHandler(nullptr),
+    mOverruns(0)
 {
     SetInstance(instance);
 
@@ -93,42 +135,50 @@ Adc::~Adc()
  * \brief   Initializes the ADC instance with the given configuration.
  * \param   config  The configuration for the ADC instance to use.
  * \returns True if the configuration could be applied, else false.
+ * \note    Asserts if the list of channels is empty or too long.
  */
 bool Adc::Init(const IConfig& config)
 {
+    const Config& cfg = reinterpret_cast<const Config&>(config);
+
+    EXPECT(cfg.mChannelCount > 0);
+    EXPECT(cfg.mChannelCount <= ADC_MAX_SCAN_CHANNELS);
+
+    if ((cfg.mChannelCount == 0) || (cfg.mChannelCount > ADC_MAX_SCAN_CHANNELS)) { return false; }
+
     CheckAndEnableAHB2PeripheralClock(mInstance);
 
-    const Config& cfg = reinterpret_cast<const Config&>(config);
+    mChannelCount = cfg.mChannelCount;
+    mTrigger      = cfg.mTrigger;
 
     mHandle.Init.ClockPrescaler        = ADC_CLOCK_SYNC_PCLK_DIV2;
     mHandle.Init.Resolution            = GetResolution(cfg.mResolution);
     mHandle.Init.DataAlign             = ADC_DATAALIGN_RIGHT;
-    mHandle.Init.ScanConvMode          = DISABLE;
-    mHandle.Init.EOCSelection          = ADC_EOC_SINGLE_CONV;
-    mHandle.Init.ContinuousConvMode    = DISABLE;
-    mHandle.Init.NbrOfConversion       = 1;
+    mHandle.Init.ScanConvMode          = (mChannelCount > 1) ? ENABLE : DISABLE;
+    mHandle.Init.NbrOfConversion       = mChannelCount;
     mHandle.Init.DiscontinuousConvMode = DISABLE;
     mHandle.Init.NbrOfDiscConversion   = 0;
-    mHandle.Init.ExternalTrigConv      = ADC_SOFTWARE_START;
-    mHandle.Init.ExternalTrigConvEdge  = ADC_EXTERNALTRIGCONVEDGE_NONE;
-    mHandle.Init.DMAContinuousRequests = DISABLE;
+    mHandle.Init.ExternalTrigConv      = GetTrigger(mTrigger);
+    mHandle.Init.ExternalTrigConvEdge  = (mTrigger == Trigger::SOFTWARE) ? ADC_EXTERNALTRIGCONVEDGE_NONE : ADC_EXTERNALTRIGCONVEDGE_RISING;
 
-    if (HAL_ADC_Init(&mHandle) == HAL_OK)
+    if (ConfigureConversion(false))
     {
         SetIRQn(ADC_IRQn, cfg.mInterruptPriority, 0);
 
-        // Configure channel
-        ADC_ChannelConfTypeDef adcChannelConfig = {};
-        adcChannelConfig.Channel      = GetChannel(cfg.mChannel);
-        adcChannelConfig.Offset       = 0;
-        adcChannelConfig.Rank         = 1;
-        adcChannelConfig.SamplingTime = ADC_SAMPLETIME_15CYCLES;
-
-        if (HAL_ADC_ConfigChannel(&mHandle, &adcChannelConfig) == HAL_OK)
+        // Configure the channels, in order of conversion
+        for (uint8_t i = 0; i < mChannelCount; i++)
         {
-            mInitialized = true;
-            return true;
+            ADC_ChannelConfTypeDef adcChannelConfig = {};
+            adcChannelConfig.Channel      = GetChannel(cfg.mChannels[i]);
+            adcChannelConfig.Offset       = 0;
+            adcChannelConfig.Rank         = i + 1;
+            adcChannelConfig.SamplingTime = GetSampleTime(cfg.mSampleTime);
+
+            if (HAL_ADC_ConfigChannel(&mHandle, &adcChannelConfig) != HAL_OK) { return false; }
         }
+
+        mInitialized = true;
+        return true;
     }
     return false;
 }
@@ -152,6 +202,7 @@ bool Adc::Sleep()
     // Disable interrupts
     HAL_NVIC_DisableIRQ( ADC_IRQn );
 
+    StopStream();
     HAL_ADC_Stop(&mHandle);
 
     mInitialized = false;
@@ -167,11 +218,14 @@ bool Adc::Sleep()
 /**
  * \brief   Sample a value with the ADC from input.
  * \param   value   Variable to store the sampled value into.
- * \returns True if sampling was succesful, else false.
+ * \returns True if sampling was succesful, else false. Returns false if not
+ *          configured for a single channel with software trigger, or when
+ *          streaming.
  */
 bool Adc::GetValue(uint16_t& value)
 {
     if (!mInitialized) { return false; }
+    if ((mChannelCount != 1) || (mTrigger != Trigger::SOFTWARE) || IsStreaming()) { return false; }
 
     if (HAL_ADC_Start(&mHandle) == HAL_OK)
     {
@@ -191,17 +245,140 @@ bool Adc::GetValue(uint16_t& value)
 /**
  * \brief   Sample a value with the ADC from input using interrupts.
  * \param   handler     Callback to call when sampling completed.
- * \returns True if the sampling could be started, else false.
+ * \returns True if the sampling could be started, else false. Returns false
+ *          if not configured for a single channel with software trigger, or
+ *          when streaming.
  */
-bool Adc::GetValueInterrupt(const std::function<void(uint16_t)>& handler)
+bool Adc::GetValueInterrupt(const Delegate<void(uint16_t)>& handler)
 {
     if (!mInitialized) { return false; }
+    if ((mChannelCount != 1) || (mTrigger != Trigger::SOFTWARE) || IsStreaming()) { return false; }
 
     mADCCallbacks.callbackEndOfConversion = handler;
 
     return (HAL_ADC_Start_IT(&mHandle) == HAL_OK);
 }
 
+/**
+ * \brief   Get the handle to the peripheral.
+ * \returns The handle to the peripheral.
+ */
+const ADC_HandleTypeDef* Adc::GetPeripheralHandle() const
+{
+    return &mHandle;
+}
+
+/**
+ * \brief   Get the pointer to the DMA handle.
+ * \details This is returned as reference-to-pointer to allow it to be changed
+ *          externally, as it needs to be linked to the DMA class.
+ * \returns The DMA handle as reference-to-pointer.
+ */
+DMA_HandleTypeDef*& Adc::GetDmaHandle()
+{
+    return mHandle.DMA_Handle;
+}
+
+/**
+ * \brief   Start streaming: convert the channels on each trigger (or
+ *          continuously with the software trigger) into a circular buffer.
+ * \details The DMA writes the conversions in order of the channels, the
+ *          buffer holds whole scans: sample n of channel c is at
+ *          buffer[(n * channels) + c]. Each time a half of the buffer is
+ *          filled the handler is called with that half (a block), while the
+ *          DMA fills the other half. The block must be processed (or copied)
+ *          before that other half is filled.
+ * \param   buffer      Pointer to the buffer the DMA writes into.
+ * \param   length      Length of the buffer in samples, a multiple of twice
+ *                      the number of channels.
+ * \param   handler     Callback to call with (block, length) of each filled
+ *                      half, called from the DMA interrupt.
+ * \returns True if the stream could be started, else false. Returns false
+ *          if no DMA is setup, the DMA is not in circular mode or already
+ *          streaming.
+ * \note    Asserts if buffer is nullptr or length invalid.
+ * \note    The DMA half transfer interrupt must be enabled, with HalfWord
+ *          data width.
+ */
+bool Adc::StartStream(uint16_t* buffer, uint16_t length, const Delegate<void(const uint16_t*, uint16_t)>& handler)
+{
+    EXPECT(buffer);
+    EXPECT(length > 0);
+
+    if (buffer == nullptr) { return false; }
+    if (length == 0) { return false; }
+    if (!mInitialized) { return false; }
+    if (IsStreaming()) { return false; }
+    if ((length % (2 * mChannelCount)) != 0) { return false; }
+    if (mHandle.DMA_Handle == nullptr) { return false; }
+    if (mHandle.DMA_Handle->Init.Mode != DMA_CIRCULAR) { return false; }
+
+    if (!ConfigureConversion(true)) { return false; }
+
+    mStreamBuffer = buffer;
+    mStreamLength = length;
+    mBlockHandler = handler;
+    mOverruns     = 0;
+
+    mADCCallbacks.callbackBlock   = [this](uint8_t half) { this->CallbackBlock(half); };
+    mADCCallbacks.callbackOverrun = [this]() { this->CallbackOverrun(); };
+
+    if (!StartDma())
+    {
+        StopStream();
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief   Stop the stream started with StartStream().
+ * \returns True if the stream is stopped, false if it was not running.
+ */
+bool Adc::StopStream()
+{
+    if (!IsStreaming()) { return false; }
+
+    StopDma();
+
+    mADCCallbacks.callbackBlock   = nullptr;
+    mADCCallbacks.callbackOverrun = nullptr;
+    mStreamBuffer = nullptr;
+    mStreamLength = 0;
+    mBlockHandler = nullptr;
+
+    return ConfigureConversion(false);
+}
+
+/**
+ * \brief   Indicate if the ADC is streaming.
+ * \returns True if streaming, else false.
+ */
+bool Adc::IsStreaming() const
+{
+    return (mStreamBuffer != nullptr);
+}
+
+/**
+ * \brief   Get the number of channels converted per trigger.
+ * \returns The number of channels, 0 if not initialized.
+ */
+uint8_t Adc::GetChannelCount() const
+{
+    return mChannelCount;
+}
+
+/**
+ * \brief   Get the number of times the stream lost conversions, because the
+ *          DMA did not read the ADC in time. The stream is restarted at the
+ *          start of the buffer each time.
+ * \returns The number of overruns since StartStream().
+ */
+uint32_t Adc::GetOverruns() const
+{
+    return mOverruns;
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -310,6 +487,100 @@ uint32_t Adc::GetResolution(const Resolution& resolution)
     return resolution_value;
 }
 
+/**
+ * \brief   Get the translated trigger value.
+ * \param   trigger     The desired trigger.
+ * \returns Translated trigger value.
+ */
+uint32_t Adc::GetTrigger(const Trigger& trigger)
+{
+    uint32_t trigger_value = ADC_SOFTWARE_START;
+
+    switch (trigger)
+    {
+        case Trigger::SOFTWARE:     { trigger_value = ADC_SOFTWARE_START;            } break;
+        case Trigger::TIMER_1_CC1:  { trigger_value = ADC_EXTERNALTRIGCONV_T1_CC1;   } break;
+        case Trigger::TIMER_2_TRGO: { trigger_value = ADC_EXTERNALTRIGCONV_T2_TRGO;  } break;
+        case Trigger::TIMER_3_TRGO: { trigger_value = ADC_EXTERNALTRIGCONV_T3_TRGO;  } break;
+        case Trigger::TIMER_8_TRGO: { trigger_value = ADC_EXTERNALTRIGCONV_T8_TRGO;  } break;
+        case Trigger::EXT_LINE_11:  { trigger_value = ADC_EXTERNALTRIGCONV_Ext_IT11; } break;
+        default: ASSERT(false); while(1) { __NOP(); } break;    // Impossible selection
+    }
+
+    return trigger_value;
+}
+
+/**
+ * \brief   Get the translated sample time value.
+ * \param   sampleTime  The desired sample time.
+ * \returns Translated sample time value.
+ */
+uint32_t Adc::GetSampleTime(const SampleTime& sampleTime)
+{
+    uint32_t sample_time_value = ADC_SAMPLETIME_15CYCLES;
+
+    switch (sampleTime)
+    {
+        case SampleTime::_3_CYCLES:   { sample_time_value = ADC_SAMPLETIME_3CYCLES;   } break;
+        case SampleTime::_15_CYCLES:  { sample_time_value = ADC_SAMPLETIME_15CYCLES;  } break;
+        case SampleTime::_28_CYCLES:  { sample_time_value = ADC_SAMPLETIME_28CYCLES;  } break;
+        case SampleTime::_56_CYCLES:  { sample_time_value = ADC_SAMPLETIME_56CYCLES;  } break;
+        case SampleTime::_84_CYCLES:  { sample_time_value = ADC_SAMPLETIME_84CYCLES;  } break;
+        case SampleTime::_112_CYCLES: { sample_time_value = ADC_SAMPLETIME_112CYCLES; } break;
+        case SampleTime::_144_CYCLES: { sample_time_value = ADC_SAMPLETIME_144CYCLES; } break;
+        case SampleTime::_480_CYCLES: { sample_time_value = ADC_SAMPLETIME_480CYCLES; } break;
+        default: ASSERT(false); while(1) { __NOP(); } break;    // Impossible selection
+    }
+
+    return sample_time_value;
+}
+
+/**
+ * \brief   Apply the conversion mode: single conversions on request, or
+ *          streaming with DMA requests.
+ * \param   stream  True to stream, false for single conversions.
+ * \returns True if the mode could be applied, else false.
+ * \note    The configured channels are kept.
+ */
+bool Adc::ConfigureConversion(bool stream)
+{
+    // Streaming with software trigger: convert back to back
+    mHandle.Init.ContinuousConvMode    = (stream && (mTrigger == Trigger::SOFTWARE)) ? ENABLE : DISABLE;
+    mHandle.Init.DMAContinuousRequests = stream ? ENABLE : DISABLE;
+    mHandle.Init.EOCSelection          = stream ? ADC_EOC_SEQ_CONV : ADC_EOC_SINGLE_CONV;
+
+    return (HAL_ADC_Init(&mHandle) == HAL_OK);
+}
+
+/**
+ * \brief   Start the DMA of the stream at the start of the buffer.
+ * \returns True if the DMA could be started, else false.
+ * \note    In multi ADC mode each (word) transfer holds two samples.
+ */
+bool Adc::StartDma()
+{
+    if (mMultiMode)
+    {
+        return (HAL_ADCEx_MultiModeStart_DMA(&mHandle, reinterpret_cast<uint32_t*>(mStreamBuffer), mStreamLength / 2) == HAL_OK);
+    }
+    return (HAL_ADC_Start_DMA(&mHandle, reinterpret_cast<uint32_t*>(mStreamBuffer), mStreamLength) == HAL_OK);
+}
+
+/**
+ * \brief   Stop the DMA of the stream.
+ */
+void Adc::StopDma()
+{
+    if (mMultiMode)
+    {
+        HAL_ADCEx_MultiModeStop_DMA(&mHandle);
+    }
+    else
+    {
+        HAL_ADC_Stop_DMA(&mHandle);
+    }
+}
+
 /**
  * \brief   Lower level configuration for the ADC interrupts.
  * \param   type        IRQn External interrupt number.
@@ -332,6 +603,33 @@ void Adc::CallbackIRQ() const
     HAL_ADC_IRQHandler(const_cast<ADC_HandleTypeDef*>(&mHandle));
 }
 
+/**
+ * \brief   ISR: a half of the stream buffer is filled, report it as block.
+ * \param   half    The half filled: 0 or 1.
+ */
+void Adc::CallbackBlock(uint8_t half)
+{
+    const uint16_t blockLength = mStreamLength / 2;
+
+    Delegate<void(const uint16_t*, uint16_t)> handler = mBlockHandler;
+    if (handler)
+    {
+        handler(&mStreamBuffer[half * blockLength], blockLength);
+    }
+}
+
+/**
+ * \brief   ISR: the ADC overran (a conversion was not read by the DMA), the
+ *          DMA requests stopped. Restart the stream at the start of the buffer.
+ */
+void Adc::CallbackOverrun()
+{
+    mOverruns++;
+
+    StopDma();
+    if (!StartDma()) { ASSERT(false); }
+}
+
 
 /************************************************************************/
 /* Interrupts                                                           */
@@ -345,6 +643,11 @@ void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* handle)
 {
     ASSERT(handle);
 
+    // Streaming: the circular DMA continues, report the second half
+    if ((handle->Instance == ADC1) && CallbackBlock(adc1_callbacks, 1)) { return; }
+    if ((handle->Instance == ADC2) && CallbackBlock(adc2_callbacks, 1)) { return; }
+    if ((handle->Instance == ADC3) && CallbackBlock(adc3_callbacks, 1)) { return; }
+
     // Could only get here via interrupt: stop, as new requests will start anew
     if (HAL_ADC_Stop_IT(handle) != HAL_OK) { ASSERT(false); }
 
@@ -353,6 +656,36 @@ void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* handle)
     if (handle->Instance == ADC3) { CallbackEndOfConversion(adc3_callbacks, static_cast<uint16_t>(HAL_ADC_GetValue(handle))); }
 }
 
+/**
+ * \brief   ISR: handler to dispatch the DMA half transfer interrupt of a
+ *          stream into a block callback.
+ * \param   handle  The ADC handle from which the half transfer ISR came.
+ */
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    if (handle->Instance == ADC1) { CallbackBlock(adc1_callbacks, 0); }
+    if (handle->Instance == ADC2) { CallbackBlock(adc2_callbacks, 0); }
+    if (handle->Instance == ADC3) { CallbackBlock(adc3_callbacks, 0); }
+}
+
+/**
+ * \brief   ISR: handler to dispatch the ADC overrun error of a stream into an
+ *          overrun callback.
+ * \param   handle  The ADC handle from which the error ISR came.
+ */
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    if ((HAL_ADC_GetError(handle) & HAL_ADC_ERROR_OVR) == 0) { return; }
+
+    if (handle->Instance == ADC1) { CallbackOverrun(adc1_callbacks); }
+    if (handle->Instance == ADC2) { CallbackOverrun(adc2_callbacks); }
+    if (handle->Instance == ADC3) { CallbackOverrun(adc3_callbacks); }
+}
+
 /**
  * \brief   ISR: route ADC1, ADC2, ADC3 interrupts to 'CallbackIRQ'.
  */
@@ -13,12 +13,16 @@
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/drivers/ADC
  *
- * \note    Only single conversion, only software trigger. Either with blocking
- *          (polling) method or using interrupt.
+ * \note    Single conversion with software trigger, either with blocking
+ *          (polling) method or using interrupt. Or streaming: a list of
+ *          channels converted continuously or on a timer trigger, written by
+ *          a circular DMA into a buffer, delivered per half buffer.
+ *          InterleavedAdc streams ADC1 as master of a dual or triple
+ *          interleaved group.
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.3
+ * \date    10-2026
  */
 
 #ifndef ADC_HPP_
@@ -28,12 +32,23 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include <initializer_list>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/IADC.hpp"
 #include "stm32f4xx_hal.h"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     ADC_MAX_SCAN_CHANNELS
+ * \brief   Maximum number of channels in the scan sequence (regular group).
+ */
+#define ADC_MAX_SCAN_CHANNELS   16
+
+
 /************************************************************************/
 /* Enums                                                                */
 /************************************************************************/
@@ -57,8 +72,10 @@ enum class ADCInstance : uint8_t
  * \brief   Data structure to contain callbacks for a SPI instance.
  */
 struct ADCCallbacks {
-    std::function<void()> callbackIRQ  = nullptr;                       ///< Callback to call when IRQ occurs.
-    std::function<void(uint16_t)> callbackEndOfConversion = nullptr;    ///< Callback to call when End Of Conversion occurs.
+    Delegate<void()> callbackIRQ  = nullptr;                       ///< Callback to call when IRQ occurs.
+    Delegate<void(uint16_t)> callbackEndOfConversion = nullptr;    ///< Callback to call when End Of Conversion occurs.
+    Delegate<void(uint8_t)> callbackBlock = nullptr;               ///< Callback to call when half (0) or second half (1) of the stream buffer is filled.
+    Delegate<void()> callbackOverrun = nullptr;                    ///< Callback to call when the stream lost a conversion.
 };
 
 
@@ -104,6 +121,38 @@ public:
         _12_BIT     ///< 2^12 = 4096 steps, default
     };
 
+    /**
+     * \enum    Trigger
+     * \brief   Available ADC triggers to start a conversion of the channels.
+     * \note    Timer6 and Timer7 cannot trigger the ADC.
+     */
+    enum class Trigger : uint8_t
+    {
+        SOFTWARE,       ///< Default: single conversion on request, or continuous when streaming
+        TIMER_1_CC1,
+        TIMER_2_TRGO,
+        TIMER_3_TRGO,
+        TIMER_8_TRGO,
+        EXT_LINE_11
+    };
+
+    /**
+     * \enum    SampleTime
+     * \brief   Available sample times, in ADC clock cycles. A conversion
+     *          takes the sample time plus the resolution (12 cycles at 12 bit).
+     */
+    enum class SampleTime : uint8_t
+    {
+        _3_CYCLES,
+        _15_CYCLES,     ///< Default
+        _28_CYCLES,
+        _56_CYCLES,
+        _84_CYCLES,
+        _112_CYCLES,
+        _144_CYCLES,
+        _480_CYCLES
+    };
+
     /**
      * \struct  Config
      * \brief   Configuration struct for ADC.
@@ -111,20 +160,52 @@ public:
     struct Config : public IConfig
     {
         /**
-         * \brief   Constructor of the ADC configuration struct.
+         * \brief   Constructor of the ADC configuration struct, single channel
+         *          converted on request.
          * \param   interruptPriority   Priority of the interrupt.
          * \param   channel             The channel to capture data from.
          * \param   resolution          The resolution of the captured data.
          */
         Config(uint8_t interruptPriority, Channel channel, Resolution resolution = Resolution::_12_BIT) :
             mInterruptPriority(interruptPriority),
-            mChannel(channel),
-            mResolution(resolution)
+            mChannels{ channel },
+            mChannelCount(1),
+            mTrigger(Trigger::SOFTWARE),
+            mResolution(resolution),
+            mSampleTime(SampleTime::_15_CYCLES)
         { }
 
-        uint8_t    mInterruptPriority;  ///< Interrupt priority.
-        Channel    mChannel;            ///< Channel to capture data from.
-        Resolution mResolution;         ///< Resolution of the captured data.
+        /**
+         * \brief   Constructor of the ADC configuration struct, a list of
+         *          channels converted in order (scan) for streaming.
+         * \param   interruptPriority   Priority of the interrupt.
+         * \param   channels            The channels to capture data from, in
+         *                              order, at most ADC_MAX_SCAN_CHANNELS.
+         * \param   trigger             The trigger for a conversion of all channels.
+         * \param   resolution          The resolution of the captured data.
+         * \param   sampleTime          The sample time of each channel.
+         */
+        Config(uint8_t interruptPriority, std::initializer_list<Channel> channels, Trigger trigger, Resolution resolution = Resolution::_12_BIT, SampleTime sampleTime = SampleTime::_15_CYCLES) :
+            mInterruptPriority(interruptPriority),
+            mChannels{},
+            mChannelCount(0),
+            mTrigger(trigger),
+            mResolution(resolution),
+            mSampleTime(sampleTime)
+        {
+            for (const Channel& channel : channels)
+            {
+                if (mChannelCount < ADC_MAX_SCAN_CHANNELS) { mChannels[mChannelCount] = channel; }
+                mChannelCount++;
+            }
+        }
+
+        uint8_t    mInterruptPriority;                  ///< Interrupt priority.
+        Channel    mChannels[ADC_MAX_SCAN_CHANNELS];    ///< Channels to capture data from, in order.
+        uint8_t    mChannelCount;                       ///< Number of channels in the list.
+        Trigger    mTrigger;                            ///< Trigger for a conversion.
+        Resolution mResolution;                         ///< Resolution of the captured data.
+        SampleTime mSampleTime;                         ///< Sample time of each channel.
     };
 
 
@@ -136,21 +217,47 @@ public:
     bool Sleep() override;
 
     bool GetValue(uint16_t& value) override;
-    bool GetValueInterrupt(const std::function<void(uint16_t)>& handler) override;
+    bool GetValueInterrupt(const Delegate<void(uint16_t)>& handler) override;
+
+    const ADC_HandleTypeDef* GetPeripheralHandle() const;
+    DMA_HandleTypeDef*& GetDmaHandle();
+
+    bool StartStream(uint16_t* buffer, uint16_t length, const Delegate<void(const uint16_t*, uint16_t)>& handler);
+    bool StopStream();
+    bool IsStreaming() const;
+    uint8_t GetChannelCount() const;
+    uint32_t GetOverruns() const;
 
 private:
+    friend class InterleavedAdc;
+
     ADCInstance       mInstance;
     ADC_HandleTypeDef mHandle = {};
     ADCCallbacks&     mADCCallbacks;
     bool              mInitialized;
+    uint8_t           mChannelCount;
+    Trigger           mTrigger;
+    bool              mMultiMode;       ///< Master of an InterleavedAdc: the DMA reads the common data register
+
+    uint16_t*                                   mStreamBuffer;
+    uint16_t                                    mStreamLength;
+    Delegate<void(const uint16_t*, uint16_t)>   mBlockHandler;
+    volatile uint32_t                           mOverruns;
 
     void SetInstance(const ADCInstance& instance);
     void CheckAndEnableAHB2PeripheralClock(const ADCInstance& instance);
     void CheckAndDisableAHB2PeripheralClock(const ADCInstance& instance);
     uint32_t GetChannel(const Channel& channel);
     uint32_t GetResolution(const Resolution& resolution);
+    uint32_t GetTrigger(const Trigger& trigger);
+    uint32_t GetSampleTime(const SampleTime& sampleTime);
+    bool ConfigureConversion(bool stream);
+    bool StartDma();
+    void StopDma();
     void SetIRQn(IRQn_Type type, uint32_t preemptPrio, uint32_t subPrio);
     void CallbackIRQ() const;
+    void CallbackBlock(uint8_t half);
+    void CallbackOverrun();
 };
 
 
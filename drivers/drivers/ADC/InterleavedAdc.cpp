@@ -0,0 +1,393 @@
+/**
+ * \file    InterleavedAdc.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   InterleavedAdc
+ *
+ * \brief   Dual or triple interleaved ADC: one channel sampled by ADC1, ADC2
+ *          (and ADC3) in turn, at two (or three) times the rate of one ADC.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/drivers/ADC
+ *
+ * \note    The ADCs convert continuously: ADC1 starts, each next ADC starts
+ *          'delay' ADCCLK cycles later, ADC1 again 'delay' after the last.
+ *          Each ADC must finish its conversion within (ADCs * delay), and
+ *          the sampling phases on the shared pin must not overlap.
+ *
+ * \note    DMA mode 2 transfers two samples per request (a word), in order
+ *          of conversion for dual and triple mode: the buffer needs no
+ *          reordering.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "drivers/ADC/InterleavedAdc.hpp"
+#include "utility/Assert/Assert.h"
+#include "stm32f4xx_hal_adc.h"
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Get the number of ADCCLK cycles to sample.
+ * \param   sampleTime  The sample time.
+ * \returns The number of ADCCLK cycles.
+ */
+static uint16_t GetSampleCycles(const Adc::SampleTime& sampleTime)
+{
+    switch (sampleTime)
+    {
+        case Adc::SampleTime::_3_CYCLES:   return 3;   break;
+        case Adc::SampleTime::_15_CYCLES:  return 15;  break;
+        case Adc::SampleTime::_28_CYCLES:  return 28;  break;
+        case Adc::SampleTime::_56_CYCLES:  return 56;  break;
+        case Adc::SampleTime::_84_CYCLES:  return 84;  break;
+        case Adc::SampleTime::_112_CYCLES: return 112; break;
+        case Adc::SampleTime::_144_CYCLES: return 144; break;
+        case Adc::SampleTime::_480_CYCLES: return 480; break;
+        default: ASSERT(false); while(1) { __NOP(); } return 0; break;    // Impossible selection
+    }
+}
+
+/**
+ * \brief   Get the number of ADCCLK cycles to convert a sample.
+ * \param   resolution  The resolution.
+ * \returns The number of ADCCLK cycles: one per bit.
+ */
+static uint16_t GetResolutionCycles(const Adc::Resolution& resolution)
+{
+    switch (resolution)
+    {
+        case Adc::Resolution::_6_BIT:  return 6;  break;
+        case Adc::Resolution::_8_BIT:  return 8;  break;
+        case Adc::Resolution::_10_BIT: return 10; break;
+        case Adc::Resolution::_12_BIT: return 12; break;
+        default: ASSERT(false); while(1) { __NOP(); } return 0; break;    // Impossible selection
+    }
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Constructor, dual interleaved mode.
+ * \param   master  The ADC1 instance.
+ * \param   slave   The ADC2 instance.
+ */
+InterleavedAdc::InterleavedAdc(Adc& master, Adc& slave) :
+    mMaster(master),
+    mSlave(slave),
+    mSlave2(nullptr),
+    mAdcCount(2),
+    mDelay(0),
+    mInitialized(false)
+{ }
+
+/**
+ * \brief   Constructor, triple interleaved mode.
+ * \param   master  The ADC1 instance.
+ * \param   slave   The ADC2 instance.
+ * \param   slave2  The ADC3 instance.
+ */
+InterleavedAdc::InterleavedAdc(Adc& master, Adc& slave, Adc& slave2) :
+    mMaster(master),
+    mSlave(slave),
+    mSlave2(&slave2),
+    mAdcCount(3),
+    mDelay(0),
+    mInitialized(false)
+{ }
+
+/**
+ * \brief   Destructor, puts the ADCs back in independent mode and sleep.
+ */
+InterleavedAdc::~InterleavedAdc()
+{
+    if (mInitialized)
+    {
+        Sleep();
+    }
+}
+
+/**
+ * \brief   Initializes the ADCs to convert the channel interleaved.
+ * \param   config  The configuration for the InterleavedAdc to use.
+ * \returns True if the configuration could be applied, else false. Returns
+ *          false if the ADCs are not ADC1, ADC2 (and ADC3), or the sample
+ *          time does not fit in the delay between the ADCs.
+ */
+bool InterleavedAdc::Init(const IConfig& config)
+{
+    const Config& cfg = reinterpret_cast<const Config&>(config);
+
+    EXPECT(mMaster.mInstance == ADCInstance::ADC_1);
+    EXPECT(mSlave.mInstance == ADCInstance::ADC_2);
+    EXPECT((mSlave2 == nullptr) || (mSlave2->mInstance == ADCInstance::ADC_3));
+
+    if (mMaster.mInstance != ADCInstance::ADC_1) { return false; }
+    if (mSlave.mInstance != ADCInstance::ADC_2) { return false; }
+    if ((mSlave2 != nullptr) && (mSlave2->mInstance != ADCInstance::ADC_3)) { return false; }
+
+    const uint8_t delay = CalculateDelay(mAdcCount, cfg.mResolution, cfg.mSampleTime);
+    if (delay == 0) { return false; }
+
+    if (IsStreaming()) { return false; }
+
+    // All ADCs convert the same channel continuously, started by the master
+    const Adc::Config adcConfig(cfg.mInterruptPriority, { cfg.mChannel }, Adc::Trigger::SOFTWARE, cfg.mResolution, cfg.mSampleTime);
+
+    mInitialized = false;
+
+    if (!mMaster.Init(adcConfig)) { return false; }
+    if (!mSlave.Init(adcConfig)) { return false; }
+    if ((mSlave2 != nullptr) && !mSlave2->Init(adcConfig)) { return false; }
+
+    mDelay = delay;
+
+    if (ConfigureMultiMode(true))
+    {
+        mMaster.mMultiMode = true;
+        mInitialized       = true;
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief   Indicate if InterleavedAdc is initialized.
+ * \returns True if InterleavedAdc is initialized, else false.
+ */
+bool InterleavedAdc::IsInit() const
+{
+    return mInitialized;
+}
+
+/**
+ * \brief   Stops the stream, puts the ADCs back in independent mode and
+ *          puts them in sleep mode.
+ * \returns True if the ADCs could be put in sleep mode, else false.
+ */
+bool InterleavedAdc::Sleep()
+{
+    StopStream();
+
+    bool result = ConfigureMultiMode(false);
+
+    mMaster.mMultiMode = false;
+    mInitialized       = false;
+    mDelay             = 0;
+
+    result &= mMaster.Sleep();
+    result &= mSlave.Sleep();
+    if (mSlave2 != nullptr) { result &= mSlave2->Sleep(); }
+
+    return result;
+}
+
+/**
+ * \brief   Get the pointer to the DMA handle of the master, the single DMA
+ *          stream of the interleaved ADCs.
+ * \details This is returned as reference-to-pointer to allow it to be changed
+ *          externally, as it needs to be linked to the DMA class.
+ * \returns The DMA handle as reference-to-pointer.
+ */
+DMA_HandleTypeDef*& InterleavedAdc::GetDmaHandle()
+{
+    return mMaster.GetDmaHandle();
+}
+
+/**
+ * \brief   Start streaming: the ADCs convert in turn, the DMA writes the
+ *          merged samples into a circular buffer.
+ * \details The samples are in order of conversion: sample n is taken
+ *          n * delay ADCCLK cycles after the first, by ADC (n % ADCs) + 1.
+ *          Each time a half of the buffer is filled the handler is called
+ *          with that half (a block), as Adc::StartStream().
+ * \param   buffer      Pointer to the buffer the DMA writes into, word
+ *                      aligned.
+ * \param   length      Length of the buffer in samples, a multiple of 4
+ *                      (dual) or 12 (triple): each block starts with ADC1.
+ * \param   handler     Callback to call with (block, length) of each filled
+ *                      half, called from the DMA interrupt.
+ * \returns True if the stream could be started, else false. Returns false
+ *          if no DMA is setup, the DMA is not circular with Word data width,
+ *          or already streaming.
+ * \note    Asserts if buffer is nullptr or length invalid.
+ */
+bool InterleavedAdc::StartStream(uint16_t* buffer, uint16_t length, const Delegate<void(const uint16_t*, uint16_t)>& handler)
+{
+    EXPECT(buffer);
+    EXPECT(length > 0);
+
+    if (buffer == nullptr) { return false; }
+    if (length == 0) { return false; }
+    if (!mInitialized) { return false; }
+    if (IsStreaming()) { return false; }
+    if ((length % (2 * GetRoundLength())) != 0) { return false; }
+    if ((reinterpret_cast<uintptr_t>(buffer) % sizeof(uint32_t)) != 0) { return false; }
+
+    const DMA_HandleTypeDef* dma = mMaster.GetDmaHandle();
+    if (dma == nullptr) { return false; }
+    if (dma->Init.PeriphDataAlignment != DMA_PDATAALIGN_WORD) { return false; }
+
+    // The slaves only need to be enabled: the master starts their conversions
+    bool result = mSlave.ConfigureConversion(true) && (HAL_ADC_Start(&mSlave.mHandle) == HAL_OK);
+    if (mSlave2 != nullptr)
+    {
+        result = result && mSlave2->ConfigureConversion(true) && (HAL_ADC_Start(&mSlave2->mHandle) == HAL_OK);
+    }
+
+    if (result && mMaster.StartStream(buffer, length, handler))
+    {
+        return true;
+    }
+
+    HAL_ADC_Stop(&mSlave.mHandle);
+    mSlave.ConfigureConversion(false);
+    if (mSlave2 != nullptr)
+    {
+        HAL_ADC_Stop(&mSlave2->mHandle);
+        mSlave2->ConfigureConversion(false);
+    }
+    return false;
+}
+
+/**
+ * \brief   Stop the stream started with StartStream().
+ * \returns True if the stream is stopped, false if it was not running.
+ */
+bool InterleavedAdc::StopStream()
+{
+    if (!IsStreaming()) { return false; }
+
+    bool result = mMaster.StopStream();
+
+    HAL_ADC_Stop(&mSlave.mHandle);
+    result &= mSlave.ConfigureConversion(false);
+    if (mSlave2 != nullptr)
+    {
+        HAL_ADC_Stop(&mSlave2->mHandle);
+        result &= mSlave2->ConfigureConversion(false);
+    }
+    return result;
+}
+
+/**
+ * \brief   Indicate if the ADCs are streaming.
+ * \returns True if streaming, else false.
+ */
+bool InterleavedAdc::IsStreaming() const
+{
+    return mMaster.IsStreaming();
+}
+
+/**
+ * \brief   Get the number of ADCs converting in turn.
+ * \returns 2 for dual, 3 for triple interleaved mode.
+ */
+uint8_t InterleavedAdc::GetAdcCount() const
+{
+    return mAdcCount;
+}
+
+/**
+ * \brief   Get the number of times the stream lost conversions. The stream
+ *          is restarted at the start of the buffer each time.
+ * \returns The number of overruns since StartStream().
+ */
+uint32_t InterleavedAdc::GetOverruns() const
+{
+    return mMaster.GetOverruns();
+}
+
+/**
+ * \brief   Get the rate of the merged stream.
+ * \returns The sample rate in Hz: ADCCLK / delay, 0 if not initialized.
+ */
+float InterleavedAdc::GetSampleRate() const
+{
+    if (!mInitialized) { return 0.0f; }
+
+    // ADCCLK is PCLK2 / 2, see Adc::Init()
+    return static_cast<float>(HAL_RCC_GetPCLK2Freq()) / (2.0f * mDelay);
+}
+
+/**
+ * \brief   Calculate the delay between the conversions of the ADCs.
+ * \details The shortest delay at which each ADC has finished its previous
+ *          conversion when it is its turn again, and the sampling phases do
+ *          not overlap.
+ * \param   adcs        Number of ADCs: 2 or 3.
+ * \param   resolution  The resolution of the conversions.
+ * \param   sampleTime  The sample time of the conversions.
+ * \returns The delay in ADCCLK cycles, 0 if the sample time is too long to
+ *          interleave.
+ */
+uint8_t InterleavedAdc::CalculateDelay(uint8_t adcs, Adc::Resolution resolution, Adc::SampleTime sampleTime)
+{
+    EXPECT((adcs == 2) || (adcs == 3));
+
+    if ((adcs != 2) && (adcs != 3)) { return 0; }
+
+    const uint16_t sample     = GetSampleCycles(sampleTime);
+    const uint16_t conversion = sample + GetResolutionCycles(resolution);
+
+    uint16_t delay = (conversion + adcs - 1) / adcs;
+    if (delay <= sample) { delay = sample + 1; }
+    if (delay < INTERLEAVED_ADC_MIN_DELAY) { delay = INTERLEAVED_ADC_MIN_DELAY; }
+
+    return (delay <= INTERLEAVED_ADC_MAX_DELAY) ? static_cast<uint8_t>(delay) : 0;
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Configure the common ADC registers.
+ * \param   interleaved     True for interleaved mode with DMA mode 2, false
+ *                          for independent ADCs.
+ * \returns True if the mode could be applied, else false.
+ */
+bool InterleavedAdc::ConfigureMultiMode(bool interleaved)
+{
+    ADC_MultiModeTypeDef multiMode = {};
+
+    if (interleaved)
+    {
+        multiMode.Mode             = (mAdcCount == 3) ? ADC_TRIPLEMODE_INTERL : ADC_DUALMODE_INTERL;
+        multiMode.DMAAccessMode    = ADC_DMAACCESSMODE_2;
+        multiMode.TwoSamplingDelay = (mDelay - INTERLEAVED_ADC_MIN_DELAY) * ADC_TWOSAMPLINGDELAY_6CYCLES;
+    }
+    else
+    {
+        multiMode.Mode             = ADC_MODE_INDEPENDENT;
+        multiMode.DMAAccessMode    = ADC_DMAACCESSMODE_DISABLED;
+        multiMode.TwoSamplingDelay = ADC_TWOSAMPLINGDELAY_5CYCLES;
+    }
+
+    return (HAL_ADCEx_MultiModeConfigChannel(&mMaster.mHandle, &multiMode) == HAL_OK);
+}
+
+/**
+ * \brief   Get the number of samples after which the DMA requests repeat:
+ *          dual 1 request (ADC1, ADC2), triple 3 requests (ADC1, ADC2, ADC3,
+ *          ADC1, ADC2, ADC3).
+ * \returns The number of samples in a round.
+ */
+uint8_t InterleavedAdc::GetRoundLength() const
+{
+    return (mAdcCount == 3) ? 6 : 2;
+}
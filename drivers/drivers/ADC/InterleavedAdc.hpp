@@ -0,0 +1,119 @@
+/**
+ * \file    InterleavedAdc.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   InterleavedAdc
+ *
+ * \brief   Dual or triple interleaved ADC: one channel sampled by ADC1, ADC2
+ *          (and ADC3) in turn, at two (or three) times the rate of one ADC.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/drivers/ADC
+ *
+ * \details Built on Adc: ADC1 is the master, it streams by a single circular
+ *          DMA from the common data register (DMA mode 2, two samples per
+ *          transfer). The samples arrive in order of conversion: ADC1, ADC2,
+ *          (ADC3,) ADC1, ... - one merged stream at ADCCLK / delay.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef INTERLEAVED_ADC_HPP_
+#define INTERLEAVED_ADC_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+#include "drivers/ADC/ADC.hpp"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     INTERLEAVED_ADC_MIN_DELAY
+ * \brief   Minimum delay between the conversions of two ADCs, in ADCCLK cycles.
+ */
+#define INTERLEAVED_ADC_MIN_DELAY   5
+
+/**
+ * \def     INTERLEAVED_ADC_MAX_DELAY
+ * \brief   Maximum delay between the conversions of two ADCs, in ADCCLK cycles.
+ */
+#define INTERLEAVED_ADC_MAX_DELAY   20
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+class InterleavedAdc final : public IConfigInitable
+{
+public:
+    /**
+     * \struct  Config
+     * \brief   Configuration struct for InterleavedAdc.
+     */
+    struct Config : public IConfig
+    {
+        /**
+         * \brief   Constructor of the InterleavedAdc configuration struct.
+         * \param   interruptPriority   Priority of the interrupt.
+         * \param   channel             Channel sampled by all ADCs.
+         * \param   resolution          Resolution of the captured data.
+         * \param   sampleTime          Sample time of each conversion, must be
+         *                              shorter than the delay between the ADCs.
+         */
+        Config(uint8_t interruptPriority, Adc::Channel channel, Adc::Resolution resolution = Adc::Resolution::_12_BIT, Adc::SampleTime sampleTime = Adc::SampleTime::_3_CYCLES) :
+            mInterruptPriority(interruptPriority),
+            mChannel(channel),
+            mResolution(resolution),
+            mSampleTime(sampleTime)
+        { }
+
+        uint8_t         mInterruptPriority;     ///< Interrupt priority.
+        Adc::Channel    mChannel;               ///< Channel to capture data from.
+        Adc::Resolution mResolution;            ///< Resolution of the captured data.
+        Adc::SampleTime mSampleTime;            ///< Sample time of each conversion.
+    };
+
+
+    InterleavedAdc(Adc& master, Adc& slave);
+    InterleavedAdc(Adc& master, Adc& slave, Adc& slave2);
+    virtual ~InterleavedAdc();
+
+    bool Init(const IConfig& config) override;
+    bool IsInit() const override;
+    bool Sleep() override;
+
+    DMA_HandleTypeDef*& GetDmaHandle();
+
+    bool StartStream(uint16_t* buffer, uint16_t length, const Delegate<void(const uint16_t*, uint16_t)>& handler);
+    bool StopStream();
+    bool IsStreaming() const;
+    uint8_t GetAdcCount() const;
+    uint32_t GetOverruns() const;
+    float GetSampleRate() const;
+
+    static uint8_t CalculateDelay(uint8_t adcs, Adc::Resolution resolution, Adc::SampleTime sampleTime);
+
+private:
+    Adc&    mMaster;
+    Adc&    mSlave;
+    Adc*    mSlave2;
+    uint8_t mAdcCount;
+    uint8_t mDelay;
+    bool    mInitialized;
+
+    bool ConfigureMultiMode(bool interleaved);
+    uint8_t GetRoundLength() const;
+};
+
+
+#endif  // INTERLEAVED_ADC_HPP_
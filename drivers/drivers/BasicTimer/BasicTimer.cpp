@@ -12,9 +12,12 @@
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/BasicTimer
  *
+ * \note    The timing is calculated as GenericTimer: Timer6 and Timer7 are
+ *          clocked from APB1 (twice PCLK1 if APB1 is divided).
+ *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    03-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -59,7 +62,8 @@ BasicTimer::BasicTimer(const BasicTimerInstance& instance) :
     mInstance(instance),
     mBasicTimerCallback( (instance == BasicTimerInstance::TIMER_6) ? (timer6_callback) : (timer7_callback) ),
     mInitialized(false),
-    mStarted(false)
+    mStarted(false),
+    mTiming()
 {
     SetInstance(instance);
 
@@ -77,18 +81,22 @@ BasicTimer::~BasicTimer()
 /**
  * \brief   Initializes the BasicTimer instance with the given configuration.
  * \param   config  The configuration for the BasicTimer instance to use.
- * \returns True if the configuration could be applied, else false.
- * \note    APB1 assumed to be 8 MHz.
+ * \returns True if the configuration could be applied, else false. Returns
+ *          false if the frequency cannot be made from the timer clock.
  */
 bool BasicTimer::Init(const IConfig& config)
 {
-    CheckAndEnableAHB1PeripheralClock(mInstance);
-
     const Config& cfg = reinterpret_cast<const Config&>(config);
 
-    mHandle.Init.Prescaler         = 8 - 1;                           // (Freq. APB1) / (Prescaler + 1) = (Freq. CLK_CNT) --> Get from 8 MHz to 1 MHz as timer counter
+    mInitialized = false;
+
+    if (!GenericTimer::CalculateTiming(GetClock(), cfg.mFrequency, mTiming)) { return false; }
+
+    CheckAndEnableAHB1PeripheralClock(mInstance);
+
+    mHandle.Init.Prescaler         = mTiming.mPrescaler;    // (Freq. timer clock) / (Prescaler + 1) = (Freq. CK_CNT)
     mHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
-    mHandle.Init.Period            = CalculatePeriod(cfg.mFrequency); // (Freq. desired) = (Freq. CNT_CLK) / (TIM_ARR + 1)
+    mHandle.Init.Period            = mTiming.mPeriod;       // (Freq. desired) = (Freq. CK_CNT) / (TIM_ARR + 1)
     mHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
     mHandle.Init.RepetitionCounter = 0;
     mHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
@@ -187,6 +195,17 @@ bool BasicTimer::Stop()
 }
 
 
+/**
+ * \brief   Get the frequency achieved, the sample rate of the DAC it
+ *          triggers.
+ * \returns The frequency in Hz, 0 if not initialized.
+ */
+float BasicTimer::GetFrequency() const
+{
+    return mInitialized ? mTiming.mFrequency : 0.0f;
+}
+
+
 /************************************************************************/
 /* Private Methods                                                      */
 /************************************************************************/
@@ -238,22 +257,15 @@ void BasicTimer::CheckAndDisableAHB1PeripheralClock(const BasicTimerInstance& in
 }
 
 /**
- * \brief   Calculate the BasicTimer period value.
- * \param   desiredFrequency    The desired frequency in Hz to use.
- * \returns Period value (TIM_ARR).
- * \note    The CLK_CNT is assumed to be 1 MHz.
+ * \brief   Get the clock of the timer: twice PCLK1, unless APB1 runs at the
+ *          AHB clock.
+ * \returns The timer clock in Hz.
  */
-uint16_t BasicTimer::CalculatePeriod(uint16_t desiredFrequency)
+uint32_t BasicTimer::GetClock()
 {
-    // Freq. CLK_CNT is 1 MHz
-    // (Freq. desired) = (Freq. CNT_CLK) / (TIM_ARR + 1)
-    // (1000000 / desiredFrequency) - 1 = TIM_ARR
-
-    uint32_t period = (1000000 / desiredFrequency) - 1;
-
-    if (period > UINT16_MAX) { period = UINT16_MAX; }
+    const uint32_t clock = HAL_RCC_GetPCLK1Freq();
 
-    return static_cast<uint16_t>(period);
+    return (clock == HAL_RCC_GetHCLKFreq()) ? clock : (2 * clock);
 }
 
 /**
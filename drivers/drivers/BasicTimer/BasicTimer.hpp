@@ -14,8 +14,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/BasicTimer
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    03-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef BASIC_TIMER_HPP_
@@ -25,9 +25,10 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/IBasicTimer.hpp"
+#include "drivers/GenericTimer/GenericTimer.hpp"
 #include "stm32f4xx_hal.h"
 
 
@@ -53,7 +54,7 @@ enum class BasicTimerInstance : uint8_t
  * \brief   Data structure to contain callback for a BasicTimer instance.
  */
 struct BasicTimerCallback {
-    std::function<void()> callbackIRQ = nullptr;    ///< Callback to call when IRQ occurs.
+    Delegate<void()> callbackIRQ = nullptr;    ///< Callback to call when IRQ occurs.
 };
 
 
@@ -66,23 +67,24 @@ public:
     /**
      * \struct  Config
      * \brief   Configuration struct for BasicTimer.
-     * \note    Can fine-tune frequency in the Init() and CalculatePeriod() methods.
+     * \note    The prescaler and period are calculated from the actual timer
+     *          clock, GetFrequency() reports the frequency achieved.
      */
     struct Config : public IConfig
     {
         /**
          * \brief   Constructor of the BasicTimer configuration struct.
          * \param   interruptPriority   Priority of the interrupt.
-         * \param   frequency           Frequency of the timer in Hz. Range [20..65535] Hz.
+         * \param   frequency           Frequency of the timer in Hz.
          */
         Config(uint8_t interruptPriority,
-               uint16_t frequency) :
+               float frequency) :
             mInterruptPriority(interruptPriority),
             mFrequency(frequency)
         { }
 
         uint8_t  mInterruptPriority;    ///< Interrupt priority.
-        uint16_t mFrequency;            ///< Frequency in Hz.
+        float    mFrequency;            ///< Frequency in Hz.
     };
 
     explicit BasicTimer(const BasicTimerInstance& instance);
@@ -96,17 +98,20 @@ public:
     bool IsStarted() const override;
     bool Stop() override;
 
+    float GetFrequency() const;
+
 private:
-    BasicTimerInstance  mInstance;
-    TIM_HandleTypeDef   mHandle = {};
-    BasicTimerCallback& mBasicTimerCallback;
-    bool                mInitialized;
-    bool                mStarted;
+    BasicTimerInstance          mInstance;
+    TIM_HandleTypeDef           mHandle = {};
+    BasicTimerCallback&         mBasicTimerCallback;
+    bool                        mInitialized;
+    bool                        mStarted;
+    GenericTimer::TimingSetting mTiming;
 
     void SetInstance(const BasicTimerInstance& instance);
     void CheckAndEnableAHB1PeripheralClock(const BasicTimerInstance& instance);
     void CheckAndDisableAHB1PeripheralClock(const BasicTimerInstance& instance);
-    uint16_t CalculatePeriod(uint16_t desiredFrequency);
+    uint32_t GetClock();
     IRQn_Type GetIRQn(const BasicTimerInstance& instance);
     void SetIRQn(IRQn_Type type, uint32_t preemptPrio, uint32_t subPrio);
     void CallbackIRQ();
@@ -19,9 +19,13 @@
  *          DMA is fixed: DMA1 Channel 7, Stream 5 --> PA4 (DAC Channel 1)
  *                        DMA1 Channel 7, Stream 6 --> PA5 (DAC Channel 2)
  *
+ * \note    Streaming: the handler fills both halves before the DMA starts,
+ *          then refills each half as soon as the DMA moved on to the other
+ *          half. The CPU is involved once per half buffer, not per sample.
+ *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.2
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -32,6 +36,29 @@
 #include "stm32f4xx_hal_dac.h"
 
 
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static DACCallbacks dac_callbacks {};
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Call the block callback, if configured (streaming).
+ * \param   callbackBlock   The callbackBlock of the channel to call.
+ * \param   half            The half of the stream buffer output: 0 or 1.
+ */
+static void CallbackBlock(const Delegate<void(uint8_t)>& callbackBlock, uint8_t half)
+{
+    if (callbackBlock)
+    {
+        callbackBlock(half);
+    }
+}
+
+
 /************************************************************************/
 /* Public Methods                                                       */
 /************************************************************************/
@@ -79,11 +106,14 @@ bool Dac::IsInit() const
 
 /**
  * \brief   Puts the DAC module in sleep mode.
- * \details Stops output on channel(s).
+ * \details Stops output (and streams) on channel(s).
  * \returns True if DAC module could be put in sleep mode, else false.
  */
 bool Dac::Sleep()
 {
+    StopStream(Channel::CHANNEL_1);
+    StopStream(Channel::CHANNEL_2);
+
     StopChannel(Channel::CHANNEL_1);
     StopChannel(Channel::CHANNEL_2);
 
@@ -299,6 +329,110 @@ bool Dac::StopWaveform(const Channel& channel)
 }
 
 
+/**
+ * \brief   Start streaming on the given channel: the DMA outputs the buffer
+ *          in a loop, each half is refilled by the handler while the DMA
+ *          outputs the other half.
+ * \details The handler is called with (block, length): first for both
+ *          halves, before the DMA starts, then for each half the DMA is done
+ *          with. It must fill the block before the DMA is done with the
+ *          other half: half the buffer length in samples.
+ * \param   channel     Channel to stream on.
+ * \param   buffer      Pointer to the buffer the DMA outputs.
+ * \param   length      Length of the buffer in samples, a multiple of 2.
+ * \param   handler     Callback to call to fill a block, called from the
+ *                      DMA interrupt.
+ * \returns True if the stream could be started, else false. Returns false if
+ *          not initialized, no DMA is setup, the DMA is not in circular mode
+ *          or the channel is already started.
+ * \note    Asserts if buffer is nullptr, length or handler invalid.
+ * \note    The DMA half transfer interrupt must be enabled.
+ */
+bool Dac::StartStream(const Channel& channel, uint16_t* buffer, uint16_t length, const Delegate<void(uint16_t*, uint16_t)>& handler)
+{
+    EXPECT(buffer);
+    EXPECT(length > 0);
+    EXPECT(handler);
+
+    if (buffer == nullptr) { return false; }
+    if ((length == 0) || ((length % 2) != 0)) { return false; }
+    if (!handler) { return false; }
+    if (!mInitialized) { return false; }
+
+    const DMA_HandleTypeDef* dma = (channel == Channel::CHANNEL_1) ? mHandle.DMA_Handle1 : mHandle.DMA_Handle2;
+    const ChannelConfig& config  = (channel == Channel::CHANNEL_1) ? mChannel1 : mChannel2;
+
+    if (dma == nullptr) { return false; }
+    if (dma->Init.Mode != DMA_CIRCULAR) { return false; }
+    if (config.mStarted) { return false; }
+
+    // Both halves filled before the first sample is output
+    handler(buffer, length / 2);
+    handler(&buffer[length / 2], length / 2);
+
+    switch (channel)
+    {
+        case Channel::CHANNEL_1:
+            mBlockHandlerChannel1 = handler;
+            dac_callbacks.callbackBlockChannel1 = [this](uint8_t half) { this->CallbackBlock(Channel::CHANNEL_1, half); };
+            break;
+        case Channel::CHANNEL_2:
+            mBlockHandlerChannel2 = handler;
+            dac_callbacks.callbackBlockChannel2 = [this](uint8_t half) { this->CallbackBlock(Channel::CHANNEL_2, half); };
+            break;
+        default: ASSERT(false); while(1) { __NOP(); } break;    // Impossible selection
+    }
+
+    SetWaveform(channel, buffer, length);
+
+    if (StartWaveform(channel))
+    {
+        return true;
+    }
+
+    StopStream(channel);
+    return false;
+}
+
+/**
+ * \brief   Stop the stream started with StartStream().
+ * \param   channel     Channel to stop the stream on.
+ * \returns True if the stream is stopped, false if it was not running.
+ */
+bool Dac::StopStream(const Channel& channel)
+{
+    if (!IsStreaming(channel)) { return false; }
+
+    StopWaveform(channel);
+
+    switch (channel)
+    {
+        case Channel::CHANNEL_1:
+            dac_callbacks.callbackBlockChannel1 = nullptr;
+            mBlockHandlerChannel1 = nullptr;
+            break;
+        case Channel::CHANNEL_2:
+            dac_callbacks.callbackBlockChannel2 = nullptr;
+            mBlockHandlerChannel2 = nullptr;
+            break;
+        default: ASSERT(false); while(1) { __NOP(); } break;    // Impossible selection
+    }
+
+    SetWaveform(channel, nullptr, 0);
+    return true;
+}
+
+/**
+ * \brief   Indicate if the given channel is streaming.
+ * \param   channel     The channel to check.
+ * \returns True if streaming, else false.
+ */
+bool Dac::IsStreaming(const Channel& channel) const
+{
+    return (channel == Channel::CHANNEL_1) ? static_cast<bool>(mBlockHandlerChannel1) : static_cast<bool>(mBlockHandlerChannel2);
+}
+
+
 /************************************************************************/
 /* Private Methods                                                      */
 /************************************************************************/
@@ -460,3 +594,69 @@ void Dac::SetWaveform(const Channel& channel, const uint16_t* values, uint16_t l
         default: ASSERT(false); while(1) { __NOP(); } break;    // Impossible selection
     };
 }
+
+/**
+ * \brief   ISR: the DMA is done with a half of the stream buffer, let the
+ *          handler refill it.
+ * \param   channel     The channel streaming.
+ * \param   half        The half output: 0 or 1.
+ */
+void Dac::CallbackBlock(const Channel& channel, uint8_t half)
+{
+    const Waveform& waveform = (channel == Channel::CHANNEL_1) ? mWaveformChannel1 : mWaveformChannel2;
+    const uint16_t blockLength = waveform.mLength / 2;
+
+    Delegate<void(uint16_t*, uint16_t)> handler = (channel == Channel::CHANNEL_1) ? mBlockHandlerChannel1 : mBlockHandlerChannel2;
+    if (handler)
+    {
+        handler(&waveform.mValues[half * blockLength], blockLength);
+    }
+}
+
+
+/************************************************************************/
+/* Interrupts                                                           */
+/************************************************************************/
+/**
+ * \brief   ISR: the DMA of channel 1 output the first half of the buffer.
+ * \param   handle  The DAC handle.
+ */
+void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    CallbackBlock(dac_callbacks.callbackBlockChannel1, 0);
+}
+
+/**
+ * \brief   ISR: the DMA of channel 1 output the second half of the buffer.
+ * \param   handle  The DAC handle.
+ */
+void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    CallbackBlock(dac_callbacks.callbackBlockChannel1, 1);
+}
+
+/**
+ * \brief   ISR: the DMA of channel 2 output the first half of the buffer.
+ * \param   handle  The DAC handle.
+ */
+void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    CallbackBlock(dac_callbacks.callbackBlockChannel2, 0);
+}
+
+/**
+ * \brief   ISR: the DMA of channel 2 output the second half of the buffer.
+ * \param   handle  The DAC handle.
+ */
+void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    CallbackBlock(dac_callbacks.callbackBlockChannel2, 1);
+}
@@ -15,10 +15,12 @@
  *
  * \note    Either use software trigger, or use DMA in combination with a timer - assume BasicTimer 6 or 7 is used?
  *          Can be any timer. Also can be external trigger.
+ *          Streaming: a circular DMA outputs a buffer, each half is refilled
+ *          by a handler while the other half is output (utility/Dds).
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.2
+ * \date    10-2026
  */
 
 #ifndef DAC_HPP_
@@ -29,11 +31,25 @@
 /************************************************************************/
 #include <cstdint>
 #include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/IDAC.hpp"
 #include "stm32f4xx_hal.h"
 
 
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  DACCallbacks
+ * \brief   Data structure to contain the stream callbacks of the DAC channels.
+ */
+struct DACCallbacks {
+    Delegate<void(uint8_t)> callbackBlockChannel1 = nullptr;    ///< Callback to call when the first (0) or second half (1) of the channel 1 stream buffer is output.
+    Delegate<void(uint8_t)> callbackBlockChannel2 = nullptr;    ///< Callback to call when the first (0) or second half (1) of the channel 2 stream buffer is output.
+};
+
+
 /************************************************************************/
 /* Class declaration                                                    */
 /************************************************************************/
@@ -135,6 +151,10 @@ public:
     bool StartWaveform(const Channel& channel) override;
     bool StopWaveform(const Channel& channel) override;
 
+    bool StartStream(const Channel& channel, uint16_t* buffer, uint16_t length, const Delegate<void(uint16_t*, uint16_t)>& handler);
+    bool StopStream(const Channel& channel);
+    bool IsStreaming(const Channel& channel) const;
+
 private:
     DAC_HandleTypeDef mHandle = {};
     bool              mInitialized;
@@ -143,6 +163,9 @@ private:
     Waveform          mWaveformChannel1 = {};
     Waveform          mWaveformChannel2 = {};
 
+    Delegate<void(uint16_t*, uint16_t)> mBlockHandlerChannel1;
+    Delegate<void(uint16_t*, uint16_t)> mBlockHandlerChannel2;
+
     void CheckAndEnableAHB1PeripheralClock();
     void CheckAndDisableAHB1PeripheralClock();
 
@@ -152,6 +175,7 @@ private:
     bool StartChannel(const Channel& channel);
     bool StopChannel(const Channel& channel);
     void SetWaveform(const Channel& channel, const uint16_t* values, uint16_t length);
+    void CallbackBlock(const Channel& channel, uint8_t half);
 };
 
 
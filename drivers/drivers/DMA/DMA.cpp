@@ -14,14 +14,14 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/DMA
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    09-2019
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
 /* Includes                                                             */
 /************************************************************************/
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "drivers/DMA/DMA.hpp"
 #include "utility/Assert/Assert.h"
 
@@ -29,8 +29,8 @@
 /************************************************************************/
 /* Static variables                                                     */
 /************************************************************************/
-static std::function<void()> dma1Callbacks[8] {};
-static std::function<void()> dma2Callbacks[8] {};
+static Delegate<void()> dma1Callbacks[8] {};
+static Delegate<void()> dma2Callbacks[8] {};
 
 
 /************************************************************************/
@@ -64,11 +64,12 @@ DMA::~DMA()
  * \param   channel             The DMA channel to configure for.
  * \param   direction           The direction of the DMA to use.
  * \param   bufferMode          The buffer mode to use.
- * \param   width               Memory data width to use. Default Byte size.
+ * \param   width               Data width to use, for peripheral and memory. Default Byte size.
  * \param   priority            DMA priority. Default Low.
  * \param   halfBufferInterrupt Flag, indicating half buffer interrupt is to be used or not. Default true.
  * \returns True if the DMA object could be configured, else false.
- * \note    Peripheral data width is fixed at Byte size.
+ * \note    Peripheral and memory use the same data width (direct mode, no
+ *          FIFO): HalfWord for the ADC and DAC, Byte for SPI and USART.
  */
 bool DMA::Configure(Channel channel, Direction direction, BufferMode bufferMode, DataWidth width /* = DataWidth::Byte */, Priority priority /* = Priority::Low */, HalfBufferInterrupt halfBufferInterrupt /* = HalfBufferInterrupt::Enabled */)
 {
@@ -81,8 +82,8 @@ bool DMA::Configure(Channel channel, Direction direction, BufferMode bufferMode,
     mHandle.Init.Direction           = GetDirection(direction);
     mHandle.Init.PeriphInc           = DMA_PINC_DISABLE;
     mHandle.Init.MemInc              = DMA_MINC_ENABLE;
-    mHandle.Init.PeriphDataAlignment = DMA_PDATAALIGN_BYTE;     // Fixed ay Byte size.
-    mHandle.Init.MemDataAlignment    = GetDataWidth(width);
+    mHandle.Init.PeriphDataAlignment = GetPeripheralDataWidth(width);
+    mHandle.Init.MemDataAlignment    = GetMemoryDataWidth(width);
     mHandle.Init.Mode                = (bufferMode == DMA::BufferMode::Circular) ? DMA_CIRCULAR : DMA_NORMAL;
     mHandle.Init.Priority            = GetPriority(priority);
     mHandle.Init.FIFOMode            = DMA_FIFOMODE_DISABLE;
@@ -199,11 +200,11 @@ uint32_t DMA::GetDirection(Direction direction)
 }
 
 /**
- * \brief   Get the DMA data width as register value.
+ * \brief   Get the DMA peripheral data width as register value.
  * \param   width   The data width to get the register value for.
- * \returns The data width as register value.
+ * \returns The peripheral data width as register value.
  */
-uint32_t DMA::GetDataWidth(DataWidth width)
+uint32_t DMA::GetPeripheralDataWidth(DataWidth width)
 {
     switch (width)
     {
@@ -214,6 +215,22 @@ uint32_t DMA::GetDataWidth(DataWidth width)
     }
 }
 
+/**
+ * \brief   Get the DMA memory data width as register value.
+ * \param   width   The data width to get the register value for.
+ * \returns The memory data width as register value.
+ */
+uint32_t DMA::GetMemoryDataWidth(DataWidth width)
+{
+    switch (width)
+    {
+        case DataWidth::Byte:     return DMA_MDATAALIGN_BYTE;     break;
+        case DataWidth::HalfWord: return DMA_MDATAALIGN_HALFWORD; break;
+        case DataWidth::Word:     return DMA_MDATAALIGN_WORD;     break;
+        default: ASSERT(false); while(1) { __NOP(); } return DMA_MDATAALIGN_BYTE; break;    // Impossible selection
+    }
+}
+
 /**
  * \brief   Get the DMA priority as register value.
  * \param   priority    The priority to get the register value for.
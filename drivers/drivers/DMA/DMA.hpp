@@ -14,8 +14,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/DMA
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    09-2019
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef DMA_HPP_
@@ -154,7 +154,8 @@ private:
     DMA_Stream_TypeDef* GetInstance(Stream stream);
     uint32_t GetChannel(Channel channel);
     uint32_t GetDirection(Direction direction);
-    uint32_t GetDataWidth(DataWidth width);
+    uint32_t GetPeripheralDataWidth(DataWidth width);
+    uint32_t GetMemoryDataWidth(DataWidth width);
     uint32_t GetPriority(Priority priority);
 
     void ConnectInternalCallback(Stream stream);
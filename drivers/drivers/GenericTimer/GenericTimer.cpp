@@ -13,8 +13,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/GenericTimer
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -25,6 +25,17 @@
 #include "stm32f4xx_hal_tim.h"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     GENERIC_TIMER_PRESCALER_SEARCH
+ * \brief   Number of prescalers tried to find an exact divider, bounds the
+ *          time spent in Init().
+ */
+#define GENERIC_TIMER_PRESCALER_SEARCH  1024
+
+
 /************************************************************************/
 /* Static variables                                                     */
 /************************************************************************/
@@ -87,7 +98,8 @@ GenericTimer::GenericTimer(const GenericTimerInstance& instance) :
                            ((instance == GenericTimerInstance::TIMER_12) ? timer12_callback :
                            ((instance == GenericTimerInstance::TIMER_13) ? timer13_callback : timer14_callback))))))))) ),
     mInitialized(false),
-    mStarted(false)
+    mStarted(false),
+    mTiming()
 {
     SetInstance(instance);
 
@@ -106,23 +118,37 @@ GenericTimer::~GenericTimer()
  * \brief   Initializes the GenericTimer instance with the given configuration.
  * \param   config  The configuration for the GenericTimer instance to use.
  * \returns True if the configuration could be applied, else false.
- * \note    APB1 and APB2 assumed to be 8 MHz.
+ * \note    The prescaler and period are calculated from the timer clock of
+ *          the APB bus the timer is on, configure the clocks first.
  */
 bool GenericTimer::Init(const IConfig& config)
 {
-    CheckAndEnableAHBPeripheralClock(mInstance);
-
     const Config& cfg = reinterpret_cast<const Config&>(config);
 
-    mHandle.Init.Prescaler         = 800 - 1;                            // (Freq. APB) / (Prescaler + 1) = (Freq. CK_CNT) --> Get from 8 MHz to 10 kHz as timer counter
+    EXPECT(!cfg.mTriggerOutput || HasTriggerOutput(mInstance));
+
+    if (cfg.mTriggerOutput && !HasTriggerOutput(mInstance))            { return false; }
+    if (!CalculateTiming(GetClock(mInstance), cfg.mFrequency, mTiming)) { return false; }
+
+    CheckAndEnableAHBPeripheralClock(mInstance);
+
+    mHandle.Init.Prescaler         = mTiming.mPrescaler;    // (Freq. timer clock) / (Prescaler + 1) = (Freq. CK_CNT)
     mHandle.Init.CounterMode       = TIM_COUNTERMODE_UP;
-    mHandle.Init.Period            = CalculatePeriod(cfg.mFrequency);    // (Freq. desired) = (Freq. CK_CNT) / (TIM_ARR + 1)
+    mHandle.Init.Period            = mTiming.mPeriod;       // (Freq. desired) = (Freq. CK_CNT) / (TIM_ARR + 1)
     mHandle.Init.ClockDivision     = TIM_CLOCKDIVISION_DIV1;
     mHandle.Init.RepetitionCounter = 0;
     mHandle.Init.AutoReloadPreload = TIM_AUTORELOAD_PRELOAD_ENABLE;
 
     if (HAL_TIM_Base_Init(&mHandle) == HAL_OK)
     {
+        if (cfg.mTriggerOutput)
+        {
+            TIM_MasterConfigTypeDef masterConfig = {};
+            masterConfig.MasterOutputTrigger = TIM_TRGO_UPDATE;
+            masterConfig.MasterSlaveMode     = TIM_MASTERSLAVEMODE_DISABLE;
+            if (HAL_TIMEx_MasterConfigSynchronization(&mHandle, &masterConfig) != HAL_OK) { return false; }
+        }
+
         // Configure NVIC to generate interrupt
         SetIRQn(GetIRQn(mInstance), cfg.mInterruptPriority, 0);
 
@@ -165,10 +191,12 @@ bool GenericTimer::Sleep()
 
 /**
  * \brief   Starts the timer.
- * \param   handler     Callback to call when timer elapsed.
+ * \param   handler     Callback to call when timer elapsed. If empty the
+ *                      timer runs without interrupts, for instance when only
+ *                      used as trigger output.
  * \returns True if the timer could be started, else false.
  */
-bool GenericTimer::Start(const std::function<void()>& handler)
+bool GenericTimer::Start(const Delegate<void()>& handler)
 {
     if (!mInitialized) { return false; }
 
@@ -176,7 +204,8 @@ bool GenericTimer::Start(const std::function<void()>& handler)
     {
         mGenericTimerCallback.callbackElapsed = handler;
 
-        HAL_TIM_Base_Start_IT(&mHandle);
+        if (handler) { HAL_TIM_Base_Start_IT(&mHandle); }
+        else         { HAL_TIM_Base_Start(&mHandle);    }
         mStarted = true;
     }
 
@@ -209,6 +238,67 @@ bool GenericTimer::Stop()
     return true;
 }
 
+/**
+ * \brief   Get the frequency the timer runs at, which can deviate slightly
+ *          from the configured frequency.
+ * \returns The achieved frequency in Hz, 0.0 if not initialized.
+ */
+float GenericTimer::GetFrequency() const
+{
+    return (mInitialized) ? mTiming.mFrequency : 0.0f;
+}
+
+/**
+ * \brief   Calculate the prescaler and period for a frequency.
+ * \details The smallest prescaler is used for the finest period, unless a
+ *          slightly larger prescaler divides the clock exactly.
+ * \param   clock       The timer clock in Hz.
+ * \param   frequency   The desired frequency in Hz.
+ * \param   setting     Receives the prescaler and period and the frequency
+ *                      they result in.
+ * \returns True if the frequency can be made from the clock, else false.
+ */
+bool GenericTimer::CalculateTiming(uint32_t clock, float frequency, TimingSetting& setting)
+{
+    EXPECT(frequency > 0.0f);
+
+    if (clock == 0)            { return false; }
+    if (!(frequency > 0.0f))   { return false; }
+
+    // Timer clocks per update: (Prescaler + 1) * (TIM_ARR + 1)
+    const float ticks = static_cast<float>(clock) / frequency;
+
+    if (ticks < 2.0f)          { return false; }    // Too fast, TIM_ARR of at least 1
+    if (ticks > 4294967296.0f) { return false; }    // Too slow, 16 bit prescaler and period
+
+    const uint64_t divider = static_cast<uint64_t>(ticks + 0.5f);
+
+    uint32_t bestPrescaler = 0;
+    uint32_t bestPeriod    = 0;
+    uint64_t bestError     = UINT64_MAX;
+
+    const uint32_t minPrescaler = static_cast<uint32_t>((divider + 0xFFFF) / 0x10000);
+    for (uint32_t prescaler = minPrescaler; (prescaler <= 0x10000) && (prescaler < minPrescaler + GENERIC_TIMER_PRESCALER_SEARCH); prescaler++)
+    {
+        const uint32_t period = static_cast<uint32_t>((divider + (prescaler / 2)) / prescaler);
+        const uint64_t actual = static_cast<uint64_t>(prescaler) * period;
+        const uint64_t error  = (actual > divider) ? (actual - divider) : (divider - actual);
+
+        if (error < bestError)
+        {
+            bestPrescaler = prescaler;
+            bestPeriod    = period;
+            bestError     = error;
+        }
+        if (error == 0) { break; }
+    }
+
+    setting.mPrescaler = static_cast<uint16_t>(bestPrescaler - 1);
+    setting.mPeriod    = static_cast<uint16_t>(bestPeriod - 1);
+    setting.mFrequency = static_cast<float>(clock) / (static_cast<float>(bestPrescaler) * static_cast<float>(bestPeriod));
+    return true;
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -285,26 +375,50 @@ void GenericTimer::CheckAndDisableAHBPeripheralClock(const GenericTimerInstance&
 }
 
 /**
- * \brief   Calculate the GenericTimer period value.
- * \param   desiredFrequency    The desired frequency in Hz to use.
- * \returns Period value (TIM_ARR).
- * \note    The CK_CNT is assumed to be 10 kHz.
- *          Asserts if desiredFrequency not within valid range.
+ * \brief   Get the clock the GenericTimer counts, TIM9, TIM10 and TIM11 are
+ *          on APB2, the others on APB1.
+ * \param   instance    The GenericTimer instance to get the clock for.
+ * \returns The timer clock in Hz. If the APB bus runs slower than the AHB
+ *          bus the timers run at twice the APB clock.
+ * \note    Asserts if not a valid GenericTimer instance provided.
  */
-uint16_t GenericTimer::CalculatePeriod(float desiredFrequency)
+uint32_t GenericTimer::GetClock(const GenericTimerInstance& instance)
 {
-    // Freq. CK_CNT is 10 kHz
-    // (Freq. desired) = (Freq. CK_CNT) / (TIM_ARR + 1)
-    // (10000 / desiredFrequency) - 1 = TIM_ARR
+    uint32_t clock = 0;
 
-    EXPECT(desiredFrequency > 0.0);
-    EXPECT(desiredFrequency <= 10000.0);
-
-    uint32_t period = (10000 / desiredFrequency) - 1;
+    switch (instance)
+    {
+        case GenericTimerInstance::TIMER_9:
+        case GenericTimerInstance::TIMER_10:
+        case GenericTimerInstance::TIMER_11: clock = HAL_RCC_GetPCLK2Freq(); break;
+        case GenericTimerInstance::TIMER_2:
+        case GenericTimerInstance::TIMER_3:
+        case GenericTimerInstance::TIMER_4:
+        case GenericTimerInstance::TIMER_5:
+        case GenericTimerInstance::TIMER_12:
+        case GenericTimerInstance::TIMER_13:
+        case GenericTimerInstance::TIMER_14: clock = HAL_RCC_GetPCLK1Freq(); break;
+        default: ASSERT(false); return 0; break;
+    }
 
-    if (period > 10000) { period = 10000; }
+    return (clock == HAL_RCC_GetHCLKFreq()) ? clock : (2 * clock);
+}
 
-    return static_cast<uint16_t>(period);
+/**
+ * \brief   Indicate if the GenericTimer has a trigger output (master mode).
+ * \param   instance    The GenericTimer instance to check.
+ * \returns True if the update event can be put on TRGO, else false.
+ */
+bool GenericTimer::HasTriggerOutput(const GenericTimerInstance& instance)
+{
+    switch (instance)
+    {
+        case GenericTimerInstance::TIMER_2:
+        case GenericTimerInstance::TIMER_3:
+        case GenericTimerInstance::TIMER_4:
+        case GenericTimerInstance::TIMER_5: return true;  break;
+        default:                            return false; break;
+    }
 }
 
 /**
@@ -13,9 +13,15 @@
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/GenericTimer
  *
+ * \details The prescaler and period are calculated from the actual timer
+ *          clock, the achieved frequency is available with GetFrequency().
+ *          Optionally the update event is put on the trigger output (TRGO),
+ *          to pace the ADC (TIM2, TIM3) or the DAC (TIM2, TIM4, TIM5) in
+ *          hardware.
+ *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef GENERIC_TIMER_HPP_
@@ -25,7 +31,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/IGenericTimer.hpp"
 #include "stm32f4xx_hal.h"
@@ -61,8 +67,8 @@ enum class GenericTimerInstance : uint8_t
  * \brief   Data structure to contain callback for a GenericTimer instance.
  */
 struct GenericTimerCallbacks {
-    std::function<void()> callbackIRQ = nullptr;        ///< Callback to call when IRQ occurs.
-    std::function<void()> callbackElapsed = nullptr;    ///< Callback to call when timer elapsed event occurs.
+    Delegate<void()> callbackIRQ = nullptr;        ///< Callback to call when IRQ occurs.
+    Delegate<void()> callbackElapsed = nullptr;    ///< Callback to call when timer elapsed event occurs.
 };
 
 
@@ -75,25 +81,43 @@ public:
     /**
      * \struct  Config
      * \brief   Configuration struct for GenericTimer.
-     * \note    Can fine-tune frequency in the Init() and CalculatePeriod() methods.
      */
     struct Config : public IConfig
     {
         /**
          * \brief   Constructor of the GenericTimer configuration struct.
          * \param   interruptPriority   Priority of the interrupt.
-         * \param   frequency           Frequency of the timer in Hz. Range [0.0 .. 10000.0] Hz (excluding max values).
+         * \param   frequency           Frequency of the timer in Hz. Range (timer clock / 2^32) up to (timer clock / 2) Hz.
+         * \param   triggerOutput       True to put the update event on the trigger output (TRGO), only
+         *                              available for TIM2 up to TIM5.
          */
         Config(uint8_t interruptPriority,
-               float frequency) :
+               float frequency,
+               bool triggerOutput = false) :
             mInterruptPriority(interruptPriority),
-            mFrequency(frequency)
+            mFrequency(frequency),
+            mTriggerOutput(triggerOutput)
         { }
 
         uint8_t mInterruptPriority;    ///< Interrupt priority.
         float   mFrequency;            ///< Frequency in Hz.
+        bool    mTriggerOutput;        ///< Update event as trigger output (TRGO).
     };
 
+    /**
+     * \struct  TimingSetting
+     * \brief   Prescaler and period for a frequency and the resulting frequency.
+     */
+    struct TimingSetting
+    {
+        uint16_t     mPrescaler = 0;            ///< Value for the prescaler register (PSC).
+        uint16_t     mPeriod    = 0;            ///< Value for the auto-reload register (ARR).
+        float        mFrequency = 0.0f;         ///< Achieved frequency in Hz.
+    };
+
+    static bool CalculateTiming(uint32_t clock, float frequency, TimingSetting& setting);
+
+
     explicit GenericTimer(const GenericTimerInstance& instance);
     virtual ~GenericTimer();
 
@@ -101,21 +125,25 @@ public:
     bool IsInit() const override;
     bool Sleep() override;
 
-    bool Start(const std::function<void()>& handler) override;
+    bool Start(const Delegate<void()>& handler) override;
     bool IsStarted() const override;
     bool Stop() override;
 
+    float GetFrequency() const;
+
 private:
     GenericTimerInstance   mInstance;
     TIM_HandleTypeDef      mHandle = {};
     GenericTimerCallbacks& mGenericTimerCallback;
     bool                   mInitialized;
     bool                   mStarted;
+    TimingSetting          mTiming;
 
     void SetInstance(const GenericTimerInstance& instance);
     void CheckAndEnableAHBPeripheralClock(const GenericTimerInstance& instance);
     void CheckAndDisableAHBPeripheralClock(const GenericTimerInstance& instance);
-    uint16_t CalculatePeriod(float desiredFrequency);
+    uint32_t GetClock(const GenericTimerInstance& instance);
+    bool HasTriggerOutput(const GenericTimerInstance& instance);
     IRQn_Type GetIRQn(const GenericTimerInstance& instance);
     void SetIRQn(IRQn_Type type, uint32_t preemptPrio, uint32_t subPrio);
     void CallbackIRQ();
@@ -219,7 +219,7 @@ DMA_HandleTypeDef*& I2C::GetDmaRxHandle()
  * \returns True if the transaction could be started, else false. Returns false if no DMA is setup for Tx.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool I2C::WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool I2C::WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -245,7 +245,7 @@ bool I2C::WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const std
  *          if no DMA is setup for Rx.
  * \note    Asserts if dest is nullptr or length invalid.
  */
-bool I2C::ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool I2C::ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(dest);
     EXPECT(length > 0);
@@ -270,7 +270,7 @@ bool I2C::ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const std::func
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool I2C::WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool I2C::WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -294,7 +294,7 @@ bool I2C::WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, con
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if dest is nullptr or length invalid.
  */
-bool I2C::ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler)
+bool I2C::ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(dest);
     EXPECT(length > 0);
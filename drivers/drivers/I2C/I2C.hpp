@@ -25,7 +25,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/II2C.hpp"
 #include "stm32f4xx_hal.h"
@@ -54,10 +54,10 @@ enum class I2CInstance : uint8_t
  * \brief   Data structure to contain callbacks for an I2C instance.
  */
 struct I2CCallbacks {
-    std::function<void()> callbackEvent = nullptr;  ///< Callback to call when Event occurs.
-    std::function<void()> callbackError = nullptr;  ///< Callback to call when Error occurs.
-    std::function<void()> callbackTx    = nullptr;  ///< Callback to call when Tx done.
-    std::function<void()> callbackRx    = nullptr;  ///< Callback to call when Rx done.
+    Delegate<void()> callbackEvent = nullptr;  ///< Callback to call when Event occurs.
+    Delegate<void()> callbackError = nullptr;  ///< Callback to call when Error occurs.
+    Delegate<void()> callbackTx    = nullptr;  ///< Callback to call when Tx done.
+    Delegate<void()> callbackRx    = nullptr;  ///< Callback to call when Rx done.
 };
 
 
@@ -112,11 +112,11 @@ public:
     DMA_HandleTypeDef*& GetDmaTxHandle();
     DMA_HandleTypeDef*& GetDmaRxHandle();
 
-    bool WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
+    bool WriteDMA(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadDMA(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
 
-    bool WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
+    bool WriteInterrupt(uint8_t slave, const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadInterrupt(uint8_t slave, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
 
     bool WriteBlocking(uint8_t slave, const uint8_t* src, uint16_t length) override;
     bool ReadBlocking(uint8_t slave, uint8_t* dest, uint16_t length) override;
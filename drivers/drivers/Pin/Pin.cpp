@@ -249,7 +249,7 @@ void Pin::Configure(Alternate alternate, PullUpDown pullUpDown /* = PullUpDown::
  * \note    This method assumes the HAL has set NVIC_PRIORITYGROUP_4.
  * \returns True if the interrupt could be configured, else false.
  */
-bool Pin::Interrupt(Trigger trigger, const std::function<void()>& callback, bool enableAfterConfigure /* = true */)
+bool Pin::Interrupt(Trigger trigger, const Delegate<void()>& callback, bool enableAfterConfigure /* = true */)
 {
     ASSERT(mDirection == Direction::INPUT);     // Cannot configure interrupt if pin is not configured as input
     ASSERT(callback);                           // Cannot configure interrupt without callback
@@ -11,13 +11,14 @@
  *
  * \brief   SPI peripheral driver class - Master only.
  *
- * \note    The ChipSelect must be toggled outside this driver.
+ * \note    The ChipSelect must be toggled outside this driver, or by using
+ *          ChipSelect segments in a Transfer.
  *
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/drivers/SPI
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.1
- * \date    05-2021
+ * \version 1.2
+ * \date    10-2026
  */
 
 #ifndef SPI_HPP_
@@ -27,7 +28,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/ISPI.hpp"
 #include "stm32f4xx_hal.h"
@@ -56,8 +57,9 @@ enum class SPIInstance : uint8_t
  * \brief   Data structure to contain callbacks for a SPI instance.
  */
 struct SPICallbacks {
-    std::function<void()> callbackIRQ  = nullptr;   ///< Callback to call when IRQ occurs.
-    std::function<void()> callbackTxRx = nullptr;   ///< Callback to call when Tx/Rx done.
+    Delegate<void()> callbackIRQ   = nullptr;  ///< Callback to call when IRQ occurs.
+    Delegate<void()> callbackTxRx  = nullptr;  ///< Callback to call when Tx/Rx done.
+    Delegate<void()> callbackError = nullptr;  ///< Callback to call when the HAL reports an error.
 };
 
 
@@ -113,23 +115,30 @@ public:
     DMA_HandleTypeDef*& GetDmaTxHandle();
     DMA_HandleTypeDef*& GetDmaRxHandle();
 
-    bool WriteDMA(const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadDMA(uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
+    bool Transfer(const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler) override;
 
-    bool WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void()>& handler) override;
+    bool WriteDMA(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool WriteReadDMA(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadDMA(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+
+    bool WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool WriteReadInterrupt(const uint8_t* src, uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void()>& handler) override;
 
     bool WriteBlocking(const uint8_t* src, uint16_t length) override;
     bool WriteReadBlocking(const uint8_t* src, uint8_t* dest, uint16_t length) override;
     bool ReadBlocking(uint8_t* dest, uint16_t length) override;
 
 private:
-    SPIInstance       mInstance;
-    SPI_HandleTypeDef mHandle = {};
-    SPICallbacks&     mSPICallbacks;
-    bool              mInitialized;
+    SPIInstance          mInstance;
+    SPI_HandleTypeDef    mHandle = {};
+    SPICallbacks&        mSPICallbacks;
+    bool                 mInitialized;
+    const SPISegment*    mSegments;
+    uint8_t              mSegmentCount;
+    uint8_t              mSegmentIndex;
+    bool                 mTransferBusy;
+    Delegate<void(bool)> mTransferHandler;
 
     void SetInstance(const SPIInstance& instance);
     void CheckAndEnableAHBPeripheralClock(const SPIInstance& instance);
@@ -140,6 +149,14 @@ private:
     IRQn_Type GetIRQn(const SPIInstance& instance);
     void SetIRQn(IRQn_Type type, uint32_t preemptPrio, uint32_t subPrio);
     void CallbackIRQ();
+
+    bool IsValidSegment(const SPISegment& segment) const;
+    bool RunSegments();
+    bool StartSegment(const SPISegment& segment);
+    void SegmentCompleted();
+    void SegmentFailed();
+    void AbortSegments();
+    void FinishTransfer(bool result);
 };
 
 #endif  // SPI_HPP_
@@ -13,8 +13,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/drivers/Usart
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.2
- * \date    05-2021
+ * \version 1.4
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -74,6 +74,33 @@ static void CallbackRxDone(const UsartCallbacks& usart_callbacks, uint16_t bytes
     }
 }
 
+/**
+ * \brief   Call the callbackRxEvent, if configured.
+ * \param   usart_variables     Structure containing the callbackRxEvent to call.
+ * \returns True if called (circular reception ongoing), else false.
+ */
+static bool CallbackRxEvent(const UsartCallbacks& usart_callbacks)
+{
+    if (usart_callbacks.callbackRxEvent)
+    {
+        usart_callbacks.callbackRxEvent();
+        return true;
+    }
+    return false;
+}
+
+/**
+ * \brief   Call the callbackRxError, if configured.
+ * \param   usart_variables     Structure containing the callbackRxError to call.
+ */
+static void CallbackRxError(const UsartCallbacks& usart_callbacks)
+{
+    if (usart_callbacks.callbackRxError)
+    {
+        usart_callbacks.callbackRxError();
+    }
+}
+
 
 /************************************************************************/
 /* Public Methods                                                       */
@@ -85,7 +112,17 @@ static void CallbackRxDone(const UsartCallbacks& usart_callbacks, uint16_t bytes
 Usart::Usart(const UsartInstance& instance) :
     mInstance(instance),
     mUsartCallbacks( (instance == UsartInstance::USART_1) ? (usart1_callbacks) : ( (instance == UsartInstance::USART_2) ? (usart2_callbacks) : ( (instance == UsartInstance::USART_3) ? (usart3_callbacks) : (usart6_callbacks) ) ) ),
-    mInitialized(false)
+    mInitialized(false),
+    mBaudrateSetting(),
+    mRxBuffer(nullptr),
+    mRxSize(0),
+    mRxPosition(0),
+    mRxReceived(0),
+    mRxConsumed(0),
+    mRxOverruns(0),
+    mRxErrors(0),
+    mRxRestart(0),
+    mRxSpanHandler(nullptr)
 {
     SetInstance(instance);
 
@@ -107,11 +144,13 @@ Usart::~Usart()
  */
 bool Usart::Init(const IConfig& config)
 {
-    CheckAndEnableAHB1PeripheralClock(mInstance);
-
     const Config& cfg = reinterpret_cast<const Config&>(config);
 
-    mHandle.Init.BaudRate     = static_cast<uint32_t>(cfg.mBaudrate);
+    if (!CalculateBaudrate(GetClock(mInstance), cfg.mBaudrate, cfg.mOverSampling, mBaudrateSetting)) { return false; }
+
+    CheckAndEnableAHB1PeripheralClock(mInstance);
+
+    mHandle.Init.BaudRate     = cfg.mBaudrate;
     mHandle.Init.WordLength   = (cfg.mWordLength == WordLength::_8_BIT) ? UART_WORDLENGTH_8B : UART_WORDLENGTH_9B;
     mHandle.Init.Parity       = GetParity(cfg.mParity);
     mHandle.Init.StopBits     = (cfg.mStopBits == StopBits::_1_BIT) ? UART_STOPBITS_1 : UART_STOPBITS_2;
@@ -121,6 +160,9 @@ bool Usart::Init(const IConfig& config)
 
     if (HAL_UART_Init(&mHandle) == HAL_OK)
     {
+        // The HAL rounds the fraction differently, use the calculated divider
+        mHandle.Instance->BRR = mBaudrateSetting.mBrr;
+
         // Configure NVIC to generate interrupt
         SetIRQn(GetIRQn(mInstance), cfg.mInterruptPriority, 0);
 
@@ -151,6 +193,9 @@ bool Usart::Sleep()
     // For Int. and DMA started transfers. Not handling result as to reach DeInit().
     HAL_UART_Abort(&mHandle);
 
+    mUsartCallbacks.callbackRxEvent = nullptr;
+    mUsartCallbacks.callbackRxError = nullptr;
+    mRxBuffer = nullptr;
     mInitialized = false;
 
     if (HAL_UART_DeInit(&mHandle) == HAL_OK)
@@ -161,6 +206,67 @@ bool Usart::Sleep()
     return false;
 }
 
+/**
+ * \brief   Get the baud rate the USART runs at, which can deviate slightly
+ *          from the configured baud rate.
+ * \returns The achieved baud rate, 0 if not initialized.
+ */
+uint32_t Usart::GetBaudrate() const
+{
+    return (mInitialized) ? mBaudrateSetting.mBaudrate : 0;
+}
+
+/**
+ * \brief   Get the deviation of the achieved baud rate from the configured
+ *          baud rate.
+ * \returns The deviation in parts per million, 0 if not initialized.
+ */
+uint32_t Usart::GetBaudrateError() const
+{
+    return (mInitialized) ? mBaudrateSetting.mErrorPpm : 0;
+}
+
+/**
+ * \brief   Calculate the divider for a baud rate.
+ * \details The USART divides the peripheral clock by USARTDIV, which has a
+ *          12 bit mantissa and a 4 bit (16 times over sampling) or 3 bit (8
+ *          times over sampling) fraction. Per bit the clock is divided by
+ *          'clock / baudrate', rounded to the nearest value possible.
+ * \param   clock           The peripheral clock of the USART in Hz.
+ * \param   baudrate        The requested baud rate.
+ * \param   overSampling    The over sampling mode.
+ * \param   setting         Is set to the divider and achieved baud rate, also
+ *                          when the error is too large.
+ * \returns True if the baud rate can be made within
+ *          USART_MAX_BAUDRATE_ERROR_PPM, else false.
+ */
+bool Usart::CalculateBaudrate(uint32_t clock, uint32_t baudrate, OverSampling overSampling, BaudrateSetting& setting)
+{
+    EXPECT(baudrate > 0);
+
+    if (clock == 0)    { return false; }
+    if (baudrate == 0) { return false; }
+
+    const bool     overSampling8 = (overSampling == OverSampling::_8_TIMES);
+    const uint32_t minDivider    = (overSampling8) ? 8      : 16;          // USARTDIV of 1.0
+    const uint32_t maxDivider    = (overSampling8) ? 0x7FFF : 0xFFFF;      // 12 bit mantissa, 3 or 4 bit fraction
+
+    // USARTDIV times the over sampling
+    const uint32_t divider = static_cast<uint32_t>((static_cast<uint64_t>(clock) + (baudrate / 2)) / baudrate);
+
+    if (divider < minDivider) { return false; }     // Too fast
+    if (divider > maxDivider) { return false; }     // Too slow
+
+    const uint64_t ideal      = static_cast<uint64_t>(baudrate) * divider;
+    const uint64_t difference = (ideal > clock) ? (ideal - clock) : (clock - ideal);
+
+    setting.mBrr      = static_cast<uint16_t>((overSampling8) ? (((divider & ~0x7U) << 1) | (divider & 0x7U)) : divider);
+    setting.mBaudrate = (clock + (divider / 2)) / divider;
+    setting.mErrorPpm = static_cast<uint32_t>((difference * 1000000 + (ideal / 2)) / ideal);
+
+    return (setting.mErrorPpm <= USART_MAX_BAUDRATE_ERROR_PPM);
+}
+
 /**
  * \brief   Get the handle to the peripheral.
  * \returns The handle to the peripheral.
@@ -200,7 +306,7 @@ DMA_HandleTypeDef*& Usart::GetDmaRxHandle()
  * \returns True if the transaction could be started, else false. Returns false if no DMA is setup for Tx.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool Usart::WriteDma(const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool Usart::WriteDma(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -227,7 +333,7 @@ bool Usart::WriteDma(const uint8_t* src, uint16_t length, const std::function<vo
  * \note    If IDLE line detection is not used callback will only be called
  *          when the expected number of bytes are received.
  */
-bool Usart::ReadDma(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection /* = true */)
+bool Usart::ReadDma(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection /* = true */)
 {
     EXPECT(dest);
     EXPECT(length > 0);
@@ -255,7 +361,7 @@ bool Usart::ReadDma(uint8_t* dest, uint16_t length, const std::function<void(uin
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if src is nullptr or length invalid.
  */
-bool Usart::WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler)
+bool Usart::WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler)
 {
     EXPECT(src);
     EXPECT(length > 0);
@@ -278,7 +384,7 @@ bool Usart::WriteInterrupt(const uint8_t* src, uint16_t length, const std::funct
  * \returns True if the transaction could be started, else false.
  * \note    Asserts if dest is nullptr or length invalid.
  */
-bool Usart::ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection /* = true */)
+bool Usart::ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection /* = true */)
 {
     EXPECT(dest);
     EXPECT(length > 0);
@@ -335,6 +441,157 @@ bool Usart::ReadBlocking(uint8_t* dest, uint16_t length)
     return (HAL_UART_Receive(&mHandle, dest, length, HAL_MAX_DELAY) == HAL_OK);
 }
 
+/**
+ * \brief   Start continuous reception using a circular DMA buffer.
+ * \details The reception never stops: new data is reported as spans of the
+ *          buffer on the half transfer, transfer complete and IDLE line
+ *          interrupts. Data wrapping around the end of the buffer is reported
+ *          as 2 spans. The data can be processed in place, either from the
+ *          handler or from a task using ReadAcquire() and ReadRelease().
+ * \param   buffer      Pointer to the buffer the DMA writes into.
+ * \param   length      Length of the buffer in bytes.
+ * \param   handler     Callback to call with (offset, length) of the new
+ *                      data, can be nullptr when only ReadAcquire() is used.
+ * \returns True if the reception could be started, else false. Returns false
+ *          if no DMA is setup for Rx or the DMA is not in circular mode.
+ * \note    Asserts if buffer is nullptr or length invalid.
+ * \note    The DMA half transfer interrupt must be enabled, this guarantees
+ *          at least 1 event per half buffer.
+ * \note    A reception error (overrun, framing, noise or DMA error) stops the
+ *          DMA in the HAL: the reception is restarted at the start of the
+ *          buffer and the error is counted, see GetRxErrors().
+ */
+bool Usart::ReadCircularDma(uint8_t* buffer, uint16_t length, const Delegate<void(uint16_t, uint16_t)>& handler)
+{
+    EXPECT(buffer);
+    EXPECT(length > 0);
+
+    if (buffer == nullptr) { return false; }
+    if (length == 0) { return false; }
+    if (!mInitialized) { return false; }
+    if (mHandle.hdmarx == nullptr) { return false; }
+    if (mHandle.hdmarx->Init.Mode != DMA_CIRCULAR) { return false; }
+
+    mRxBuffer      = buffer;
+    mRxSize        = length;
+    mRxPosition    = 0;
+    mRxReceived    = 0;
+    mRxConsumed    = 0;
+    mRxOverruns    = 0;
+    mRxErrors      = 0;
+    mRxRestart     = 0;
+    mRxSpanHandler = handler;
+
+    mUsartCallbacks.callbackRxEvent = [this]() { this->CallbackRxEvent(); };
+    mUsartCallbacks.callbackRxError = [this]() { this->CallbackRxError(); };
+
+    __HAL_UART_CLEAR_IDLEFLAG(&mHandle);
+    __HAL_UART_ENABLE_IT(&mHandle, UART_IT_IDLE);
+
+    if (HAL_UART_Receive_DMA(&mHandle, buffer, length) != HAL_OK)
+    {
+        __HAL_UART_DISABLE_IT(&mHandle, UART_IT_IDLE);
+        mUsartCallbacks.callbackRxEvent = nullptr;
+        mUsartCallbacks.callbackRxError = nullptr;
+        mRxBuffer = nullptr;
+        return false;
+    }
+    return true;
+}
+
+/**
+ * \brief   Stop the circular reception started with ReadCircularDma().
+ * \returns True if the reception is stopped, false if it was not running.
+ * \note    Data not yet released with ReadRelease() is discarded.
+ */
+bool Usart::StopCircularRead()
+{
+    if (mRxBuffer == nullptr) { return false; }
+
+    __HAL_UART_DISABLE_IT(&mHandle, UART_IT_IDLE);
+    mUsartCallbacks.callbackRxEvent = nullptr;
+    mUsartCallbacks.callbackRxError = nullptr;
+    mRxBuffer = nullptr;
+
+    return (HAL_UART_AbortReceive(&mHandle) == HAL_OK);
+}
+
+/**
+ * \brief   Get the oldest received data which is not released yet, without
+ *          copying it.
+ * \param   data    Is set to the start of the data in the circular buffer,
+ *                  nullptr if there is no data.
+ * \returns The number of contiguous bytes available at data. Call again after
+ *          ReadRelease() for data wrapped around the end of the buffer.
+ * \note    If the DMA overwrote data not yet released, the unreleased data is
+ *          discarded and counted, see GetRxOverruns(). Data not released
+ *          before a reception error is discarded as well.
+ */
+uint16_t Usart::ReadAcquire(const uint8_t*& data)
+{
+    data = nullptr;
+
+    if (mRxBuffer == nullptr) { return 0; }
+
+    // Restarted after an error: skip to the data received since
+    const uint32_t restart = mRxRestart;
+    if (static_cast<int32_t>(restart - mRxConsumed) > 0)
+    {
+        mRxConsumed = restart;
+    }
+
+    const uint32_t received = mRxReceived;
+    uint32_t available = received - mRxConsumed;
+
+    if (available > mRxSize)
+    {
+        mRxOverruns++;
+        mRxConsumed = received;
+        return 0;
+    }
+    if (available == 0) { return 0; }
+
+    const uint16_t index      = static_cast<uint16_t>(mRxConsumed % mRxSize);
+    const uint16_t contiguous = mRxSize - index;
+
+    data = &mRxBuffer[index];
+    return static_cast<uint16_t>((available < contiguous) ? available : contiguous);
+}
+
+/**
+ * \brief   Release data obtained with ReadAcquire(), the DMA can overwrite it.
+ * \param   length  The number of bytes processed.
+ * \note    Asserts if more is released than available.
+ */
+void Usart::ReadRelease(uint16_t length)
+{
+    const uint32_t available = mRxReceived - mRxConsumed;
+
+    EXPECT(length <= available);
+
+    mRxConsumed += (length < available) ? length : available;
+}
+
+/**
+ * \brief   Get the number of times the circular reception overwrote data not
+ *          yet released.
+ * \returns The number of overruns since ReadCircularDma().
+ */
+uint32_t Usart::GetRxOverruns() const
+{
+    return mRxOverruns;
+}
+
+/**
+ * \brief   Get the number of reception errors (overrun, framing, noise or DMA
+ *          error) after which the circular reception was restarted.
+ * \returns The number of errors since ReadCircularDma().
+ */
+uint32_t Usart::GetRxErrors() const
+{
+    return mRxErrors;
+}
+
 
 /************************************************************************/
 /* Private Methods                                                      */
@@ -392,6 +649,24 @@ void Usart::CheckAndDisableAHB1PeripheralClock(const UsartInstance& instance)
     }
 }
 
+/**
+ * \brief   Get the peripheral clock of the USART instance.
+ * \param   instance    The USART instance to get the clock for.
+ * \returns The clock in Hz: USART1 and USART6 are on APB2, USART2 and USART3
+ *          on APB1.
+ */
+uint32_t Usart::GetClock(const UsartInstance& instance)
+{
+    switch (instance)
+    {
+        case UsartInstance::USART_1: return HAL_RCC_GetPCLK2Freq(); break;
+        case UsartInstance::USART_2: return HAL_RCC_GetPCLK1Freq(); break;
+        case UsartInstance::USART_3: return HAL_RCC_GetPCLK1Freq(); break;
+        case UsartInstance::USART_6: return HAL_RCC_GetPCLK2Freq(); break;
+        default: ASSERT(false); return 0; break;
+    }
+}
+
 /**
  * \brief   Get the parify mode for the Usart.
  * \param   parity  The parity mode to get.
@@ -455,16 +730,86 @@ void Usart::CallbackIRQ()
     // Check if the 'IDLE' flag is set, if so call end of Rx callback, the clear flag.
     if (__HAL_UART_GET_FLAG(&mHandle, UART_FLAG_IDLE))
     {
-        HAL_UART_RxCpltCallback(&mHandle);
-
-        // End the transmission, received line IDLE - clears RxState
-        HAL_UART_AbortReceive_IT(&mHandle);
+        // Circular reception: report the data received so far, the DMA continues.
+        if (mUsartCallbacks.callbackRxEvent)
+        {
+            __HAL_UART_CLEAR_IDLEFLAG(&mHandle);
+            CallbackRxEvent();
+        }
+        else
+        {
+            HAL_UART_RxCpltCallback(&mHandle);
+
+            // End the transmission, received line IDLE - clears RxState
+            HAL_UART_AbortReceive_IT(&mHandle);
+        }
     }
 
     // If it was another interrupt, pass it through
     HAL_UART_IRQHandler(&mHandle);
 }
 
+/**
+ * \brief   ISR: circular Rx event (half transfer, transfer complete or IDLE).
+ *          Determines the new data from the DMA position and reports it as
+ *          1 or 2 spans (when wrapped around the end of the buffer).
+ */
+void Usart::CallbackRxEvent()
+{
+    // NDTR reloads to the buffer length at the end of the buffer
+    uint16_t position = mRxSize - static_cast<uint16_t>(__HAL_DMA_GET_COUNTER(mHandle.hdmarx));
+    if (position >= mRxSize) { position = 0; }
+
+    const uint16_t start = mRxPosition;
+    const uint16_t count = (position >= start) ? (position - start) : (mRxSize - start + position);
+
+    if (count == 0) { return; }
+
+    mRxPosition  = position;
+    mRxReceived += count;
+
+    Delegate<void(uint16_t, uint16_t)> handler = mRxSpanHandler;
+    if (handler)
+    {
+        if (count <= (mRxSize - start))
+        {
+            handler(start, count);
+        }
+        else
+        {
+            handler(start, mRxSize - start);
+            handler(0, position);
+        }
+    }
+}
+
+/**
+ * \brief   ISR: the HAL aborted the circular reception on an error (overrun,
+ *          framing, noise or DMA error). Reports the data received before
+ *          the error, then restarts the DMA at the start of the buffer.
+ * \note    The HAL calls the error callback for a Tx DMA error as well, then
+ *          the Rx DMA stream is still running and the reception continues.
+ */
+void Usart::CallbackRxError()
+{
+    if (HAL_DMA_GetState(mHandle.hdmarx) == HAL_DMA_STATE_BUSY) { return; }
+
+    mRxErrors++;
+
+    CallbackRxEvent();
+
+    // The DMA restarts at offset 0: move the count of received bytes to the
+    // next buffer boundary, the reader skips to it.
+    const uint32_t restart = mRxReceived + ((mRxSize - mRxPosition) % mRxSize);
+    mRxPosition = 0;
+    mRxReceived = restart;
+    mRxRestart  = restart;
+
+    const bool result = (HAL_UART_Receive_DMA(&mHandle, mRxBuffer, mRxSize) == HAL_OK);
+    EXPECT(result);
+    (void)(result);
+}
+
 
 /************************************************************************/
 /* Interrupts                                                           */
@@ -495,6 +840,12 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef* handle)
 {
     ASSERT(handle);
 
+    // Circular reception: the DMA continues, report the new data
+    if ((handle->Instance == USART1) && CallbackRxEvent(usart1_callbacks)) { return; }
+    if ((handle->Instance == USART2) && CallbackRxEvent(usart2_callbacks)) { return; }
+    if ((handle->Instance == USART3) && CallbackRxEvent(usart3_callbacks)) { return; }
+    if ((handle->Instance == USART6) && CallbackRxEvent(usart6_callbacks)) { return; }
+
     // ToDo: check for error
 
     // Disable and clear IDLE line interrupt
@@ -524,6 +875,37 @@ void HAL_UART_RxCpltCallback(UART_HandleTypeDef* handle)
     handle->RxXferSize = 0;
 }
 
+/**
+ * \brief   ISR: handler to dispatch the USART RX half completed interrupt into
+ *          the circular Rx event. Unused for other transfers.
+ * \param   handle  The USART handle from which the RX ISR came.
+ */
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    if (handle->Instance == USART1) { CallbackRxEvent(usart1_callbacks); }
+    if (handle->Instance == USART2) { CallbackRxEvent(usart2_callbacks); }
+    if (handle->Instance == USART3) { CallbackRxEvent(usart3_callbacks); }
+    if (handle->Instance == USART6) { CallbackRxEvent(usart6_callbacks); }
+}
+
+/**
+ * \brief   ISR: handler to dispatch the USART error interrupt into the
+ *          circular Rx error callback, which ignores errors that did not stop
+ *          the reception. Unused for other transfers.
+ * \param   handle  The USART handle from which the error ISR came.
+ */
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* handle)
+{
+    ASSERT(handle);
+
+    if (handle->Instance == USART1) { CallbackRxError(usart1_callbacks); }
+    if (handle->Instance == USART2) { CallbackRxError(usart2_callbacks); }
+    if (handle->Instance == USART3) { CallbackRxError(usart3_callbacks); }
+    if (handle->Instance == USART6) { CallbackRxError(usart6_callbacks); }
+}
+
 /**
  * \brief   ISR: route USART1 interrupts to 'CallbackIRQ'.
  */
@@ -14,8 +14,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/drivers/Usart
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.2
- * \date    05-2021
+ * \version 1.3
+ * \date    10-2026
  */
 
 #ifndef USART_HPP_
@@ -25,12 +25,23 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "interfaces/IInitable.hpp"
 #include "interfaces/IUSART.hpp"
 #include "stm32f4xx_hal.h"
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     USART_MAX_BAUDRATE_ERROR_PPM
+ * \brief   Maximum deviation of the achievable baud rate from the requested
+ *          baud rate, in parts per million. Init() fails above this.
+ */
+#define USART_MAX_BAUDRATE_ERROR_PPM    20000
+
+
 /************************************************************************/
 /* Enums                                                                */
 /************************************************************************/
@@ -55,9 +66,11 @@ enum class UsartInstance : uint8_t
  * \brief   Data structure to contain callbacks for an Usart instance.
  */
 struct UsartCallbacks {
-    std::function<void()> callbackIRQ = nullptr;          ///< Callback to call when IRQ occurs.
-    std::function<void()> callbackTx  = nullptr;          ///< Callback to call when Tx done.
-    std::function<void(uint16_t)> callbackRx  = nullptr;  ///< Callback to call when Rx done.
+    Delegate<void()> callbackIRQ = nullptr;          ///< Callback to call when IRQ occurs.
+    Delegate<void()> callbackTx  = nullptr;          ///< Callback to call when Tx done.
+    Delegate<void(uint16_t)> callbackRx  = nullptr;  ///< Callback to call when Rx done.
+    Delegate<void()> callbackRxEvent = nullptr;      ///< Callback to call on circular Rx events (half, complete, IDLE).
+    Delegate<void()> callbackRxError = nullptr;      ///< Callback to call on a circular Rx error (overrun, framing, noise, DMA).
 };
 
 
@@ -69,7 +82,8 @@ class Usart final : public IUSART, public IConfigInitable
 public:
     /**
      * \enum    Baudrate
-     * \brief   Available USART baud rates.
+     * \brief   Common USART baud rates. Other baud rates can be configured
+     *          by value, see Config.
      */
     enum class Baudrate : uint32_t
     {
@@ -80,7 +94,10 @@ public:
         _115K2 =  115200,     ///< 115200
         _230K4 =  230400,     ///< 230400
         _460K8 =  460800,     ///< 460800
-        _912K6 =  912600      ///< 912600
+        _912K6 =  912600,     ///< 912600, deprecated: use _921K6
+        _921K6 =  921600,     ///< 921600
+        _1M    = 1000000,     ///< 1000000
+        _2M    = 2000000      ///< 2000000
     };
 
     /**
@@ -147,6 +164,27 @@ public:
                Parity parity = Parity::NO,
                StopBits stopBits = StopBits::_1_BIT,
                OverSampling overSampling = OverSampling::_8_TIMES) :
+            Config(interruptPriority, useHardwareFlowControl, static_cast<uint32_t>(baudrate), wordLength, parity, stopBits, overSampling)
+        { }
+
+        /**
+         * \brief   Constructor of the USART configuration struct, for any baud rate.
+         * \param   interruptPriority       Priority of the interrupt.
+         * \param   useHardwareFlowControl  Flag indicating to use hardware flow control (CTS/RTS).
+         * \param   baudrate                Baud rate of the USART in baud. Init() fails if it
+         *                                  cannot be made within USART_MAX_BAUDRATE_ERROR_PPM.
+         * \param   wordLength              Word length of the USART         -- default: 8 bits.
+         * \param   parity                  Parity of the USART              -- default: no parity.
+         * \param   stopBits                Stop bit mode for the USART      -- default: 1 bit.
+         * \param   overSampling            Over sampling mode for the USART -- default: 8 times.
+         */
+        Config(uint8_t interruptPriority,
+               bool useHardwareFlowControl,
+               uint32_t baudrate,
+               WordLength wordLength = WordLength::_8_BIT,
+               Parity parity = Parity::NO,
+               StopBits stopBits = StopBits::_1_BIT,
+               OverSampling overSampling = OverSampling::_8_TIMES) :
             mInterruptPriority(interruptPriority),
             mUseHardwareFlowControl(useHardwareFlowControl),
             mBaudrate(baudrate),
@@ -158,13 +196,26 @@ public:
 
         uint8_t      mInterruptPriority;        ///< Interrupt priority.
         bool         mUseHardwareFlowControl;   ///< Flag indicating to use hardware flow control.
-        Baudrate     mBaudrate;                 ///< Baud rate of the USART.
+        uint32_t     mBaudrate;                 ///< Baud rate of the USART.
         WordLength   mWordLength;               ///< Word length of the USART.
         Parity       mParity;                   ///< Parity of the USART.
         StopBits     mStopBits;                 ///< Stop bit mode for the USART.
         OverSampling mOverSampling;             ///< Over sampling of the USART.
     };
 
+    /**
+     * \struct  BaudrateSetting
+     * \brief   Divider for a baud rate and the resulting baud rate.
+     */
+    struct BaudrateSetting
+    {
+        uint16_t     mBrr      = 0;             ///< Value for the baud rate register.
+        uint32_t     mBaudrate = 0;             ///< Achieved baud rate.
+        uint32_t     mErrorPpm = 0;             ///< Deviation from the requested baud rate in parts per million.
+    };
+
+    static bool CalculateBaudrate(uint32_t clock, uint32_t baudrate, OverSampling overSampling, BaudrateSetting& setting);
+
 
     explicit Usart(const UsartInstance& instance);
     virtual ~Usart();
@@ -173,32 +224,56 @@ public:
     bool IsInit() const override;
     bool Sleep() override;
 
+    uint32_t GetBaudrate() const;
+    uint32_t GetBaudrateError() const;
+
     const UART_HandleTypeDef* GetPeripheralHandle() const;
     DMA_HandleTypeDef*& GetDmaTxHandle();
     DMA_HandleTypeDef*& GetDmaRxHandle();
 
-    bool WriteDma(const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadDma(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true) override;
+    bool WriteDma(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadDma(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true) override;
 
-    bool WriteInterrupt(const uint8_t* src, uint16_t length, const std::function<void()>& handler) override;
-    bool ReadInterrupt(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true) override;
+    bool WriteInterrupt(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override;
+    bool ReadInterrupt(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true) override;
 
     bool WriteBlocking(const uint8_t* src, uint16_t length) override;
     bool ReadBlocking(uint8_t* dest, uint16_t length) override;
 
+    bool ReadCircularDma(uint8_t* buffer, uint16_t length, const Delegate<void(uint16_t, uint16_t)>& handler);
+    bool StopCircularRead();
+    uint16_t ReadAcquire(const uint8_t*& data);
+    void ReadRelease(uint16_t length);
+    uint32_t GetRxOverruns() const;
+    uint32_t GetRxErrors() const;
+
 private:
     UsartInstance      mInstance;
     UART_HandleTypeDef mHandle = {};
     UsartCallbacks&    mUsartCallbacks;
     bool               mInitialized;
+    BaudrateSetting    mBaudrateSetting;
+
+    uint8_t*                           mRxBuffer;
+    uint16_t                           mRxSize;
+    uint16_t                           mRxPosition;
+    volatile uint32_t                  mRxReceived;
+    uint32_t                           mRxConsumed;
+    uint32_t                           mRxOverruns;
+    uint32_t                           mRxErrors;
+    volatile uint32_t                  mRxRestart;
+    Delegate<void(uint16_t, uint16_t)> mRxSpanHandler;
 
     void SetInstance(const UsartInstance& instance);
     void CheckAndEnableAHB1PeripheralClock(const UsartInstance& instance);
     void CheckAndDisableAHB1PeripheralClock(const UsartInstance& instance);
+    uint32_t GetClock(const UsartInstance& instance);
     uint32_t GetParity(const Parity& parity);
     IRQn_Type GetIRQn(const UsartInstance& instance);
     void SetIRQn(IRQn_Type type, uint32_t preemptPrio, uint32_t subPrio);
     void CallbackIRQ();
+    void CallbackRxEvent();
+    void CallbackRxError();
 };
 
 
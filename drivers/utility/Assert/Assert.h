@@ -20,8 +20,8 @@
  *          to only be used by these macros.
  *
  * \author  T. Louwers <terry.louwers@fourtress.nl>
- * \version 1.0
- * \date    05-2021
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef ASSERT_H_
@@ -37,13 +37,14 @@ extern "C" {
 /* Includes                                                             */
 /************************************************************************/
 #include "config.h"
+#include "utility/DeferredLog/DeferredLog.h"
 #include <stdlib.h>
 
 
 /************************************************************************/
 /* Function declarations                                                */
 /************************************************************************/
-void _expect_log(const char* expr, int line, const char* file);
+void _expect_log(const DeferredLogSite* site);
 void _expect_breakpoint();
 void _assert_breakpoint();
 void _assert_reset(const char* expr, int line, const char* file);
@@ -57,12 +58,14 @@ void _assert_reset(const char* expr, int line, const char* file);
  *          a little while longer. For instance: nothing will break inside the
  *          method where EXPECT() is placed. Checks around buffers if there is
  *          still room available could be of this type.
+ *          Logging records the expression, file and line in the deferred log
+ *          (utility/DeferredLog): cheap enough for interrupts.
  */
 #if (EXPECT_MODE == HANDLE_BY_IGNORING)
 #  define EXPECT(expr)  (void)(expr);
 
 #elif (EXPECT_MODE == HANDLE_BY_LOGGING)
-#  define EXPECT(expr)  if (!(expr)) { _expect_log(#expr, __LINE__, __FILE__); }
+#  define EXPECT(expr)  if (!(expr)) { static const DeferredLogSite _expect_site = { #expr, __FILE__, __LINE__, DEFERRED_LOG_EXPECT }; _expect_log(&_expect_site); }
 
 #elif (EXPECT_MODE == HANDLE_BY_BREAKPOINT)
 #  define EXPECT(expr)  if (!(expr)) { _expect_breakpoint(); }
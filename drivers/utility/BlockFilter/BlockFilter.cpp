@@ -0,0 +1,480 @@
+/**
+ * \file    BlockFilter.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Oversampling and decimation of ADC blocks: box-car, CIC and FIR.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/BlockFilter
+ *
+ * \details Each channel is processed in its own pass over the block, so its
+ *          state stays in registers. Only the phase towards the next output
+ *          scan is shared by the channels.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/BlockFilter/BlockFilter.hpp"
+#include "utility/Assert/Assert.h"
+#include <algorithm>
+#include <cstring>
+#if defined(__ARM_FEATURE_DSP)
+#include "stm32f4xx_hal.h"
+#endif
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+static constexpr int32_t MID_SCALE = 0x8000;        // Subtracted from the samples of the FIR: 16 bit unsigned to int16_t
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Multiply and accumulate two arrays of 16 bit values.
+ * \param   a       First array.
+ * \param   b       Second array.
+ * \param   count   Number of values, even.
+ * \returns The sum of the products.
+ * \note    With the DSP extension two products per SMLALD. The arrays need
+ *          not be word aligned: the Cortex-M4 loads unaligned words.
+ */
+static inline int64_t MultiplyAccumulate(const int16_t* a, const int16_t* b, uint8_t count)
+{
+    int64_t sum = 0;
+
+#if defined(__ARM_FEATURE_DSP)
+    for (uint8_t i = 0; i < count; i += 2)
+    {
+        uint32_t pairA;
+        uint32_t pairB;
+        std::memcpy(&pairA, &a[i], sizeof(pairA));
+        std::memcpy(&pairB, &b[i], sizeof(pairB));
+        sum = static_cast<int64_t>(__SMLALD(pairA, pairB, static_cast<uint64_t>(sum)));
+    }
+#else
+    for (uint8_t i = 0; i < count; i += 2)
+    {
+        sum += (static_cast<int32_t>(a[i])     * b[i]);
+        sum += (static_cast<int32_t>(a[i + 1]) * b[i + 1]);
+    }
+#endif
+
+    return sum;
+}
+
+/**
+ * \brief   Limit a value to the 16 bit output range.
+ * \param   value   The value.
+ * \returns The value, clamped to [0 .. 0xFFFF].
+ */
+static inline uint16_t Clamp(int32_t value)
+{
+    if (value < 0)      { return 0;      }
+    if (value > 0xFFFF) { return 0xFFFF; }
+    return static_cast<uint16_t>(value);
+}
+
+
+/************************************************************************/
+/* BlockFilter                                                          */
+/************************************************************************/
+/**
+ * \brief   Constructor, not initialized: Process() does nothing.
+ */
+BlockFilter::BlockFilter() :
+    mChannels(0),
+    mDecimation(1),
+    mPhase(0)
+{ }
+
+/**
+ * \brief   Filter a block of interleaved scans.
+ * \param   input   The block, whole scans.
+ * \param   length  Number of samples in the block.
+ * \param   output  Buffer for the output scans, same layout as the input.
+ * \param   size    Size of the output buffer in samples, at least
+ *                  GetOutputSize(length).
+ * \returns Number of output samples written, 0 if not initialized or the
+ *          block or buffer is invalid.
+ */
+uint16_t BlockFilter::Process(const uint16_t* input, uint16_t length, uint16_t* output, uint16_t size)
+{
+    EXPECT(input);
+    EXPECT(output);
+
+    if (mChannels == 0)                 { return 0; }
+    if (input == nullptr)               { return 0; }
+    if (output == nullptr)              { return 0; }
+    if ((length % mChannels) != 0)      { return 0; }
+    if (size < GetOutputSize(length))   { return 0; }
+
+    const uint16_t scans = length / mChannels;
+
+    for (uint8_t channel = 0; channel < mChannels; channel++)
+    {
+        ProcessChannel(channel, &input[channel], scans, &output[channel]);
+    }
+
+    const uint32_t phase = static_cast<uint32_t>(mPhase) + scans;
+    mPhase = static_cast<uint16_t>(phase % mDecimation);
+
+    return static_cast<uint16_t>((phase / mDecimation) * mChannels);
+}
+
+/**
+ * \brief   Clear the filter state, as if no samples were processed.
+ */
+void BlockFilter::Reset()
+{
+    mPhase = 0;
+    ResetState();
+}
+
+/**
+ * \brief   Get the number of output samples a block can result in, to size
+ *          the output buffer.
+ * \param   length  Number of samples in the block.
+ * \returns The maximum number of output samples, regardless of the state.
+ */
+uint16_t BlockFilter::GetOutputSize(uint16_t length) const
+{
+    if (mChannels == 0) { return 0; }
+
+    const uint32_t scans = length / mChannels;
+    return static_cast<uint16_t>(((scans + mDecimation - 1) / mDecimation) * mChannels);
+}
+
+/**
+ * \brief   Get the number of interleaved channels.
+ * \returns The number of channels, 0 if not initialized.
+ */
+uint8_t BlockFilter::GetChannelCount() const
+{
+    return mChannels;
+}
+
+/**
+ * \brief   Get the number of input scans per output scan.
+ * \returns The decimation.
+ */
+uint16_t BlockFilter::GetDecimation() const
+{
+    return mDecimation;
+}
+
+/**
+ * \brief   Set the number of channels and the decimation, clears the state.
+ * \param   channels    Number of interleaved channels.
+ * \param   decimation  Number of input scans per output scan.
+ * \returns True if valid, else false and not initialized.
+ */
+bool BlockFilter::SetLayout(uint8_t channels, uint16_t decimation)
+{
+    EXPECT(channels > 0);
+    EXPECT(channels <= BLOCK_FILTER_MAX_CHANNELS);
+    EXPECT(decimation > 0);
+
+    mChannels = 0;
+
+    if (channels == 0)                          { return false; }
+    if (channels > BLOCK_FILTER_MAX_CHANNELS)   { return false; }
+    if (decimation == 0)                        { return false; }
+
+    mChannels   = channels;
+    mDecimation = decimation;
+    Reset();
+    return true;
+}
+
+
+/************************************************************************/
+/* Oversampler                                                          */
+/************************************************************************/
+/**
+ * \brief   Constructor, not initialized.
+ */
+Oversampler::Oversampler() :
+    mShift(0),
+    mSum()
+{ }
+
+/**
+ * \brief   Initialize the box-car oversampler.
+ * \param   channels    Number of interleaved channels.
+ * \param   extraBits   Bits added to the output, 4^extraBits samples are
+ *                      summed per output. Range [1 .. 4].
+ * \returns True if the configuration is valid, else false.
+ */
+bool Oversampler::Init(uint8_t channels, uint8_t extraBits)
+{
+    EXPECT(extraBits > 0);
+    EXPECT(extraBits <= BLOCK_FILTER_MAX_EXTRA_BITS);
+
+    mChannels = 0;
+
+    if (extraBits == 0)                             { return false; }
+    if (extraBits > BLOCK_FILTER_MAX_EXTRA_BITS)    { return false; }
+
+    mShift = extraBits;
+    return SetLayout(channels, static_cast<uint16_t>(1U << (2 * extraBits)));
+}
+
+/**
+ * \brief   Sum the samples of a channel, output a rounded sum per
+ *          decimation samples.
+ * \param   channel     The channel.
+ * \param   input       First sample of the channel, scans are mChannels apart.
+ * \param   scans       Number of scans in the block.
+ * \param   output      First output of the channel, scans are mChannels apart.
+ */
+void Oversampler::ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output)
+{
+    const uint32_t round = (1U << mShift) >> 1;
+    uint32_t       sum   = mSum[channel];
+    uint16_t       phase = mPhase;
+
+    for (uint16_t n = 0; n < scans; n++)
+    {
+        sum += input[n * mChannels];
+
+        if (++phase == mDecimation)
+        {
+            *output = static_cast<uint16_t>((sum + round) >> mShift);
+            output += mChannels;
+            sum     = 0;
+            phase   = 0;
+        }
+    }
+
+    mSum[channel] = sum;
+}
+
+/**
+ * \brief   Clear the partial sums.
+ */
+void Oversampler::ResetState()
+{
+    std::memset(mSum, 0, sizeof(mSum));
+}
+
+
+/************************************************************************/
+/* CicDecimator                                                         */
+/************************************************************************/
+/**
+ * \brief   Constructor, not initialized.
+ */
+CicDecimator::CicDecimator() :
+    mOrder(0),
+    mShift(0),
+    mIntegrator(),
+    mComb()
+{ }
+
+/**
+ * \brief   Initialize the CIC decimator.
+ * \param   channels        Number of interleaved channels.
+ * \param   order           Number of integrator and comb stages. Range [1 .. 4].
+ * \param   decimationLog2  Decimation as power of 2, order * decimationLog2
+ *                          at most BLOCK_FILTER_MAX_CIC_GROWTH.
+ * \param   extraBits       Bits added to the output, at most
+ *                          order * decimationLog2. Range [0 .. 4].
+ * \returns True if the configuration is valid, else false.
+ */
+bool CicDecimator::Init(uint8_t channels, uint8_t order, uint8_t decimationLog2, uint8_t extraBits)
+{
+    const uint16_t growth = static_cast<uint16_t>(order) * decimationLog2;
+
+    EXPECT(order > 0);
+    EXPECT(order <= BLOCK_FILTER_MAX_CIC_ORDER);
+    EXPECT(decimationLog2 > 0);
+    EXPECT(growth <= BLOCK_FILTER_MAX_CIC_GROWTH);
+    EXPECT(extraBits <= BLOCK_FILTER_MAX_EXTRA_BITS);
+
+    mChannels = 0;
+
+    if (order == 0)                                 { return false; }
+    if (order > BLOCK_FILTER_MAX_CIC_ORDER)         { return false; }
+    if (decimationLog2 == 0)                        { return false; }
+    if (growth > BLOCK_FILTER_MAX_CIC_GROWTH)       { return false; }
+    if (extraBits > BLOCK_FILTER_MAX_EXTRA_BITS)    { return false; }
+    if (extraBits > growth)                         { return false; }
+
+    mOrder = order;
+    mShift = static_cast<uint8_t>(growth - extraBits);
+    return SetLayout(channels, static_cast<uint16_t>(1U << decimationLog2));
+}
+
+/**
+ * \brief   Integrate each sample of a channel, run the combs per output.
+ * \param   channel     The channel.
+ * \param   input       First sample of the channel, scans are mChannels apart.
+ * \param   scans       Number of scans in the block.
+ * \param   output      First output of the channel, scans are mChannels apart.
+ */
+void CicDecimator::ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output)
+{
+    const uint32_t round      = (1U << mShift) >> 1;
+    uint32_t*      integrator = mIntegrator[channel];
+    uint32_t*      comb       = mComb[channel];
+    uint16_t       phase      = mPhase;
+
+    for (uint16_t n = 0; n < scans; n++)
+    {
+        uint32_t value = input[n * mChannels];
+        for (uint8_t stage = 0; stage < mOrder; stage++)
+        {
+            integrator[stage] += value;
+            value = integrator[stage];
+        }
+
+        if (++phase == mDecimation)
+        {
+            for (uint8_t stage = 0; stage < mOrder; stage++)
+            {
+                const uint32_t difference = value - comb[stage];
+                comb[stage] = value;
+                value       = difference;
+            }
+
+            *output = Clamp(static_cast<int32_t>((value + round) >> mShift));
+            output += mChannels;
+            phase   = 0;
+        }
+    }
+}
+
+/**
+ * \brief   Clear the integrators and comb delays.
+ */
+void CicDecimator::ResetState()
+{
+    std::memset(mIntegrator, 0, sizeof(mIntegrator));
+    std::memset(mComb, 0, sizeof(mComb));
+}
+
+
+/************************************************************************/
+/* FirDecimator                                                         */
+/************************************************************************/
+/**
+ * \brief   Constructor, not initialized.
+ */
+FirDecimator::FirDecimator() :
+    mTaps(0),
+    mShift(0),
+    mOffset(0),
+    mPosition(),
+    mCoefficients(),
+    mHistory()
+{ }
+
+/**
+ * \brief   Initialize the FIR decimator.
+ * \param   channels        Number of interleaved channels.
+ * \param   coefficients    The Q15 coefficients, coefficients[0] applies to
+ *                          the newest sample. Copied. The sum of their
+ *                          absolute values is at most 16.0.
+ * \param   taps            Number of coefficients. Range [1 .. 32].
+ * \param   decimation      Number of input scans per output scan.
+ * \param   extraBits       Bits added to the output. Range [0 .. 4].
+ * \returns True if the configuration is valid, else false.
+ */
+bool FirDecimator::Init(uint8_t channels, const int16_t* coefficients, uint8_t taps, uint16_t decimation, uint8_t extraBits)
+{
+    EXPECT(coefficients);
+    EXPECT(taps > 0);
+    EXPECT(taps <= BLOCK_FILTER_MAX_TAPS);
+    EXPECT(extraBits <= BLOCK_FILTER_MAX_EXTRA_BITS);
+
+    mChannels = 0;
+
+    if (coefficients == nullptr)                    { return false; }
+    if (taps == 0)                                  { return false; }
+    if (taps > BLOCK_FILTER_MAX_TAPS)               { return false; }
+    if (extraBits > BLOCK_FILTER_MAX_EXTRA_BITS)    { return false; }
+
+    int32_t gain   = 0;
+    int32_t dcGain = 0;
+    for (uint8_t i = 0; i < taps; i++)
+    {
+        gain   += (coefficients[i] < 0) ? -coefficients[i] : coefficients[i];
+        dcGain += coefficients[i];
+    }
+    if (gain > (16 << 15))                          { return false; }
+
+    // Reversed, so a window of the history (oldest sample first) lines up.
+    // An odd number of taps gets a leading 0, for whole pairs.
+    mTaps = static_cast<uint8_t>((taps + 1) & ~1U);
+    std::memset(mCoefficients, 0, sizeof(mCoefficients));
+    for (uint8_t i = 0; i < taps; i++)
+    {
+        mCoefficients[mTaps - 1 - i] = coefficients[i];
+    }
+
+    // The samples are filtered minus MID_SCALE: add it back, times the DC
+    // gain, together with the rounding.
+    mShift  = static_cast<uint8_t>(15 - extraBits);
+    mOffset = (static_cast<int64_t>(dcGain) * MID_SCALE) + (1 << (mShift - 1));
+    return SetLayout(channels, decimation);
+}
+
+/**
+ * \brief   Add each sample of a channel to its history, calculate the
+ *          outputs kept.
+ * \details A sample is stored at 'position' and 'position + taps', after
+ *          which the window of the last 'taps' samples starts at the next
+ *          position, without wrapping. The samples are stored minus
+ *          MID_SCALE, so the full 16 bit range fits an int16_t.
+ * \param   channel     The channel.
+ * \param   input       First sample of the channel, scans are mChannels apart.
+ * \param   scans       Number of scans in the block.
+ * \param   output      First output of the channel, scans are mChannels apart.
+ */
+void FirDecimator::ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output)
+{
+    int16_t*      history  = mHistory[channel];
+    uint8_t       position = mPosition[channel];
+    uint16_t      phase    = mPhase;
+
+    for (uint16_t n = 0; n < scans; n++)
+    {
+        const int16_t sample = static_cast<int16_t>(static_cast<int32_t>(input[n * mChannels]) - MID_SCALE);
+        history[position]         = sample;
+        history[position + mTaps] = sample;
+        if (++position == mTaps) { position = 0; }
+
+        if (++phase == mDecimation)
+        {
+            const int64_t sum = MultiplyAccumulate(&history[position], mCoefficients, mTaps);
+
+            *output = Clamp(static_cast<int32_t>((sum + mOffset) >> mShift));
+            output += mChannels;
+            phase   = 0;
+        }
+    }
+
+    mPosition[channel] = position;
+}
+
+/**
+ * \brief   Clear the history: as if preceded by zeros.
+ */
+void FirDecimator::ResetState()
+{
+    std::memset(mPosition, 0, sizeof(mPosition));
+    std::fill_n(&mHistory[0][0], sizeof(mHistory) / sizeof(mHistory[0][0]), static_cast<int16_t>(-MID_SCALE));
+}
@@ -0,0 +1,187 @@
+/**
+ * \file    BlockFilter.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Oversampling and decimation of ADC blocks: box-car, CIC and FIR.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/BlockFilter
+ *
+ * \details A filter takes a block of interleaved scans, as delivered by
+ *          Adc::StartStream(): sample n of channel c is at
+ *          input[(n * channels) + c]. The output has the same layout, one
+ *          output scan per 'decimation' input scans. Blocks can have any
+ *          number of whole scans, the filter state carries over from block
+ *          to block: the output does not depend on how the input is split.
+ *
+ *          The output is the low pass filtered input shifted left by
+ *          'extraBits': averaging 4^n samples of uncorrelated noise gives n
+ *          extra bits of resolution (as AN2668). Input and extra bits
+ *          together must fit in 16 bits.
+ *
+ *          Integer kernels only. Box-car and CIC need one ADD per sample per
+ *          stage. The FIR calculates only the outputs kept, two taps per
+ *          SMLALD on the Cortex-M4 (portable C elsewhere).
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+#ifndef BLOCK_FILTER_HPP_
+#define BLOCK_FILTER_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     BLOCK_FILTER_MAX_CHANNELS
+ * \brief   Maximum number of interleaved channels.
+ */
+#define BLOCK_FILTER_MAX_CHANNELS       8
+
+/**
+ * \def     BLOCK_FILTER_MAX_EXTRA_BITS
+ * \brief   Maximum number of bits added to the output, 12 bit samples become
+ *          16 bit outputs.
+ */
+#define BLOCK_FILTER_MAX_EXTRA_BITS     4
+
+/**
+ * \def     BLOCK_FILTER_MAX_CIC_ORDER
+ * \brief   Maximum number of integrator and comb stages of the CIC.
+ */
+#define BLOCK_FILTER_MAX_CIC_ORDER      4
+
+/**
+ * \def     BLOCK_FILTER_MAX_CIC_GROWTH
+ * \brief   Maximum bit growth of the CIC: order * log2(decimation). The
+ *          32 bit registers hold 12 bit samples and the growth.
+ */
+#define BLOCK_FILTER_MAX_CIC_GROWTH     20
+
+/**
+ * \def     BLOCK_FILTER_MAX_TAPS
+ * \brief   Maximum number of FIR coefficients.
+ */
+#define BLOCK_FILTER_MAX_TAPS           32
+
+
+/************************************************************************/
+/* Class declarations                                                   */
+/************************************************************************/
+/**
+ * \class   BlockFilter
+ * \brief   Base of the filters: channels, decimation and the block loop.
+ */
+class BlockFilter
+{
+public:
+    virtual ~BlockFilter() = default;
+
+    uint16_t Process(const uint16_t* input, uint16_t length, uint16_t* output, uint16_t size);
+    void Reset();
+
+    uint16_t GetOutputSize(uint16_t length) const;
+    uint8_t GetChannelCount() const;
+    uint16_t GetDecimation() const;
+
+protected:
+    BlockFilter();
+
+    bool SetLayout(uint8_t channels, uint16_t decimation);
+
+    uint8_t  mChannels;
+    uint16_t mDecimation;
+    uint16_t mPhase;            ///< Input scans since the last output scan
+
+private:
+    virtual void ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output) = 0;
+    virtual void ResetState() = 0;
+};
+
+
+/**
+ * \class   Oversampler
+ * \brief   Box-car: the sum of 4^extraBits samples, shifted right by
+ *          extraBits. Also decimates by 4^extraBits.
+ */
+class Oversampler final : public BlockFilter
+{
+public:
+    Oversampler();
+
+    bool Init(uint8_t channels, uint8_t extraBits);
+
+private:
+    uint8_t  mShift;
+    uint32_t mSum[BLOCK_FILTER_MAX_CHANNELS];
+
+    void ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output) override;
+    void ResetState() override;
+};
+
+
+/**
+ * \class   CicDecimator
+ * \brief   Cascaded integrator-comb: 'order' integrators at the input rate,
+ *          'order' combs (differential delay 1) at the output rate. The
+ *          gain decimation^order is removed, leaving extraBits.
+ * \note    The integrators wrap around, which the combs undo: exact integer
+ *          arithmetic, no overflow handling needed.
+ */
+class CicDecimator final : public BlockFilter
+{
+public:
+    CicDecimator();
+
+    bool Init(uint8_t channels, uint8_t order, uint8_t decimationLog2, uint8_t extraBits);
+
+private:
+    uint8_t  mOrder;
+    uint8_t  mShift;
+    uint32_t mIntegrator[BLOCK_FILTER_MAX_CHANNELS][BLOCK_FILTER_MAX_CIC_ORDER];
+    uint32_t mComb[BLOCK_FILTER_MAX_CHANNELS][BLOCK_FILTER_MAX_CIC_ORDER];
+
+    void ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output) override;
+    void ResetState() override;
+};
+
+
+/**
+ * \class   FirDecimator
+ * \brief   FIR with Q15 coefficients, only every 'decimation'-th output is
+ *          calculated. Outputs below 0 or above 16 bits are clamped.
+ */
+class FirDecimator final : public BlockFilter
+{
+public:
+    FirDecimator();
+
+    bool Init(uint8_t channels, const int16_t* coefficients, uint8_t taps, uint16_t decimation, uint8_t extraBits);
+
+private:
+    uint8_t  mTaps;             ///< Taps rounded up to even, pairs for SMLAD
+    uint8_t  mShift;
+    int64_t  mOffset;           ///< Mid-scale times the DC gain, plus rounding
+    uint8_t  mPosition[BLOCK_FILTER_MAX_CHANNELS];
+    alignas(4) int16_t mCoefficients[BLOCK_FILTER_MAX_TAPS];                                ///< Reversed: oldest sample first
+    alignas(4) int16_t mHistory[BLOCK_FILTER_MAX_CHANNELS][2 * BLOCK_FILTER_MAX_TAPS];      ///< Samples stored twice: a window is contiguous
+
+    void ProcessChannel(uint8_t channel, const uint16_t* input, uint16_t scans, uint16_t* output) override;
+    void ResetState() override;
+};
+
+
+#endif  // BLOCK_FILTER_HPP_
@@ -0,0 +1,395 @@
+/**
+ * \file    CircularFifo.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          Kjell Hedström <hedstrom@kjellkod.cc> wrote this file, with
+ *          modifications from <terry.louwers@fourtress.nl>. The latter
+ *          modified the license for chance on a beer. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \note    This is a modification of the code published by
+ *          Kjell Hedström, hedstrom@kjellkod.cc, most recent versions
+ *          can be found at: http://www.kjellkod.cc/threadsafecircularqueue
+ *
+ * \class   CircularFifo
+ *
+ * \brief   Single-Producer, Single-Consumer, lock free, wait free, circular buffer.
+ *
+ * \details The size must be a power of 2: the head and tail are free running
+ *          counters, the index into the buffer is obtained with a mask and
+ *          all 'Size' elements can be used. Next to single element push/pop,
+ *          elements can be moved in bulk (push_n/pop_n) or accessed in place
+ *          as contiguous spans (write_acquire/read_acquire), for instance as
+ *          DMA source or destination.
+ *          The producer and consumer indices are placed on separate cache
+ *          lines, each with a cached copy of the other index: the producer
+ *          and consumer only touch each others line when the cached copy
+ *          indicates the buffer is full or empty.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/CircularFifo
+ *
+ * \author  Terry Louwers (terry.louwers@fourtress.nl)
+ * \version 2.0
+ * \date    10-2026
+ */
+
+#ifndef CIRCULARFIFO_HPP_
+#define CIRCULARFIFO_HPP_
+
+/******************************************************************************
+ * Includes                                                                   *
+ *****************************************************************************/
+#include <atomic>
+#include <cstddef>
+
+
+/******************************************************************************
+ * Defines                                                                    *
+ *****************************************************************************/
+/**
+ * \def     CIRCULAR_FIFO_CACHE_LINE_SIZE
+ * \brief   Alignment of the producer and consumer administration. The
+ *          Cortex-M4 has no data cache, 32 bytes matches the Cortex-M7. Can
+ *          be overruled (for instance with 4) to save RAM.
+ */
+#ifndef CIRCULAR_FIFO_CACHE_LINE_SIZE
+    #if defined(__arm__)
+        #define CIRCULAR_FIFO_CACHE_LINE_SIZE   32
+    #else
+        #define CIRCULAR_FIFO_CACHE_LINE_SIZE   64
+    #endif
+#endif
+
+
+/******************************************************************************
+ * Template Class                                                             *
+ *****************************************************************************/
+template<typename Element, size_t Size>
+class CircularFifo
+{
+    static_assert((Size >= 2) && ((Size & (Size - 1)) == 0), "Size must be a power of 2");
+
+public:
+    enum { Capacity = Size };
+
+    CircularFifo() : _tail(0), _headCache(0), _head(0), _tailCache(0) {}
+    virtual ~CircularFifo() {}
+
+    bool push(const Element& item);
+    bool pop(Element& item);
+
+    bool peek(Element& item);
+
+    size_t push_n(const Element* items, size_t count);
+    size_t pop_n(Element* items, size_t count);
+
+    size_t write_acquire(Element*& span);
+    void write_commit(size_t count);
+    size_t read_acquire(const Element*& span);
+    void read_release(size_t count);
+
+    size_t size() const;
+    bool empty() const;
+    bool full() const;
+    bool isLockFree() const;
+    void clear();
+
+private:
+    static constexpr size_t Mask = Size - 1;
+
+    size_t writable(size_t tail, size_t wanted);
+    size_t readable(size_t head, size_t wanted);
+
+    // Producer: tail(input) index and its copy of the head
+    alignas(CIRCULAR_FIFO_CACHE_LINE_SIZE) std::atomic<size_t> _tail;
+    size_t                                                     _headCache;
+
+    // Consumer: head(output) index and its copy of the tail
+    alignas(CIRCULAR_FIFO_CACHE_LINE_SIZE) std::atomic<size_t> _head;
+    size_t                                                     _tailCache;
+
+    alignas(CIRCULAR_FIFO_CACHE_LINE_SIZE) Element             _array[Size];
+};
+
+
+/**
+ * \brief   Push a new item at the position indexed by the tail. After writing the tail is
+ *          incremented one step. The queue grows with the tail.
+ *          When the queue is full (tail is 'Size' ahead of head), any writes will fail.
+ * \param   item    Constant reference to the element to add to the queue.
+ * \result  True if the element was added, false if not (queue full).
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::push(const Element& item)
+{
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+
+    if (writable(current_tail, 1) == 0)
+    {
+        return false; // full queue
+    }
+
+    _array[current_tail & Mask] = item;
+    _tail.store(current_tail + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * \brief   Pop the item indexed by the head. The head is moved toward the tail as
+ *          it is incremented one step.
+ *          The queue shrinks with the head.
+ *          When the queue is empty, head and tail will be equal. At this point,
+ *          any reads will fail.
+ * \param   item    Reference to put the read value into (read from the queue).
+ * \result  True if the element was read, false if not (queue empty).
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::pop(Element& item)
+{
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+
+    if (readable(current_head, 1) == 0)
+    {
+        return false; // empty queue
+    }
+
+    item = _array[current_head & Mask];
+    _head.store(current_head + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * \brief   Peek the item indexed by the head.
+ * \param   item    Reference to put the peeked value into (read from the queue).
+ * \result  True if the element could be peeked, false if not (queue empty).
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::peek(Element& item)
+{
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+
+    if (readable(current_head, 1) == 0)
+    {
+        return false; // empty queue
+    }
+
+    item = _array[current_head & Mask];
+    return true;
+}
+
+/**
+ * \brief   Push as many items as fit, in order. The tail is moved once for all items.
+ * \param   items   Pointer to the elements to add to the queue.
+ * \param   count   The number of elements to add.
+ * \result  The number of elements added, less than count if the queue is full.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::push_n(const Element* items, size_t count)
+{
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    const size_t free_slots   = writable(current_tail, count);
+    const size_t n            = (count < free_slots) ? count : free_slots;
+
+    const size_t index = current_tail & Mask;
+    const size_t first = ((Size - index) < n) ? (Size - index) : n;
+
+    for (size_t i = 0; i < first; i++) { _array[index + i] = items[i]; }
+    for (size_t i = first; i < n; i++) { _array[i - first] = items[i]; }
+
+    _tail.store(current_tail + n, std::memory_order_release);
+    return n;
+}
+
+/**
+ * \brief   Pop as many items as available, up to count, in order. The head is moved
+ *          once for all items.
+ * \param   items   Pointer to put the read values into.
+ * \param   count   The maximum number of elements to read.
+ * \result  The number of elements read, less than count if the queue runs empty.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::pop_n(Element* items, size_t count)
+{
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    const size_t used_slots   = readable(current_head, count);
+    const size_t n            = (count < used_slots) ? count : used_slots;
+
+    const size_t index = current_head & Mask;
+    const size_t first = ((Size - index) < n) ? (Size - index) : n;
+
+    for (size_t i = 0; i < first; i++) { items[i] = _array[index + i]; }
+    for (size_t i = first; i < n; i++) { items[i] = _array[i - first]; }
+
+    _head.store(current_head + n, std::memory_order_release);
+    return n;
+}
+
+/**
+ * \brief   Get the contiguous free space at the tail, to be filled in place (for
+ *          instance by DMA). The elements become available to the consumer with
+ *          write_commit().
+ * \param   span    Is set to the first free element.
+ * \result  The number of contiguous free elements, 0 if the queue is full. Less
+ *          than the total free space if the free space wraps around.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::write_acquire(Element*& span)
+{
+    const size_t current_tail = _tail.load(std::memory_order_relaxed);
+    const size_t index        = current_tail & Mask;
+    const size_t to_end       = Size - index;
+    const size_t free_slots   = writable(current_tail, to_end);
+
+    span = &_array[index];
+    return (free_slots < to_end) ? free_slots : to_end;
+}
+
+/**
+ * \brief   Make elements written in place available to the consumer.
+ * \param   count   The number of elements written, at most the number returned
+ *                  by write_acquire().
+ */
+template<typename Element, size_t Size>
+void CircularFifo<Element, Size>::write_commit(size_t count)
+{
+    _tail.store(_tail.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+/**
+ * \brief   Get the contiguous available elements at the head, to be processed
+ *          in place. The elements are removed with read_release().
+ * \param   span    Is set to the first available element.
+ * \result  The number of contiguous available elements, 0 if the queue is empty.
+ *          Less than the total available if the elements wrap around.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::read_acquire(const Element*& span)
+{
+    const size_t current_head = _head.load(std::memory_order_relaxed);
+    const size_t index        = current_head & Mask;
+    const size_t to_end       = Size - index;
+    const size_t used_slots   = readable(current_head, to_end);
+
+    span = &_array[index];
+    return (used_slots < to_end) ? used_slots : to_end;
+}
+
+/**
+ * \brief   Remove elements processed in place, the producer can reuse the space.
+ * \param   count   The number of elements processed, at most the number returned
+ *                  by read_acquire().
+ */
+template<typename Element, size_t Size>
+void CircularFifo<Element, Size>::read_release(size_t count)
+{
+    _head.store(_head.load(std::memory_order_relaxed) + count, std::memory_order_release);
+}
+
+/**
+ * \brief   Get the number of elements in the queue.
+ * \remark  This is a snapshot, queue status may change by either producer or
+ *          consumer before the other accesses it.
+ * \result  Returns the number of elements in the queue.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::size() const
+{
+    // Head first: the tail never falls behind a later read head
+    const size_t current_head = _head.load(std::memory_order_acquire);
+    return (_tail.load(std::memory_order_acquire) - current_head);
+}
+
+/**
+ * \brief   Checks if the queue is empty.
+ * \remark  This is a snapshot, queue status may change by either producer or
+ *          consumer before the other accesses it.
+ * \result  Returns true if the queue is empty, else false.
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::empty() const
+{
+    return (size() == 0);
+}
+
+/**
+ * \brief   Checks if the queue is full.
+ * \remark  This is a snapshot, queue status may change by either producer or
+ *          consumer before the other accesses it.
+ * \result  Returns true if the queue is full, else false.
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::full() const
+{
+    return (size() >= Size);
+}
+
+/**
+ * \brief   Check if atomic operations on the head and tail are truly lock-free.
+ * \remark  This can be used as a sanity check to see if the compiler did the right thing.
+ * \result  Returns true if the atomic operations on the head and tail are lock-free, else false.
+ */
+template<typename Element, size_t Size>
+bool CircularFifo<Element, Size>::isLockFree() const
+{
+    return (_tail.is_lock_free() && _head.is_lock_free());
+}
+
+/**
+ * \brief   Clear the queue (by setting head and tail to 0).
+ * \remark  Use sparsely.
+ * \note    This is NOT thread safe.
+ */
+template<typename Element, size_t Size>
+void CircularFifo<Element, Size>::clear()
+{
+    _tail.store(0, std::memory_order_release);
+    _head.store(0, std::memory_order_release);
+    _headCache = 0;
+    _tailCache = 0;
+}
+
+/**
+ * \brief   Producer: number of free elements. The head is only read from the
+ *          consumer if the cached copy shows less than wanted.
+ * \param   tail    The current tail.
+ * \param   wanted  The number of free elements needed.
+ * \result  The number of free elements.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::writable(size_t tail, size_t wanted)
+{
+    size_t free_slots = Size - (tail - _headCache);
+
+    if (free_slots < wanted)
+    {
+        _headCache = _head.load(std::memory_order_acquire);
+        free_slots = Size - (tail - _headCache);
+    }
+    return free_slots;
+}
+
+/**
+ * \brief   Consumer: number of available elements. The tail is only read from
+ *          the producer if the cached copy shows less than wanted.
+ * \param   head    The current head.
+ * \param   wanted  The number of elements needed.
+ * \result  The number of available elements.
+ */
+template<typename Element, size_t Size>
+size_t CircularFifo<Element, Size>::readable(size_t head, size_t wanted)
+{
+    size_t used_slots = _tailCache - head;
+
+    if (used_slots < wanted)
+    {
+        _tailCache = _tail.load(std::memory_order_acquire);
+        used_slots = _tailCache - head;
+    }
+    return used_slots;
+}
+
+
+#endif  // CIRCULARFIFO_HPP_
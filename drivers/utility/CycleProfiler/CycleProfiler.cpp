@@ -0,0 +1,282 @@
+/**
+ * \file    CycleProfiler.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \class   CycleProfiler
+ *
+ * \brief   Cycle accurate profiling of code zones, using the DWT cycle counter.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/CycleProfiler
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.1
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/CycleProfiler/CycleProfiler.hpp"
+#include "utility/Assert/Assert.h"
+#include "utility/Critical/Critical.hpp"
+#include <cstring>
+
+
+/************************************************************************/
+/* Static assertions                                                    */
+/************************************************************************/
+static_assert((PROFILER_HISTOGRAM_BASE & (PROFILER_HISTOGRAM_BASE - 1)) == 0, "PROFILER_HISTOGRAM_BASE must be a power of 2");
+static_assert(PROFILER_HISTOGRAM_BINS >= 2, "PROFILER_HISTOGRAM_BINS must be at least 2");
+static_assert(PROFILER_MAX_ZONES < PROFILER_INVALID_ZONE, "PROFILER_MAX_ZONES too large");
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  Zone
+ * \brief   Administration of a single zone.
+ */
+struct Zone
+{
+    const char* name;
+    uint32_t    start;
+    uint32_t    count;
+    uint32_t    min;
+    uint32_t    max;
+    uint64_t    total;
+    uint32_t    histogram[PROFILER_HISTOGRAM_BINS];
+};
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static Zone     zones[PROFILER_MAX_ZONES] = {};
+static uint8_t  zoneCount = 0;
+static uint32_t epoch     = 0;          // Incremented by Init(): invalidates the cached zone ids
+static uint32_t overhead  = 0;
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Get the histogram bin for the given duration.
+ * \param   cycles  The duration in cycles.
+ * \returns The bin, 0 for durations below PROFILER_HISTOGRAM_BASE.
+ */
+static inline uint8_t GetBin(uint32_t cycles)
+{
+    if (cycles < PROFILER_HISTOGRAM_BASE) { return 0; }
+
+    // floor(log2(cycles)) - log2(base) + 1
+    const uint32_t bin = (31 - __builtin_clz(cycles)) - __builtin_ctz(PROFILER_HISTOGRAM_BASE) + 1;
+    return (bin < PROFILER_HISTOGRAM_BINS) ? static_cast<uint8_t>(bin) : (PROFILER_HISTOGRAM_BINS - 1);
+}
+
+/**
+ * \brief   Clear the measurements of a zone, keeps its name.
+ * \param   zone    The zone to clear.
+ */
+static void ClearZone(Zone& zone)
+{
+    zone.start = 0;
+    zone.count = 0;
+    zone.min   = UINT32_MAX;
+    zone.max   = 0;
+    zone.total = 0;
+    memset(zone.histogram, 0, sizeof(zone.histogram));
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Enable the DWT cycle counter, remove all zones and calibrate the
+ *          overhead of a measurement.
+ * \details The overhead (the cycles between 2 consecutive reads of the
+ *          counter) is subtracted from each measurement.
+ * \returns True if the cycle counter is enabled, else false.
+ */
+bool CycleProfiler::Init()
+{
+    CoreDebug->DEMCR |= CoreDebug_DEMCR_TRCENA_Msk;
+    DWT->CTRL        |= DWT_CTRL_CYCCNTENA_Msk;
+
+    const uint32_t prim = EnterCritical();
+    memset(zones, 0, sizeof(zones));
+    zoneCount = 0;
+    if (++epoch == 0) { epoch = 1; }
+
+    // Take the minimum of a few samples, the first may include a cache or flash wait state
+    overhead = UINT32_MAX;
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        const uint32_t start = Now();
+        const uint32_t delta = Now() - start;
+        if (delta < overhead) { overhead = delta; }
+    }
+    ExitCritical(prim);
+
+    return ((DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk) != 0);
+}
+
+/**
+ * \brief   Register a zone by name.
+ * \param   name    The name of the zone, must remain valid (string literal).
+ * \returns The id of the zone, the existing id if the name was registered
+ *          before, PROFILER_INVALID_ZONE if the name is invalid or no more
+ *          zones are available.
+ * \note    The name is compared by address, not by content.
+ */
+uint8_t CycleProfiler::Register(const char* name)
+{
+    EXPECT(name != nullptr);
+    if (name == nullptr) { return PROFILER_INVALID_ZONE; }
+
+    uint8_t id = PROFILER_INVALID_ZONE;
+
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < zoneCount; i++)
+    {
+        if (zones[i].name == name) { id = i; }
+    }
+
+    if ((id == PROFILER_INVALID_ZONE) && (zoneCount < PROFILER_MAX_ZONES))
+    {
+        id = zoneCount;
+        zones[id].name = name;
+        ClearZone(zones[id]);
+        zoneCount++;
+    }
+    ExitCritical(prim);
+
+    EXPECT(id != PROFILER_INVALID_ZONE);
+    return id;
+}
+
+/**
+ * \brief   Register a zone by name once per Init(), the id is kept in the
+ *          cache: for zones in code running before or across an Init().
+ * \param   name    The name of the zone, must remain valid (string literal).
+ * \param   cache   The id of the zone, initially { PROFILER_INVALID_ZONE, 0 }.
+ * \returns The id of the zone, PROFILER_INVALID_ZONE if Init() was not called
+ *          or no more zones are available.
+ */
+uint8_t CycleProfiler::Register(const char* name, ProfilerZoneCache& cache)
+{
+    if (cache.epoch != epoch)
+    {
+        cache.zone  = Register(name);
+        cache.epoch = epoch;
+    }
+    return cache.zone;
+}
+
+/**
+ * \brief   Mark the start of a zone, for instance at the start of an ISR.
+ * \param   zone    The zone, as returned by Register().
+ * \note    A zone cannot be nested in itself: use a separate zone per
+ *          interrupt priority level.
+ */
+void CycleProfiler::Enter(uint8_t zone)
+{
+    if (zone < zoneCount) { zones[zone].start = Now(); }
+}
+
+/**
+ * \brief   Mark the end of a zone, records the time since Enter().
+ * \param   zone    The zone, as returned by Register().
+ */
+void CycleProfiler::Exit(uint8_t zone)
+{
+    if (zone < zoneCount) { Record(zone, Now() - zones[zone].start); }
+}
+
+/**
+ * \brief   Record a measured duration for a zone.
+ * \param   zone    The zone, as returned by Register().
+ * \param   cycles  The duration, the calibrated overhead is subtracted.
+ * \note    Safe to call from ISR and task context, takes constant time.
+ */
+void CycleProfiler::Record(uint8_t zone, uint32_t cycles)
+{
+    if (zone >= zoneCount) { return; }
+
+    cycles = (cycles > overhead) ? (cycles - overhead) : 0;
+    const uint8_t bin = GetBin(cycles);
+
+    Zone& z = zones[zone];
+
+    const uint32_t prim = EnterCritical();
+    z.count++;
+    z.total += cycles;
+    if (cycles < z.min) { z.min = cycles; }
+    if (cycles > z.max) { z.max = cycles; }
+    z.histogram[bin]++;
+    ExitCritical(prim);
+}
+
+/**
+ * \brief   Get the number of registered zones.
+ * \returns The number of registered zones, ids are 0 up to this number.
+ */
+uint8_t CycleProfiler::GetZoneCount()
+{
+    return zoneCount;
+}
+
+/**
+ * \brief   Get a consistent copy of the measurements of a zone.
+ * \param   zone    The zone, as returned by Register().
+ * \param   stats   Filled with the measurements.
+ * \returns True if the zone is valid, else false.
+ */
+bool CycleProfiler::GetStatistics(uint8_t zone, ProfilerZoneStats& stats)
+{
+    EXPECT(zone < zoneCount);
+    if (zone >= zoneCount) { return false; }
+
+    const Zone& z = zones[zone];
+
+    const uint32_t prim = EnterCritical();
+    stats.name  = z.name;
+    stats.count = z.count;
+    stats.min   = (z.count > 0) ? z.min : 0;
+    stats.max   = z.max;
+    stats.total = z.total;
+    memcpy(stats.histogram, z.histogram, sizeof(stats.histogram));
+    ExitCritical(prim);
+
+    stats.mean = (stats.count > 0) ? static_cast<uint32_t>(stats.total / stats.count) : 0;
+    return true;
+}
+
+/**
+ * \brief   Get the calibrated overhead of a measurement.
+ * \returns The overhead in cycles, subtracted from each measurement.
+ */
+uint32_t CycleProfiler::GetOverhead()
+{
+    return overhead;
+}
+
+/**
+ * \brief   Clear the measurements of all zones, the zones stay registered.
+ */
+void CycleProfiler::Reset()
+{
+    const uint32_t prim = EnterCritical();
+    for (uint8_t i = 0; i < zoneCount; i++)
+    {
+        ClearZone(zones[i]);
+    }
+    ExitCritical(prim);
+}
@@ -0,0 +1,301 @@
+/**
+ * \file    Dds.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Direct digital synthesis of sine, saw and triangle waveforms, in
+ *          blocks for a DAC stream.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/Dds
+ *
+ * \note    The tables hold Q15 values of one period. With 256 entries and
+ *          linear interpolation the error of the sine is below 1 LSB of a
+ *          12 bit DAC.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/Dds/Dds.hpp"
+#include "utility/Assert/Assert.h"
+
+
+/************************************************************************/
+/* Constants                                                            */
+/************************************************************************/
+namespace {
+
+constexpr double PI = 3.14159265358979323846;
+
+/**
+ * \brief   Sine for the tables: Taylor series on [0, pi/2], accurate to well
+ *          beyond 16 bits. Compile time only.
+ * \param   x   Angle in radians, [0, 2 pi).
+ * \returns sin(x).
+ */
+constexpr double Sine(double x)
+{
+    double sign = 1.0;
+    if (x >= PI)     { x -= PI; sign = -1.0; }
+    if (x > (PI / 2)) { x = PI - x; }
+
+    const double x2 = x * x;
+    double term = x;
+    double sum  = x;
+    for (int n = 1; n <= 7; n++)
+    {
+        term *= -x2 / ((2 * n) * ((2 * n) + 1));
+        sum  += term;
+    }
+    return sign * sum;
+}
+
+/**
+ * \brief   One period of a waveform in Q15, calculated at compile time.
+ */
+struct Table
+{
+    int16_t values[DDS_TABLE_SIZE];
+
+    constexpr explicit Table(Dds::Shape shape) :
+        values{}
+    {
+        for (int i = 0; i < DDS_TABLE_SIZE; i++)
+        {
+            const double position = static_cast<double>(i % (DDS_TABLE_SIZE - 1)) / (DDS_TABLE_SIZE - 1);   // [0, 1)
+            double value = 0.0;
+
+            switch (shape)
+            {
+                case Dds::Shape::SINE:     value = Sine(2.0 * PI * position); break;
+                case Dds::Shape::SAW:      value = (2.0 * position) - 1.0; break;
+                case Dds::Shape::TRIANGLE: value = (position < 0.25) ? (4.0 * position) : ((position < 0.75) ? (2.0 - (4.0 * position)) : ((4.0 * position) - 4.0)); break;
+            }
+
+            value *= 32767.0;
+            values[i] = static_cast<int16_t>((value >= 0.0) ? (value + 0.5) : (value - 0.5));
+        }
+    }
+};
+
+constexpr Table sineTable(Dds::Shape::SINE);
+constexpr Table sawTable(Dds::Shape::SAW);
+constexpr Table triangleTable(Dds::Shape::TRIANGLE);
+
+static_assert(sineTable.values[(DDS_TABLE_SIZE - 1) / 4] == 32767, "Sine table: peak at a quarter period");
+
+} // namespace
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Constructor, the synthesizer is not initialized.
+ */
+Dds::Dds() :
+    mSampleRate(0.0f),
+    mMid(0),
+    mMaxPeak(0),
+    mPhase(0),
+    mTuningWord(0),
+    mPeak(0),
+    mShape(Shape::SINE),
+    mPendingTuningWord(0),
+    mPendingPeak(0),
+    mPendingShape(Shape::SINE),
+    mPendingPhaseReset(false)
+{ }
+
+/**
+ * \brief   Initialize the synthesizer: a sine at amplitude 1.0 and 0 Hz.
+ * \param   sampleRate  The rate at which the DAC outputs the samples, in Hz.
+ * \param   fullScale   The highest DAC code: 4095 for 12 bit, 255 for 8 bit.
+ *                      The output swings around (fullScale + 1) / 2.
+ * \returns True if the synthesizer is initialized, else false.
+ * \note    Asserts if the sample rate or full scale is invalid.
+ */
+bool Dds::Init(float sampleRate, uint16_t fullScale /* = 4095 */)
+{
+    EXPECT(sampleRate > 0.0f);
+    EXPECT(fullScale > 1);
+
+    if (!(sampleRate > 0.0f) || (fullScale <= 1)) { return false; }
+
+    mSampleRate = sampleRate;
+    mMid        = static_cast<uint16_t>((static_cast<uint32_t>(fullScale) + 1) / 2);
+    mMaxPeak    = fullScale - mMid;
+    mPhase      = 0;
+    mTuningWord = 0;
+    mPeak       = 0;            // Fades in over the first block
+    mShape      = Shape::SINE;
+
+    mPendingTuningWord = 0;
+    mPendingPeak       = mMaxPeak;
+    mPendingShape      = Shape::SINE;
+    mPendingPhaseReset = false;
+    return true;
+}
+
+/**
+ * \brief   Indicate if the synthesizer is initialized.
+ * \returns True if initialized, else false.
+ */
+bool Dds::IsInit() const
+{
+    return (mSampleRate > 0.0f);
+}
+
+/**
+ * \brief   Set the frequency, applied from the next block on.
+ * \param   frequency   The frequency in Hz, [0 .. sample rate / 2].
+ * \returns True if the frequency is set, else false.
+ */
+bool Dds::SetFrequency(float frequency)
+{
+    EXPECT(frequency >= 0.0f);
+    EXPECT(frequency <= (mSampleRate / 2));
+
+    if (!IsInit()) { return false; }
+    if (!(frequency >= 0.0f) || (frequency > (mSampleRate / 2))) { return false; }
+
+    mPendingTuningWord = CalculateTuningWord(mSampleRate, frequency);
+    return true;
+}
+
+/**
+ * \brief   Set the amplitude, the next block ramps to it.
+ * \param   amplitude   The amplitude relative to full scale, [0.0 .. 1.0].
+ * \returns True if the amplitude is set, else false.
+ */
+bool Dds::SetAmplitude(float amplitude)
+{
+    EXPECT(amplitude >= 0.0f);
+    EXPECT(amplitude <= 1.0f);
+
+    if (!IsInit()) { return false; }
+    if (!(amplitude >= 0.0f) || (amplitude > 1.0f)) { return false; }
+
+    mPendingPeak = static_cast<uint16_t>((amplitude * mMaxPeak) + 0.5f);
+    return true;
+}
+
+/**
+ * \brief   Set the waveform, applied from the next block on.
+ * \param   shape   The waveform.
+ */
+void Dds::SetShape(Shape shape)
+{
+    mPendingShape = shape;
+}
+
+/**
+ * \brief   Restart the period at the next block.
+ */
+void Dds::ResetPhase()
+{
+    mPendingPhaseReset = true;
+}
+
+/**
+ * \brief   Get the frequency synthesized (from the next block on).
+ * \returns The frequency in Hz, as set by the tuning word.
+ */
+float Dds::GetFrequency() const
+{
+    return (static_cast<float>(mPendingTuningWord) * mSampleRate) / 4294967296.0f;
+}
+
+/**
+ * \brief   Get the sample rate.
+ * \returns The sample rate in Hz, 0 if not initialized.
+ */
+float Dds::GetSampleRate() const
+{
+    return mSampleRate;
+}
+
+/**
+ * \brief   Write the next block of samples: intended as handler of
+ *          Dac::StartStream(), called from the DMA interrupt.
+ * \param   block   The block to fill with DAC codes.
+ * \param   length  The number of samples in the block.
+ */
+void Dds::Fill(uint16_t* block, uint16_t length)
+{
+    EXPECT(block);
+
+    if ((block == nullptr) || (length == 0)) { return; }
+    if (!IsInit()) { return; }
+
+    // Apply the changes made since the last block
+    mTuningWord = mPendingTuningWord;
+    mShape      = mPendingShape;
+    if (mPendingPhaseReset)
+    {
+        mPendingPhaseReset = false;
+        mPhase = 0;
+    }
+
+    const int16_t* table  = GetTable(mShape);
+    const uint16_t target = mPendingPeak;
+
+    // Peak in Q16, ramping to the target over the block
+    int32_t       peak = static_cast<int32_t>(mPeak) * 65536;
+    const int32_t step = ((static_cast<int32_t>(target) - mPeak) * 65536) / length;
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        const uint32_t index    = mPhase >> (32 - DDS_TABLE_BITS);
+        const int32_t  fraction = static_cast<int32_t>((mPhase >> (17 - DDS_TABLE_BITS)) & 0x7FFF);     // Q15
+        const int32_t  first    = table[index];
+        const int32_t  value    = first + (((table[index + 1] - first) * fraction) >> 15);
+
+        peak += step;
+        block[i] = static_cast<uint16_t>(mMid + (((value * (peak >> 16)) + 0x4000) >> 15));
+
+        mPhase += mTuningWord;
+    }
+
+    mPeak = target;
+}
+
+/**
+ * \brief   Calculate the phase increment per sample for a frequency.
+ * \param   sampleRate  The sample rate in Hz.
+ * \param   frequency   The frequency in Hz, [0 .. sample rate / 2].
+ * \returns The tuning word: frequency * 2^32 / sample rate, rounded.
+ */
+uint32_t Dds::CalculateTuningWord(float sampleRate, float frequency)
+{
+    return static_cast<uint32_t>(((frequency / sampleRate) * 4294967296.0f) + 0.5f);
+}
+
+
+/************************************************************************/
+/* Private Methods                                                      */
+/************************************************************************/
+/**
+ * \brief   Get the table of a waveform.
+ * \param   shape   The waveform.
+ * \returns The table of one period, DDS_TABLE_SIZE entries.
+ */
+const int16_t* Dds::GetTable(Shape shape)
+{
+    switch (shape)
+    {
+        case Shape::SINE:     return sineTable.values;     break;
+        case Shape::SAW:      return sawTable.values;      break;
+        case Shape::TRIANGLE: return triangleTable.values; break;
+        default: ASSERT(false); return sineTable.values; break;     // Impossible selection
+    }
+}
@@ -0,0 +1,117 @@
+/**
+ * \file    Dds.hpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Direct digital synthesis of sine, saw and triangle waveforms, in
+ *          blocks for a DAC stream.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/Dds
+ *
+ * \details A 32 bit phase accumulator advances by the tuning word each
+ *          sample: frequency = tuningWord * sampleRate / 2^32. The top bits
+ *          index a table of one period, the next 16 bits interpolate
+ *          linearly between two entries. The tables are calculated at
+ *          compile time (constexpr), no RAM and no start-up cost.
+ *
+ *          Frequency, amplitude and shape can be changed at any time (from a
+ *          task), they are applied at the start of the next block (in the
+ *          DMA interrupt): the phase is continuous, the amplitude ramps
+ *          linearly over the block. No clicks, no table swapping.
+ *
+ *          The cost per sample is fixed: one table lookup, one interpolation
+ *          and one scaling multiply, for every shape.
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef DDS_HPP_
+#define DDS_HPP_
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <cstdint>
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     DDS_TABLE_BITS
+ * \brief   Number of phase bits indexing the tables.
+ */
+#define DDS_TABLE_BITS      8
+
+/**
+ * \def     DDS_TABLE_SIZE
+ * \brief   Number of entries for one period, plus one: the first entry
+ *          repeated, for the interpolation of the last step.
+ */
+#define DDS_TABLE_SIZE      ((1 << DDS_TABLE_BITS) + 1)
+
+
+/************************************************************************/
+/* Class declaration                                                    */
+/************************************************************************/
+/**
+ * \class   Dds
+ * \brief   Phase accumulator synthesizer writing DAC codes.
+ */
+class Dds
+{
+public:
+    /**
+     * \enum    Shape
+     * \brief   Available waveforms.
+     */
+    enum class Shape : uint8_t
+    {
+        SINE,
+        SAW,        ///< Rising from minimum to maximum
+        TRIANGLE    ///< Rising from the mid level, as the sine
+    };
+
+    Dds();
+
+    bool Init(float sampleRate, uint16_t fullScale = 4095);
+    bool IsInit() const;
+
+    bool SetFrequency(float frequency);
+    bool SetAmplitude(float amplitude);
+    void SetShape(Shape shape);
+    void ResetPhase();
+
+    float GetFrequency() const;
+    float GetSampleRate() const;
+
+    void Fill(uint16_t* block, uint16_t length);
+
+    static uint32_t CalculateTuningWord(float sampleRate, float frequency);
+
+private:
+    float    mSampleRate;
+    uint16_t mMid;                          ///< Output code of the zero level
+    uint16_t mMaxPeak;                      ///< Peak in codes at amplitude 1.0
+    uint32_t mPhase;
+    uint32_t mTuningWord;
+    uint16_t mPeak;                         ///< Peak in codes at the end of the last block
+    Shape    mShape;
+
+    volatile uint32_t mPendingTuningWord;   ///< Written by the setters, applied by Fill()
+    volatile uint16_t mPendingPeak;
+    volatile Shape    mPendingShape;
+    volatile bool     mPendingPhaseReset;
+
+    static const int16_t* GetTable(Shape shape);
+};
+
+
+#endif  // DDS_HPP_
@@ -0,0 +1,220 @@
+/**
+ * \file    DeferredLog.cpp
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ *
+ * \brief   Binary deferred logger: cheap to record, formatted later.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/Drivers/utility/DeferredLog
+ *
+ * \details Multiple producers (tasks and interrupts of any priority), one
+ *          consumer. A producer reserves a slot by advancing the head with a
+ *          compare and swap (LDREX/STREX, no interrupts disabled), fills it
+ *          and then publishes it by writing the sequence number of the slot.
+ *          The consumer only reads a slot once it is published, entries are
+ *          read in the order their slots were reserved. A full ring drops
+ *          the new entry and counts it.
+ *
+ * \note    Does not use EXPECT() itself: it is the backend of EXPECT().
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "utility/DeferredLog/DeferredLog.h"
+#include <atomic>
+#include <cstdio>
+#include "stm32f4xx_hal.h"
+
+
+static_assert((DEFERRED_LOG_SIZE & (DEFERRED_LOG_SIZE - 1)) == 0, "DEFERRED_LOG_SIZE must be a power of 2");
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  Slot
+ * \brief   Entry in the ring, published when sequence is its index + 1.
+ */
+struct Slot
+{
+    std::atomic<uint32_t> sequence;
+    DeferredLogEntry      entry;
+};
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static Slot                  ring[DEFERRED_LOG_SIZE];
+static std::atomic<uint32_t> head    {0};       ///< Next slot to reserve
+static std::atomic<uint32_t> tail    {0};       ///< Next slot to read
+static std::atomic<uint32_t> dropped {0};
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+static inline void PutU32(uint8_t* buffer, uint32_t value)
+{
+    buffer[0] = static_cast<uint8_t>(value);
+    buffer[1] = static_cast<uint8_t>(value >> 8);
+    buffer[2] = static_cast<uint8_t>(value >> 16);
+    buffer[3] = static_cast<uint8_t>(value >> 24);
+}
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+/**
+ * \brief   Handler of DEFERRED_LOG(): record an entry.
+ * \param   site    The call site.
+ * \param   arg0    First argument.
+ * \param   arg1    Second argument.
+ */
+void _deferred_log(const DeferredLogSite* site, uint32_t arg0, uint32_t arg1)
+{
+    const uint32_t timestamp = DWT->CYCCNT;
+
+    // Reserve a slot, unless the consumer is a full ring behind
+    uint32_t index = head.load(std::memory_order_relaxed);
+    do
+    {
+        if ((index - tail.load(std::memory_order_acquire)) >= DEFERRED_LOG_SIZE)
+        {
+            dropped.fetch_add(1, std::memory_order_relaxed);
+            return;
+        }
+    } while (!head.compare_exchange_weak(index, index + 1, std::memory_order_relaxed));
+
+    Slot& slot = ring[index & (DEFERRED_LOG_SIZE - 1)];
+    slot.entry.site      = site;
+    slot.entry.timestamp = timestamp;
+    slot.entry.args[0]   = arg0;
+    slot.entry.args[1]   = arg1;
+    slot.sequence.store(index + 1, std::memory_order_release);
+}
+
+
+/************************************************************************/
+/* Public Methods                                                       */
+/************************************************************************/
+/**
+ * \brief   Empty the ring and clear the dropped count.
+ * \note    Not to be called while entries are recorded.
+ */
+void DeferredLog::Init()
+{
+    for (uint32_t i = 0; i < DEFERRED_LOG_SIZE; i++)
+    {
+        ring[i].sequence.store(0, std::memory_order_relaxed);
+    }
+    head.store(0, std::memory_order_relaxed);
+    tail.store(0, std::memory_order_relaxed);
+    dropped.store(0, std::memory_order_release);
+}
+
+/**
+ * \brief   Read the oldest entry.
+ * \param   entry   Receives the entry.
+ * \returns True if an entry is read, false if the ring is empty or the
+ *          oldest entry is still being recorded.
+ * \note    Single consumer: call from one task only.
+ */
+bool DeferredLog::Read(DeferredLogEntry& entry)
+{
+    const uint32_t index = tail.load(std::memory_order_relaxed);
+    Slot& slot = ring[index & (DEFERRED_LOG_SIZE - 1)];
+
+    if (slot.sequence.load(std::memory_order_acquire) != (index + 1)) { return false; }
+
+    entry = slot.entry;
+    tail.store(index + 1, std::memory_order_release);
+    return true;
+}
+
+/**
+ * \brief   Format an entry as text.
+ * \param   entry   The entry.
+ * \param   buffer  Buffer to write the text in, '\0' terminated.
+ * \param   size    Size of the buffer.
+ * \returns The length of the text, truncated to the buffer, 0 if no buffer.
+ */
+uint16_t DeferredLog::Format(const DeferredLogEntry& entry, char* buffer, uint16_t size)
+{
+    if ((buffer == nullptr) || (size == 0) || (entry.site == nullptr)) { return 0; }
+
+    const DeferredLogSite& site = *entry.site;
+    int length = 0;
+
+    if (site.kind == DEFERRED_LOG_EXPECT)
+    {
+        length = snprintf(buffer, size, "EXPECT: [%s], line: [%d], file: [%s]", site.text, static_cast<int>(site.line), site.file);
+    }
+    else
+    {
+        length = snprintf(buffer, size, site.text, static_cast<unsigned int>(entry.args[0]), static_cast<unsigned int>(entry.args[1]));
+        if ((length >= 0) && (length < size))
+        {
+            length += snprintf(&buffer[length], size - length, ", line: [%d], file: [%s]", static_cast<int>(site.line), site.file);
+        }
+    }
+
+    if (length < 0)     { buffer[0] = '\0'; return 0; }
+    if (length >= size) { return size - 1; }
+    return static_cast<uint16_t>(length);
+}
+
+/**
+ * \brief   Encode an entry for a host, which finds the text, file and line
+ *          at the site address in the ELF file.
+ * \details Layout, little endian: id ('L'), site address, timestamp, the
+ *          arguments, 4 bytes each.
+ * \param   entry   The entry.
+ * \param   buffer  Buffer to write the record in.
+ * \param   size    Size of the buffer, at least DEFERRED_LOG_RECORD_SIZE.
+ * \returns The length of the record, 0 if the buffer is too small.
+ */
+uint16_t DeferredLog::Encode(const DeferredLogEntry& entry, uint8_t* buffer, uint16_t size)
+{
+    if ((buffer == nullptr) || (size < DEFERRED_LOG_RECORD_SIZE)) { return 0; }
+
+    buffer[0] = DEFERRED_LOG_RECORD_ID;
+    PutU32(&buffer[1], static_cast<uint32_t>(reinterpret_cast<uintptr_t>(entry.site)));
+    PutU32(&buffer[5], entry.timestamp);
+    for (uint8_t i = 0; i < DEFERRED_LOG_MAX_ARGS; i++)
+    {
+        PutU32(&buffer[9 + (4 * i)], entry.args[i]);
+    }
+
+    return DEFERRED_LOG_RECORD_SIZE;
+}
+
+/**
+ * \brief   Get the number of entries recorded and not read yet.
+ * \returns The number of entries, including those still being recorded.
+ */
+uint32_t DeferredLog::GetPending()
+{
+    return head.load(std::memory_order_relaxed) - tail.load(std::memory_order_relaxed);
+}
+
+/**
+ * \brief   Get the number of entries dropped because the ring was full.
+ * \returns The number of dropped entries.
+ */
+uint32_t DeferredLog::GetDropped()
+{
+    return dropped.load(std::memory_order_relaxed);
+}
@@ -0,0 +1,300 @@
+/**
+ * \file    stack_monitor.c
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \brief   Stack high-water monitor for the FreeRTOS task stacks and the main
+ *          stack (MSP), scanned in slices from the idle hook.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/utility/StackPainting
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include "stack_monitor.h"
+#include "stack_painting.h"
+#include "utility/Assert/Assert.h"
+#include "stm32f4xx_hal.h"
+
+
+/************************************************************************/
+/* Externals                                                            */
+/************************************************************************/
+/**
+ * \brief   Top and bottom of the main stack, as used by stack_painting.c.
+ */
+extern uint32_t _estack;
+extern uint32_t _ebss;
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  stack_region_t
+ * \brief   Administration of a monitored stack.
+ */
+typedef struct
+{
+    const char*     name;
+    const uint32_t* bottom;     ///< Lowest word of the stack
+    const uint32_t* top;        ///< One past the highest word
+    const uint32_t* mark;       ///< Lowest word found used, top if none
+    const uint32_t* cursor;     ///< Next word to check in the current pass
+    uint32_t        fill;
+    bool            scanned;
+} stack_region_t;
+
+
+/************************************************************************/
+/* Static variables                                                     */
+/************************************************************************/
+static stack_region_t regions[STACK_MONITOR_MAX_ENTRIES] = {0};
+static uint8_t        region_count = 0;
+static uint8_t        current      = 0;
+static bool           idle_added   = false;
+
+
+/************************************************************************/
+/* Static functions                                                     */
+/************************************************************************/
+static inline uint32_t enter_critical(void)
+{
+    const uint32_t prim = __get_PRIMASK();
+    __disable_irq();
+    return prim;
+}
+
+static inline void exit_critical(uint32_t prim)
+{
+    if (!prim) { __enable_irq(); }
+}
+
+static inline void put_u16(uint8_t* buffer, uint16_t value)
+{
+    buffer[0] = (uint8_t)(value);
+    buffer[1] = (uint8_t)(value >> 8);
+}
+
+static inline uint16_t to_u16(uint32_t value)
+{
+    return (value > 0xFFFF) ? 0xFFFF : (uint16_t)value;
+}
+
+
+/************************************************************************/
+/* Public functions                                                     */
+/************************************************************************/
+/**
+ * \brief   Forget all monitored stacks, the idle task is added again at the
+ *          next call of stack_monitor_idle_hook().
+ */
+void stack_monitor_init(void)
+{
+    const uint32_t prim = enter_critical();
+    region_count = 0;
+    current      = 0;
+    idle_added   = false;
+    exit_critical(prim);
+}
+
+/**
+ * \brief   Monitor the stack of a FreeRTOS task.
+ * \param   task    The task, NULL for the calling task.
+ * \param   depth   Stack depth in words, as given at creation of the task.
+ * \returns True if the task is added, else false.
+ * \note    The task must not be deleted while it is monitored.
+ */
+bool stack_monitor_add_task(TaskHandle_t task, uint32_t depth)
+{
+    TaskStatus_t status;
+
+    // eRunning: skip finding out the state, not needed for the stack base
+    vTaskGetInfo(task, &status, pdFALSE, eRunning);
+
+    return stack_monitor_add_region(status.pcTaskName, (const uint32_t*)status.pxStackBase, depth, STACK_MONITOR_TASK_FILL);
+}
+
+/**
+ * \brief   Monitor the main stack (MSP): from the end of the bss section to
+ *          the top of the RAM, painted with paint_stack().
+ * \returns True if the main stack is added, else false.
+ * \note    With the scheduler running the main stack is used by interrupts.
+ */
+bool stack_monitor_add_main(void)
+{
+    const uint32_t words = (uint32_t)(&_estack - &_ebss);
+
+    return stack_monitor_add_region("MSP", &_ebss, words, STACK_PAINT_VALUE);
+}
+
+/**
+ * \brief   Monitor a painted region, growing down from the top.
+ * \param   name    Name of the region, for the usage.
+ * \param   bottom  Lowest word of the region.
+ * \param   words   Size of the region in words.
+ * \param   fill    Value the unused words are painted with.
+ * \returns True if the region is added, else false.
+ */
+bool stack_monitor_add_region(const char* name, const uint32_t* bottom, uint32_t words, uint32_t fill)
+{
+    EXPECT(bottom);
+    EXPECT(words > 0);
+    EXPECT(region_count < STACK_MONITOR_MAX_ENTRIES);
+
+    if (bottom == NULL)                               { return false; }
+    if (words == 0)                                   { return false; }
+    if (region_count >= STACK_MONITOR_MAX_ENTRIES)    { return false; }
+
+    stack_region_t region;
+    region.name    = name;
+    region.bottom  = bottom;
+    region.top     = bottom + words;
+    region.mark    = region.top;
+    region.cursor  = bottom;
+    region.fill    = fill;
+    region.scanned = false;
+
+    const uint32_t prim = enter_critical();
+    regions[region_count++] = region;
+    exit_critical(prim);
+
+    return true;
+}
+
+/**
+ * \brief   To be called from vApplicationIdleHook(): checks the next slice of
+ *          STACK_MONITOR_SLICE_WORDS words. The regions are scanned in turn.
+ * \note    The idle task adds itself at the first call, with a stack depth
+ *          of configMINIMAL_STACK_SIZE.
+ */
+void stack_monitor_idle_hook(void)
+{
+    if (!idle_added)
+    {
+        idle_added = true;
+        (void)stack_monitor_add_task(NULL, configMINIMAL_STACK_SIZE);
+    }
+
+    if (region_count == 0) { return; }
+
+    const uint32_t prim = enter_critical();
+
+    stack_region_t* region = &regions[current];
+    const uint32_t* end    = region->mark;
+    const uint32_t* word   = region->cursor;
+    bool            done   = false;
+
+    if ((end - word) > STACK_MONITOR_SLICE_WORDS) { end = word + STACK_MONITOR_SLICE_WORDS; }
+
+    // Search up from the bottom: painted until the first used word
+    for ( ; word < end; word++)
+    {
+        if (*word != region->fill) { break; }
+    }
+
+    if (word < end)
+    {
+        region->mark = word;
+        done = true;
+    }
+    else if (end == region->mark)
+    {
+        done = true;
+    }
+
+    if (done)
+    {
+        region->cursor  = region->bottom;
+        region->scanned = true;
+        current = (uint8_t)((current + 1) % region_count);
+    }
+    else
+    {
+        region->cursor = end;
+    }
+
+    exit_critical(prim);
+}
+
+/**
+ * \brief   Get the number of monitored stacks.
+ * \returns The number of monitored stacks.
+ */
+uint8_t stack_monitor_get_count(void)
+{
+    return region_count;
+}
+
+/**
+ * \brief   Get the usage of a monitored stack.
+ * \param   index   The stack, in order of adding.
+ * \param   usage   Receives the usage.
+ * \returns True if the stack exists, else false.
+ */
+bool stack_monitor_get_usage(uint8_t index, stack_usage_t* usage)
+{
+    EXPECT(usage);
+
+    if (usage == NULL)           { return false; }
+    if (index >= region_count)   { return false; }
+
+    const uint32_t prim = enter_critical();
+    const stack_region_t* region = &regions[index];
+
+    usage->name     = region->name;
+    usage->size     = (uint32_t)(region->top - region->bottom) * 4;
+    usage->used     = (uint32_t)(region->top - region->mark) * 4;
+    usage->headroom = usage->size - usage->used;
+    usage->scanned  = region->scanned;
+    exit_critical(prim);
+
+    return true;
+}
+
+/**
+ * \brief   Get the usage of all monitored stacks as compact binary report.
+ * \details Layout, little endian: id ('S'), number of entries, per entry:
+ *          index, flags (bit 0: scanned), size and headroom in words (16 bit
+ *          each, saturated).
+ * \param   buffer  Buffer to write the report in.
+ * \param   size    Size of the buffer, STACK_MONITOR_REPORT_SIZE(n) for n
+ *                  entries.
+ * \returns The length of the report, 0 if the buffer is too small.
+ */
+uint16_t stack_monitor_get_report(uint8_t* buffer, uint16_t size)
+{
+    EXPECT(buffer);
+
+    if (buffer == NULL) { return 0; }
+
+    const uint8_t count = region_count;
+    if (size < STACK_MONITOR_REPORT_SIZE(count)) { return 0; }
+
+    buffer[0] = STACK_MONITOR_REPORT_ID;
+    buffer[1] = count;
+
+    uint8_t* entry = &buffer[2];
+    for (uint8_t i = 0; i < count; i++)
+    {
+        stack_usage_t usage;
+        (void)stack_monitor_get_usage(i, &usage);
+
+        entry[0] = i;
+        entry[1] = usage.scanned ? 1 : 0;
+        put_u16(&entry[2], to_u16(usage.size / 4));
+        put_u16(&entry[4], to_u16(usage.headroom / 4));
+        entry += 6;
+    }
+
+    return STACK_MONITOR_REPORT_SIZE(count);
+}
@@ -0,0 +1,121 @@
+/**
+ * \file    stack_monitor.h
+ *
+ * \licence "THE BEER-WARE LICENSE" (Revision 42):
+ *          <terry.louwers@fourtress.nl> wrote this file. As long as you retain
+ *          this notice you can do whatever you want with this stuff. If we
+ *          meet some day, and you think this stuff is worth it, you can buy me
+ *          a beer in return.
+ *                                                                Terry Louwers
+ * \brief   Stack high-water monitor for the FreeRTOS task stacks and the main
+ *          stack (MSP), scanned in slices from the idle hook.
+ *
+ * \details Each monitored stack is a region of painted words: FreeRTOS fills
+ *          the task stacks with tskSTACK_FILL_BYTE at creation, paint_stack()
+ *          fills the main stack. Per region the lowest word ever used (the
+ *          high-water mark) is kept. A pass over a region checks the painted
+ *          words from the bottom of the stack up to the current high-water
+ *          mark, STACK_MONITOR_SLICE_WORDS words per call of
+ *          stack_monitor_idle_hook(): the time interrupts are disabled is
+ *          bounded by the slice, not by the stack size. Used words only move
+ *          the mark down, a pass stops at the first used word found.
+ *
+ * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/utility/StackPainting
+ *
+ * \author  T. Louwers <terry.louwers@fourtress.nl>
+ * \version 1.0
+ * \date    10-2026
+ */
+
+#ifndef STACK_MONITOR_H_
+#define STACK_MONITOR_H_
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+
+/************************************************************************/
+/* Includes                                                             */
+/************************************************************************/
+#include <stdbool.h>
+#include <stdint.h>
+#include "FreeRTOS.h"
+#include "task.h"
+
+
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     STACK_MONITOR_MAX_ENTRIES
+ * \brief   Maximum number of stacks monitored: tasks, idle task and MSP.
+ */
+#define STACK_MONITOR_MAX_ENTRIES       8
+
+/**
+ * \def     STACK_MONITOR_SLICE_WORDS
+ * \brief   Words checked per call of stack_monitor_idle_hook(), with
+ *          interrupts disabled.
+ */
+#define STACK_MONITOR_SLICE_WORDS       64
+
+/**
+ * \def     STACK_MONITOR_TASK_FILL
+ * \brief   Paint of the task stacks: tskSTACK_FILL_BYTE of tasks.c (filled
+ *          with configCHECK_FOR_STACK_OVERFLOW > 1 or configUSE_TRACE_FACILITY).
+ */
+#define STACK_MONITOR_TASK_FILL         0xA5A5A5A5
+
+/**
+ * \def     STACK_MONITOR_REPORT_ID
+ * \brief   First byte of the report, identifies it in a telemetry stream.
+ */
+#define STACK_MONITOR_REPORT_ID         'S'
+
+/**
+ * \def     STACK_MONITOR_REPORT_SIZE
+ * \brief   Size in bytes of a report with n entries.
+ */
+#define STACK_MONITOR_REPORT_SIZE(n)    (2 + ((n) * 6))
+
+
+/************************************************************************/
+/* Structures                                                           */
+/************************************************************************/
+/**
+ * \struct  stack_usage_t
+ * \brief   Usage of a monitored stack, in bytes.
+ */
+typedef struct
+{
+    const char* name;       ///< Name of the task, "MSP" for the main stack
+    uint32_t    size;       ///< Size of the stack
+    uint32_t    used;       ///< Most ever used (high-water mark)
+    uint32_t    headroom;   ///< Never used: size - used
+    bool        scanned;    ///< At least one pass completed, before that used is not valid
+} stack_usage_t;
+
+
+/************************************************************************/
+/* Functions                                                            */
+/************************************************************************/
+void stack_monitor_init(void);
+
+bool stack_monitor_add_task(TaskHandle_t task, uint32_t depth);
+bool stack_monitor_add_main(void);
+bool stack_monitor_add_region(const char* name, const uint32_t* bottom, uint32_t words, uint32_t fill);
+
+void stack_monitor_idle_hook(void);
+
+uint8_t  stack_monitor_get_count(void);
+bool     stack_monitor_get_usage(uint8_t index, stack_usage_t* usage);
+uint16_t stack_monitor_get_report(uint8_t* buffer, uint16_t size);
+
+
+#ifdef __cplusplus
+}
+#endif
+
+
+#endif  // STACK_MONITOR_H_
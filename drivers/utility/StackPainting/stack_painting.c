@@ -12,8 +12,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/utility/StackPainting
  *
  * \author  Terry Louwers (terry.louwers@fourtress.nl)
- * \version 1.0
- * \date    11-2019
+ * \version 1.1
+ * \date    10-2026
  */
 
 /************************************************************************/
@@ -47,7 +47,7 @@ extern uint32_t _ebss;
  *          possible a stack value is the same as the number, it is
  *          very unlikely and not repeated for long.
  */
-const uint32_t PAINT_VALUE = 0xC5C5C5C5;
+const uint32_t PAINT_VALUE = STACK_PAINT_VALUE;
 
 
 /************************************************************************/
@@ -12,8 +12,8 @@
  * \note    https://github.com/tlouwers/STM32F4-DISCOVERY/tree/develop/utility/StackPainting
  *
  * \author  Terry Louwers (terry.louwers@fourtress.nl)
- * \version 1.0
- * \date    11-2019
+ * \version 1.1
+ * \date    10-2026
  */
 
 #ifndef STACK_PAINTING_H_
@@ -30,6 +30,16 @@ extern "C" {
 #include <stdint.h>
 
 
+/************************************************************************/
+/* Defines                                                              */
+/************************************************************************/
+/**
+ * \def     STACK_PAINT_VALUE
+ * \brief   Value the main stack is painted with by paint_stack().
+ */
+#define STACK_PAINT_VALUE   0xC5C5C5C5
+
+
 /************************************************************************/
 /* Functions                                                            */
 /************************************************************************/
@@ -0,0 +1,60 @@
+#ifndef INC_FREERTOS_H
+#define INC_FREERTOS_H
+
+// Fake: just enough of FreeRTOS to build heap_4.c on the host, for the
+// allocator benchmark, and the task types used by the utilities. No
+// scheduler: suspending it does nothing.
+#include <stddef.h>
+#include <stdint.h>
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#define configSUPPORT_DYNAMIC_ALLOCATION    1
+#define configAPPLICATION_ALLOCATED_HEAP    0
+#define configUSE_MALLOC_FAILED_HOOK        0
+#define configTOTAL_HEAP_SIZE               ( ( size_t ) ( 64 * 1024 ) )
+#define configMINIMAL_STACK_SIZE            128
+#define configASSERT( x )
+
+#define portBYTE_ALIGNMENT                  8
+#define portBYTE_ALIGNMENT_MASK             ( 0x0007 )
+#define portMAX_DELAY                       ( ( size_t ) -1 )
+
+#define pdFALSE                             ( ( BaseType_t ) 0 )
+#define pdTRUE                              ( ( BaseType_t ) 1 )
+
+#define PRIVILEGED_DATA
+#define PRIVILEGED_FUNCTION
+#define mtCOVERAGE_TEST_MARKER()
+#define traceMALLOC( pvAddress, uiSize )
+#define traceFREE( pvAddress, uiSize )
+
+typedef long          BaseType_t;
+typedef unsigned long UBaseType_t;
+typedef uint32_t      StackType_t;
+
+typedef struct xHeapStats
+{
+    size_t xAvailableHeapSpaceInBytes;
+    size_t xSizeOfLargestFreeBlockInBytes;
+    size_t xSizeOfSmallestFreeBlockInBytes;
+    size_t xNumberOfFreeBlocks;
+    size_t xMinimumEverFreeBytesRemaining;
+    size_t xNumberOfSuccessfulAllocations;
+    size_t xNumberOfSuccessfulFrees;
+} HeapStats_t;
+
+void*  pvPortMalloc( size_t xSize );
+void   vPortFree( void * pv );
+size_t xPortGetFreeHeapSize( void );
+size_t xPortGetMinimumEverFreeHeapSize( void );
+void   vPortInitialiseBlocks( void );
+void   vPortGetHeapStats( HeapStats_t * pxHeapStats );
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // INC_FREERTOS_H
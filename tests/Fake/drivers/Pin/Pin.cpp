@@ -1,13 +1,38 @@
 #include "Pin.hpp"
 
 
-Pin::Pin(PinIdPort idAndPort)
+// Interrupt callbacks per pin number (like the EXTI lines), see 'FakePin_TriggerInterrupt()'.
+static PinInterrupt fakePinInterrupts[16] = {};
+
+static uint8_t GetLine(uint16_t id)
+{
+    uint8_t line = 0;
+    while ((line < 15) && ((id & (1U << line)) == 0)) { line++; }
+    return line;
+}
+
+// Simulates an interrupt on the given pin, calls the callback if enabled.
+void FakePin_TriggerInterrupt(PinIdPort idAndPort)
+{
+    const PinInterrupt& pinInterrupt = fakePinInterrupts[GetLine(idAndPort.id)];
+    if (pinInterrupt.enabled && pinInterrupt.callback)
+    {
+        pinInterrupt.callback();
+    }
+}
+
+
+Pin::Pin(PinIdPort idAndPort) :
+    mId(idAndPort.id), mPort(idAndPort.port)
 {}
-Pin::Pin(PinIdPort idAndPort, Level level, Drive drive)
+Pin::Pin(PinIdPort idAndPort, Level level, Drive drive) :
+    mId(idAndPort.id), mPort(idAndPort.port)
 {}
-Pin::Pin(PinIdPort idAndPort, PullUpDown pullUpDown)
+Pin::Pin(PinIdPort idAndPort, PullUpDown pullUpDown) :
+    mId(idAndPort.id), mPort(idAndPort.port)
 {}
-Pin::Pin(PinIdPort idAndPort, Alternate alternate, PullUpDown pullUpDown, Mode mode)
+Pin::Pin(PinIdPort idAndPort, Alternate alternate, PullUpDown pullUpDown, Mode mode) :
+    mId(idAndPort.id), mPort(idAndPort.port)
 {}
 
 void Pin::Configure(Level level, Drive drive)
@@ -17,30 +42,38 @@ void Pin::Configure(PullUpDown pullUpDown)
 void Pin::Configure(Alternate alternate, PullUpDown pullUpDown, Mode mode)
 {}
 
-bool Pin::Interrupt(Trigger trigger, const std::function<void()>& callback, bool enabledAfterConfigure)
+bool Pin::Interrupt(Trigger trigger, const Delegate<void()>& callback, bool enabledAfterConfigure)
 {
+    fakePinInterrupts[GetLine(mId)].callback = callback;
+    fakePinInterrupts[GetLine(mId)].enabled  = enabledAfterConfigure;
     return true;
 }
 
 bool Pin::InterruptEnable()
 {
+    fakePinInterrupts[GetLine(mId)].enabled = true;
     return true;
 }
 
 bool Pin::InterruptDisable()
 {
+    fakePinInterrupts[GetLine(mId)].enabled = false;
     return true;
 }
 
 bool Pin::InterruptRemove()
 {
+    fakePinInterrupts[GetLine(mId)] = {};
     return true;
 }
 
 void Pin::Toggle() const
 {}
 void Pin::Set(Level level)
-{}
+{
+    // Recorded by the fake HAL, allows checking the ChipSelect sequence.
+    HAL_GPIO_WritePin(mPort, mId, (level == Level::HIGH) ? GPIO_PIN_SET : GPIO_PIN_RESET);
+}
 
 Level Pin::Get() const
 {
@@ -6,7 +6,7 @@
 /* Includes                                                             */
 /************************************************************************/
 #include <cstdint>
-#include <functional>
+#include "utility/Delegate/Delegate.hpp"
 #include "stm32f4xx_hal.h"
 
 
@@ -28,8 +28,8 @@ struct PinIdPort
  */
 struct PinInterrupt
 {
-    std::function<void()> callback = nullptr;   ///< Callback to call when interrupt for pin triggers.
-    bool                  enabled  = false;     ///< Flag, indicating interrupt for pin is enabled or not.
+    Delegate<void()> callback = nullptr;   ///< Callback to call when interrupt for pin triggers.
+    bool             enabled  = false;     ///< Flag, indicating interrupt for pin is enabled or not.
 };
 
 
@@ -149,7 +149,7 @@ public:
     void Configure(PullUpDown pullUpDown);
     void Configure(Alternate alternate, PullUpDown pullUpDown = PullUpDown::HIGHZ, Mode mode = Mode::PUSH_PULL);
 
-    bool Interrupt(Trigger trigger, const std::function<void()>& callback, bool enabledAfterConfigure = true);
+    bool Interrupt(Trigger trigger, const Delegate<void()>& callback, bool enabledAfterConfigure = true);
     bool InterruptEnable();
     bool InterruptDisable();
     bool InterruptRemove();
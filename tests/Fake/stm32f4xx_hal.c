@@ -1,10 +1,664 @@
 
 #include "stm32f4xx_hal.h"
+#include <string.h>
 
 // Fake implementation done in 'C' file, to prevent multiple definitions.
 
 
+// Recorded HAL calls, see 'FakeHal_GetEvent()'.
+#define FAKE_HAL_MAX_EVENTS     256
+
+static FakeHalEvent       events[FAKE_HAL_MAX_EVENTS];
+static uint32_t           eventCount = 0;
+
+// Data returned by SPI reads and the (single) pending SPI DMA transfer.
+static uint8_t            spiRxData[256];
+static uint16_t           spiRxLength = 0;
+static SPI_HandleTypeDef* spiPendingHandle = NULL;
+static FakeHalCall        spiPendingCall;
+static uint8_t*           spiPendingDest = NULL;
+static uint16_t           spiPendingLength = 0;
+static uint8_t            spiFailStarts = 0;
+
+// Register memory of USART1, USART2, USART3 and USART6.
+USART_TypeDef             FakeHal_UsartRegisters[4];
+
+// Register memory of ADC1, ADC2, ADC3 and their common registers, and the buffer of the (single) ADC DMA stream.
+ADC_TypeDef               FakeHal_AdcRegisters[3];
+ADC_Common_TypeDef        FakeHal_AdcCommonRegisters;
+static uint16_t*          adcDmaBuffer = NULL;
+static uint16_t           adcDmaLength = 0;
+
+// Register memory of the DAC, and the buffers of the DMA streams of channel 1 and 2.
+DAC_TypeDef               FakeHal_DacRegisters;
+static uint16_t*          dacDmaBuffer[2] = { NULL, NULL };
+static uint16_t           dacDmaLength[2] = { 0, 0 };
+
+// Register memory of TIM1 up to TIM14.
+TIM_TypeDef               FakeHal_TimRegisters[14];
+
+// Register memory of the DWT cycle counter and CoreDebug.
+DWT_Type                  FakeHal_DwtRegisters;
+CoreDebug_Type            FakeHal_CoreDebugRegisters;
+
+// Register memory of SysTick, the DMA streams, the RTC and the RCC.
+SysTick_Type              FakeHal_SysTickRegisters;
+DMA_Stream_TypeDef        FakeHal_DmaStreamRegisters[16];
+RTC_TypeDef               FakeHal_RtcRegisters;
+RCC_TypeDef               FakeHal_RccRegisters;
+
+uint32_t                  SystemCoreClock = 16000000UL;
+
+// Called when the CPU would sleep, see 'FakeHal_SetSleepHook()'.
+static void (*sleepHook)(FakeHalCall call) = NULL;
+
+
+static void Record(FakeHalCall call, uint32_t value, uint16_t length)
+{
+    if (eventCount < FAKE_HAL_MAX_EVENTS)
+    {
+        events[eventCount].call   = call;
+        events[eventCount].value  = value;
+        events[eventCount].length = length;
+    }
+    eventCount++;
+}
+
+static void FillRxData(uint8_t* dest, uint16_t length)
+{
+    if (dest == NULL) { return; }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        dest[i] = (i < spiRxLength) ? spiRxData[i] : 0;
+    }
+}
+
+static HAL_StatusTypeDef StartSpiDma(FakeHalCall call, SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size)
+{
+    if ((pTxData == NULL) && (pRxData == NULL)) { return HAL_ERROR; }
+    if (Size == 0)                              { return HAL_ERROR; }
+    if (spiPendingHandle != NULL)               { return HAL_BUSY;  }
+    if (spiFailStarts > 0)                      { spiFailStarts--; return HAL_ERROR; }
+
+    Record(call, (pTxData != NULL) ? pTxData[0] : 0, Size);
+
+    spiPendingHandle = hspi;
+    spiPendingCall   = call;
+    spiPendingDest   = pRxData;
+    spiPendingLength = Size;
+    return HAL_OK;
+}
+
+
 // __NOP() formally part of CMSIS, only available for ARM.
 void __NOP(void) { ; }
 
+// Sleep, formally part of CMSIS: the sleep hook stands in for the time passing.
+void __WFI(void)
+{
+    Record(FAKE_HAL_WFI, 0, 0);
+    if (sleepHook != NULL) { sleepHook(FAKE_HAL_WFI); }
+}
+
+void __DSB(void) { ; }
+void __ISB(void) { ; }
+
+// Interrupt masking, formally part of CMSIS: only the PRIMASK state is kept.
+static uint32_t primask = 0;
+
+uint32_t __get_PRIMASK(void) { return primask; }
+void __disable_irq(void)     { primask = 1; }
+void __enable_irq(void)      { primask = 0; }
+
 void HAL_Delay(uint32_t Delay) { ; }
+
+void HAL_SuspendTick(void) { Record(FAKE_HAL_SUSPEND_TICK, 0, 0); }
+void HAL_ResumeTick(void)  { Record(FAKE_HAL_RESUME_TICK, 0, 0);  }
+
+// Peripheral clocks, see 'FakeHal_SetPclkFreq()'. The AHB runs at 168 MHz.
+static uint32_t pclk1Freq = 42000000UL;
+static uint32_t pclk2Freq = 84000000UL;
+
+uint32_t HAL_RCC_GetHCLKFreq(void)  { return 168000000UL; }
+uint32_t HAL_RCC_GetPCLK1Freq(void) { return pclk1Freq; }
+uint32_t HAL_RCC_GetPCLK2Freq(void) { return pclk2Freq; }
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority) { ; }
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn) { ; }
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn) { ; }
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn) { ; }
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState)
+{
+    Record(FAKE_HAL_GPIO_WRITE_PIN, PinState, GPIO_Pin);
+}
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi)   { return HAL_OK; }
+HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef* hspi) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi)
+{
+    if (spiPendingHandle == hspi) { spiPendingHandle = NULL; }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    if (spiPendingHandle != NULL) { return HAL_BUSY; }
+    Record(FAKE_HAL_SPI_TRANSMIT, pData[0], Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout)
+{
+    if (spiPendingHandle != NULL) { return HAL_BUSY; }
+    Record(FAKE_HAL_SPI_RECEIVE, 0, Size);
+    FillRxData(pData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t Timeout)
+{
+    if (spiPendingHandle != NULL) { return HAL_BUSY; }
+    Record(FAKE_HAL_SPI_TRANSMIT_RECEIVE, pTxData[0], Size);
+    FillRxData(pRxData, Size);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)                            { return HAL_OK; }
+HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)                             { return HAL_OK; }
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_IT(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)
+{
+    return StartSpiDma(FAKE_HAL_SPI_TRANSMIT_DMA, hspi, pData, NULL, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size)
+{
+    return StartSpiDma(FAKE_HAL_SPI_RECEIVE_DMA, hspi, NULL, pData, Size);
+}
+
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size)
+{
+    return StartSpiDma(FAKE_HAL_SPI_TRANSMIT_RECEIVE_DMA, hspi, pTxData, pRxData, Size);
+}
+
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef* hspi) { ; }
+
+// Weak callbacks, as in the real HAL: overruled by the SPI driver (if linked).
+__attribute__((weak)) void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi)   { ; }
+__attribute__((weak)) void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* hspi)   { ; }
+__attribute__((weak)) void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi) { ; }
+__attribute__((weak)) void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi)    { ; }
+
+HAL_DMA_StateTypeDef HAL_DMA_GetState(DMA_HandleTypeDef* hdma) { return hdma->State; }
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart)   { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef* huart) { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef* huart)  { return HAL_UART_AbortReceive(huart); }
+
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart)
+{
+    Record(FAKE_HAL_UART_ABORT_RECEIVE, 0, 0);
+    huart->RxXferSize  = 0;
+    huart->RxXferCount = 0;
+    if (huart->hdmarx != NULL)
+    {
+        huart->hdmarx->Instance->NDTR = 0;
+        huart->hdmarx->State = HAL_DMA_STATE_READY;
+    }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef* huart) { return HAL_UART_AbortReceive(huart); }
+
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout) { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout)  { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)                { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)                 { return HAL_OK; }
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)               { return HAL_OK; }
+
+// Starts the DMA stream: NDTR counts down from Size, see 'FakeHal_UartDmaReceive()'.
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size)
+{
+    if ((pData == NULL) || (Size == 0)) { return HAL_ERROR; }
+
+    Record(FAKE_HAL_UART_RECEIVE_DMA, 0, Size);
+
+    huart->pRxBuffPtr  = pData;
+    huart->RxXferSize  = Size;
+    huart->RxXferCount = 0;
+    huart->hdmarx->Instance->NDTR = Size;
+    huart->hdmarx->State = HAL_DMA_STATE_BUSY;
+    return HAL_OK;
+}
+
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart) { ; }
+
+// Weak callbacks, as in the real HAL: overruled by the Usart driver (if linked).
+__attribute__((weak)) void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart)     { ; }
+__attribute__((weak)) void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart)     { ; }
+__attribute__((weak)) void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart) { ; }
+__attribute__((weak)) void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart)      { ; }
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc)   { return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef* hadc) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig)
+{
+    Record(FAKE_HAL_ADC_CONFIG_CHANNEL, sConfig->Channel, (uint16_t)sConfig->Rank);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc)
+{
+    Record(FAKE_HAL_ADC_START, (uint32_t)(hadc->Instance - ADC1) + 1, 0);
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc)                              { return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef* hadc, uint32_t Timeout) { return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_Start_IT(ADC_HandleTypeDef* hadc)                          { return HAL_OK; }
+HAL_StatusTypeDef HAL_ADC_Stop_IT(ADC_HandleTypeDef* hadc)                           { return HAL_OK; }
+
+// Starts the DMA stream: NDTR counts down from Length, see 'FakeHal_AdcDmaConvert()'.
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length)
+{
+    if ((pData == NULL) || (Length == 0) || (hadc->DMA_Handle == NULL)) { return HAL_ERROR; }
+
+    Record(FAKE_HAL_ADC_START_DMA, 0, (uint16_t)Length);
+
+    adcDmaBuffer    = (uint16_t*)pData;
+    adcDmaLength    = (uint16_t)Length;
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+    hadc->DMA_Handle->Instance->NDTR = Length;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc)
+{
+    Record(FAKE_HAL_ADC_STOP_DMA, 0, 0);
+    adcDmaBuffer = NULL;
+    if (hadc->DMA_Handle != NULL) { hadc->DMA_Handle->Instance->NDTR = 0; }
+    return HAL_OK;
+}
+
+// The multi mode, DMA access mode and delay are kept in the common control register.
+HAL_StatusTypeDef HAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef* hadc, ADC_MultiModeTypeDef* multimode)
+{
+    ADC123_COMMON->CCR = multimode->Mode | multimode->DMAAccessMode | multimode->TwoSamplingDelay;
+    return HAL_OK;
+}
+
+// Starts the DMA stream of the master: Length words of two samples each. The
+// fake counts NDTR in samples, as 'HAL_ADC_Start_DMA()'.
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length)
+{
+    if ((pData == NULL) || (Length == 0) || (hadc->DMA_Handle == NULL)) { return HAL_ERROR; }
+
+    Record(FAKE_HAL_ADC_MULTIMODE_START_DMA, 0, (uint16_t)Length);
+
+    adcDmaBuffer    = (uint16_t*)pData;
+    adcDmaLength    = (uint16_t)(2 * Length);
+    hadc->ErrorCode = HAL_ADC_ERROR_NONE;
+    hadc->DMA_Handle->Instance->NDTR = 2 * Length;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc)
+{
+    Record(FAKE_HAL_ADC_MULTIMODE_STOP_DMA, 0, 0);
+    adcDmaBuffer = NULL;
+    if (hadc->DMA_Handle != NULL) { hadc->DMA_Handle->Instance->NDTR = 0; }
+    return HAL_OK;
+}
+
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc) { return hadc->Instance->DR; }
+uint32_t HAL_ADC_GetError(ADC_HandleTypeDef* hadc) { return hadc->ErrorCode; }
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc)   { ; }
+
+// Weak callbacks, as in the real HAL: overruled by the ADC driver (if linked).
+__attribute__((weak)) void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc)     { ; }
+__attribute__((weak)) void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc) { ; }
+__attribute__((weak)) void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc)        { ; }
+
+// Index of the DAC channel for the administration: 0 or 1.
+static uint32_t DacIndex(uint32_t Channel)
+{
+    return (Channel == DAC_CHANNEL_1) ? 0 : 1;
+}
+
+HAL_StatusTypeDef HAL_DAC_Init(DAC_HandleTypeDef* hdac)   { return HAL_OK; }
+HAL_StatusTypeDef HAL_DAC_DeInit(DAC_HandleTypeDef* hdac) { return HAL_OK; }
+HAL_StatusTypeDef HAL_DAC_ConfigChannel(DAC_HandleTypeDef* hdac, DAC_ChannelConfTypeDef* sConfig, uint32_t Channel) { return HAL_OK; }
+HAL_StatusTypeDef HAL_DAC_Start(DAC_HandleTypeDef* hdac, uint32_t Channel) { return HAL_OK; }
+HAL_StatusTypeDef HAL_DAC_Stop(DAC_HandleTypeDef* hdac, uint32_t Channel)  { return HAL_OK; }
+
+// Starts the DMA stream of the channel: NDTR counts down from Length, see 'FakeHal_DacDmaOutput()'.
+HAL_StatusTypeDef HAL_DAC_Start_DMA(DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t* pData, uint32_t Length, uint32_t Alignment)
+{
+    DMA_HandleTypeDef* hdma = (Channel == DAC_CHANNEL_1) ? hdac->DMA_Handle1 : hdac->DMA_Handle2;
+    if ((pData == NULL) || (Length == 0) || (hdma == NULL)) { return HAL_ERROR; }
+
+    Record(FAKE_HAL_DAC_START_DMA, Channel, (uint16_t)Length);
+
+    dacDmaBuffer[DacIndex(Channel)] = (uint16_t*)pData;
+    dacDmaLength[DacIndex(Channel)] = (uint16_t)Length;
+    hdma->Instance->NDTR = Length;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DAC_Stop_DMA(DAC_HandleTypeDef* hdac, uint32_t Channel)
+{
+    DMA_HandleTypeDef* hdma = (Channel == DAC_CHANNEL_1) ? hdac->DMA_Handle1 : hdac->DMA_Handle2;
+
+    Record(FAKE_HAL_DAC_STOP_DMA, Channel, 0);
+    dacDmaBuffer[DacIndex(Channel)] = NULL;
+    if (hdma != NULL) { hdma->Instance->NDTR = 0; }
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_DAC_SetValue(DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t Alignment, uint32_t Data)
+{
+    if (Channel == DAC_CHANNEL_1) { hdac->Instance->DHR12R1 = Data; }
+    else                          { hdac->Instance->DHR12R2 = Data; }
+    return HAL_OK;
+}
+
+// Weak callbacks, as in the real HAL: overruled by the DAC driver (if linked).
+__attribute__((weak)) void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef* hdac)       { ; }
+__attribute__((weak)) void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef* hdac)   { ; }
+__attribute__((weak)) void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef* hdac)     { ; }
+__attribute__((weak)) void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef* hdac) { ; }
+
+// The timer number of a fake timer, as recorded.
+static uint32_t TimNumber(const TIM_HandleTypeDef* htim)
+{
+    return (uint32_t)(htim->Instance - FakeHal_TimRegisters) + 1;
+}
+
+// Writes the prescaler and period into the registers, as the real HAL.
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim)
+{
+    htim->Instance->PSC = htim->Init.Prescaler;
+    htim->Instance->ARR = htim->Init.Period;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_DeInit(TIM_HandleTypeDef* htim) { return HAL_OK; }
+
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim)
+{
+    Record(FAKE_HAL_TIM_START, TimNumber(htim), 0);
+    htim->Instance->CR1 |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim)
+{
+    Record(FAKE_HAL_TIM_START_IT, TimNumber(htim), 0);
+    htim->Instance->DIER |= TIM_DIER_UIE;
+    htim->Instance->CR1  |= TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim)
+{
+    Record(FAKE_HAL_TIM_STOP, TimNumber(htim), 0);
+    htim->Instance->CR1 &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim)
+{
+    Record(FAKE_HAL_TIM_STOP, TimNumber(htim), 0);
+    htim->Instance->DIER &= ~TIM_DIER_UIE;
+    htim->Instance->CR1  &= ~TIM_CR1_CEN;
+    return HAL_OK;
+}
+
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* sMasterConfig)
+{
+    htim->Instance->CR2 = (htim->Instance->CR2 & ~TIM_CR2_MMS) | sMasterConfig->MasterOutputTrigger;
+    return HAL_OK;
+}
+
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef* htim) { ; }
+
+// Weak callback, as in the real HAL: overruled by the GenericTimer driver (if linked).
+__attribute__((weak)) void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim) { ; }
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef* hrtc)
+{
+    hrtc->Instance->PRER = (hrtc->Init.AsynchPrediv << 16) | hrtc->Init.SynchPrediv;
+    return HAL_OK;
+}
+
+void HAL_RTCEx_WakeUpTimerIRQHandler(RTC_HandleTypeDef* hrtc) { ; }
+
+void HAL_PWR_EnableBkUpAccess(void) { ; }
+
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry)
+{
+    Record(FAKE_HAL_PWR_ENTER_STOP, Regulator, 0);
+    if (sleepHook != NULL) { sleepHook(FAKE_HAL_PWR_ENTER_STOP); }
+}
+
+
+void FakeHal_Reset(void)
+{
+    primask          = 0;
+    eventCount       = 0;
+    spiRxLength      = 0;
+    spiPendingHandle = NULL;
+    spiPendingDest   = NULL;
+    spiPendingLength = 0;
+    spiFailStarts    = 0;
+    memset(FakeHal_UsartRegisters, 0, sizeof(FakeHal_UsartRegisters));
+    memset(FakeHal_AdcRegisters, 0, sizeof(FakeHal_AdcRegisters));
+    memset(&FakeHal_AdcCommonRegisters, 0, sizeof(FakeHal_AdcCommonRegisters));
+    adcDmaBuffer     = NULL;
+    adcDmaLength     = 0;
+    memset(&FakeHal_DacRegisters, 0, sizeof(FakeHal_DacRegisters));
+    dacDmaBuffer[0]  = NULL;
+    dacDmaBuffer[1]  = NULL;
+    dacDmaLength[0]  = 0;
+    dacDmaLength[1]  = 0;
+    memset(FakeHal_TimRegisters, 0, sizeof(FakeHal_TimRegisters));
+    memset(&FakeHal_DwtRegisters, 0, sizeof(FakeHal_DwtRegisters));
+    memset(&FakeHal_CoreDebugRegisters, 0, sizeof(FakeHal_CoreDebugRegisters));
+    memset(&FakeHal_SysTickRegisters, 0, sizeof(FakeHal_SysTickRegisters));
+    memset(FakeHal_DmaStreamRegisters, 0, sizeof(FakeHal_DmaStreamRegisters));
+    memset(&FakeHal_RtcRegisters, 0, sizeof(FakeHal_RtcRegisters));
+    memset(&FakeHal_RccRegisters, 0, sizeof(FakeHal_RccRegisters));
+    SystemCoreClock  = 16000000UL;
+    sleepHook        = NULL;
+    pclk1Freq        = 42000000UL;
+    pclk2Freq        = 84000000UL;
+}
+
+uint32_t FakeHal_GetEventCount(void)
+{
+    return eventCount;
+}
+
+FakeHalEvent FakeHal_GetEvent(uint32_t index)
+{
+    FakeHalEvent empty = { FAKE_HAL_GPIO_WRITE_PIN, 0, 0 };
+    return (index < eventCount && index < FAKE_HAL_MAX_EVENTS) ? events[index] : empty;
+}
+
+void FakeHal_SetSpiRxData(const uint8_t* data, uint16_t length)
+{
+    spiRxLength = (length > sizeof(spiRxData)) ? sizeof(spiRxData) : length;
+    memcpy(spiRxData, data, spiRxLength);
+}
+
+// Simulates the DMA transfer complete interrupt of the pending SPI DMA transfer.
+void FakeHal_CompleteSpiDma(void)
+{
+    SPI_HandleTypeDef* handle = spiPendingHandle;
+    if (handle == NULL) { return; }
+
+    FillRxData(spiPendingDest, spiPendingLength);
+    spiPendingHandle = NULL;
+
+    switch (spiPendingCall)
+    {
+        case FAKE_HAL_SPI_TRANSMIT_DMA:         HAL_SPI_TxCpltCallback(handle);   break;
+        case FAKE_HAL_SPI_RECEIVE_DMA:          HAL_SPI_RxCpltCallback(handle);   break;
+        case FAKE_HAL_SPI_TRANSMIT_RECEIVE_DMA: HAL_SPI_TxRxCpltCallback(handle); break;
+        default: break;
+    }
+}
+
+// Simulates a DMA (or SPI) error of the pending SPI DMA transfer: the HAL stops
+// the transfer and calls the error callback.
+void FakeHal_ErrorSpiDma(void)
+{
+    SPI_HandleTypeDef* handle = spiPendingHandle;
+    if (handle == NULL) { return; }
+
+    spiPendingHandle = NULL;
+    HAL_SPI_ErrorCallback(handle);
+}
+
+// The next 'count' SPI DMA transfers fail to start (HAL_ERROR).
+void FakeHal_FailSpiDmaStarts(uint8_t count)
+{
+    spiFailStarts = count;
+}
+
+// Simulates the Rx DMA stream of the UART receiving bytes: the data is stored at
+// the position NDTR points to, NDTR counts down. The half transfer and transfer
+// complete interrupts are called when reached, a circular stream reloads NDTR.
+void FakeHal_UartDmaReceive(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t length)
+{
+    DMA_HandleTypeDef* hdma = huart->hdmarx;
+    if ((hdma == NULL) || (huart->pRxBuffPtr == NULL)) { return; }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        if (hdma->Instance->NDTR == 0) { return; }      // Normal mode: stream stopped
+
+        const uint16_t position = huart->RxXferSize - hdma->Instance->NDTR;
+        huart->pRxBuffPtr[position] = data[i];
+        hdma->Instance->NDTR--;
+
+        if ((position + 1) == (huart->RxXferSize / 2))
+        {
+            HAL_UART_RxHalfCpltCallback(huart);
+        }
+        if (hdma->Instance->NDTR == 0)
+        {
+            if (hdma->Init.Mode == DMA_CIRCULAR) { hdma->Instance->NDTR = huart->RxXferSize; }
+            HAL_UART_RxCpltCallback(huart);
+        }
+    }
+}
+
+// Simulates the DMA stream of the ADC transferring conversions: as the UART,
+// the half transfer and transfer complete callbacks are called when reached.
+void FakeHal_AdcDmaConvert(ADC_HandleTypeDef* hadc, const uint16_t* data, uint16_t length)
+{
+    DMA_HandleTypeDef* hdma = hadc->DMA_Handle;
+    if ((hdma == NULL) || (adcDmaBuffer == NULL)) { return; }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        if (hdma->Instance->NDTR == 0) { return; }      // Normal mode: stream stopped
+
+        const uint16_t position = adcDmaLength - hdma->Instance->NDTR;
+        adcDmaBuffer[position] = data[i];
+        hdma->Instance->NDTR--;
+
+        if ((position + 1) == (adcDmaLength / 2))
+        {
+            HAL_ADC_ConvHalfCpltCallback(hadc);
+        }
+        if (hdma->Instance->NDTR == 0)
+        {
+            if (hdma->Init.Mode == DMA_CIRCULAR) { hdma->Instance->NDTR = adcDmaLength; }
+            HAL_ADC_ConvCpltCallback(hadc);
+        }
+    }
+}
+
+// Simulates a conversion not read in time: the DMA requests stop, the error callback is called.
+void FakeHal_AdcOverrun(ADC_HandleTypeDef* hadc)
+{
+    hadc->ErrorCode |= HAL_ADC_ERROR_OVR;
+    if (hadc->DMA_Handle != NULL) { hadc->DMA_Handle->Instance->NDTR = 0; }
+    HAL_ADC_ErrorCallback(hadc);
+}
+
+// Simulates the DMA stream of a DAC channel transferring samples to the DAC
+// on each trigger: the samples output are copied into 'output'. The half
+// transfer and transfer complete callbacks are called when reached.
+void FakeHal_DacDmaOutput(DAC_HandleTypeDef* hdac, uint32_t channel, uint16_t* output, uint16_t length)
+{
+    DMA_HandleTypeDef* hdma   = (channel == DAC_CHANNEL_1) ? hdac->DMA_Handle1 : hdac->DMA_Handle2;
+    const uint32_t     index  = DacIndex(channel);
+    if ((hdma == NULL) || (dacDmaBuffer[index] == NULL)) { return; }
+
+    for (uint16_t i = 0; i < length; i++)
+    {
+        if ((hdma->Instance->NDTR == 0) || (dacDmaBuffer[index] == NULL)) { return; }
+
+        const uint16_t position = dacDmaLength[index] - hdma->Instance->NDTR;
+        output[i] = dacDmaBuffer[index][position];
+        hdma->Instance->NDTR--;
+
+        if ((position + 1) == (dacDmaLength[index] / 2))
+        {
+            if (channel == DAC_CHANNEL_1) { HAL_DAC_ConvHalfCpltCallbackCh1(hdac); }
+            else                          { HAL_DACEx_ConvHalfCpltCallbackCh2(hdac); }
+        }
+        if (hdma->Instance->NDTR == 0)
+        {
+            if (hdma->Init.Mode == DMA_CIRCULAR) { hdma->Instance->NDTR = dacDmaLength[index]; }
+            if (channel == DAC_CHANNEL_1) { HAL_DAC_ConvCpltCallbackCh1(hdac); }
+            else                          { HAL_DACEx_ConvCpltCallbackCh2(hdac); }
+        }
+    }
+}
+
+void FakeHal_SetPclkFreq(uint32_t pclk1, uint32_t pclk2)
+{
+    pclk1Freq = pclk1;
+    pclk2Freq = pclk2;
+}
+
+// Simulates the line becoming idle, the USART IRQ handler is to be called next.
+void FakeHal_UartIdle(UART_HandleTypeDef* huart)
+{
+    huart->Instance->SR |= UART_FLAG_IDLE;
+}
+
+// Simulates a reception error with the DMA: as the HAL, the reception is
+// aborted (the stream stops, NDTR keeps its value) and the error callback is
+// called. The stream only continues when the reception is started again.
+void FakeHal_UartError(UART_HandleTypeDef* huart, uint32_t errorCode)
+{
+    huart->ErrorCode  = errorCode;
+    huart->pRxBuffPtr = NULL;
+    if (huart->hdmarx != NULL) { huart->hdmarx->State = HAL_DMA_STATE_READY; }
+    HAL_UART_ErrorCallback(huart);
+}
+
+// Simulates a DMA error of the Tx stream: as the HAL, the error callback is
+// called, the Rx stream continues.
+void FakeHal_UartTxDmaError(UART_HandleTypeDef* huart)
+{
+    huart->ErrorCode |= HAL_UART_ERROR_DMA;
+    HAL_UART_ErrorCallback(huart);
+}
+
+// Hook called by __WFI() and HAL_PWR_EnterSTOPMode(), for instance to advance
+// the SysTick or RTC registers as if time passed while sleeping.
+void FakeHal_SetSleepHook(void (*hook)(FakeHalCall call))
+{
+    sleepHook = hook;
+}
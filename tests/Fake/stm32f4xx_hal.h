@@ -181,9 +181,889 @@ typedef enum
 #define GPIOI           ((GPIO_TypeDef *) GPIOI_BASE)
 
 
+/**
+ * \brief   HAL Status structures definition (from stm32f4xx_hal_def.h)
+ */
+typedef enum
+{
+    HAL_OK      = 0x00U,
+    HAL_ERROR   = 0x01U,
+    HAL_BUSY    = 0x02U,
+    HAL_TIMEOUT = 0x03U
+} HAL_StatusTypeDef;
+
+#define HAL_MAX_DELAY   0xFFFFFFFFU
+
+/**
+ * \brief   GPIO Bit SET and Bit RESET enumeration (from stm32f4xx_hal_gpio.h)
+ */
+typedef enum
+{
+    GPIO_PIN_RESET = 0,
+    GPIO_PIN_SET
+} GPIO_PinState;
+
+/**
+ * \brief   DMA Stream registers and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t CR;       ///< DMA stream x configuration register
+    volatile uint32_t NDTR;     ///< DMA stream x number of data register
+    volatile uint32_t PAR;      ///< DMA stream x peripheral address register
+    volatile uint32_t M0AR;     ///< DMA stream x memory 0 address register
+    volatile uint32_t M1AR;     ///< DMA stream x memory 1 address register
+    volatile uint32_t FCR;      ///< DMA stream x FIFO control register
+} DMA_Stream_TypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Direction;
+    uint32_t PeriphDataAlignment;
+    uint32_t MemDataAlignment;
+    uint32_t Mode;
+    uint32_t Priority;
+} DMA_InitTypeDef;
+
+typedef enum
+{
+    HAL_DMA_STATE_RESET = 0x00U,
+    HAL_DMA_STATE_READY = 0x01U,
+    HAL_DMA_STATE_BUSY  = 0x02U
+} HAL_DMA_StateTypeDef;
+
+typedef struct __DMA_HandleTypeDef
+{
+    DMA_Stream_TypeDef*           Instance;   ///< Register base address
+    DMA_InitTypeDef               Init;       ///< DMA communication parameters
+    volatile HAL_DMA_StateTypeDef State;      ///< DMA transfer state
+    void*                         Parent;     ///< Parent object state
+} DMA_HandleTypeDef;
+
+#define DMA_NORMAL                  (0x00000000U)
+#define DMA_CIRCULAR                (0x00000100U)
+#define DMA_PDATAALIGN_BYTE         (0x00000000U)
+#define DMA_PDATAALIGN_HALFWORD     (0x00000800U)
+#define DMA_PDATAALIGN_WORD         (0x00001000U)
+#define DMA_MDATAALIGN_BYTE         (0x00000000U)
+#define DMA_MDATAALIGN_HALFWORD     (0x00002000U)
+#define DMA_MDATAALIGN_WORD         (0x00004000U)
+
+#define __HAL_DMA_GET_COUNTER(__HANDLE__)   ((__HANDLE__)->Instance->NDTR)
+
+/**
+ * \brief   Serial Peripheral Interface registers, init structure and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t CR1;      ///< SPI control register 1
+    volatile uint32_t CR2;      ///< SPI control register 2
+    volatile uint32_t SR;       ///< SPI status register
+    volatile uint32_t DR;       ///< SPI data register
+} SPI_TypeDef;
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t Direction;
+    uint32_t DataSize;
+    uint32_t CLKPolarity;
+    uint32_t CLKPhase;
+    uint32_t NSS;
+    uint32_t BaudRatePrescaler;
+    uint32_t FirstBit;
+    uint32_t TIMode;
+    uint32_t CRCCalculation;
+    uint32_t CRCPolynomial;
+} SPI_InitTypeDef;
+
+typedef struct __SPI_HandleTypeDef
+{
+    SPI_TypeDef*       Instance;
+    SPI_InitTypeDef    Init;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+} SPI_HandleTypeDef;
+
+#define SPI_MODE_MASTER             (0x00000104U)
+#define SPI_DIRECTION_2LINES        (0x00000000U)
+#define SPI_DATASIZE_8BIT           (0x00000000U)
+#define SPI_POLARITY_LOW            (0x00000000U)
+#define SPI_POLARITY_HIGH           (0x00000002U)
+#define SPI_PHASE_1EDGE             (0x00000000U)
+#define SPI_PHASE_2EDGE             (0x00000001U)
+#define SPI_NSS_SOFT                (0x00000200U)
+#define SPI_BAUDRATEPRESCALER_2     (0x00000000U)
+#define SPI_BAUDRATEPRESCALER_4     (0x00000008U)
+#define SPI_BAUDRATEPRESCALER_8     (0x00000010U)
+#define SPI_BAUDRATEPRESCALER_16    (0x00000018U)
+#define SPI_BAUDRATEPRESCALER_32    (0x00000020U)
+#define SPI_BAUDRATEPRESCALER_64    (0x00000028U)
+#define SPI_BAUDRATEPRESCALER_128   (0x00000030U)
+#define SPI_BAUDRATEPRESCALER_256   (0x00000038U)
+#define SPI_FIRSTBIT_MSB            (0x00000000U)
+#define SPI_TIMODE_DISABLE          (0x00000000U)
+#define SPI_CRCCALCULATION_DISABLE  (0x00000000U)
+
+/**
+ * \brief   APB1/APB2 peripherals
+ */
+#define SPI2_BASE       (APB1PERIPH_BASE + 0x3800UL)
+#define SPI3_BASE       (APB1PERIPH_BASE + 0x3C00UL)
+#define SPI1_BASE       (APB2PERIPH_BASE + 0x3000UL)
+
+#define SPI1            ((SPI_TypeDef *) SPI1_BASE)
+#define SPI2            ((SPI_TypeDef *) SPI2_BASE)
+#define SPI3            ((SPI_TypeDef *) SPI3_BASE)
+
+/**
+ * \brief   Peripheral clock control, the fake keeps the clocks enabled.
+ */
+#define __HAL_RCC_SPI1_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_SPI2_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_SPI3_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_SPI1_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_SPI2_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_SPI3_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_SPI1_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_SPI2_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_SPI3_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_SPI1_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_SPI2_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_SPI3_IS_CLK_DISABLED()    (0)
+
+/**
+ * \brief   Universal Synchronous Asynchronous Receiver Transmitter registers,
+ *          init structure and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t SR;       ///< USART status register
+    volatile uint32_t DR;       ///< USART data register
+    volatile uint32_t BRR;      ///< USART baud rate register
+    volatile uint32_t CR1;      ///< USART control register 1
+    volatile uint32_t CR2;      ///< USART control register 2
+    volatile uint32_t CR3;      ///< USART control register 3
+    volatile uint32_t GTPR;     ///< USART guard time and prescaler register
+} USART_TypeDef;
+
+typedef struct
+{
+    uint32_t BaudRate;
+    uint32_t WordLength;
+    uint32_t StopBits;
+    uint32_t Parity;
+    uint32_t Mode;
+    uint32_t HwFlowCtl;
+    uint32_t OverSampling;
+} UART_InitTypeDef;
+
+typedef struct __UART_HandleTypeDef
+{
+    USART_TypeDef*     Instance;
+    UART_InitTypeDef   Init;
+    uint8_t*           pRxBuffPtr;
+    uint16_t           RxXferSize;
+    volatile uint16_t  RxXferCount;
+    DMA_HandleTypeDef* hdmatx;
+    DMA_HandleTypeDef* hdmarx;
+    volatile uint32_t  ErrorCode;
+} UART_HandleTypeDef;
+
+#define UART_WORDLENGTH_8B          (0x00000000U)
+#define UART_WORDLENGTH_9B          (0x00001000U)
+#define UART_STOPBITS_1             (0x00000000U)
+#define UART_STOPBITS_2             (0x00002000U)
+#define UART_PARITY_NONE            (0x00000000U)
+#define UART_PARITY_EVEN            (0x00000400U)
+#define UART_PARITY_ODD             (0x00000600U)
+#define UART_MODE_TX_RX             (0x0000000CU)
+#define UART_HWCONTROL_NONE         (0x00000000U)
+#define UART_HWCONTROL_RTS_CTS      (0x00000300U)
+#define UART_OVERSAMPLING_16        (0x00000000U)
+#define UART_OVERSAMPLING_8         (0x00008000U)
+#define UART_FLAG_IDLE              (0x00000010U)
+#define HAL_UART_ERROR_NONE         (0x00000000U)
+#define HAL_UART_ERROR_PE           (0x00000001U)
+#define HAL_UART_ERROR_NE           (0x00000002U)
+#define HAL_UART_ERROR_FE           (0x00000004U)
+#define HAL_UART_ERROR_ORE          (0x00000008U)
+#define HAL_UART_ERROR_DMA          (0x00000010U)
+#define UART_IT_IDLE                (0x10000010U)
+
+// Interrupts are kept in CR1, flags are cleared by writing 0 (instead of reading SR and DR).
+#define __HAL_UART_GET_FLAG(__HANDLE__, __FLAG__)           (((__HANDLE__)->Instance->SR & (__FLAG__)) == (__FLAG__))
+#define __HAL_UART_CLEAR_FLAG(__HANDLE__, __FLAG__)         ((__HANDLE__)->Instance->SR &= ~(__FLAG__))
+#define __HAL_UART_CLEAR_IDLEFLAG(__HANDLE__)               ((__HANDLE__)->Instance->SR &= ~UART_FLAG_IDLE)
+#define __HAL_UART_ENABLE_IT(__HANDLE__, __INTERRUPT__)     ((__HANDLE__)->Instance->CR1 |= ((__INTERRUPT__) & 0x0000FFFFU))
+#define __HAL_UART_DISABLE_IT(__HANDLE__, __INTERRUPT__)    ((__HANDLE__)->Instance->CR1 &= ~((__INTERRUPT__) & 0x0000FFFFU))
+
+// The fake USARTs are backed by memory, the driver accesses the registers directly.
+extern USART_TypeDef FakeHal_UsartRegisters[4];
+
+#define USART1          (&FakeHal_UsartRegisters[0])
+#define USART2          (&FakeHal_UsartRegisters[1])
+#define USART3          (&FakeHal_UsartRegisters[2])
+#define USART6          (&FakeHal_UsartRegisters[3])
+
+#define __HAL_RCC_USART1_CLK_ENABLE()       do { } while(0)
+#define __HAL_RCC_USART2_CLK_ENABLE()       do { } while(0)
+#define __HAL_RCC_USART3_CLK_ENABLE()       do { } while(0)
+#define __HAL_RCC_USART6_CLK_ENABLE()       do { } while(0)
+#define __HAL_RCC_USART1_CLK_DISABLE()      do { } while(0)
+#define __HAL_RCC_USART2_CLK_DISABLE()      do { } while(0)
+#define __HAL_RCC_USART3_CLK_DISABLE()      do { } while(0)
+#define __HAL_RCC_USART6_CLK_DISABLE()      do { } while(0)
+#define __HAL_RCC_USART1_IS_CLK_ENABLED()   (1)
+#define __HAL_RCC_USART2_IS_CLK_ENABLED()   (1)
+#define __HAL_RCC_USART3_IS_CLK_ENABLED()   (1)
+#define __HAL_RCC_USART6_IS_CLK_ENABLED()   (1)
+#define __HAL_RCC_USART1_IS_CLK_DISABLED()  (0)
+#define __HAL_RCC_USART2_IS_CLK_DISABLED()  (0)
+#define __HAL_RCC_USART3_IS_CLK_DISABLED()  (0)
+#define __HAL_RCC_USART6_IS_CLK_DISABLED()  (0)
+
+
+/**
+ * \brief   Functional state (from stm32f4xx.h)
+ */
+typedef enum
+{
+    DISABLE = 0U,
+    ENABLE  = !DISABLE
+} FunctionalState;
+
+/**
+ * \brief   Analog to Digital Converter registers, init structures and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t SR;       ///< ADC status register
+    volatile uint32_t CR1;      ///< ADC control register 1
+    volatile uint32_t CR2;      ///< ADC control register 2
+    volatile uint32_t DR;       ///< ADC regular data register
+} ADC_TypeDef;
+
+typedef struct
+{
+    volatile uint32_t CSR;      ///< ADC common status register
+    volatile uint32_t CCR;      ///< ADC common control register
+    volatile uint32_t CDR;      ///< ADC common regular data register for dual and triple modes
+} ADC_Common_TypeDef;
+
+typedef struct
+{
+    uint32_t        ClockPrescaler;
+    uint32_t        Resolution;
+    uint32_t        DataAlign;
+    uint32_t        ScanConvMode;
+    uint32_t        EOCSelection;
+    FunctionalState ContinuousConvMode;
+    uint32_t        NbrOfConversion;
+    FunctionalState DiscontinuousConvMode;
+    uint32_t        NbrOfDiscConversion;
+    uint32_t        ExternalTrigConv;
+    uint32_t        ExternalTrigConvEdge;
+    FunctionalState DMAContinuousRequests;
+} ADC_InitTypeDef;
+
+typedef struct
+{
+    uint32_t Channel;
+    uint32_t Rank;
+    uint32_t SamplingTime;
+    uint32_t Offset;
+} ADC_ChannelConfTypeDef;
+
+typedef struct
+{
+    uint32_t Mode;
+    uint32_t DMAAccessMode;
+    uint32_t TwoSamplingDelay;
+} ADC_MultiModeTypeDef;
+
+typedef struct __ADC_HandleTypeDef
+{
+    ADC_TypeDef*       Instance;
+    ADC_InitTypeDef    Init;
+    DMA_HandleTypeDef* DMA_Handle;
+    volatile uint32_t  ErrorCode;
+} ADC_HandleTypeDef;
+
+#define ADC_CLOCK_SYNC_PCLK_DIV2        (0x00000000U)
+#define ADC_RESOLUTION_12B              (0x00000000U)
+#define ADC_RESOLUTION_10B              (0x01000000U)
+#define ADC_RESOLUTION_8B               (0x02000000U)
+#define ADC_RESOLUTION_6B               (0x03000000U)
+#define ADC_DATAALIGN_RIGHT             (0x00000000U)
+#define ADC_EOC_SEQ_CONV                (0x00000000U)
+#define ADC_EOC_SINGLE_CONV             (0x00000001U)
+#define ADC_SOFTWARE_START              (0x0F000001U)
+#define ADC_EXTERNALTRIGCONV_T1_CC1     (0x00000000U)
+#define ADC_EXTERNALTRIGCONV_T2_TRGO    (0x06000000U)
+#define ADC_EXTERNALTRIGCONV_T3_TRGO    (0x08000000U)
+#define ADC_EXTERNALTRIGCONV_T8_TRGO    (0x0E000000U)
+#define ADC_EXTERNALTRIGCONV_Ext_IT11   (0x0F000000U)
+#define ADC_EXTERNALTRIGCONVEDGE_NONE   (0x00000000U)
+#define ADC_EXTERNALTRIGCONVEDGE_RISING (0x10000000U)
+#define ADC_SAMPLETIME_3CYCLES          (0x00000000U)
+#define ADC_SAMPLETIME_15CYCLES         (0x00000001U)
+#define ADC_SAMPLETIME_28CYCLES         (0x00000002U)
+#define ADC_SAMPLETIME_56CYCLES         (0x00000003U)
+#define ADC_SAMPLETIME_84CYCLES         (0x00000004U)
+#define ADC_SAMPLETIME_112CYCLES        (0x00000005U)
+#define ADC_SAMPLETIME_144CYCLES        (0x00000006U)
+#define ADC_SAMPLETIME_480CYCLES        (0x00000007U)
+#define ADC_CHANNEL_0                   (0x00000000U)
+#define ADC_CHANNEL_1                   (0x00000001U)
+#define ADC_CHANNEL_2                   (0x00000002U)
+#define ADC_CHANNEL_3                   (0x00000003U)
+#define ADC_CHANNEL_4                   (0x00000004U)
+#define ADC_CHANNEL_5                   (0x00000005U)
+#define ADC_CHANNEL_6                   (0x00000006U)
+#define ADC_CHANNEL_7                   (0x00000007U)
+#define ADC_CHANNEL_8                   (0x00000008U)
+#define ADC_CHANNEL_9                   (0x00000009U)
+#define ADC_CHANNEL_10                  (0x0000000AU)
+#define ADC_CHANNEL_11                  (0x0000000BU)
+#define ADC_CHANNEL_12                  (0x0000000CU)
+#define ADC_CHANNEL_13                  (0x0000000DU)
+#define ADC_CHANNEL_14                  (0x0000000EU)
+#define ADC_CHANNEL_15                  (0x0000000FU)
+#define ADC_MODE_INDEPENDENT            (0x00000000U)
+#define ADC_DUALMODE_INTERL             (0x00000007U)
+#define ADC_TRIPLEMODE_INTERL           (0x00000017U)
+#define ADC_DMAACCESSMODE_DISABLED      (0x00000000U)
+#define ADC_DMAACCESSMODE_2             (0x00008000U)
+#define ADC_TWOSAMPLINGDELAY_5CYCLES    (0x00000000U)
+#define ADC_TWOSAMPLINGDELAY_6CYCLES    (0x00000100U)
+#define ADC_TWOSAMPLINGDELAY_20CYCLES   (0x00000F00U)
+#define HAL_ADC_ERROR_NONE              (0x00U)
+#define HAL_ADC_ERROR_OVR               (0x02U)
+#define HAL_ADC_ERROR_DMA               (0x04U)
+
+// The fake ADCs are backed by memory.
+extern ADC_TypeDef FakeHal_AdcRegisters[3];
+extern ADC_Common_TypeDef FakeHal_AdcCommonRegisters;
+
+#define ADC1            (&FakeHal_AdcRegisters[0])
+#define ADC2            (&FakeHal_AdcRegisters[1])
+#define ADC3            (&FakeHal_AdcRegisters[2])
+#define ADC123_COMMON   (&FakeHal_AdcCommonRegisters)
+
+#define __HAL_RCC_ADC1_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_ADC2_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_ADC3_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_ADC1_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_ADC2_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_ADC3_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_ADC1_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_ADC2_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_ADC3_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_ADC1_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_ADC2_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_ADC3_IS_CLK_DISABLED()    (0)
+
+/**
+ * \brief   Timer registers, init structures and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t CR1;      ///< TIM control register 1
+    volatile uint32_t CR2;      ///< TIM control register 2
+    volatile uint32_t DIER;     ///< TIM DMA/interrupt enable register
+    volatile uint32_t CNT;      ///< TIM counter register
+    volatile uint32_t PSC;      ///< TIM prescaler
+    volatile uint32_t ARR;      ///< TIM auto-reload register
+} TIM_TypeDef;
+
+typedef struct
+{
+    uint32_t Prescaler;
+    uint32_t CounterMode;
+    uint32_t Period;
+    uint32_t ClockDivision;
+    uint32_t RepetitionCounter;
+    uint32_t AutoReloadPreload;
+} TIM_Base_InitTypeDef;
+
+typedef struct
+{
+    uint32_t MasterOutputTrigger;
+    uint32_t MasterSlaveMode;
+} TIM_MasterConfigTypeDef;
+
+typedef struct
+{
+    TIM_TypeDef*         Instance;
+    TIM_Base_InitTypeDef Init;
+} TIM_HandleTypeDef;
+
+#define TIM_COUNTERMODE_UP              (0x00000000U)
+#define TIM_CLOCKDIVISION_DIV1          (0x00000000U)
+#define TIM_AUTORELOAD_PRELOAD_ENABLE   (0x00000080U)
+#define TIM_TRGO_RESET                  (0x00000000U)
+#define TIM_TRGO_UPDATE                 (0x00000020U)
+#define TIM_MASTERSLAVEMODE_DISABLE     (0x00000000U)
+#define TIM_CR1_CEN                     (0x00000001U)
+#define TIM_CR2_MMS                     (0x00000070U)
+#define TIM_DIER_UIE                    (0x00000001U)
+
+// The fake timers are backed by memory, index is the timer number - 1.
+extern TIM_TypeDef FakeHal_TimRegisters[14];
+
+#define TIM2            (&FakeHal_TimRegisters[1])
+#define TIM3            (&FakeHal_TimRegisters[2])
+#define TIM4            (&FakeHal_TimRegisters[3])
+#define TIM5            (&FakeHal_TimRegisters[4])
+#define TIM6            (&FakeHal_TimRegisters[5])
+#define TIM7            (&FakeHal_TimRegisters[6])
+#define TIM9            (&FakeHal_TimRegisters[8])
+#define TIM10           (&FakeHal_TimRegisters[9])
+#define TIM11           (&FakeHal_TimRegisters[10])
+#define TIM12           (&FakeHal_TimRegisters[11])
+#define TIM13           (&FakeHal_TimRegisters[12])
+#define TIM14           (&FakeHal_TimRegisters[13])
+
+#define __HAL_RCC_TIM2_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM3_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM4_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM5_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM6_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM7_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM9_CLK_ENABLE()         do { } while(0)
+#define __HAL_RCC_TIM10_CLK_ENABLE()        do { } while(0)
+#define __HAL_RCC_TIM11_CLK_ENABLE()        do { } while(0)
+#define __HAL_RCC_TIM12_CLK_ENABLE()        do { } while(0)
+#define __HAL_RCC_TIM13_CLK_ENABLE()        do { } while(0)
+#define __HAL_RCC_TIM14_CLK_ENABLE()        do { } while(0)
+#define __HAL_RCC_TIM2_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM3_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM4_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM5_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM6_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM7_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM9_CLK_DISABLE()        do { } while(0)
+#define __HAL_RCC_TIM10_CLK_DISABLE()       do { } while(0)
+#define __HAL_RCC_TIM11_CLK_DISABLE()       do { } while(0)
+#define __HAL_RCC_TIM12_CLK_DISABLE()       do { } while(0)
+#define __HAL_RCC_TIM13_CLK_DISABLE()       do { } while(0)
+#define __HAL_RCC_TIM14_CLK_DISABLE()       do { } while(0)
+#define __HAL_RCC_TIM2_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM3_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM4_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM5_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM6_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM7_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM9_IS_CLK_ENABLED()     (1)
+#define __HAL_RCC_TIM10_IS_CLK_ENABLED()    (1)
+#define __HAL_RCC_TIM11_IS_CLK_ENABLED()    (1)
+#define __HAL_RCC_TIM12_IS_CLK_ENABLED()    (1)
+#define __HAL_RCC_TIM13_IS_CLK_ENABLED()    (1)
+#define __HAL_RCC_TIM14_IS_CLK_ENABLED()    (1)
+#define __HAL_RCC_TIM2_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM3_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM4_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM5_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM6_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM7_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM9_IS_CLK_DISABLED()    (0)
+#define __HAL_RCC_TIM10_IS_CLK_DISABLED()   (0)
+#define __HAL_RCC_TIM11_IS_CLK_DISABLED()   (0)
+#define __HAL_RCC_TIM12_IS_CLK_DISABLED()   (0)
+#define __HAL_RCC_TIM13_IS_CLK_DISABLED()   (0)
+#define __HAL_RCC_TIM14_IS_CLK_DISABLED()   (0)
+
+/**
+ * \brief   Digital to Analog Converter registers, channel configuration and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t CR;       ///< DAC control register
+    volatile uint32_t SWTRIGR;  ///< DAC software trigger register
+    volatile uint32_t DHR12R1;  ///< DAC channel1 12-bit right-aligned data holding register
+    volatile uint32_t DHR12R2;  ///< DAC channel2 12-bit right-aligned data holding register
+} DAC_TypeDef;
+
+typedef struct
+{
+    uint32_t DAC_Trigger;
+    uint32_t DAC_OutputBuffer;
+} DAC_ChannelConfTypeDef;
+
+typedef struct __DAC_HandleTypeDef
+{
+    DAC_TypeDef*       Instance;
+    DMA_HandleTypeDef* DMA_Handle1;
+    DMA_HandleTypeDef* DMA_Handle2;
+    volatile uint32_t  ErrorCode;
+} DAC_HandleTypeDef;
+
+#define DAC_CHANNEL_1                   (0x00000000U)
+#define DAC_CHANNEL_2                   (0x00000010U)
+#define DAC_ALIGN_12B_R                 (0x00000000U)
+#define DAC_ALIGN_12B_L                 (0x00000004U)
+#define DAC_ALIGN_8B_R                  (0x00000008U)
+#define DAC_TRIGGER_NONE                (0x00000000U)
+#define DAC_TRIGGER_T6_TRGO             (0x00000004U)
+#define DAC_TRIGGER_T8_TRGO             (0x0000000CU)
+#define DAC_TRIGGER_T7_TRGO             (0x00000014U)
+#define DAC_TRIGGER_T5_TRGO             (0x0000001CU)
+#define DAC_TRIGGER_T2_TRGO             (0x00000024U)
+#define DAC_TRIGGER_T4_TRGO             (0x0000002CU)
+#define DAC_TRIGGER_EXT_IT9             (0x00000034U)
+#define DAC_OUTPUTBUFFER_ENABLE         (0x00000000U)
+
+// The fake DAC is backed by memory.
+extern DAC_TypeDef FakeHal_DacRegisters;
+
+#define DAC             (&FakeHal_DacRegisters)
+
+#define __HAL_RCC_DAC_CLK_ENABLE()          do { } while(0)
+#define __HAL_RCC_DAC_CLK_DISABLE()         do { } while(0)
+#define __HAL_RCC_DAC_IS_CLK_ENABLED()      (1)
+#define __HAL_RCC_DAC_IS_CLK_DISABLED()     (0)
+
+/**
+ * @brief Data Watchpoint and Trace, only the cycle counter.
+ */
+typedef struct
+{
+    volatile uint32_t CTRL;     ///< Control Register,      Address offset: 0x00
+    volatile uint32_t CYCCNT;   ///< Cycle Count Register,  Address offset: 0x04
+} DWT_Type;
+
+/**
+ * @brief Core Debug, only the exception and monitor control register.
+ */
+typedef struct
+{
+    volatile uint32_t DEMCR;    ///< Debug Exception and Monitor Control Register
+} CoreDebug_Type;
+
+#define DWT_CTRL_CYCCNTENA_Msk          (0x00000001U)
+#define CoreDebug_DEMCR_TRCENA_Msk      (0x01000000U)
+
+// Backed by memory, the tests use DWT->CYCCNT as clock.
+extern DWT_Type       FakeHal_DwtRegisters;
+extern CoreDebug_Type FakeHal_CoreDebugRegisters;
+
+#define DWT             (&FakeHal_DwtRegisters)
+#define CoreDebug       (&FakeHal_CoreDebugRegisters)
+
+/**
+ * @brief System Tick timer.
+ */
+typedef struct
+{
+    volatile uint32_t CTRL;     ///< SysTick Control and Status Register,   Address offset: 0x00
+    volatile uint32_t LOAD;     ///< SysTick Reload Value Register,         Address offset: 0x04
+    volatile uint32_t VAL;      ///< SysTick Current Value Register,        Address offset: 0x08
+    volatile uint32_t CALIB;    ///< SysTick Calibration Register,          Address offset: 0x0C
+} SysTick_Type;
+
+#define SysTick_CTRL_ENABLE_Msk         (0x00000001U)
+#define SysTick_CTRL_TICKINT_Msk        (0x00000002U)
+#define SysTick_CTRL_CLKSOURCE_Msk      (0x00000004U)
+#define SysTick_CTRL_COUNTFLAG_Msk      (0x00010000U)
+#define SysTick_LOAD_RELOAD_Msk         (0x00FFFFFFU)
+
+// Backed by memory: the counter does not run, the tests set VAL and COUNTFLAG.
+extern SysTick_Type   FakeHal_SysTickRegisters;
+
+#define SysTick         (&FakeHal_SysTickRegisters)
+
+// Core clock in Hz, as in system_stm32f4xx.c.
+extern uint32_t SystemCoreClock;
+
+
+/**
+ * \brief   DMA stream instances, only the enable bit is used.
+ */
+extern DMA_Stream_TypeDef FakeHal_DmaStreamRegisters[16];
+
+#define DMA1_Stream0    (&FakeHal_DmaStreamRegisters[0])
+#define DMA1_Stream1    (&FakeHal_DmaStreamRegisters[1])
+#define DMA1_Stream2    (&FakeHal_DmaStreamRegisters[2])
+#define DMA1_Stream3    (&FakeHal_DmaStreamRegisters[3])
+#define DMA1_Stream4    (&FakeHal_DmaStreamRegisters[4])
+#define DMA1_Stream5    (&FakeHal_DmaStreamRegisters[5])
+#define DMA1_Stream6    (&FakeHal_DmaStreamRegisters[6])
+#define DMA1_Stream7    (&FakeHal_DmaStreamRegisters[7])
+#define DMA2_Stream0    (&FakeHal_DmaStreamRegisters[8])
+#define DMA2_Stream1    (&FakeHal_DmaStreamRegisters[9])
+#define DMA2_Stream2    (&FakeHal_DmaStreamRegisters[10])
+#define DMA2_Stream3    (&FakeHal_DmaStreamRegisters[11])
+#define DMA2_Stream4    (&FakeHal_DmaStreamRegisters[12])
+#define DMA2_Stream5    (&FakeHal_DmaStreamRegisters[13])
+#define DMA2_Stream6    (&FakeHal_DmaStreamRegisters[14])
+#define DMA2_Stream7    (&FakeHal_DmaStreamRegisters[15])
+
+#define DMA_SxCR_EN                     (0x00000001U)
+
+
+/**
+ * \brief   Real-Time Clock registers, init structure and handle (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t TR;       ///< RTC time register
+    volatile uint32_t DR;       ///< RTC date register
+    volatile uint32_t CR;       ///< RTC control register
+    volatile uint32_t ISR;      ///< RTC initialization and status register
+    volatile uint32_t PRER;     ///< RTC prescaler register
+    volatile uint32_t WUTR;     ///< RTC wakeup timer register
+    volatile uint32_t SSR;      ///< RTC sub second register
+} RTC_TypeDef;
+
+typedef struct
+{
+    uint32_t HourFormat;
+    uint32_t AsynchPrediv;
+    uint32_t SynchPrediv;
+    uint32_t OutPut;
+    uint32_t OutPutPolarity;
+    uint32_t OutPutType;
+} RTC_InitTypeDef;
+
+typedef struct
+{
+    RTC_TypeDef*    Instance;   ///< Register base address
+    RTC_InitTypeDef Init;       ///< RTC required parameters
+} RTC_HandleTypeDef;
+
+#define RTC_HOURFORMAT_24               (0x00000000U)
+#define RTC_OUTPUT_DISABLE              (0x00000000U)
+#define RTC_OUTPUT_POLARITY_HIGH        (0x00000000U)
+#define RTC_OUTPUT_TYPE_OPENDRAIN       (0x00000000U)
+#define RTC_WAKEUPCLOCK_RTCCLK_DIV16    (0x00000000U)
+#define RCC_RTCCLKSOURCE_LSI            (0x00000200U)
+
+#define RTC_TR_ST_Pos                   (4U)
+#define RTC_TR_ST                       (0x00000070U)
+#define RTC_TR_SU                       (0x0000000FU)
+#define RTC_CR_WUCKSEL                  (0x00000007U)
+#define RTC_CR_WUTE                     (0x00000400U)
+#define RTC_CR_WUTIE                    (0x00004000U)
+#define RTC_ISR_WUTWF                   (0x00000004U)
+#define RTC_ISR_RSF                     (0x00000020U)
+#define RTC_ISR_WUTF                    (0x00000400U)
+
+// Backed by memory, the tests set the time (TR) and sub seconds (SSR).
+extern RTC_TypeDef    FakeHal_RtcRegisters;
+
+#define RTC             (&FakeHal_RtcRegisters)
+
+#define __HAL_RCC_PWR_CLK_ENABLE()          do { } while(0)
+#define __HAL_RCC_RTC_CONFIG(__SOURCE__)    do { } while(0)
+#define __HAL_RCC_RTC_ENABLE()              do { } while(0)
+#define __HAL_RCC_RTC_DISABLE()             do { } while(0)
+#define __HAL_RTC_WRITEPROTECTION_DISABLE(__HANDLE__)   do { } while(0)
+#define __HAL_RTC_WRITEPROTECTION_ENABLE(__HANDLE__)    do { } while(0)
+#define __HAL_RTC_WAKEUPTIMER_EXTI_ENABLE_IT()              do { } while(0)
+#define __HAL_RTC_WAKEUPTIMER_EXTI_ENABLE_RISING_EDGE()     do { } while(0)
+#define __HAL_RTC_WAKEUPTIMER_EXTI_CLEAR_FLAG()             do { } while(0)
+
+/**
+ * \brief   Reset and clock control registers (reduced)
+ */
+typedef struct
+{
+    volatile uint32_t CR;       ///< RCC clock control register
+    volatile uint32_t PLLCFGR;  ///< RCC PLL configuration register
+    volatile uint32_t CFGR;     ///< RCC clock configuration register
+} RCC_TypeDef;
+
+#define RCC_CR_HSEON                    (0x00010000U)
+#define RCC_CR_HSERDY                   (0x00020000U)
+#define RCC_CR_PLLON                    (0x01000000U)
+#define RCC_CR_PLLRDY                   (0x02000000U)
+#define RCC_CFGR_SW                     (0x00000003U)
+#define RCC_CFGR_SW_HSI                 (0x00000000U)
+#define RCC_CFGR_SW_PLL                 (0x00000002U)
+#define RCC_CFGR_SWS_Pos                (2U)
+#define RCC_CFGR_SWS                    (0x0000000CU)
+
+// Backed by memory: the oscillators and clock switch do not run, the tests
+// set the ready and status bits.
+extern RCC_TypeDef    FakeHal_RccRegisters;
+
+#define RCC             (&FakeHal_RccRegisters)
+
+#define PWR_MAINREGULATOR_ON            (0x00000000U)
+#define PWR_LOWPOWERREGULATOR_ON        (0x00000001U)
+#define PWR_STOPENTRY_WFI               (0x00000001U)
+
+
 void __NOP(void);
+void __WFI(void);
+void __DSB(void);
+void __ISB(void);
+
+uint32_t __get_PRIMASK(void);
+void __disable_irq(void);
+void __enable_irq(void);
 
 void HAL_Delay(uint32_t Delay);
+void HAL_SuspendTick(void);
+void HAL_ResumeTick(void);
+
+uint32_t HAL_RCC_GetHCLKFreq(void);
+uint32_t HAL_RCC_GetPCLK1Freq(void);
+uint32_t HAL_RCC_GetPCLK2Freq(void);
+
+void HAL_NVIC_SetPriority(IRQn_Type IRQn, uint32_t PreemptPriority, uint32_t SubPriority);
+void HAL_NVIC_EnableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_DisableIRQ(IRQn_Type IRQn);
+void HAL_NVIC_ClearPendingIRQ(IRQn_Type IRQn);
+
+void HAL_GPIO_WritePin(GPIO_TypeDef* GPIOx, uint16_t GPIO_Pin, GPIO_PinState PinState);
+
+HAL_DMA_StateTypeDef HAL_DMA_GetState(DMA_HandleTypeDef* hdma);
+
+HAL_StatusTypeDef HAL_SPI_Init(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_DeInit(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Abort(SPI_HandleTypeDef* hspi);
+HAL_StatusTypeDef HAL_SPI_Transmit(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Receive(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_SPI_Transmit_IT(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Receive_IT(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_IT(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Transmit_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_Receive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_SPI_TransmitReceive_DMA(SPI_HandleTypeDef* hspi, uint8_t* pTxData, uint8_t* pRxData, uint16_t Size);
+void HAL_SPI_IRQHandler(SPI_HandleTypeDef* hspi);
+void HAL_SPI_TxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_RxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_TxRxCpltCallback(SPI_HandleTypeDef* hspi);
+void HAL_SPI_ErrorCallback(SPI_HandleTypeDef* hspi);
+
+HAL_StatusTypeDef HAL_UART_Init(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_DeInit(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Abort(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_AbortReceive_IT(UART_HandleTypeDef* huart);
+HAL_StatusTypeDef HAL_UART_Transmit(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Receive(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size, uint32_t Timeout);
+HAL_StatusTypeDef HAL_UART_Transmit_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_IT(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Transmit_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+HAL_StatusTypeDef HAL_UART_Receive_DMA(UART_HandleTypeDef* huart, uint8_t* pData, uint16_t Size);
+void HAL_UART_IRQHandler(UART_HandleTypeDef* huart);
+void HAL_UART_TxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_RxHalfCpltCallback(UART_HandleTypeDef* huart);
+void HAL_UART_ErrorCallback(UART_HandleTypeDef* huart);
+
+HAL_StatusTypeDef HAL_ADC_Init(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_DeInit(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_ConfigChannel(ADC_HandleTypeDef* hadc, ADC_ChannelConfTypeDef* sConfig);
+HAL_StatusTypeDef HAL_ADC_Start(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Stop(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_PollForConversion(ADC_HandleTypeDef* hadc, uint32_t Timeout);
+HAL_StatusTypeDef HAL_ADC_Start_IT(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Stop_IT(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADC_Start_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADC_Stop_DMA(ADC_HandleTypeDef* hadc);
+uint32_t HAL_ADC_GetValue(ADC_HandleTypeDef* hadc);
+uint32_t HAL_ADC_GetError(ADC_HandleTypeDef* hadc);
+void HAL_ADC_IRQHandler(ADC_HandleTypeDef* hadc);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeConfigChannel(ADC_HandleTypeDef* hadc, ADC_MultiModeTypeDef* multimode);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStart_DMA(ADC_HandleTypeDef* hadc, uint32_t* pData, uint32_t Length);
+HAL_StatusTypeDef HAL_ADCEx_MultiModeStop_DMA(ADC_HandleTypeDef* hadc);
+
+HAL_StatusTypeDef HAL_DAC_Init(DAC_HandleTypeDef* hdac);
+HAL_StatusTypeDef HAL_DAC_DeInit(DAC_HandleTypeDef* hdac);
+HAL_StatusTypeDef HAL_DAC_ConfigChannel(DAC_HandleTypeDef* hdac, DAC_ChannelConfTypeDef* sConfig, uint32_t Channel);
+HAL_StatusTypeDef HAL_DAC_Start(DAC_HandleTypeDef* hdac, uint32_t Channel);
+HAL_StatusTypeDef HAL_DAC_Stop(DAC_HandleTypeDef* hdac, uint32_t Channel);
+HAL_StatusTypeDef HAL_DAC_Start_DMA(DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t* pData, uint32_t Length, uint32_t Alignment);
+HAL_StatusTypeDef HAL_DAC_Stop_DMA(DAC_HandleTypeDef* hdac, uint32_t Channel);
+HAL_StatusTypeDef HAL_DAC_SetValue(DAC_HandleTypeDef* hdac, uint32_t Channel, uint32_t Alignment, uint32_t Data);
+void HAL_DAC_ConvCpltCallbackCh1(DAC_HandleTypeDef* hdac);
+void HAL_DAC_ConvHalfCpltCallbackCh1(DAC_HandleTypeDef* hdac);
+void HAL_DACEx_ConvCpltCallbackCh2(DAC_HandleTypeDef* hdac);
+void HAL_DACEx_ConvHalfCpltCallbackCh2(DAC_HandleTypeDef* hdac);
+void HAL_ADC_ConvCpltCallback(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ConvHalfCpltCallback(ADC_HandleTypeDef* hadc);
+void HAL_ADC_ErrorCallback(ADC_HandleTypeDef* hadc);
+
+HAL_StatusTypeDef HAL_TIM_Base_Init(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_DeInit(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Start_IT(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIM_Base_Stop_IT(TIM_HandleTypeDef* htim);
+HAL_StatusTypeDef HAL_TIMEx_MasterConfigSynchronization(TIM_HandleTypeDef* htim, TIM_MasterConfigTypeDef* sMasterConfig);
+void HAL_TIM_IRQHandler(TIM_HandleTypeDef* htim);
+void HAL_TIM_PeriodElapsedCallback(TIM_HandleTypeDef* htim);
+
+HAL_StatusTypeDef HAL_RTC_Init(RTC_HandleTypeDef* hrtc);
+void HAL_RTCEx_WakeUpTimerIRQHandler(RTC_HandleTypeDef* hrtc);
+
+void HAL_PWR_EnableBkUpAccess(void);
+void HAL_PWR_EnterSTOPMode(uint32_t Regulator, uint8_t STOPEntry);
+
+
+/************************************************************************/
+/* Fake helpers                                                         */
+/************************************************************************/
+/**
+ * \brief   HAL calls recorded by the fake, in order of occurrence.
+ */
+typedef enum
+{
+    FAKE_HAL_GPIO_WRITE_PIN,
+    FAKE_HAL_SPI_TRANSMIT,
+    FAKE_HAL_SPI_RECEIVE,
+    FAKE_HAL_SPI_TRANSMIT_RECEIVE,
+    FAKE_HAL_SPI_TRANSMIT_DMA,
+    FAKE_HAL_SPI_RECEIVE_DMA,
+    FAKE_HAL_SPI_TRANSMIT_RECEIVE_DMA,
+    FAKE_HAL_UART_RECEIVE_DMA,
+    FAKE_HAL_UART_ABORT_RECEIVE,
+    FAKE_HAL_ADC_CONFIG_CHANNEL,
+    FAKE_HAL_ADC_START,
+    FAKE_HAL_ADC_START_DMA,
+    FAKE_HAL_ADC_STOP_DMA,
+    FAKE_HAL_ADC_MULTIMODE_START_DMA,
+    FAKE_HAL_ADC_MULTIMODE_STOP_DMA,
+    FAKE_HAL_DAC_START_DMA,
+    FAKE_HAL_DAC_STOP_DMA,
+    FAKE_HAL_TIM_START,
+    FAKE_HAL_TIM_START_IT,
+    FAKE_HAL_TIM_STOP,
+    FAKE_HAL_WFI,
+    FAKE_HAL_SUSPEND_TICK,
+    FAKE_HAL_RESUME_TICK,
+    FAKE_HAL_PWR_ENTER_STOP
+} FakeHalCall;
+
+typedef struct
+{
+    FakeHalCall call;       ///< The HAL method called.
+    uint32_t    value;      ///< Pin state for GPIO, the first byte written for SPI, the ADC channel or number, the timer number, the DAC channel.
+    uint16_t    length;     ///< Number of bytes for SPI and UART, the pin id for GPIO, the ADC rank or number of samples.
+} FakeHalEvent;
+
+void FakeHal_Reset(void);
+uint32_t FakeHal_GetEventCount(void);
+FakeHalEvent FakeHal_GetEvent(uint32_t index);
+void FakeHal_SetSpiRxData(const uint8_t* data, uint16_t length);
+void FakeHal_CompleteSpiDma(void);
+void FakeHal_ErrorSpiDma(void);
+void FakeHal_FailSpiDmaStarts(uint8_t count);
+void FakeHal_UartDmaReceive(UART_HandleTypeDef* huart, const uint8_t* data, uint16_t length);
+void FakeHal_UartIdle(UART_HandleTypeDef* huart);
+void FakeHal_UartError(UART_HandleTypeDef* huart, uint32_t errorCode);
+void FakeHal_UartTxDmaError(UART_HandleTypeDef* huart);
+void FakeHal_AdcDmaConvert(ADC_HandleTypeDef* hadc, const uint16_t* data, uint16_t length);
+void FakeHal_AdcOverrun(ADC_HandleTypeDef* hadc);
+void FakeHal_DacDmaOutput(DAC_HandleTypeDef* hdac, uint32_t channel, uint16_t* output, uint16_t length);
+void FakeHal_SetPclkFreq(uint32_t pclk1, uint32_t pclk2);
+void FakeHal_SetSleepHook(void (*hook)(FakeHalCall call));
 
 #define UNUSED(X) (void)X      /* To avoid gcc/g++ warnings */
 
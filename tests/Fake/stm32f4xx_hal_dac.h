@@ -0,0 +1,7 @@
+#ifndef __STM32F4xx_HAL_DAC_H
+#define __STM32F4xx_HAL_DAC_H
+
+// Fake: DAC types and methods are declared in 'stm32f4xx_hal.h'.
+#include "stm32f4xx_hal.h"
+
+#endif  // __STM32F4xx_HAL_DAC_H
@@ -0,0 +1,7 @@
+#ifndef __STM32F4xx_HAL_TIM_H
+#define __STM32F4xx_HAL_TIM_H
+
+// Fake: TIM types and methods are declared in 'stm32f4xx_hal.h'.
+#include "stm32f4xx_hal.h"
+
+#endif  // __STM32F4xx_HAL_TIM_H
@@ -0,0 +1,50 @@
+#ifndef INC_TASK_H
+#define INC_TASK_H
+
+// Fake: heap_4.c suspends the scheduler around its list updates, there is
+// no scheduler and no interrupt to keep out. vTaskGetInfo() is implemented
+// by the test using it.
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+typedef enum
+{
+    eRunning = 0,
+    eReady,
+    eBlocked,
+    eSuspended,
+    eDeleted,
+    eInvalid
+} eTaskState;
+
+typedef struct xTASK_STATUS
+{
+    TaskHandle_t  xHandle;
+    const char*   pcTaskName;
+    UBaseType_t   xTaskNumber;
+    eTaskState    eCurrentState;
+    UBaseType_t   uxCurrentPriority;
+    UBaseType_t   uxBasePriority;
+    uint32_t      ulRunTimeCounter;
+    StackType_t*  pxStackBase;
+    uint16_t      usStackHighWaterMark;
+} TaskStatus_t;
+
+void vTaskGetInfo( TaskHandle_t xTask, TaskStatus_t* pxTaskStatus, BaseType_t xGetFreeStackSpace, eTaskState eState );
+
+static inline void       vTaskSuspendAll( void ) { }
+static inline BaseType_t xTaskResumeAll( void )  { return 0; }
+
+#define taskENTER_CRITICAL()
+#define taskEXIT_CRITICAL()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif  // INC_TASK_H
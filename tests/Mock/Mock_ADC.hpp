@@ -29,7 +29,7 @@ public:
 
     MOCK_METHOD1(GetValue, bool(uint16_t& value));
 
-    MOCK_METHOD1(GetValueInterrupt, bool(const std::function<void(uint16_t)>& handler));
+    MOCK_METHOD1(GetValueInterrupt, bool(const Delegate<void(uint16_t)>& handler));
 };
 
 
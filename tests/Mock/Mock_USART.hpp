@@ -36,11 +36,11 @@ public:
             .WillByDefault(Return(true));
     }
 
-    MOCK_METHOD3(WriteDMA, bool(const uint8_t* src, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD4(ReadDMA, bool(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true));
+    MOCK_METHOD3(WriteDMA, bool(const uint8_t* src, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD4(ReadDMA, bool(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true));
 
-    MOCK_METHOD3(WriteInterrupt, bool(const uint8_t* src, uint16_t length, const std::function<void()>& handler));
-    MOCK_METHOD4(ReadInterrupt, bool(uint8_t* dest, uint16_t length, const std::function<void(uint16_t)>& handler, bool useIdleDetection = true);
+    MOCK_METHOD3(WriteInterrupt, bool(const uint8_t* src, uint16_t length, const Delegate<void()>& handler));
+    MOCK_METHOD4(ReadInterrupt, bool(uint8_t* dest, uint16_t length, const Delegate<void(uint16_t)>& handler, bool useIdleDetection = true);
 
     MOCK_METHOD2(WriteBlocking, bool(const uint8_t* src, uint16_t length));
     MOCK_METHOD2(ReadBlocking, bool(uint8_t* dest, uint16_t length));
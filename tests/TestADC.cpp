@@ -0,0 +1,169 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/ADC/ADC.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+#include <vector>
+
+
+namespace {
+
+
+// Test fixture for Adc - scan of channels streamed by a circular DMA.
+class ADC_Test : public ::testing::Test
+{
+protected:
+    ADC_Test() :
+        mSubject(ADCInstance::ADC_1)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+
+        mDma.Instance  = &mDmaStream;
+        mDma.Init.Mode = DMA_CIRCULAR;
+    }
+
+    void InitScan()
+    {
+        EXPECT_TRUE(mSubject.Init(Adc::Config(10, { Adc::Channel::CHANNEL_1, Adc::Channel::CHANNEL_2 }, Adc::Trigger::TIMER_2_TRGO)));
+        mSubject.GetDmaHandle() = &mDma;
+    }
+
+    void StartStream()
+    {
+        InitScan();
+        EXPECT_TRUE(mSubject.StartStream(mBuffer, 8, [this](const uint16_t* block, uint16_t length) { this->mBlocks.emplace_back(block, block + length); }));
+    }
+
+    ADC_HandleTypeDef* Handle() { return const_cast<ADC_HandleTypeDef*>(mSubject.GetPeripheralHandle()); }
+
+    // Conversions 'first', 'first + 1', ... transferred by the DMA.
+    void Convert(uint16_t first, uint16_t length)
+    {
+        std::vector<uint16_t> data;
+        for (uint16_t i = 0; i < length; i++) { data.push_back(first + i); }
+        FakeHal_AdcDmaConvert(Handle(), data.data(), length);
+    }
+
+    std::vector<std::vector<uint16_t>> mBlocks;
+    uint16_t           mBuffer[8] = {};
+    DMA_Stream_TypeDef mDmaStream = {};
+    DMA_HandleTypeDef  mDma = {};
+    Adc                mSubject;
+};
+
+
+TEST_F(ADC_Test, Init_scan)
+{
+    InitScan();
+
+    const ADC_HandleTypeDef* handle = mSubject.GetPeripheralHandle();
+    EXPECT_EQ(ENABLE, handle->Init.ScanConvMode);
+    EXPECT_EQ(2, handle->Init.NbrOfConversion);
+    EXPECT_EQ(ADC_EXTERNALTRIGCONV_T2_TRGO, handle->Init.ExternalTrigConv);
+    EXPECT_EQ(ADC_EXTERNALTRIGCONVEDGE_RISING, handle->Init.ExternalTrigConvEdge);
+    EXPECT_EQ(2, mSubject.GetChannelCount());
+
+    // Channels configured in order of conversion
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_ADC_CONFIG_CHANNEL, FakeHal_GetEvent(0).call);
+    EXPECT_EQ(ADC_CHANNEL_1, FakeHal_GetEvent(0).value);
+    EXPECT_EQ(1, FakeHal_GetEvent(0).length);
+    EXPECT_EQ(ADC_CHANNEL_2, FakeHal_GetEvent(1).value);
+    EXPECT_EQ(2, FakeHal_GetEvent(1).length);
+
+    // Single conversions only for a single channel
+    uint16_t value = 0;
+    EXPECT_FALSE(mSubject.GetValue(value));
+}
+
+TEST_F(ADC_Test, StartStream_invalid)
+{
+    auto handler = [](const uint16_t*, uint16_t) { };
+
+    // Not initialized, no DMA linked
+    EXPECT_FALSE(mSubject.StartStream(mBuffer, 8, handler));
+    EXPECT_TRUE(mSubject.Init(Adc::Config(10, { Adc::Channel::CHANNEL_1, Adc::Channel::CHANNEL_2 }, Adc::Trigger::TIMER_2_TRGO)));
+    EXPECT_FALSE(mSubject.StartStream(mBuffer, 8, handler));
+
+    // Not circular, not whole scans per half
+    mSubject.GetDmaHandle() = &mDma;
+    mDma.Init.Mode = DMA_NORMAL;
+    EXPECT_FALSE(mSubject.StartStream(mBuffer, 8, handler));
+    mDma.Init.Mode = DMA_CIRCULAR;
+    EXPECT_FALSE(mSubject.StartStream(mBuffer, 6, handler));
+
+    EXPECT_TRUE(mSubject.StartStream(mBuffer, 8, handler));
+    EXPECT_FALSE(mSubject.StartStream(mBuffer, 8, handler));    // Already streaming
+}
+
+TEST_F(ADC_Test, Blocks_on_half_and_complete)
+{
+    StartStream();
+
+    const ADC_HandleTypeDef* handle = mSubject.GetPeripheralHandle();
+    EXPECT_EQ(ENABLE, handle->Init.DMAContinuousRequests);
+    EXPECT_EQ(DISABLE, handle->Init.ContinuousConvMode);        // Timer triggered
+    EXPECT_TRUE(mSubject.IsStreaming());
+
+    Convert(100, 3);
+    EXPECT_TRUE(mBlocks.empty());
+
+    Convert(103, 1);
+    ASSERT_EQ(1, mBlocks.size());
+    EXPECT_EQ(std::vector<uint16_t>({ 100, 101, 102, 103 }), mBlocks[0]);
+
+    // Second half, then wraps around to the first half
+    Convert(104, 8);
+    ASSERT_EQ(3, mBlocks.size());
+    EXPECT_EQ(std::vector<uint16_t>({ 104, 105, 106, 107 }), mBlocks[1]);
+    EXPECT_EQ(std::vector<uint16_t>({ 108, 109, 110, 111 }), mBlocks[2]);
+}
+
+TEST_F(ADC_Test, Software_trigger_converts_continuously)
+{
+    EXPECT_TRUE(mSubject.Init(Adc::Config(10, { Adc::Channel::CHANNEL_3 }, Adc::Trigger::SOFTWARE)));
+    mSubject.GetDmaHandle() = &mDma;
+    EXPECT_EQ(DISABLE, mSubject.GetPeripheralHandle()->Init.ContinuousConvMode);
+
+    EXPECT_TRUE(mSubject.StartStream(mBuffer, 8, nullptr));
+    EXPECT_EQ(ENABLE, mSubject.GetPeripheralHandle()->Init.ContinuousConvMode);
+
+    EXPECT_TRUE(mSubject.StopStream());
+    EXPECT_EQ(DISABLE, mSubject.GetPeripheralHandle()->Init.ContinuousConvMode);
+    EXPECT_EQ(DISABLE, mSubject.GetPeripheralHandle()->Init.DMAContinuousRequests);
+}
+
+TEST_F(ADC_Test, Overrun_restarts_stream)
+{
+    StartStream();
+
+    Convert(100, 2);
+    FakeHal_AdcOverrun(Handle());
+    EXPECT_EQ(1, mSubject.GetOverruns());
+
+    // Restarted at the start of the buffer
+    Convert(200, 4);
+    ASSERT_EQ(1, mBlocks.size());
+    EXPECT_EQ(std::vector<uint16_t>({ 200, 201, 202, 203 }), mBlocks[0]);
+}
+
+TEST_F(ADC_Test, StopStream)
+{
+    EXPECT_FALSE(mSubject.StopStream());
+
+    StartStream();
+    EXPECT_TRUE(mSubject.StopStream());
+    EXPECT_FALSE(mSubject.IsStreaming());
+    EXPECT_EQ(FAKE_HAL_ADC_STOP_DMA, FakeHal_GetEvent(FakeHal_GetEventCount() - 1).call);
+
+    // No more blocks
+    Convert(100, 8);
+    EXPECT_TRUE(mBlocks.empty());
+}
+
+
+} // namespace
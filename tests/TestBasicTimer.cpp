@@ -0,0 +1,34 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/BasicTimer/BasicTimer.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+TEST(BasicTimer_Test, Init_sample_rate)
+{
+    FakeHal_Reset();
+    BasicTimer subject(BasicTimerInstance::TIMER_6);
+    EXPECT_EQ(0.0f, subject.GetFrequency());
+
+    // TIM6 runs at twice PCLK1 (42 MHz): the exact DAC sample rate
+    EXPECT_TRUE(subject.Init(BasicTimer::Config(10, 48000.0f)));
+    EXPECT_EQ(0,               TIM6->PSC);
+    EXPECT_EQ(1749,            TIM6->ARR);
+    EXPECT_EQ(TIM_TRGO_UPDATE, TIM6->CR2 & TIM_CR2_MMS);
+    EXPECT_EQ(48000.0f,        subject.GetFrequency());
+
+    // Not reachable: stays uninitialized
+    EXPECT_FALSE(subject.Init(BasicTimer::Config(10, 0.0f)));
+    EXPECT_FALSE(subject.IsInit());
+    EXPECT_EQ(0.0f, subject.GetFrequency());
+}
+
+
+} // namespace
@@ -0,0 +1,251 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/BlockFilter/BlockFilter.hpp"
+
+// Supporting files
+#include <chrono>
+#include <cstdio>
+#include <vector>
+
+
+namespace {
+
+
+// Golden vectors: 2 channels, 16 scans of 12 bit samples. The expected
+// outputs are calculated with a reference implementation (direct
+// convolution with the impulse response, double precision integers).
+const std::vector<uint16_t> goldenInput =
+{
+     988, 1796, 1637, 3498,  543, 3757, 3357, 3930,  218, 4069, 2476, 1563, 1566,  607, 1299, 3696,
+    1657, 2924, 1277,   16, 4095, 2585, 2991, 3424, 2589, 2308, 2732, 3764, 1565,  514, 1067, 1350,
+};
+
+// Box-car, 1 extra bit: sums of 4 samples, shifted right 1
+const std::vector<uint16_t> goldenOversampler =
+{
+    3263, 6491, 2780, 4968, 5010, 4475, 3977, 3968,
+};
+
+// CIC, order 3, decimation 4, 2 extra bits
+const std::vector<uint16_t> goldenCic =
+{
+    1543, 3384, 5758, 12099, 6911, 9234, 10078, 9379,
+};
+
+// FIR, 5 taps (gain 1.0), decimation 2, 1 extra bit
+const int16_t firCoefficients[] = { -2048, 10240, 16384, 10240, -2048 };
+
+const std::vector<uint16_t> goldenFir =
+{
+     413,  685, 2174, 6477, 3319, 8189, 3009, 3532, 2844, 5706, 4336, 2569, 6667, 6010, 4821, 4931,
+};
+
+
+// Process 'input' in blocks of 'scans' scans, returns all outputs.
+std::vector<uint16_t> ProcessInBlocks(BlockFilter& filter, const std::vector<uint16_t>& input, uint16_t scans)
+{
+    const uint16_t length = scans * filter.GetChannelCount();
+    std::vector<uint16_t> result;
+    std::vector<uint16_t> output(filter.GetOutputSize(length));
+
+    for (size_t offset = 0; offset < input.size(); offset += length)
+    {
+        const uint16_t written = filter.Process(&input[offset], length, output.data(), static_cast<uint16_t>(output.size()));
+        result.insert(result.end(), output.begin(), output.begin() + written);
+    }
+    return result;
+}
+
+
+TEST(BlockFilter_Test, Oversampler_golden)
+{
+    Oversampler filter;
+    ASSERT_TRUE(filter.Init(2, 1));
+    EXPECT_EQ(4, filter.GetDecimation());
+
+    EXPECT_EQ(goldenOversampler, ProcessInBlocks(filter, goldenInput, 16));
+}
+
+TEST(BlockFilter_Test, Cic_golden)
+{
+    CicDecimator filter;
+    ASSERT_TRUE(filter.Init(2, 3, 2, 2));
+    EXPECT_EQ(4, filter.GetDecimation());
+
+    EXPECT_EQ(goldenCic, ProcessInBlocks(filter, goldenInput, 16));
+}
+
+TEST(BlockFilter_Test, Fir_golden)
+{
+    FirDecimator filter;
+    ASSERT_TRUE(filter.Init(2, firCoefficients, 5, 2, 1));
+
+    EXPECT_EQ(goldenFir, ProcessInBlocks(filter, goldenInput, 16));
+}
+
+// The state carries over: the output does not depend on the block size.
+TEST(BlockFilter_Test, Any_block_size)
+{
+    Oversampler  oversampler;
+    CicDecimator cic;
+    FirDecimator fir;
+
+    for (uint16_t scans : { 1, 2, 3, 5, 8 })
+    {
+        SCOPED_TRACE(::testing::Message() << scans << " scans per block");
+
+        const std::vector<uint16_t> input(goldenInput.begin(), goldenInput.begin() + ((16 / scans) * scans * 2));
+        const size_t total   = input.size() / 2;        // Scans
+        const size_t outputs = (total / 4) * 2;         // Decimation 4, 2 channels
+
+        ASSERT_TRUE(oversampler.Init(2, 1));
+        ASSERT_TRUE(cic.Init(2, 3, 2, 2));
+        ASSERT_TRUE(fir.Init(2, firCoefficients, 5, 2, 1));
+
+        EXPECT_EQ(std::vector<uint16_t>(goldenOversampler.begin(), goldenOversampler.begin() + outputs), ProcessInBlocks(oversampler, input, scans));
+        EXPECT_EQ(std::vector<uint16_t>(goldenCic.begin(), goldenCic.begin() + outputs), ProcessInBlocks(cic, input, scans));
+        EXPECT_EQ(std::vector<uint16_t>(goldenFir.begin(), goldenFir.begin() + ((total / 2) * 2)), ProcessInBlocks(fir, input, scans));
+    }
+}
+
+// Full scale input with the maximum extra bits and growth: no overflow.
+TEST(BlockFilter_Test, Full_scale)
+{
+    const std::vector<uint16_t> input(1024, 4095);
+    const int16_t unity[] = { 16384, 16384 };
+
+    Oversampler oversampler;
+    ASSERT_TRUE(oversampler.Init(1, 4));
+    EXPECT_EQ(std::vector<uint16_t>(4, 65520), ProcessInBlocks(oversampler, input, 256));
+
+    CicDecimator cic;
+    ASSERT_TRUE(cic.Init(1, 4, 5, 4));
+    const std::vector<uint16_t> output = ProcessInBlocks(cic, input, 256);
+    ASSERT_EQ(32, output.size());
+    EXPECT_EQ(65520, output.back());                // Settled after order outputs
+
+    FirDecimator fir;
+    ASSERT_TRUE(fir.Init(1, unity, 2, 1, 4));
+    EXPECT_EQ(65520, ProcessInBlocks(fir, input, 256).back());
+}
+
+TEST(BlockFilter_Test, Fir_full_scale_16_bit_input)
+{
+    // Unity gain: after the 5 taps the output equals the input, also at
+    // and above mid-scale (which is negative as int16_t).
+    FirDecimator fir;
+    ASSERT_TRUE(fir.Init(1, firCoefficients, 5, 1, 0));
+
+    for (uint16_t value : { 0x0000, 0x7FFF, 0x8000, 0xC000, 0xFFFF })
+    {
+        fir.Reset();
+        EXPECT_EQ(value, ProcessInBlocks(fir, std::vector<uint16_t>(8, value), 8).back());
+    }
+
+    // A 16 bit oversampler output chained into the FIR
+    Oversampler oversampler;
+    ASSERT_TRUE(oversampler.Init(1, 4));
+    ASSERT_TRUE(fir.Init(1, firCoefficients, 5, 2, 0));
+
+    const std::vector<uint16_t> oversampled = ProcessInBlocks(oversampler, std::vector<uint16_t>(2048, 4095), 256);
+    ASSERT_EQ(8, oversampled.size());
+    EXPECT_EQ(65520, oversampled.back());
+    EXPECT_EQ(65520, ProcessInBlocks(fir, oversampled, 4).back());      // Settled after the 5 taps
+}
+
+TEST(BlockFilter_Test, Init_invalid)
+{
+    Oversampler  oversampler;
+    CicDecimator cic;
+    FirDecimator fir;
+    const int16_t loud[] = { 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767,
+                             32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767, 32767 };
+
+    EXPECT_FALSE(oversampler.Init(0, 1));
+    EXPECT_FALSE(oversampler.Init(BLOCK_FILTER_MAX_CHANNELS + 1, 1));
+    EXPECT_FALSE(oversampler.Init(1, 0));
+    EXPECT_FALSE(oversampler.Init(1, BLOCK_FILTER_MAX_EXTRA_BITS + 1));
+
+    EXPECT_FALSE(cic.Init(1, 0, 2, 0));
+    EXPECT_FALSE(cic.Init(1, BLOCK_FILTER_MAX_CIC_ORDER + 1, 2, 0));
+    EXPECT_FALSE(cic.Init(1, 4, 6, 0));             // Growth beyond 32 bit registers
+    EXPECT_FALSE(cic.Init(1, 1, 2, 3));             // More extra bits than growth
+
+    EXPECT_FALSE(fir.Init(1, nullptr, 5, 2, 0));
+    EXPECT_FALSE(fir.Init(1, firCoefficients, 0, 2, 0));
+    EXPECT_FALSE(fir.Init(1, firCoefficients, 5, 0, 0));
+    EXPECT_FALSE(fir.Init(1, loud, 17, 1, 0));      // Gain above 16.0
+
+    // A failed Init leaves the filter uninitialized
+    ASSERT_TRUE(fir.Init(1, firCoefficients, 5, 2, 0));
+    EXPECT_FALSE(fir.Init(1, firCoefficients, 5, 2, BLOCK_FILTER_MAX_EXTRA_BITS + 1));
+    EXPECT_EQ(0, fir.GetChannelCount());
+}
+
+TEST(BlockFilter_Test, Process_invalid)
+{
+    Oversampler filter;
+    uint16_t output[8] = {};
+
+    EXPECT_EQ(0, filter.Process(goldenInput.data(), 16, output, 8));    // Not initialized
+
+    ASSERT_TRUE(filter.Init(2, 1));
+    EXPECT_EQ(0, filter.Process(goldenInput.data(), 15, output, 8));    // Not whole scans
+    EXPECT_EQ(0, filter.Process(goldenInput.data(), 32, output, 3));    // Output too small
+    EXPECT_EQ(0, filter.Process(nullptr, 16, output, 8));
+    EXPECT_EQ(8, filter.GetOutputSize(32));
+    EXPECT_EQ(4, filter.Process(goldenInput.data(), 16, output, 4));
+
+    // Partial sums cleared
+    filter.Reset();
+    EXPECT_EQ(0, filter.Process(goldenInput.data(), 6, output, 8));
+    EXPECT_EQ(2, filter.Process(goldenInput.data() + 6, 2, output, 8));
+}
+
+// Host side benchmark: the filters on blocks of 2 channels, as from the ADC.
+// Prints the time per input sample, does not fail on timing. Disabled: run
+// with --gtest_also_run_disabled_tests.
+TEST(BlockFilter_Test, DISABLED_Benchmark)
+{
+    static constexpr uint32_t ROUNDS = 2000;
+    static constexpr uint16_t BLOCK  = 512;
+
+    std::vector<uint16_t> input(BLOCK);
+    for (uint16_t i = 0; i < BLOCK; i++) { input[i] = goldenInput[i % goldenInput.size()]; }
+    uint16_t output[BLOCK];
+
+    const int16_t lowPass[BLOCK_FILTER_MAX_TAPS] = {
+          -64,  -96,  -64,   64,  320,  640,  960, 1216, 1408, 1536, 1664, 1792, 1856, 1920, 1984, 2048,
+         2048, 1984, 1920, 1856, 1792, 1664, 1536, 1408, 1216,  960,  640,  320,   64,  -64,  -96,  -64 };
+
+    Oversampler  oversampler;
+    CicDecimator cic;
+    FirDecimator fir;
+    ASSERT_TRUE(oversampler.Init(2, 2));
+    ASSERT_TRUE(cic.Init(2, 3, 4, 2));
+    ASSERT_TRUE(fir.Init(2, lowPass, BLOCK_FILTER_MAX_TAPS, 16, 2));
+
+    volatile uint32_t sink = 0;
+    BlockFilter* filters[] = { &oversampler, &cic, &fir };
+    double ns[3];
+
+    for (size_t f = 0; f < 3; f++)
+    {
+        const auto start = std::chrono::steady_clock::now();
+        for (uint32_t r = 0; r < ROUNDS; r++)
+        {
+            sink = sink + filters[f]->Process(input.data(), BLOCK, output, BLOCK);
+        }
+        const auto end = std::chrono::steady_clock::now();
+        ns[f] = std::chrono::duration<double, std::nano>(end - start).count() / (static_cast<double>(ROUNDS) * BLOCK);
+    }
+
+    std::printf("[ BENCH    ] box-car: %.2f ns/sample, CIC: %.2f ns/sample, FIR %u taps: %.2f ns/sample\n",
+                ns[0], ns[1], BLOCK_FILTER_MAX_TAPS, ns[2]);
+    EXPECT_GT(sink, 0);
+}
+
+
+} // namespace
@@ -0,0 +1,240 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/CircularFifo/CircularFifo.hpp"
+
+// Supporting files
+#include <chrono>
+#include <cstdint>
+#include <cstdio>
+#include <thread>
+
+
+namespace {
+
+
+TEST(CircularFifo_Test, Push_pop)
+{
+    CircularFifo<uint32_t, 4> fifo;
+    uint32_t item = 0;
+
+    EXPECT_TRUE(fifo.isLockFree());
+    EXPECT_TRUE(fifo.empty());
+    EXPECT_FALSE(fifo.pop(item));
+    EXPECT_FALSE(fifo.peek(item));
+
+    // All 'Size' elements can be used
+    for (uint32_t i = 0; i < 4; i++) { EXPECT_TRUE(fifo.push(i)); }
+    EXPECT_TRUE(fifo.full());
+    EXPECT_EQ(4, fifo.size());
+    EXPECT_FALSE(fifo.push(4));
+
+    EXPECT_TRUE(fifo.peek(item));
+    EXPECT_EQ(0, item);
+    EXPECT_TRUE(fifo.pop(item));
+    EXPECT_EQ(0, item);
+
+    // Wraps around
+    EXPECT_TRUE(fifo.push(4));
+    for (uint32_t i = 1; i < 5; i++)
+    {
+        EXPECT_TRUE(fifo.pop(item));
+        EXPECT_EQ(i, item);
+    }
+    EXPECT_TRUE(fifo.empty());
+}
+
+TEST(CircularFifo_Test, Push_n_pop_n)
+{
+    CircularFifo<uint8_t, 8> fifo;
+    const uint8_t src[16] = { 0, 1, 2, 3, 4, 5, 6, 7, 8, 9, 10, 11, 12, 13, 14, 15 };
+    uint8_t dest[10] = {};
+
+    EXPECT_EQ(5, fifo.push_n(src, 5));
+    EXPECT_EQ(3, fifo.pop_n(dest, 3));
+    EXPECT_EQ(0, dest[0]);
+    EXPECT_EQ(2, dest[2]);
+
+    // Only the free space is used, wrapping around the end
+    EXPECT_EQ(6, fifo.push_n(&src[5], 10));
+    EXPECT_TRUE(fifo.full());
+
+    EXPECT_EQ(8, fifo.pop_n(dest, 10));
+    for (uint8_t i = 0; i < 8; i++) { EXPECT_EQ(i + 3, dest[i]); }
+
+    EXPECT_EQ(0, fifo.pop_n(dest, 10));
+    EXPECT_EQ(0, fifo.push_n(src, 0));
+}
+
+TEST(CircularFifo_Test, Acquire_spans)
+{
+    CircularFifo<uint16_t, 8> fifo;
+    uint16_t* write = nullptr;
+    const uint16_t* read = nullptr;
+
+    EXPECT_EQ(0, fifo.read_acquire(read));
+
+    // Fill in place (as done by DMA)
+    ASSERT_EQ(8, fifo.write_acquire(write));
+    for (uint16_t i = 0; i < 6; i++) { write[i] = i; }
+    fifo.write_commit(6);
+
+    ASSERT_EQ(6, fifo.read_acquire(read));
+    EXPECT_EQ(5, read[5]);
+    fifo.read_release(4);
+
+    // Free space wraps: only the part until the end is contiguous
+    ASSERT_EQ(2, fifo.write_acquire(write));
+    write[0] = 6;
+    write[1] = 7;
+    fifo.write_commit(2);
+
+    ASSERT_EQ(4, fifo.write_acquire(write));
+    write[0] = 8;
+    fifo.write_commit(1);
+
+    ASSERT_EQ(4, fifo.read_acquire(read));
+    EXPECT_EQ(4, read[0]);
+    fifo.read_release(4);
+
+    ASSERT_EQ(1, fifo.read_acquire(read));
+    EXPECT_EQ(8, read[0]);
+    fifo.read_release(1);
+    EXPECT_TRUE(fifo.empty());
+}
+
+TEST(CircularFifo_Test, Clear)
+{
+    CircularFifo<uint32_t, 4> fifo;
+    uint32_t item = 0;
+
+    fifo.push(1);
+    fifo.push(2);
+    fifo.clear();
+
+    EXPECT_TRUE(fifo.empty());
+    EXPECT_FALSE(fifo.pop(item));
+    EXPECT_TRUE(fifo.push(3));
+    EXPECT_TRUE(fifo.pop(item));
+    EXPECT_EQ(3, item);
+}
+
+// Producer and consumer threads, mixing the single, bulk and in place methods.
+// Build with TESTS_WITH_TSAN to have ThreadSanitizer check the synchronization.
+TEST(CircularFifo_Test, Stress_two_threads)
+{
+    static constexpr uint32_t COUNT = 1000000;
+
+    CircularFifo<uint32_t, 64> fifo;
+    bool inOrder = true;
+
+    std::thread consumer([&fifo, &inOrder]() {
+        uint32_t expected = 0;
+        uint32_t buffer[16];
+        uint32_t item;
+
+        while (expected < COUNT)
+        {
+            if (fifo.empty()) { std::this_thread::yield(); }
+
+            switch (expected % 3)
+            {
+                case 0:
+                    if (fifo.pop(item)) { inOrder &= (item == expected++); }
+                    break;
+                case 1:
+                {
+                    const size_t n = fifo.pop_n(buffer, 16);
+                    for (size_t i = 0; i < n; i++) { inOrder &= (buffer[i] == expected++); }
+                    break;
+                }
+                default:
+                {
+                    const uint32_t* span = nullptr;
+                    const size_t n = fifo.read_acquire(span);
+                    for (size_t i = 0; i < n; i++) { inOrder &= (span[i] == expected++); }
+                    fifo.read_release(n);
+                    break;
+                }
+            }
+        }
+    });
+
+    uint32_t next = 0;
+    uint32_t buffer[16];
+    while (next < COUNT)
+    {
+        if (fifo.full()) { std::this_thread::yield(); }
+
+        switch (next % 3)
+        {
+            case 0:
+                if (fifo.push(next)) { next++; }
+                break;
+            case 1:
+            {
+                const uint32_t n = (COUNT - next < 16) ? (COUNT - next) : 16;
+                for (uint32_t i = 0; i < n; i++) { buffer[i] = next + i; }
+                next += fifo.push_n(buffer, n);
+                break;
+            }
+            default:
+            {
+                uint32_t* span = nullptr;
+                size_t n = fifo.write_acquire(span);
+                if (n > COUNT - next) { n = COUNT - next; }
+                for (size_t i = 0; i < n; i++) { span[i] = next + i; }
+                fifo.write_commit(n);
+                next += n;
+                break;
+            }
+        }
+    }
+
+    consumer.join();
+
+    EXPECT_TRUE(inOrder);
+    EXPECT_TRUE(fifo.empty());
+}
+
+// Host side benchmark: single element versus bulk transfers, in one thread.
+// Prints the time per element, does not fail on timing. Disabled: run with
+// --gtest_also_run_disabled_tests.
+TEST(CircularFifo_Test, DISABLED_Benchmark)
+{
+    static constexpr uint32_t ROUNDS = 20000;
+    static constexpr size_t   BLOCK  = 64;
+
+    CircularFifo<uint8_t, 256> fifo;
+    uint8_t src[BLOCK] = {};
+    uint8_t dest[BLOCK];
+    volatile uint32_t sink = 0;
+
+    const auto startSingle = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < ROUNDS; r++)
+    {
+        for (size_t i = 0; i < BLOCK; i++) { fifo.push(src[i]); }
+        for (size_t i = 0; i < BLOCK; i++) { fifo.pop(dest[i]); }
+        sink = sink + dest[r % BLOCK];
+    }
+    const auto startBulk = std::chrono::steady_clock::now();
+    for (uint32_t r = 0; r < ROUNDS; r++)
+    {
+        fifo.push_n(src, BLOCK);
+        fifo.pop_n(dest, BLOCK);
+        sink = sink + dest[r % BLOCK];
+    }
+    const auto end = std::chrono::steady_clock::now();
+
+    const double count = static_cast<double>(ROUNDS) * BLOCK;
+    const double nsSingle = std::chrono::duration<double, std::nano>(startBulk - startSingle).count() / count;
+    const double nsBulk   = std::chrono::duration<double, std::nano>(end - startBulk).count() / count;
+
+    std::printf("[ BENCH    ] push/pop: %.2f ns/element, push_n/pop_n: %.2f ns/element\n", nsSingle, nsBulk);
+    RecordProperty("ns_per_element_single", std::to_string(nsSingle));
+    RecordProperty("ns_per_element_bulk",   std::to_string(nsBulk));
+}
+
+
+} // namespace
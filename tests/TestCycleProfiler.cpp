@@ -0,0 +1,179 @@
+#include "gtest/gtest.h"
+
+
+// Test subject, with the driver zones
+#define PROFILE_DRIVERS
+#include "utility/CycleProfiler/CycleProfiler.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+// Fixture, the fake DWT cycle counter is set by hand: it serves as clock.
+class CycleProfiler_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        FakeHal_Reset();
+        ASSERT_TRUE(CycleProfiler::Init());
+    }
+
+    void Measure(uint8_t zone, uint32_t cycles)
+    {
+        ProfileScope scope(zone);
+        DWT->CYCCNT += cycles;
+    }
+
+    // As inside a driver: the zone registers at its first use.
+    void DriverZone(uint32_t cycles)
+    {
+        PROFILE_DRIVER_SCOPE("Driver");
+        DWT->CYCCNT += cycles;
+    }
+};
+
+
+TEST_F(CycleProfiler_Test, Init)
+{
+    EXPECT_TRUE(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+    EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+    EXPECT_EQ(0, CycleProfiler::GetOverhead());
+    EXPECT_EQ(0, CycleProfiler::GetZoneCount());
+}
+
+TEST_F(CycleProfiler_Test, Register)
+{
+    static const char* names[PROFILER_MAX_ZONES + 1] = {
+        "0", "1", "2", "3", "4", "5", "6", "7", "8", "9", "10", "11", "12", "13", "14", "15", "16"
+    };
+
+    EXPECT_EQ(PROFILER_INVALID_ZONE, CycleProfiler::Register(nullptr));
+
+    for (uint8_t i = 0; i < PROFILER_MAX_ZONES; i++)
+    {
+        EXPECT_EQ(i, CycleProfiler::Register(names[i]));
+    }
+
+    // Same name gives the same id, table full gives an invalid id
+    EXPECT_EQ(3, CycleProfiler::Register(names[3]));
+    EXPECT_EQ(PROFILER_INVALID_ZONE, CycleProfiler::Register(names[PROFILER_MAX_ZONES]));
+    EXPECT_EQ(PROFILER_MAX_ZONES, CycleProfiler::GetZoneCount());
+
+    // Measurements on an invalid zone are ignored
+    CycleProfiler::Record(PROFILER_INVALID_ZONE, 100);
+    ProfilerZoneStats stats;
+    EXPECT_FALSE(CycleProfiler::GetStatistics(PROFILER_INVALID_ZONE, stats));
+}
+
+TEST_F(CycleProfiler_Test, Driver_scope)
+{
+    CycleProfiler::Register("Application");
+
+    DriverZone(100);
+    DriverZone(300);
+    EXPECT_EQ(2, CycleProfiler::GetZoneCount());
+
+    ProfilerZoneStats stats;
+    ASSERT_TRUE(CycleProfiler::GetStatistics(1, stats));
+    EXPECT_STREQ("Driver", stats.name);
+    EXPECT_EQ(2, stats.count);
+    EXPECT_EQ(200, stats.mean);
+
+    // Init() removes the zones: registered anew at the next use
+    ASSERT_TRUE(CycleProfiler::Init());
+    CycleProfiler::Register("Other");
+    CycleProfiler::Register("Application");
+
+    DriverZone(50);
+    EXPECT_EQ(3, CycleProfiler::GetZoneCount());
+    ASSERT_TRUE(CycleProfiler::GetStatistics(2, stats));
+    EXPECT_STREQ("Driver", stats.name);
+    EXPECT_EQ(1, stats.count);
+    EXPECT_EQ(50, stats.mean);
+}
+
+TEST_F(CycleProfiler_Test, Scope_statistics)
+{
+    const uint8_t zone = CycleProfiler::Register("Spi");
+    ProfilerZoneStats stats;
+
+    ASSERT_TRUE(CycleProfiler::GetStatistics(zone, stats));
+    EXPECT_STREQ("Spi", stats.name);
+    EXPECT_EQ(0, stats.count);
+    EXPECT_EQ(0, stats.min);
+    EXPECT_EQ(0, stats.mean);
+
+    Measure(zone, 100);
+    Measure(zone, 300);
+    Measure(zone, 200);
+
+    ASSERT_TRUE(CycleProfiler::GetStatistics(zone, stats));
+    EXPECT_EQ(3, stats.count);
+    EXPECT_EQ(100, stats.min);
+    EXPECT_EQ(300, stats.max);
+    EXPECT_EQ(200, stats.mean);
+    EXPECT_EQ(600, stats.total);
+}
+
+TEST_F(CycleProfiler_Test, Histogram)
+{
+    const uint8_t zone = CycleProfiler::Register("Histogram");
+    ProfilerZoneStats stats;
+
+    CycleProfiler::Record(zone, 0);
+    CycleProfiler::Record(zone, PROFILER_HISTOGRAM_BASE - 1);
+    CycleProfiler::Record(zone, PROFILER_HISTOGRAM_BASE);
+    CycleProfiler::Record(zone, PROFILER_HISTOGRAM_BASE * 2 - 1);
+    CycleProfiler::Record(zone, PROFILER_HISTOGRAM_BASE * 2);
+    CycleProfiler::Record(zone, PROFILER_HISTOGRAM_BASE * 8);
+    CycleProfiler::Record(zone, UINT32_MAX);
+
+    ASSERT_TRUE(CycleProfiler::GetStatistics(zone, stats));
+    EXPECT_EQ(2, stats.histogram[0]);
+    EXPECT_EQ(2, stats.histogram[1]);
+    EXPECT_EQ(1, stats.histogram[2]);
+    EXPECT_EQ(1, stats.histogram[4]);
+    EXPECT_EQ(1, stats.histogram[PROFILER_HISTOGRAM_BINS - 1]);
+}
+
+TEST_F(CycleProfiler_Test, Enter_exit)
+{
+    const uint8_t isr = CycleProfiler::Register("ISR");
+    ProfilerZoneStats stats;
+
+    // Counter wraps during the zone
+    DWT->CYCCNT = UINT32_MAX - 10;
+    CycleProfiler::Enter(isr);
+    DWT->CYCCNT += 50;
+    CycleProfiler::Exit(isr);
+
+    ASSERT_TRUE(CycleProfiler::GetStatistics(isr, stats));
+    EXPECT_EQ(1, stats.count);
+    EXPECT_EQ(50, stats.max);
+}
+
+TEST_F(CycleProfiler_Test, Reset)
+{
+    const uint8_t zone = CycleProfiler::Register("Reset");
+    ProfilerZoneStats stats;
+
+    Measure(zone, 40);
+    CycleProfiler::Reset();
+
+    EXPECT_EQ(1, CycleProfiler::GetZoneCount());
+    ASSERT_TRUE(CycleProfiler::GetStatistics(zone, stats));
+    EXPECT_EQ(0, stats.count);
+    EXPECT_EQ(0, stats.max);
+    EXPECT_EQ(0, stats.histogram[1]);
+
+    Measure(zone, 20);
+    ASSERT_TRUE(CycleProfiler::GetStatistics(zone, stats));
+    EXPECT_EQ(20, stats.min);
+}
+
+
+} // namespace
@@ -0,0 +1,135 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/DAC/DAC.hpp"
+
+// Supporting files
+#include "utility/Dds/Dds.hpp"
+#include "stm32f4xx_hal.h"
+#include <vector>
+
+
+namespace {
+
+
+// Test fixture for Dac streaming - channel 1 on a circular DMA, the output
+// read back through the fake DMA.
+class Dac_Stream_Test : public ::testing::Test
+{
+protected:
+    Dac_Stream_Test()
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+
+        mDma.Instance  = &mDmaStream;
+        mDma.Init.Mode = DMA_CIRCULAR;
+    }
+
+    bool StartStream(Dac& subject, uint16_t length)
+    {
+        EXPECT_TRUE(subject.Init());
+        EXPECT_TRUE(subject.ConfigureChannel(Dac::Channel::CHANNEL_1, Dac::ChannelConfig(Dac::Precision::_12_BIT_R, Dac::Trigger::TIMER_6)));
+        subject.GetDmaChannel1Handle() = &mDma;
+        return subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, length, [this](uint16_t* block, uint16_t length)
+        {
+            for (uint16_t i = 0; i < length; i++) { block[i] = mNext++; }
+            this->mBlocks++;
+        });
+    }
+
+    std::vector<uint16_t> Output(Dac& subject, uint16_t length)
+    {
+        std::vector<uint16_t> output(length);
+        FakeHal_DacDmaOutput(const_cast<DAC_HandleTypeDef*>(subject.GetPeripheralHandle()), DAC_CHANNEL_1, output.data(), length);
+        return output;
+    }
+
+    uint16_t            mNext = 0;
+    uint32_t            mBlocks = 0;
+    uint16_t            mBuffer[8] = {};
+    DMA_Stream_TypeDef  mDmaStream = {};
+    DMA_HandleTypeDef   mDma = {};
+};
+
+
+TEST_F(Dac_Stream_Test, StartStream_invalid)
+{
+    Dac subject;
+    auto handler = [](uint16_t*, uint16_t) { };
+
+    // Not initialized, no DMA linked
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, handler));
+    EXPECT_TRUE(subject.Init());
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, handler));
+
+    // Normal mode DMA, odd length, no buffer
+    subject.GetDmaChannel1Handle() = &mDma;
+    mDma.Init.Mode = DMA_NORMAL;
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, handler));
+    mDma.Init.Mode = DMA_CIRCULAR;
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 7, handler));
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, nullptr, 8, handler));
+
+    EXPECT_TRUE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, handler));
+    EXPECT_FALSE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, handler));   // Already streaming
+    EXPECT_FALSE(subject.IsStreaming(Dac::Channel::CHANNEL_2));
+}
+
+TEST_F(Dac_Stream_Test, Stream_refills_halves)
+{
+    Dac subject;
+    ASSERT_TRUE(StartStream(subject, 8));
+    EXPECT_TRUE(subject.IsStreaming(Dac::Channel::CHANNEL_1));
+
+    // Both halves filled before the DMA starts
+    EXPECT_EQ(2, mBlocks);
+    const uint32_t count = FakeHal_GetEventCount();
+    EXPECT_EQ(FAKE_HAL_DAC_START_DMA, FakeHal_GetEvent(count - 1).call);
+    EXPECT_EQ(8,                      FakeHal_GetEvent(count - 1).length);
+
+    // Each half output is refilled: an endless sequence
+    std::vector<uint16_t> expected;
+    for (uint16_t i = 0; i < 24; i++) { expected.push_back(i); }
+    EXPECT_EQ(expected, Output(subject, 24));
+    EXPECT_EQ(2 + 6, mBlocks);
+
+    EXPECT_TRUE(subject.StopStream(Dac::Channel::CHANNEL_1));
+    EXPECT_FALSE(subject.IsStreaming(Dac::Channel::CHANNEL_1));
+    EXPECT_EQ(FAKE_HAL_DAC_STOP_DMA, FakeHal_GetEvent(FakeHal_GetEventCount() - 1).call);
+    EXPECT_FALSE(subject.StopStream(Dac::Channel::CHANNEL_1));
+
+    // No refills after the stream stopped
+    Output(subject, 8);
+    EXPECT_EQ(2 + 6, mBlocks);
+}
+
+// A Dds as handler: a continuous sine across the block boundaries.
+TEST_F(Dac_Stream_Test, Stream_Dds)
+{
+    Dds dds;
+    ASSERT_TRUE(dds.Init(48000.0f));
+    ASSERT_TRUE(dds.SetFrequency(12000.0f));        // 2048, 4095, 2048, 1, ...
+
+    Dac subject;
+    ASSERT_TRUE(subject.Init());
+    subject.GetDmaChannel1Handle() = &mDma;
+    ASSERT_TRUE(subject.StartStream(Dac::Channel::CHANNEL_1, mBuffer, 8, [&dds](uint16_t* block, uint16_t length) { dds.Fill(block, length); }));
+
+    Output(subject, 4);                             // Fade in
+    const std::vector<uint16_t> output = Output(subject, 12);
+    for (uint16_t i = 0; i < 12; i += 4)
+    {
+        EXPECT_EQ(2048, output[i + 0]);
+        EXPECT_EQ(4095, output[i + 1]);
+        EXPECT_EQ(2048, output[i + 2]);
+        EXPECT_EQ(1,    output[i + 3]);
+    }
+
+    EXPECT_TRUE(subject.Sleep());
+    EXPECT_FALSE(subject.IsStreaming(Dac::Channel::CHANNEL_1));
+}
+
+
+} // namespace
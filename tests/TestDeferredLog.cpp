@@ -0,0 +1,164 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/DeferredLog/DeferredLog.h"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+#include <atomic>
+#include <cstring>
+#include <thread>
+#include <vector>
+
+
+namespace {
+
+
+// Fixture, the fake DWT cycle counter is the timestamp.
+class DeferredLog_Test : public ::testing::Test
+{
+protected:
+    void SetUp() override
+    {
+        FakeHal_Reset();
+        DeferredLog::Init();
+    }
+};
+
+
+TEST_F(DeferredLog_Test, Record_and_read_in_order)
+{
+    DeferredLogEntry entry = {};
+    EXPECT_FALSE(DeferredLog::Read(entry));
+
+    DWT->CYCCNT = 100;
+    DEFERRED_LOG("start");
+    DWT->CYCCNT = 200;
+    DEFERRED_LOG("value %u of %u", 3, 7);
+    EXPECT_EQ(2, DeferredLog::GetPending());
+
+    ASSERT_TRUE(DeferredLog::Read(entry));
+    EXPECT_STREQ("start", entry.site->text);
+    EXPECT_EQ(100, entry.timestamp);
+    EXPECT_EQ(0, entry.args[0]);
+
+    ASSERT_TRUE(DeferredLog::Read(entry));
+    EXPECT_EQ(DEFERRED_LOG_TEXT, entry.site->kind);
+    EXPECT_EQ(200, entry.timestamp);
+    EXPECT_EQ(3, entry.args[0]);
+    EXPECT_EQ(7, entry.args[1]);
+
+    EXPECT_FALSE(DeferredLog::Read(entry));
+    EXPECT_EQ(0, DeferredLog::GetPending());
+}
+
+TEST_F(DeferredLog_Test, Same_site_same_id)
+{
+    DeferredLogEntry first  = {};
+    DeferredLogEntry second = {};
+
+    for (uint32_t i = 0; i < 2; i++) { DEFERRED_LOG("loop %u", i); }
+    ASSERT_TRUE(DeferredLog::Read(first));
+    ASSERT_TRUE(DeferredLog::Read(second));
+
+    EXPECT_EQ(first.site, second.site);
+    EXPECT_EQ(1, second.args[0]);
+}
+
+TEST_F(DeferredLog_Test, Full_ring_drops_new_entries)
+{
+    for (uint32_t i = 0; i < DEFERRED_LOG_SIZE + 3; i++) { DEFERRED_LOG("entry %u", i); }
+    EXPECT_EQ(DEFERRED_LOG_SIZE, DeferredLog::GetPending());
+    EXPECT_EQ(3, DeferredLog::GetDropped());
+
+    // Oldest entries kept, room again after reading
+    DeferredLogEntry entry = {};
+    ASSERT_TRUE(DeferredLog::Read(entry));
+    EXPECT_EQ(0, entry.args[0]);
+    DEFERRED_LOG("entry %u", 99);
+    EXPECT_EQ(3, DeferredLog::GetDropped());
+
+    uint32_t last = 0;
+    while (DeferredLog::Read(entry)) { last = entry.args[0]; }
+    EXPECT_EQ(99, last);
+}
+
+TEST_F(DeferredLog_Test, Format)
+{
+    static const DeferredLogSite expect = { "length > 0", "SPI.cpp", 42, DEFERRED_LOG_EXPECT };
+    static const DeferredLogSite text   = { "busy %u, pending %x", "Usart.cpp", 7, DEFERRED_LOG_TEXT };
+    DeferredLogEntry entry = { &expect, 0, { 0, 0 } };
+    char buffer[80];
+
+    EXPECT_EQ(std::strlen("EXPECT: [length > 0], line: [42], file: [SPI.cpp]"), DeferredLog::Format(entry, buffer, sizeof(buffer)));
+    EXPECT_STREQ("EXPECT: [length > 0], line: [42], file: [SPI.cpp]", buffer);
+
+    entry = { &text, 0, { 1, 0x1F } };
+    DeferredLog::Format(entry, buffer, sizeof(buffer));
+    EXPECT_STREQ("busy 1, pending 1f, line: [7], file: [Usart.cpp]", buffer);
+
+    // Truncated, still terminated
+    EXPECT_EQ(9, DeferredLog::Format(entry, buffer, 10));
+    EXPECT_STREQ("busy 1, p", buffer);
+    EXPECT_EQ(0, DeferredLog::Format(entry, nullptr, 10));
+}
+
+TEST_F(DeferredLog_Test, Encode)
+{
+    static const DeferredLogSite site = { "x %u", "File.cpp", 1, DEFERRED_LOG_TEXT };
+    const DeferredLogEntry entry = { &site, 0x11223344, { 0xAABBCCDD, 5 } };
+    uint8_t record[DEFERRED_LOG_RECORD_SIZE] = {};
+
+    EXPECT_EQ(0, DeferredLog::Encode(entry, record, DEFERRED_LOG_RECORD_SIZE - 1));
+    ASSERT_EQ(DEFERRED_LOG_RECORD_SIZE, DeferredLog::Encode(entry, record, sizeof(record)));
+
+    const uint32_t address = static_cast<uint32_t>(reinterpret_cast<uintptr_t>(&site));
+    EXPECT_EQ(DEFERRED_LOG_RECORD_ID, record[0]);
+    EXPECT_EQ(address & 0xFF, record[1]);
+    EXPECT_EQ(address >> 24, record[4]);
+    EXPECT_EQ(0x44, record[5]);
+    EXPECT_EQ(0x11, record[8]);
+    EXPECT_EQ(0xDD, record[9]);
+    EXPECT_EQ(5, record[13]);
+}
+
+// Producers on several threads, as interrupts of different priorities: each
+// entry is read once, per producer in order, none lost unless counted.
+TEST_F(DeferredLog_Test, Concurrent_producers)
+{
+    static constexpr uint32_t PRODUCERS = 4;
+    static constexpr uint32_t COUNT     = 20000;
+
+    std::atomic<uint32_t> running { PRODUCERS };
+    std::vector<std::thread> producers;
+    for (uint32_t p = 0; p < PRODUCERS; p++)
+    {
+        producers.emplace_back([p, &running]() {
+            for (uint32_t i = 0; i < COUNT; i++) { DEFERRED_LOG("producer %u: %u", p, i); }
+            running--;
+        });
+    }
+
+    uint32_t received = 0;
+    int64_t  last[PRODUCERS];
+    std::fill(std::begin(last), std::end(last), -1);
+
+    DeferredLogEntry entry = {};
+    while ((running > 0) || (DeferredLog::GetPending() > 0))
+    {
+        if (DeferredLog::Read(entry))
+        {
+            ASSERT_LT(entry.args[0], PRODUCERS);
+            EXPECT_GT(static_cast<int64_t>(entry.args[1]), last[entry.args[0]]);
+            last[entry.args[0]] = entry.args[1];
+            received++;
+        }
+    }
+    for (auto& producer : producers) { producer.join(); }
+
+    EXPECT_EQ(PRODUCERS * COUNT, received + DeferredLog::GetDropped());
+}
+
+
+} // namespace
@@ -0,0 +1,166 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/Delegate/Delegate.hpp"
+
+// Supporting files
+#include <chrono>
+#include <cstdio>
+#include <functional>
+
+
+namespace {
+
+
+// Constants
+static constexpr uint32_t DISPATCH_COUNT = 1000000;
+
+
+// Helper class mimicking a driver client receiving a callback.
+class Client
+{
+public:
+    void Done()                { mCount++; }
+    void Received(uint16_t n)  { mCount += n; }
+    uint32_t Count() const     { return mCount; }
+
+    uint32_t mCount = 0;
+};
+
+
+// Mimics the static callback tables of the drivers (like 'spi1_callbacks').
+static Delegate<void()>      delegateTable {};
+static std::function<void()> functionTable {};
+
+
+// Test fixture for Delegate.
+class Delegate_Test : public ::testing::Test
+{
+protected:
+    Delegate_Test()
+    {
+        // Initialize test matter
+        delegateTable = nullptr;
+        functionTable = nullptr;
+    }
+
+    Client mClient;
+};
+
+
+TEST_F(Delegate_Test, Empty)
+{
+    Delegate<void()> subject;
+
+    EXPECT_FALSE(subject);
+    EXPECT_TRUE(subject == nullptr);
+
+    subject = [this]() { mClient.Done(); };
+
+    EXPECT_TRUE(subject);
+    EXPECT_TRUE(subject != nullptr);
+
+    subject = nullptr;
+
+    EXPECT_FALSE(subject);
+}
+
+TEST_F(Delegate_Test, Lambda)
+{
+    Delegate<void()> subject = [this]() { mClient.Done(); };
+
+    subject();
+    subject();
+
+    EXPECT_EQ(2, mClient.mCount);
+}
+
+TEST_F(Delegate_Test, Lambda_with_argument)
+{
+    Delegate<void(uint16_t)> subject = [this](uint16_t length) { mClient.Received(length); };
+
+    subject(25);
+
+    EXPECT_EQ(25, mClient.mCount);
+}
+
+TEST_F(Delegate_Test, Member_method)
+{
+    auto subject = Delegate<void(uint16_t)>::Create<Client, &Client::Received>(&mClient);
+
+    subject(3);
+    subject(4);
+
+    EXPECT_EQ(7, mClient.mCount);
+}
+
+TEST_F(Delegate_Test, Const_member_method)
+{
+    const Client& client = mClient;
+    mClient.mCount = 5;
+
+    auto subject = Delegate<uint32_t()>::Create<Client, &Client::Count>(&client);
+
+    EXPECT_EQ(5, subject());
+    mClient.Done();
+    EXPECT_EQ(6, subject());
+}
+
+TEST_F(Delegate_Test, Copy)
+{
+    Delegate<void()> subject = [this]() { mClient.Done(); };
+
+    Delegate<void()> copy = subject;
+    subject = nullptr;
+
+    copy();
+
+    EXPECT_EQ(1, mClient.mCount);
+}
+
+TEST_F(Delegate_Test, Larger_storage)
+{
+    uint32_t a = 1;
+    uint32_t b = 2;
+    Client* client = &mClient;
+
+    Delegate<void(), 3 * sizeof(void*)> subject = [client, a, b]() { client->mCount += (a + b); };
+
+    subject();
+
+    EXPECT_EQ(3, mClient.mCount);
+}
+
+// Host side benchmark: Delegate versus std::function dispatch. Prints the
+// time, does not fail on timing. Disabled: run with
+// --gtest_also_run_disabled_tests.
+TEST_F(Delegate_Test, DISABLED_Benchmark_dispatch)
+{
+    delegateTable = [this]() { mClient.Done(); };
+    functionTable = [this]() { mClient.Done(); };
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < DISPATCH_COUNT; i++)
+    {
+        if (delegateTable) { delegateTable(); }
+    }
+    auto delegateDuration = std::chrono::steady_clock::now() - start;
+
+    start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < DISPATCH_COUNT; i++)
+    {
+        if (functionTable) { functionTable(); }
+    }
+    auto functionDuration = std::chrono::steady_clock::now() - start;
+
+    EXPECT_EQ(2 * DISPATCH_COUNT, mClient.mCount);
+
+    std::printf("[ BENCH    ] Delegate:      %lld ns for %u dispatches\n",
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(delegateDuration).count()), DISPATCH_COUNT);
+    std::printf("[ BENCH    ] std::function: %lld ns for %u dispatches\n",
+                static_cast<long long>(std::chrono::duration_cast<std::chrono::nanoseconds>(functionDuration).count()), DISPATCH_COUNT);
+}
+
+
+} // namespace
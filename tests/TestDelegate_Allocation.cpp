@@ -0,0 +1,93 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/Delegate/Delegate.hpp"
+
+// Supporting files
+#include <cstdlib>
+#include <functional>
+#include <new>
+
+
+// Count heap allocations to prove the Delegate does not allocate. Replaces
+// the global operator new: built as executable of its own (see
+// CMakeLists.txt), the other tests keep the regular allocation.
+static size_t allocationCount = 0;
+
+void* operator new(size_t size)
+{
+    allocationCount++;
+    void* ptr = std::malloc(size);
+    if (ptr == nullptr) { throw std::bad_alloc(); }
+    return ptr;
+}
+
+void operator delete(void* ptr) noexcept
+{
+    std::free(ptr);
+}
+
+void operator delete(void* ptr, size_t) noexcept
+{
+    std::free(ptr);
+}
+
+
+namespace {
+
+
+// Helper class mimicking a driver client receiving a callback.
+class Client
+{
+public:
+    void Received(uint16_t n)  { mCount += n; }
+
+    uint32_t mCount = 0;
+};
+
+
+// Mimics the static callback tables of the drivers (like 'spi1_callbacks').
+static Delegate<void()>      delegateTable {};
+static std::function<void()> functionTable {};
+
+
+TEST(Delegate_Allocation_Test, No_heap_allocation_per_transfer)
+{
+    Client client;
+    Client* ptr = &client;
+    uint16_t length = 6;
+
+    const size_t before = allocationCount;
+
+    for (uint32_t i = 0; i < 1000; i++)
+    {
+        // Mimics 'mSPICallbacks.callbackTxRx = handler' followed by the ISR dispatch.
+        delegateTable = [ptr, length]() { ptr->Received(length); };
+        if (delegateTable) { delegateTable(); }
+    }
+
+    EXPECT_EQ(before, allocationCount);
+    EXPECT_EQ(6000, client.mCount);
+}
+
+TEST(Delegate_Allocation_Test, Reference_std_function_allocates)
+{
+    Client client;
+    Client* ptr = &client;
+    uint64_t a = 1;
+    uint64_t b = 2;
+
+    const size_t before = allocationCount;
+
+    // Capture larger than the small buffer of std::function: heap allocation for every assignment.
+    functionTable = [ptr, a, b]() { ptr->mCount += static_cast<uint32_t>(a + b); };
+    functionTable();
+    functionTable = nullptr;
+
+    EXPECT_LT(before, allocationCount);
+    EXPECT_EQ(3, client.mCount);
+}
+
+
+} // namespace
@@ -0,0 +1,127 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/GenericTimer/GenericTimer.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+// Test fixture for GenericTimer - timing from the timer clock and trigger output.
+class GenericTimer_Test : public ::testing::Test
+{
+protected:
+    GenericTimer_Test() :
+        mSubject(GenericTimerInstance::TIMER_2)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+    }
+
+    GenericTimer mSubject;
+};
+
+
+struct TimingCase
+{
+    uint32_t clock;
+    float    frequency;
+    bool     valid;
+    uint16_t prescaler;
+    uint16_t period;
+    float    achieved;
+};
+
+const TimingCase timingCases[] =
+{
+    //    clock  frequency  valid    PSC     ARR     achieved
+    { 84000000,   48000.0f,  true,     0,   1749,   48000.0f  },
+    { 84000000,   44100.0f,  true,     0,   1904,   44094.49f },
+    { 84000000,       1.0f,  true,  1343,  62499,       1.0f  },    // Exact divider above the smallest prescaler
+    {168000000,    1000.0f,  true,     2,  55999,    1000.0f  },
+    { 84000000,   42.0e6f,   true,     0,      1,   42.0e6f   },
+    { 84000000,   50.0e6f,  false,     0,      0,       0.0f  },    // Too fast
+    { 84000000,     0.01f,  false,     0,      0,       0.0f  },    // Too slow
+};
+
+
+TEST(GenericTimer_Timing_Test, CalculateTiming_table)
+{
+    for (const TimingCase& c : timingCases)
+    {
+        SCOPED_TRACE(::testing::Message() << c.clock << " Hz clock, " << c.frequency << " Hz");
+
+        GenericTimer::TimingSetting setting;
+        EXPECT_EQ(c.valid,          GenericTimer::CalculateTiming(c.clock, c.frequency, setting));
+        EXPECT_EQ(c.prescaler,      setting.mPrescaler);
+        EXPECT_EQ(c.period,         setting.mPeriod);
+        EXPECT_FLOAT_EQ(c.achieved, setting.mFrequency);
+    }
+}
+
+TEST(GenericTimer_Timing_Test, CalculateTiming_invalid)
+{
+    GenericTimer::TimingSetting setting;
+
+    EXPECT_FALSE(GenericTimer::CalculateTiming(0, 1000.0f, setting));
+    EXPECT_FALSE(GenericTimer::CalculateTiming(84000000, 0.0f, setting));
+    EXPECT_FALSE(GenericTimer::CalculateTiming(84000000, -1.0f, setting));
+}
+
+TEST_F(GenericTimer_Test, Init_trigger_output)
+{
+    EXPECT_EQ(0.0f, mSubject.GetFrequency());
+
+    // TIM2 runs at twice PCLK1 (42 MHz), as APB1 is slower than the AHB
+    EXPECT_TRUE(mSubject.Init(GenericTimer::Config(10, 48000.0f, true)));
+    EXPECT_EQ(0,               TIM2->PSC);
+    EXPECT_EQ(1749,            TIM2->ARR);
+    EXPECT_EQ(TIM_TRGO_UPDATE, TIM2->CR2 & TIM_CR2_MMS);
+    EXPECT_EQ(48000.0f,        mSubject.GetFrequency());
+
+    // APB1 at the AHB clock: TIM2 runs at PCLK1
+    FakeHal_SetPclkFreq(168000000, 84000000);
+    EXPECT_TRUE(mSubject.Init(GenericTimer::Config(10, 1000.0f)));
+    EXPECT_EQ(2,               TIM2->PSC);
+    EXPECT_EQ(55999,           TIM2->ARR);
+}
+
+TEST_F(GenericTimer_Test, Init_apb2)
+{
+    GenericTimer timer(GenericTimerInstance::TIMER_9);
+
+    // TIM9 runs at twice PCLK2 (84 MHz), has no trigger output
+    EXPECT_TRUE(timer.Init(GenericTimer::Config(10, 1000.0f)));
+    EXPECT_EQ(2,     TIM9->PSC);
+    EXPECT_EQ(55999, TIM9->ARR);
+
+    EXPECT_FALSE(timer.Init(GenericTimer::Config(10, 1000.0f, true)));
+    EXPECT_FALSE(mSubject.Init(GenericTimer::Config(10, 50.0e6f)));
+}
+
+TEST_F(GenericTimer_Test, Start_trigger_only)
+{
+    EXPECT_FALSE(mSubject.Start(nullptr));
+    ASSERT_TRUE(mSubject.Init(GenericTimer::Config(10, 48000.0f, true)));
+
+    // Without handler no interrupts: the ADC or DAC follows the trigger output
+    EXPECT_TRUE(mSubject.Start(nullptr));
+    EXPECT_TRUE(mSubject.IsStarted());
+    EXPECT_EQ(FAKE_HAL_TIM_START, FakeHal_GetEvent(0).call);
+    EXPECT_EQ(2,                  FakeHal_GetEvent(0).value);
+    EXPECT_EQ(0,                  TIM2->DIER & TIM_DIER_UIE);
+
+    EXPECT_TRUE(mSubject.Stop());
+    EXPECT_FALSE(mSubject.IsStarted());
+
+    EXPECT_TRUE(mSubject.Start([]() { }));
+    EXPECT_EQ(FAKE_HAL_TIM_START_IT, FakeHal_GetEvent(2).call);
+    EXPECT_EQ(TIM_DIER_UIE,          TIM2->DIER & TIM_DIER_UIE);
+}
+
+
+} // namespace
@@ -15,6 +15,9 @@
 namespace {
 
 
+using ::testing::Invoke;
+
+
 // Test fixture for HI-M1388AR - 8x8 LED matrix display.
 class HI_M1388AR_Test : public ::testing::Test
 {
@@ -27,7 +30,53 @@ protected:
         // Initialize test matter
     }
 
+    // Count the blocking SPI transactions, capture the Transfers.
+    void CaptureTransactions()
+    {
+        ON_CALL(spi, WriteBlocking(_, _))
+            .WillByDefault(Invoke([this](const uint8_t* src, uint16_t length)
+            {
+                mBlockingWrites++;
+                return true;
+            }));
+        ON_CALL(spi, Transfer(_, _, _))
+            .WillByDefault(Invoke([this](const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler)
+            {
+                mSegments = segments;
+                mCount    = count;
+                mDone     = handler;
+                mTransfers++;
+                return true;
+            }));
+    }
+
+    // Number of (2 byte) register writes in the captured Transfer.
+    uint8_t LinesInTransfer() const
+    {
+        uint8_t lines = 0;
+        for (uint8_t i = 0; i < mCount; i++)
+        {
+            if (mSegments[i].type == SPISegment::Type::Write) { lines++; }
+        }
+        return lines;
+    }
+
+    void CompleteTransfer(bool result = true)
+    {
+        const Delegate<void(bool)> done = mDone;
+        done(result);
+    }
+
+    void FrameDone() { mFramesDone++; }
+
     HI_M1388AR mSubject;
+
+    const SPISegment*    mSegments = nullptr;
+    uint8_t              mCount = 0;
+    Delegate<void(bool)> mDone;
+    uint32_t             mBlockingWrites = 0;
+    uint32_t             mTransfers = 0;
+    uint32_t             mFramesDone = 0;
 };
 
 
@@ -63,4 +112,138 @@ TEST_F(HI_M1388AR_Test, WriteDigits)
 }
 
 
+TEST_F(HI_M1388AR_Test, WriteDigits_only_changed_lines)
+{
+    CaptureTransactions();
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.ClearDisplay());
+    EXPECT_EQ(0, mBlockingWrites);                  // Already cleared by Init
+
+    uint8_t frame[8] = {};
+    frame[3] = 0x18;
+    frame[4] = 0x18;
+    EXPECT_TRUE(mSubject.WriteDigits(frame));
+    EXPECT_EQ(2, mBlockingWrites);
+
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.WriteDigits(frame));
+    EXPECT_EQ(0, mBlockingWrites);
+
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.WriteDigits(symbol_smiley));
+    EXPECT_EQ(8, mBlockingWrites);
+
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.WriteDigits(symbol_sadface));
+    EXPECT_EQ(2, mBlockingWrites);                  // Only the mouth changes
+}
+
+TEST_F(HI_M1388AR_Test, WriteDigits_after_Init_writes_all_lines)
+{
+    CaptureTransactions();
+
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+    EXPECT_EQ(5 + 8, mBlockingWrites);              // Configure + all lines
+
+    EXPECT_TRUE(mSubject.Sleep());
+
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+    EXPECT_EQ(5 + 8, mBlockingWrites);              // Display content unknown after Sleep
+}
+
+TEST_F(HI_M1388AR_Test, WriteFrameAsync_single_transfer)
+{
+    CaptureTransactions();
+
+    uint8_t frame[8] = {};
+    EXPECT_FALSE(mSubject.WriteFrameAsync(frame, [this]() { this->FrameDone(); }));   // Not initialized yet
+
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+    mBlockingWrites = 0;
+
+    frame[0] = 0x81;
+    frame[7] = 0x81;
+    EXPECT_TRUE(mSubject.WriteFrameAsync(frame, [this]() { this->FrameDone(); }));
+
+    EXPECT_EQ(1, mTransfers);
+    EXPECT_EQ(0, mBlockingWrites);
+    ASSERT_EQ(6, mCount);                           // 2 lines: ChipSelect, register + value, ChipSelect
+    EXPECT_EQ(2, LinesInTransfer());
+    EXPECT_EQ(SPISegment::Type::ChipSelectAssert,   mSegments[0].type);
+    EXPECT_EQ(0x01, mSegments[1].src[0]);           // DIGIT_0
+    EXPECT_EQ(0x81, mSegments[1].src[1]);
+    EXPECT_EQ(SPISegment::Type::ChipSelectDeassert, mSegments[2].type);
+    EXPECT_EQ(0x08, mSegments[4].src[0]);           // DIGIT_7
+
+    // Busy until the Transfer is done
+    EXPECT_TRUE(mSubject.IsBusy());
+    EXPECT_FALSE(mSubject.WriteFrameAsync(frame, nullptr));
+    EXPECT_FALSE(mSubject.WriteDigits(frame));
+
+    CompleteTransfer();
+    EXPECT_FALSE(mSubject.IsBusy());
+    EXPECT_EQ(1, mFramesDone);
+
+    // Unchanged frame: no transaction, handler called directly
+    EXPECT_TRUE(mSubject.WriteFrameAsync(frame, [this]() { this->FrameDone(); }));
+    EXPECT_EQ(1, mTransfers);
+    EXPECT_EQ(2, mFramesDone);
+}
+
+TEST_F(HI_M1388AR_Test, WriteFrameAsync_transactions_per_frame)
+{
+    CaptureTransactions();
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+
+    // Scrolling a single lit line: each frame changes 2 lines
+    for (uint8_t i = 1; i < 8; i++)
+    {
+        uint8_t frame[8] = {};
+        frame[i] = 0xFF;
+
+        EXPECT_TRUE(mSubject.WriteFrameAsync(frame));
+        EXPECT_EQ((i == 1) ? 1 : 2, LinesInTransfer());
+        CompleteTransfer();
+    }
+    EXPECT_EQ(7, mTransfers);
+}
+
+TEST_F(HI_M1388AR_Test, WriteFrameAsync_failed_start)
+{
+    CaptureTransactions();
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+
+    EXPECT_CALL(spi, Transfer(_, _, _)).WillOnce(::testing::Return(false));
+    EXPECT_FALSE(mSubject.WriteFrameAsync(symbol_smiley));
+    EXPECT_FALSE(mSubject.IsBusy());
+
+    // Nothing was written: all lines are written blocking
+    mBlockingWrites = 0;
+    EXPECT_TRUE(mSubject.WriteDigits(symbol_smiley));
+    EXPECT_EQ(8, mBlockingWrites);
+}
+
+TEST_F(HI_M1388AR_Test, WriteFrameAsync_failed_transfer)
+{
+    CaptureTransactions();
+    EXPECT_TRUE(mSubject.Init(HI_M1388AR::Config(8)));
+
+    // The Transfer fails: not busy anymore, the handler is called
+    uint8_t frame[8] = {};
+    frame[0] = 0x81;
+    EXPECT_TRUE(mSubject.WriteFrameAsync(frame, [this]() { this->FrameDone(); }));
+    CompleteTransfer(false);
+    EXPECT_FALSE(mSubject.IsBusy());
+    EXPECT_EQ(1, mFramesDone);
+
+    // The line is unknown: written again with the same frame
+    EXPECT_TRUE(mSubject.WriteFrameAsync(frame, [this]() { this->FrameDone(); }));
+    EXPECT_EQ(2, mTransfers);
+    EXPECT_EQ(1, LinesInTransfer());
+}
+
+
 } // namespace
@@ -0,0 +1,250 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "components/HI-M1388AR/HI-M1388AR_Animation.hpp"
+
+// Supporting files
+#include "board/BoardConfig.hpp"
+#include "components/HI-M1388AR/HI-M1388AR_Lib.hpp"
+
+// Mock
+#include "Mock/Mock_SPI.hpp"
+
+
+namespace {
+
+
+using ::testing::Invoke;
+
+
+// Glyph table is resolved at compile time
+static_assert(GetGlyph('7') == digit_seven, "digit glyph");
+static_assert(GetGlyph('Q') == letter_Q,    "capital glyph");
+static_assert(GetGlyph('q') == letter_q,    "small glyph");
+static_assert(GetGlyph(' ') == symbol_blank, "unknown glyph");
+
+
+// Timer of which the tick is called by the test.
+class FakeTimer : public IGenericTimer
+{
+public:
+    bool Start(const Delegate<void()>& handler) override { mHandler = handler; mStarted = true; return true; }
+    bool IsStarted() const override { return mStarted; }
+    bool Stop() override { mStarted = false; return true; }
+
+    void Fire() { if (mStarted && mHandler) { mHandler(); } }
+
+private:
+    Delegate<void()> mHandler;
+    bool             mStarted = false;
+};
+
+
+// Test fixture for HI-M1388AR_Animation - 8x8 LED matrix animations.
+class HI_M1388AR_Animation_Test : public ::testing::Test
+{
+protected:
+    Mock_SPI spi;
+
+    HI_M1388AR_Animation_Test() :
+        mDisplay(spi, PIN_SPI2_CS),
+        mSubject(mDisplay)
+    {
+        // Initialize test matter
+        EXPECT_TRUE(mDisplay.Init(HI_M1388AR::Config(8)));
+
+        // Decode the lines written by the Transfers into 'mLines'
+        ON_CALL(spi, Transfer(_, _, _))
+            .WillByDefault(Invoke([this](const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler)
+            {
+                for (uint8_t i = 0; i < count; i++)
+                {
+                    if (segments[i].type == SPISegment::Type::Write)
+                    {
+                        mLines[segments[i].src[0] - 1] = segments[i].src[1];
+                    }
+                }
+                mTransfers++;
+
+                if (mCompleteTransfers) { handler(true); }
+                else                    { mPending = handler; }
+                return true;
+            }));
+
+        EXPECT_TRUE(mSubject.Start(mTimer));
+    }
+
+    // Tick after rendering, as the application loop would.
+    void RenderAndTick()
+    {
+        mSubject.Render();
+        mTimer.Fire();
+    }
+
+    bool Shows(const uint8_t* glyph) const
+    {
+        return std::memcmp(mLines, glyph, MATRIX_SIZE) == 0;
+    }
+
+    HI_M1388AR           mDisplay;
+    HI_M1388AR_Animation mSubject;
+    FakeTimer            mTimer;
+
+    uint8_t              mLines[MATRIX_SIZE] = {};
+    uint32_t             mTransfers = 0;
+    bool                 mCompleteTransfers = true;
+    Delegate<void(bool)> mPending;
+};
+
+
+TEST_F(HI_M1388AR_Animation_Test, ShowGlyph)
+{
+    EXPECT_FALSE(mSubject.ShowGlyph(nullptr));
+
+    EXPECT_TRUE(mSubject.ShowGlyph(digit_one));
+    EXPECT_FALSE(mSubject.IsDone());
+
+    RenderAndTick();
+    EXPECT_TRUE(Shows(digit_one));
+    EXPECT_TRUE(mSubject.IsDone());
+
+    // Nothing more to show: no transfer, no missed tick
+    RenderAndTick();
+    EXPECT_EQ(1, mTransfers);
+    EXPECT_EQ(0, mSubject.GetMissedTicks());
+}
+
+TEST_F(HI_M1388AR_Animation_Test, ScrollText)
+{
+    EXPECT_TRUE(mSubject.ScrollText("A"));
+
+    // Blank, 'A' shifts in from the right, 'A', 'A' shifts out to the left, blank
+    for (uint8_t step = 0; step <= 2 * MATRIX_SIZE; step++)
+    {
+        RenderAndTick();
+
+        if (step == 0)                { EXPECT_TRUE(Shows(symbol_blank)); }
+        if (step == 4)                { EXPECT_EQ(static_cast<uint8_t>(letter_A[0] << 4), mLines[0]); }
+        if (step == MATRIX_SIZE)      { EXPECT_TRUE(Shows(letter_A)); }
+        if (step == MATRIX_SIZE + 4)  { EXPECT_EQ(letter_A[0] >> 4, mLines[0]); }
+        if (step == 2 * MATRIX_SIZE)  { EXPECT_TRUE(Shows(symbol_blank)); }
+    }
+
+    EXPECT_TRUE(mSubject.IsDone());
+    EXPECT_EQ(0, mSubject.GetMissedTicks());
+}
+
+TEST_F(HI_M1388AR_Animation_Test, ScrollText_repeat)
+{
+    EXPECT_TRUE(mSubject.ScrollText("AB", true));
+
+    for (uint8_t step = 0; step < 3 * MATRIX_SIZE; step++)
+    {
+        RenderAndTick();
+    }
+
+    // Starts over: blank, then 'A' again
+    RenderAndTick();
+    EXPECT_TRUE(Shows(symbol_blank));
+    for (uint8_t step = 0; step < MATRIX_SIZE; step++)
+    {
+        RenderAndTick();
+    }
+    EXPECT_TRUE(Shows(letter_A));
+    EXPECT_FALSE(mSubject.IsDone());
+}
+
+TEST_F(HI_M1388AR_Animation_Test, Frames_rendered_ahead)
+{
+    static const uint8_t frames[6][MATRIX_SIZE] = { { 1 }, { 2 }, { 3 }, { 4 }, { 5 }, { 6 } };
+
+    EXPECT_TRUE(mSubject.PlaySequence(frames, 6));
+
+    // Ring is filled ahead: ticks do not need the application loop
+    for (uint8_t i = 0; i < HI_M1388AR_ANIMATION_FRAMES; i++)
+    {
+        mTimer.Fire();
+        EXPECT_EQ(i + 1, mLines[0]);
+    }
+
+    mTimer.Fire();                                  // Render() did not keep up
+    EXPECT_EQ(1, mSubject.GetMissedTicks());
+    EXPECT_EQ(HI_M1388AR_ANIMATION_FRAMES, mLines[0]);
+
+    RenderAndTick();
+    RenderAndTick();
+    EXPECT_EQ(6, mLines[0]);
+    EXPECT_TRUE(mSubject.IsDone());
+}
+
+TEST_F(HI_M1388AR_Animation_Test, Display_busy_is_missed_tick)
+{
+    mCompleteTransfers = false;
+
+    EXPECT_TRUE(mSubject.PlayTransition(digit_one, digit_two, HI_M1388AR_Animation::Transition::Cut));
+    EXPECT_TRUE(mSubject.ShowGlyph(digit_three));   // Replaces the transition
+
+    RenderAndTick();
+    EXPECT_TRUE(Shows(digit_three));
+    EXPECT_TRUE(mDisplay.IsBusy());
+
+    EXPECT_TRUE(mSubject.ShowGlyph(digit_four));
+    RenderAndTick();                                // Previous frame still being written
+    EXPECT_EQ(1, mSubject.GetMissedTicks());
+
+    mPending(true);
+    RenderAndTick();
+    EXPECT_TRUE(Shows(digit_four));
+}
+
+TEST_F(HI_M1388AR_Animation_Test, Transition_SlideUp)
+{
+    EXPECT_TRUE(mSubject.PlayTransition(digit_one, digit_two, HI_M1388AR_Animation::Transition::SlideUp));
+
+    RenderAndTick();
+    EXPECT_TRUE(Shows(digit_one));
+
+    RenderAndTick();                                // Moved up one line
+    EXPECT_EQ(digit_two[MATRIX_SIZE - 1], mLines[0]);
+    for (uint8_t line = 1; line < MATRIX_SIZE; line++)
+    {
+        EXPECT_EQ(digit_one[line - 1], mLines[line]);
+    }
+
+    for (uint8_t step = 2; step <= MATRIX_SIZE; step++)
+    {
+        RenderAndTick();
+    }
+    EXPECT_TRUE(Shows(digit_two));
+    EXPECT_TRUE(mSubject.IsDone());
+}
+
+TEST_F(HI_M1388AR_Animation_Test, Transition_Wipe)
+{
+    EXPECT_TRUE(mSubject.PlayTransition(symbol_blank, letter_M, HI_M1388AR_Animation::Transition::Wipe));
+
+    for (uint8_t step = 0; step <= 4; step++)
+    {
+        RenderAndTick();
+    }
+
+    // Left 4 columns revealed
+    for (uint8_t line = 0; line < MATRIX_SIZE; line++)
+    {
+        EXPECT_EQ(letter_M[line] & 0x0F, mLines[line]);
+    }
+}
+
+TEST_F(HI_M1388AR_Animation_Test, Stop)
+{
+    EXPECT_TRUE(mSubject.ShowGlyph(digit_one));
+    EXPECT_TRUE(mSubject.Stop());
+
+    RenderAndTick();
+    EXPECT_EQ(0, mTransfers);
+    EXPECT_FALSE(mSubject.IsDone());
+}
+
+
+} // namespace
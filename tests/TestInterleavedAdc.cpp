@@ -0,0 +1,195 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/ADC/InterleavedAdc.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+#include <vector>
+
+
+namespace {
+
+
+// Test fixture for InterleavedAdc - ADC1 as master of ADC2 (and ADC3), a
+// single circular DMA of the merged samples.
+class InterleavedAdc_Test : public ::testing::Test
+{
+protected:
+    InterleavedAdc_Test() :
+        mAdc1(ADCInstance::ADC_1),
+        mAdc2(ADCInstance::ADC_2),
+        mAdc3(ADCInstance::ADC_3)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+
+        mDma.Instance                 = &mDmaStream;
+        mDma.Init.Mode                = DMA_CIRCULAR;
+        mDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+        mDma.Init.MemDataAlignment    = DMA_MDATAALIGN_WORD;
+    }
+
+    bool StartStream(InterleavedAdc& subject, uint16_t length)
+    {
+        EXPECT_TRUE(subject.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1)));
+        subject.GetDmaHandle() = &mDma;
+        return subject.StartStream(mBuffer, length, [this](const uint16_t* block, uint16_t length) { this->mBlocks.emplace_back(block, block + length); });
+    }
+
+    // Conversions 'first', 'first + 1', ... in order of conversion.
+    void Convert(uint16_t first, uint16_t length)
+    {
+        std::vector<uint16_t> data;
+        for (uint16_t i = 0; i < length; i++) { data.push_back(first + i); }
+        FakeHal_AdcDmaConvert(const_cast<ADC_HandleTypeDef*>(mAdc1.GetPeripheralHandle()), data.data(), length);
+    }
+
+    std::vector<std::vector<uint16_t>> mBlocks;
+    alignas(4) uint16_t mBuffer[24] = {};
+    DMA_Stream_TypeDef  mDmaStream = {};
+    DMA_HandleTypeDef   mDma = {};
+    Adc                 mAdc1;
+    Adc                 mAdc2;
+    Adc                 mAdc3;
+};
+
+
+TEST(InterleavedAdc_Delay_Test, CalculateDelay)
+{
+    // Conversion time spread over the ADCs
+    EXPECT_EQ(8, InterleavedAdc::CalculateDelay(2, Adc::Resolution::_12_BIT, Adc::SampleTime::_3_CYCLES));
+    EXPECT_EQ(5, InterleavedAdc::CalculateDelay(3, Adc::Resolution::_12_BIT, Adc::SampleTime::_3_CYCLES));
+    EXPECT_EQ(5, InterleavedAdc::CalculateDelay(2, Adc::Resolution::_6_BIT,  Adc::SampleTime::_3_CYCLES));    // Minimum delay
+
+    // Sampling phases do not overlap
+    EXPECT_EQ(16, InterleavedAdc::CalculateDelay(2, Adc::Resolution::_12_BIT, Adc::SampleTime::_15_CYCLES));
+    EXPECT_EQ(16, InterleavedAdc::CalculateDelay(3, Adc::Resolution::_12_BIT, Adc::SampleTime::_15_CYCLES));
+
+    // Too long to interleave, invalid number of ADCs
+    EXPECT_EQ(0, InterleavedAdc::CalculateDelay(2, Adc::Resolution::_12_BIT, Adc::SampleTime::_28_CYCLES));
+    EXPECT_EQ(0, InterleavedAdc::CalculateDelay(1, Adc::Resolution::_12_BIT, Adc::SampleTime::_3_CYCLES));
+    EXPECT_EQ(0, InterleavedAdc::CalculateDelay(4, Adc::Resolution::_12_BIT, Adc::SampleTime::_3_CYCLES));
+}
+
+TEST_F(InterleavedAdc_Test, Init_dual)
+{
+    InterleavedAdc subject(mAdc1, mAdc2);
+    EXPECT_EQ(0.0f, subject.GetSampleRate());
+
+    EXPECT_TRUE(subject.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1)));
+    EXPECT_TRUE(subject.IsInit());
+    EXPECT_EQ(2, subject.GetAdcCount());
+    EXPECT_EQ(ADC_DUALMODE_INTERL | ADC_DMAACCESSMODE_2 | (3 * ADC_TWOSAMPLINGDELAY_6CYCLES), ADC123_COMMON->CCR);
+
+    // ADCCLK is 42 MHz (PCLK2 / 2), a sample each 8 cycles
+    EXPECT_FLOAT_EQ(5.25e6f, subject.GetSampleRate());
+
+    // Both ADCs convert the channel
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(ADC_CHANNEL_1, FakeHal_GetEvent(0).value);
+    EXPECT_EQ(ADC_CHANNEL_1, FakeHal_GetEvent(1).value);
+
+    EXPECT_TRUE(subject.Sleep());
+    EXPECT_FALSE(subject.IsInit());
+    EXPECT_EQ(ADC_MODE_INDEPENDENT, ADC123_COMMON->CCR);
+}
+
+TEST_F(InterleavedAdc_Test, Init_invalid)
+{
+    InterleavedAdc wrongMaster(mAdc2, mAdc1);
+    EXPECT_FALSE(wrongMaster.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1)));
+
+    InterleavedAdc wrongSlave(mAdc1, mAdc2, mAdc2);
+    EXPECT_FALSE(wrongSlave.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1)));
+
+    InterleavedAdc subject(mAdc1, mAdc2);
+    EXPECT_FALSE(subject.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1, Adc::Resolution::_12_BIT, Adc::SampleTime::_28_CYCLES)));
+    EXPECT_FALSE(subject.IsInit());
+}
+
+TEST_F(InterleavedAdc_Test, StartStream_invalid)
+{
+    InterleavedAdc subject(mAdc1, mAdc2);
+    auto handler = [](const uint16_t*, uint16_t) { };
+
+    // Not initialized, no DMA linked
+    EXPECT_FALSE(subject.StartStream(mBuffer, 8, handler));
+    EXPECT_TRUE(subject.Init(InterleavedAdc::Config(10, Adc::Channel::CHANNEL_1)));
+    EXPECT_FALSE(subject.StartStream(mBuffer, 8, handler));
+
+    // Half word transfers, half buffer not whole words, not word aligned
+    subject.GetDmaHandle() = &mDma;
+    mDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_HALFWORD;
+    EXPECT_FALSE(subject.StartStream(mBuffer, 8, handler));
+    mDma.Init.PeriphDataAlignment = DMA_PDATAALIGN_WORD;
+    EXPECT_FALSE(subject.StartStream(mBuffer, 6, handler));
+    EXPECT_FALSE(subject.StartStream(mBuffer + 1, 8, handler));
+
+    EXPECT_TRUE(subject.StartStream(mBuffer, 8, handler));
+    EXPECT_FALSE(subject.StartStream(mBuffer, 8, handler));     // Already streaming
+}
+
+TEST_F(InterleavedAdc_Test, Dual_stream)
+{
+    InterleavedAdc subject(mAdc1, mAdc2);
+    ASSERT_TRUE(StartStream(subject, 8));
+    EXPECT_TRUE(subject.IsStreaming());
+
+    // The slave is enabled, the master streams words of two samples
+    const uint32_t count = FakeHal_GetEventCount();
+    EXPECT_EQ(FAKE_HAL_ADC_START,               FakeHal_GetEvent(count - 2).call);
+    EXPECT_EQ(2,                                FakeHal_GetEvent(count - 2).value);
+    EXPECT_EQ(FAKE_HAL_ADC_MULTIMODE_START_DMA, FakeHal_GetEvent(count - 1).call);
+    EXPECT_EQ(4,                                FakeHal_GetEvent(count - 1).length);
+    EXPECT_EQ(ENABLE, mAdc1.GetPeripheralHandle()->Init.ContinuousConvMode);
+    EXPECT_EQ(ENABLE, mAdc2.GetPeripheralHandle()->Init.ContinuousConvMode);
+
+    // Merged blocks, in order of conversion
+    Convert(100, 12);
+    ASSERT_EQ(3, mBlocks.size());
+    EXPECT_EQ(std::vector<uint16_t>({ 100, 101, 102, 103 }), mBlocks[0]);
+    EXPECT_EQ(std::vector<uint16_t>({ 104, 105, 106, 107 }), mBlocks[1]);
+    EXPECT_EQ(std::vector<uint16_t>({ 108, 109, 110, 111 }), mBlocks[2]);
+
+    EXPECT_TRUE(subject.StopStream());
+    EXPECT_FALSE(subject.IsStreaming());
+    EXPECT_EQ(DISABLE, mAdc2.GetPeripheralHandle()->Init.ContinuousConvMode);
+    EXPECT_FALSE(subject.StopStream());
+}
+
+TEST_F(InterleavedAdc_Test, Triple_stream)
+{
+    InterleavedAdc subject(mAdc1, mAdc2, mAdc3);
+
+    // Blocks of whole rounds of 3 transfers
+    EXPECT_FALSE(StartStream(subject, 8));
+    ASSERT_TRUE(StartStream(subject, 24));
+    EXPECT_EQ(ADC_TRIPLEMODE_INTERL | ADC_DMAACCESSMODE_2 | ADC_TWOSAMPLINGDELAY_5CYCLES, ADC123_COMMON->CCR);
+    EXPECT_FLOAT_EQ(8.4e6f, subject.GetSampleRate());
+
+    Convert(0, 24);
+    ASSERT_EQ(2, mBlocks.size());
+    EXPECT_EQ(12, mBlocks[0].size());
+    EXPECT_EQ(12, mBlocks[1].front());
+}
+
+TEST_F(InterleavedAdc_Test, Overrun_restarts_stream)
+{
+    InterleavedAdc subject(mAdc1, mAdc2);
+    ASSERT_TRUE(StartStream(subject, 8));
+
+    Convert(100, 2);
+    FakeHal_AdcOverrun(const_cast<ADC_HandleTypeDef*>(mAdc1.GetPeripheralHandle()));
+    EXPECT_EQ(1, subject.GetOverruns());
+    EXPECT_EQ(FAKE_HAL_ADC_MULTIMODE_START_DMA, FakeHal_GetEvent(FakeHal_GetEventCount() - 1).call);
+
+    // Restarted at the start of the buffer
+    Convert(200, 4);
+    ASSERT_EQ(1, mBlocks.size());
+    EXPECT_EQ(std::vector<uint16_t>({ 200, 201, 202, 203 }), mBlocks[0]);
+}
+
+
+} // namespace
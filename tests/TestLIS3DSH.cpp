@@ -1,4 +1,5 @@
 #include "gtest/gtest.h"
+#include <vector>
 
 
 // Test subject
@@ -11,22 +12,143 @@
 #include "Mock/Mock_SPI.hpp"
 
 
+// Provided by the Fake Pin: simulates a pin interrupt.
+void FakePin_TriggerInterrupt(PinIdPort idAndPort);
+
+
 namespace {
 
 
+using ::testing::Invoke;
+
+
+// Constants
+static constexpr uint8_t BURST_LENGTH = 25 * 3 * 2;     // 25 samples, X,Y,Z, 2 bytes/sample
+static constexpr uint8_t FIFO_CTRL    = 0x2E;
+static constexpr uint8_t FIFO_SRC     = 0x2F;
+static constexpr uint8_t FIFO_WTM     = 0x80;           // FIFO_SRC: watermark reached
+static constexpr uint8_t FIFO_OVRN    = 0x40;           // FIFO_SRC: fifo overrun
+static constexpr uint8_t FIFO_EMPTY   = 0x20;           // FIFO_SRC: fifo empty
+
+
 // Test fixture for LIS3DSH - accelerometer.
 class LIS3DSH_Test : public ::testing::Test
 {
 protected:
-    Mock_SPI spi;
+    Mock_SPI             spi;
+    std::vector<uint8_t> mWritten;          // Outlives mSubject, which writes on destruction
+    uint8_t              mReadBuffer[LIS3DSH_READ_BUFFER_SIZE(true, LIS3DSH_MAX_READ_SLOTS)];
 
     LIS3DSH_Test() :
-        mSubject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2)
+        mSubject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2, mReadBuffer, sizeof(mReadBuffer))
     {
         // Initialize test matter
     }
 
+    // Start streaming, SPI Transfers are captured to complete them manually.
+    void InitStreaming(uint8_t readSlots, uint8_t watermark = 25, uint16_t latencyTarget = 0)
+    {
+        EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_1600_Hz,
+                                                        LIS3DSH::Scale::_2_G,
+                                                        LIS3DSH::AntiAliasingFilter::_800_Hz,
+                                                        readSlots,
+                                                        watermark,
+                                                        latencyTarget)));
+        EXPECT_TRUE(mSubject.Enable());
+
+        ON_CALL(spi, Transfer(_, _, _))
+            .WillByDefault(Invoke([this](const SPISegment* segments, uint8_t count, const Delegate<void(bool)>& handler)
+            {
+                mSegments = segments;
+                mCount    = count;
+                mDone     = handler;
+                return true;
+            }));
+        mSubject.SetHandler([this](uint8_t length) { mLengths[mHandlerCount++ % 8] = length; });
+    }
+
+    // Watermark interrupt, SPI read not yet done.
+    void StartBurst()
+    {
+        FakePin_TriggerInterrupt(PIN_MOTION_INT1);
+    }
+
+    // SPI reads done: the fifo source register reads 'fifoSource', the
+    // samples in the fifo are filled with 'value'.
+    void CompleteBurst(uint8_t value, uint8_t fifoSource = FIFO_WTM | 25)
+    {
+        ASSERT_EQ(4, mCount);
+        ASSERT_EQ((FIFO_SRC | 0x80), mSegments[1].src[0]);
+        ASSERT_EQ(1, mSegments[2].length);
+        mSegments[2].dest[0] = fifoSource;
+        mCount = 0;
+        Done();
+
+        if (mCount == 0) { return; }                // Fifo empty, no read
+
+        ASSERT_EQ(4, mCount);
+        ASSERT_EQ(SPISegment::Type::Read, mSegments[2].type);
+        std::memset(mSegments[2].dest, value, mSegments[2].length);
+        mCount = 0;
+        Done();
+
+        if (mCount == 3)                            // Adapted watermark written
+        {
+            ASSERT_EQ(SPISegment::Type::Write, mSegments[1].type);
+            ASSERT_EQ(FIFO_CTRL, mSegments[1].src[0]);
+            mFifoCtrl = mSegments[1].src[1];
+            mCount    = 0;
+        }
+    }
+
+    // Complete the captured Transfer, which may start the next one.
+    void Done(bool result = true)
+    {
+        const Delegate<void(bool)> done = mDone;
+        done(result);
+    }
+
+    void Burst(uint8_t value, uint8_t fifoSource = FIFO_WTM | 25)
+    {
+        StartBurst();
+        CompleteBurst(value, fifoSource);
+    }
+
+    // Capture the bytes written blocking: register reads (address with read
+    // bit) and register writes (address, value).
+    void CaptureRegisterWrites()
+    {
+        ON_CALL(spi, WriteBlocking(_, _))
+            .WillByDefault(Invoke([this](const uint8_t* src, uint16_t length)
+            {
+                mWritten.insert(mWritten.end(), src, src + length);
+                return true;
+            }));
+    }
+
+    // The last value written blocking to 'reg', -1 if not written.
+    int LastRegisterWrite(uint8_t reg) const
+    {
+        int value = -1;
+        size_t i = 0;
+        while (i < mWritten.size())
+        {
+            if (mWritten[i] & 0x80) { i++; continue; }      // Register read
+
+            if ((mWritten[i] == reg) && (i + 1 < mWritten.size())) { value = mWritten[i + 1]; }
+            i += 2;
+        }
+        return value;
+    }
+
     LIS3DSH mSubject;
+
+    const SPISegment*    mSegments = nullptr;
+    uint8_t              mCount = 0;
+    Delegate<void(bool)> mDone;
+    uint8_t              mLengths[8] = {};
+    uint32_t             mHandlerCount = 0;
+    int                  mFifoCtrl = -1;
 };
 
 
@@ -34,9 +156,9 @@ TEST_F(LIS3DSH_Test, Init_IsInit_Sleep)
 {
     EXPECT_FALSE(mSubject.IsInit());
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.IsInit());
 
@@ -49,9 +171,9 @@ TEST_F(LIS3DSH_Test, Enable)
 {
     EXPECT_FALSE(mSubject.Enable());   // Not initialized yet
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.Enable());
 }
@@ -60,18 +182,18 @@ TEST_F(LIS3DSH_Test, Disable)
 {
     EXPECT_FALSE(mSubject.Disable());   // Not initialized yet
 
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     EXPECT_TRUE(mSubject.Disable());
 }
 
 TEST_F(LIS3DSH_Test, RetrieveAxesData)
 {
-    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(LIS3DSH::SampleFrequency::_50_Hz,
-                                              LIS3DSH::Scale::_2_G,
-                                              LIS3DSH::AntiAliasingFilter::_200_Hz)));
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz)));
 
     uint8_t motionArray[25 * 3 * 2] = {};       // 25 samples, X,Y,Z, 2 bytes/sample -- FIFO size
     uint8_t motionLength = sizeof(motionArray); // Normally returned from interupt when data received
@@ -81,5 +203,327 @@ TEST_F(LIS3DSH_Test, RetrieveAxesData)
     // Cannot check contents, this is filled in via SPI ReadDMA when Pin interrupt occurs.
 }
 
+TEST_F(LIS3DSH_Test, AcquireAxesData_nothing_read)
+{
+    InitStreaming(2);
+
+    LIS3DSH::AxesData axesData;
+    EXPECT_FALSE(mSubject.AcquireAxesData(axesData));
+}
+
+TEST_F(LIS3DSH_Test, AcquireAxesData_zero_copy_in_order)
+{
+    InitStreaming(2);
+
+    Burst(0x11);
+    Burst(0x22);
+
+    EXPECT_EQ(2, mHandlerCount);
+    EXPECT_EQ(BURST_LENGTH, mLengths[0]);
+
+    LIS3DSH::AxesData first;
+    ASSERT_TRUE(mSubject.AcquireAxesData(first));
+    EXPECT_EQ(BURST_LENGTH, first.length);
+    EXPECT_EQ(0x11, first.data[0]);
+    EXPECT_EQ(0x11, first.data[BURST_LENGTH - 1]);
+
+    LIS3DSH::AxesData second;
+    ASSERT_TRUE(mSubject.AcquireAxesData(second));
+    EXPECT_EQ(0x22, second.data[0]);
+    EXPECT_NE(first.data, second.data);
+
+    EXPECT_TRUE(mSubject.ReleaseAxesData(first));
+    EXPECT_TRUE(mSubject.ReleaseAxesData(second));
+    EXPECT_FALSE(mSubject.ReleaseAxesData(second));     // Already released
+
+    EXPECT_EQ(0, mSubject.GetOverrunCount());
+}
+
+TEST_F(LIS3DSH_Test, Acquired_data_not_overwritten)
+{
+    InitStreaming(2);
+
+    Burst(0x11);
+
+    LIS3DSH::AxesData slow;
+    ASSERT_TRUE(mSubject.AcquireAxesData(slow));
+
+    // Slow consumer: the next reads keep using the other slot
+    Burst(0x22);
+    Burst(0x33);
+    Burst(0x44);
+
+    EXPECT_EQ(0x11, slow.data[0]);
+    EXPECT_EQ(2, mSubject.GetOverrunCount());       // 0x22 and 0x33 overwritten
+
+    EXPECT_TRUE(mSubject.ReleaseAxesData(slow));
+
+    LIS3DSH::AxesData latest;
+    ASSERT_TRUE(mSubject.AcquireAxesData(latest));
+    EXPECT_EQ(0x44, latest.data[0]);
+    EXPECT_TRUE(mSubject.ReleaseAxesData(latest));
+}
+
+TEST_F(LIS3DSH_Test, Ring_keeps_reads_until_full)
+{
+    InitStreaming(LIS3DSH_MAX_READ_SLOTS);
+
+    for (uint8_t i = 0; i < LIS3DSH_MAX_READ_SLOTS; i++)
+    {
+        Burst(i + 1);
+    }
+    EXPECT_EQ(0, mSubject.GetOverrunCount());
+
+    Burst(0x55);                                    // Full: oldest (1) is dropped
+    EXPECT_EQ(1, mSubject.GetOverrunCount());
+
+    uint8_t expected[] = { 2, 3, 4, 0x55 };
+    for (uint8_t value : expected)
+    {
+        LIS3DSH::AxesData axesData;
+        ASSERT_TRUE(mSubject.AcquireAxesData(axesData));
+        EXPECT_EQ(value, axesData.data[0]);
+        EXPECT_TRUE(mSubject.ReleaseAxesData(axesData));
+    }
+}
+
+TEST_F(LIS3DSH_Test, Overrun_when_read_ongoing)
+{
+    InitStreaming(2);
+
+    StartBurst();
+    StartBurst();                                   // Previous read not done yet
+    EXPECT_EQ(1, mSubject.GetOverrunCount());
+
+    CompleteBurst(0x11);
+    EXPECT_EQ(1, mHandlerCount);
+}
+
+TEST_F(LIS3DSH_Test, Failed_read_frees_slot)
+{
+    InitStreaming(2);
+
+    // The Transfer fails on the bus: the slot is free again, counted as overrun
+    StartBurst();
+    Done(false);
+    EXPECT_EQ(0, mHandlerCount);
+    EXPECT_EQ(1, mSubject.GetOverrunCount());
+
+    LIS3DSH::AxesData axesData;
+    EXPECT_FALSE(mSubject.AcquireAxesData(axesData));
+
+    // The next burst is read as usual
+    Burst(0x11);
+    EXPECT_EQ(1, mHandlerCount);
+    ASSERT_TRUE(mSubject.AcquireAxesData(axesData));
+    EXPECT_EQ(0x11, axesData.data[0]);
+    EXPECT_TRUE(mSubject.ReleaseAxesData(axesData));
+}
+
+TEST_F(LIS3DSH_Test, RetrieveAxesData_copies_oldest)
+{
+    InitStreaming(2);
+
+    Burst(0x11);
+    Burst(0x22);
+
+    uint8_t motionArray[BURST_LENGTH] = {};
+
+    EXPECT_TRUE(mSubject.RetrieveAxesData(motionArray, sizeof(motionArray)));
+    EXPECT_EQ(0x11, motionArray[0]);
+    EXPECT_TRUE(mSubject.RetrieveAxesData(motionArray, sizeof(motionArray)));
+    EXPECT_EQ(0x22, motionArray[BURST_LENGTH - 1]);
+
+    LIS3DSH::AxesData axesData;
+    EXPECT_FALSE(mSubject.AcquireAxesData(axesData));   // Both released
+}
+
+TEST_F(LIS3DSH_Test, Init_invalid_read_slots)
+{
+    EXPECT_FALSE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                     0)));
+    EXPECT_FALSE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                     LIS3DSH_MAX_READ_SLOTS + 1)));
+}
+
+TEST_F(LIS3DSH_Test, Init_read_buffer_too_small)
+{
+    uint8_t readBuffer[LIS3DSH_READ_BUFFER_SIZE(true, 1)];
+    LIS3DSH subject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2, readBuffer, sizeof(readBuffer));
+
+    EXPECT_FALSE(subject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                    2)));
+    EXPECT_TRUE(subject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                   LIS3DSH::Scale::_2_G,
+                                                   LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                   1)));
+    EXPECT_TRUE(subject.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                    LIS3DSH_MAX_READ_SLOTS)));
+}
+
+TEST_F(LIS3DSH_Test, Init_without_read_buffer)
+{
+    LIS3DSH subject(spi, PIN_SPI1_CS, PIN_MOTION_INT1, PIN_MOTION_INT2, nullptr, 0);
+
+    EXPECT_FALSE(subject.Init(LIS3DSH::Config(false, LIS3DSH::SampleFrequency::_50_Hz)));
+}
+
+
+TEST_F(LIS3DSH_Test, Reads_exact_number_of_samples)
+{
+    InitStreaming(2);
+
+    Burst(0x11, FIFO_WTM | 7);
+
+    ASSERT_EQ(1, mHandlerCount);
+    EXPECT_EQ(7 * 3 * 2, mLengths[0]);
+
+    LIS3DSH::AxesData axesData;
+    ASSERT_TRUE(mSubject.AcquireAxesData(axesData));
+    EXPECT_EQ(7 * 3 * 2, axesData.length);
+    EXPECT_TRUE(mSubject.ReleaseAxesData(axesData));
+}
+
+TEST_F(LIS3DSH_Test, Empty_fifo_not_read)
+{
+    InitStreaming(2);
+
+    Burst(0x11, FIFO_EMPTY);
+
+    EXPECT_EQ(0, mHandlerCount);
+    EXPECT_EQ(0, mSubject.GetOverrunCount());
+
+    LIS3DSH::AxesData axesData;
+    EXPECT_FALSE(mSubject.AcquireAxesData(axesData));
+
+    Burst(0x22);                                    // Slot was released
+    EXPECT_EQ(1, mHandlerCount);
+}
+
+TEST_F(LIS3DSH_Test, Fifo_overrun_reads_full_fifo)
+{
+    InitStreaming(2);
+
+    Burst(0x11, FIFO_WTM | FIFO_OVRN | 0x1F);
+
+    ASSERT_EQ(1, mHandlerCount);
+    EXPECT_EQ(32 * 3 * 2, mLengths[0]);
+    EXPECT_EQ(1, mSubject.GetOverrunCount());
+}
+
+TEST_F(LIS3DSH_Test, Init_invalid_watermark)
+{
+    EXPECT_FALSE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                     2, 0)));
+    EXPECT_FALSE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                     LIS3DSH::Scale::_2_G,
+                                                     LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                     2, 32)));      // Beyond the 5 bit watermark field
+}
+
+TEST_F(LIS3DSH_Test, Init_writes_watermark)
+{
+    CaptureRegisterWrites();
+
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                    2, 10)));
+    EXPECT_EQ(10, mSubject.GetWatermark());
+    EXPECT_EQ(10, LastRegisterWrite(FIFO_CTRL));    // Bypass mode, watermark 10
+
+    EXPECT_FALSE(mSubject.SetWatermark(0));
+    EXPECT_FALSE(mSubject.SetWatermark(32));
+    EXPECT_TRUE(mSubject.SetWatermark(4));
+    EXPECT_EQ(4, mSubject.GetWatermark());
+    EXPECT_EQ(4, LastRegisterWrite(FIFO_CTRL) & 0x1F);
+}
+
+// The largest watermark fills the 5 bit field only: the fifo mode bits are
+// left as they are.
+TEST_F(LIS3DSH_Test, Maximum_watermark_keeps_fifo_mode)
+{
+    CaptureRegisterWrites();
+
+    EXPECT_TRUE(mSubject.Init(LIS3DSH::Config(true, LIS3DSH::SampleFrequency::_50_Hz,
+                                                    LIS3DSH::Scale::_2_G,
+                                                    LIS3DSH::AntiAliasingFilter::_200_Hz,
+                                                    2, 31)));
+    EXPECT_EQ(31,   mSubject.GetWatermark());
+    EXPECT_EQ(0x1F, LastRegisterWrite(FIFO_CTRL));  // Bypass mode, watermark 31
+
+    EXPECT_TRUE(mSubject.SetWatermark(31));         // The mock reads FIFO_CTRL as 0x3F: fifo mode
+    EXPECT_EQ(0x20 | 0x1F, LastRegisterWrite(FIFO_CTRL));
+}
+
+TEST_F(LIS3DSH_Test, Adaptive_watermark)
+{
+    InitStreaming(2, 25, 10);                       // 1600 Hz, 10 ms: at most 16 samples
+
+    EXPECT_EQ(16, mSubject.GetWatermark());
+
+    // Latency target missed: halved
+    Burst(0x11, FIFO_WTM | 20);
+    EXPECT_EQ(8, mSubject.GetWatermark());
+    EXPECT_EQ(0x40 | 8, mFifoCtrl);                 // Stream mode, watermark 8
+
+    // Within latency target: grows by one after a number of reads
+    for (uint8_t i = 0; i < 4; i++)
+    {
+        EXPECT_EQ(8, mSubject.GetWatermark());
+        Burst(0x22, FIFO_WTM | 8);
+
+        LIS3DSH::AxesData axesData;
+        ASSERT_TRUE(mSubject.AcquireAxesData(axesData));
+        EXPECT_TRUE(mSubject.ReleaseAxesData(axesData));
+    }
+    EXPECT_EQ(9, mSubject.GetWatermark());
+    EXPECT_EQ(0x40 | 9, mFifoCtrl);
+
+    // Fifo overrun: halved
+    Burst(0x33, FIFO_WTM | FIFO_OVRN | 0x1F);
+    EXPECT_EQ(4, mSubject.GetWatermark());
+}
+
+// A consumer not releasing its slots: the watermark is not lowered (no
+// extra interrupts), it grows up to the latency target instead.
+TEST_F(LIS3DSH_Test, Adaptive_watermark_slow_consumer)
+{
+    InitStreaming(2, 25, 10);                       // 1600 Hz, 10 ms: at most 16 samples
+
+    Burst(0x11, FIFO_WTM | 20);                     // Latency target missed: halved
+    ASSERT_EQ(8, mSubject.GetWatermark());
+
+    uint8_t previous = mSubject.GetWatermark();
+    for (uint8_t i = 0; i < 12; i++)
+    {
+        Burst(0x22, FIFO_WTM | mSubject.GetWatermark());
+        EXPECT_GE(mSubject.GetWatermark(), previous);
+        previous = mSubject.GetWatermark();
+    }
+    EXPECT_EQ(16, mSubject.GetWatermark());
+    EXPECT_EQ(0x40 | 16, mFifoCtrl);
+    EXPECT_LT(0, mSubject.GetOverrunCount());      // The consumer did lose data
+}
+
+TEST_F(LIS3DSH_Test, Fixed_watermark_does_not_adapt)
+{
+    InitStreaming(2, 16);
+
+    Burst(0x11, FIFO_WTM | FIFO_OVRN | 0x1F);
+    EXPECT_EQ(16, mSubject.GetWatermark());
+    EXPECT_EQ(-1, mFifoCtrl);
+}
+
 
 } // namespace
@@ -0,0 +1,282 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/PoolAllocator/PoolAllocator.hpp"
+
+// Supporting files
+#include "FreeRTOS.h"
+#include <algorithm>
+#include <chrono>
+#include <cstdio>
+#include <random>
+#include <string>
+#include <vector>
+
+
+namespace {
+
+
+static size_t   hookSize  = 0;
+static uint32_t hookCount = 0;
+
+static void FailureHook(size_t size)
+{
+    hookSize = size;
+    hookCount++;
+}
+
+
+// Fixture, 3 size classes: 4 blocks of 16, 4 of 64 and 2 of 256 bytes.
+class PoolAllocator_Test : public ::testing::Test
+{
+protected:
+    PoolBlocks<16, 4>  mPool16;
+    PoolBlocks<64, 4>  mPool64;
+    PoolBlocks<256, 2> mPool256;
+
+    void SetUp() override
+    {
+        hookSize  = 0;
+        hookCount = 0;
+
+        const PoolClass classes[] = { mPool16.GetClass(), mPool64.GetClass(), mPool256.GetClass() };
+        ASSERT_TRUE(PoolAllocator::Init(classes, 3));
+        PoolAllocator::SetFailureHook(FailureHook);
+    }
+
+    void TearDown() override
+    {
+        PoolAllocator::SetFailureHook(nullptr);
+    }
+
+    PoolStats Stats(uint8_t index)
+    {
+        PoolStats stats;
+        EXPECT_TRUE(PoolAllocator::GetStatistics(index, stats));
+        return stats;
+    }
+};
+
+
+TEST_F(PoolAllocator_Test, Init)
+{
+    EXPECT_EQ(3, PoolAllocator::GetClassCount());
+    EXPECT_EQ(4 * 16 + 4 * 64 + 2 * 256, PoolAllocator::GetFreeBytes());
+    EXPECT_EQ(64, Stats(1).blockSize);
+    EXPECT_EQ(4, Stats(1).blockCount);
+    EXPECT_EQ(0, Stats(1).inUse);
+
+    PoolBlocks<16, 2> pool;
+    PoolClass valid = pool.GetClass();
+    EXPECT_FALSE(PoolAllocator::Init(nullptr, 1));
+    EXPECT_FALSE(PoolAllocator::Init(&valid, 0));
+    EXPECT_FALSE(PoolAllocator::Init(&valid, POOL_ALLOCATOR_MAX_CLASSES + 1));
+
+    PoolClass invalid = valid;
+    invalid.memory = static_cast<uint8_t*>(valid.memory) + 1;      // Not aligned
+    EXPECT_FALSE(PoolAllocator::Init(&invalid, 1));
+    invalid = valid;
+    invalid.blockSize = 12;                                         // Not a multiple of the alignment
+    EXPECT_FALSE(PoolAllocator::Init(&invalid, 1));
+    invalid = valid;
+    invalid.blockCount = 0;
+    EXPECT_FALSE(PoolAllocator::Init(&invalid, 1));
+
+    const PoolClass descending[] = { mPool64.GetClass(), mPool16.GetClass() };
+    EXPECT_FALSE(PoolAllocator::Init(descending, 2));
+
+    // Failed Init() leaves the classes as they were
+    EXPECT_EQ(3, PoolAllocator::GetClassCount());
+}
+
+TEST_F(PoolAllocator_Test, Allocate_from_smallest_class)
+{
+    void* a = PoolAllocator::Allocate(1);
+    void* b = PoolAllocator::Allocate(16);
+    void* c = PoolAllocator::Allocate(17);
+    void* d = PoolAllocator::Allocate(200);
+
+    ASSERT_NE(nullptr, a);
+    ASSERT_NE(nullptr, b);
+    ASSERT_NE(nullptr, c);
+    ASSERT_NE(nullptr, d);
+    EXPECT_EQ(0, reinterpret_cast<uintptr_t>(c) % POOL_ALLOCATOR_ALIGNMENT);
+    EXPECT_EQ(2, Stats(0).inUse);
+    EXPECT_EQ(1, Stats(1).inUse);
+    EXPECT_EQ(1, Stats(2).inUse);
+
+    EXPECT_EQ(nullptr, PoolAllocator::Allocate(0));
+    EXPECT_EQ(0, hookCount);
+
+    // Larger than the largest block
+    EXPECT_EQ(nullptr, PoolAllocator::Allocate(257));
+    EXPECT_EQ(1, hookCount);
+    EXPECT_EQ(257, hookSize);
+    EXPECT_EQ(1, PoolAllocator::GetFailureCount());
+    EXPECT_EQ(0, Stats(2).failures);
+}
+
+TEST_F(PoolAllocator_Test, Exhausted_class_does_not_spill)
+{
+    void* blocks[4];
+    for (auto& block : blocks)
+    {
+        block = PoolAllocator::Allocate(8);
+        ASSERT_NE(nullptr, block);
+    }
+
+    EXPECT_EQ(nullptr, PoolAllocator::Allocate(8));
+    EXPECT_EQ(1, hookCount);
+    EXPECT_EQ(8, hookSize);
+    EXPECT_EQ(1, Stats(0).failures);
+    EXPECT_EQ(0, Stats(1).inUse);
+
+    // A freed block is handed out next
+    EXPECT_TRUE(PoolAllocator::Free(blocks[2]));
+    EXPECT_EQ(blocks[2], PoolAllocator::Allocate(8));
+}
+
+TEST_F(PoolAllocator_Test, High_water)
+{
+    void* a = PoolAllocator::Allocate(64);
+    void* b = PoolAllocator::Allocate(64);
+    void* c = PoolAllocator::Allocate(64);
+    EXPECT_TRUE(PoolAllocator::Free(a));
+    EXPECT_TRUE(PoolAllocator::Free(b));
+
+    const PoolStats stats = Stats(1);
+    EXPECT_EQ(1, stats.inUse);
+    EXPECT_EQ(3, stats.highWater);
+    EXPECT_EQ(3, stats.allocations);
+    EXPECT_EQ(0, stats.failures);
+
+    const size_t total = 4 * 16 + 4 * 64 + 2 * 256;
+    EXPECT_EQ(total - 64, PoolAllocator::GetFreeBytes());
+    EXPECT_EQ(total - (3 * 64), PoolAllocator::GetMinimumEverFreeBytes());
+
+    EXPECT_TRUE(PoolAllocator::Free(c));
+    EXPECT_EQ(total, PoolAllocator::GetFreeBytes());
+}
+
+TEST_F(PoolAllocator_Test, Free_invalid)
+{
+    uint8_t other[16];
+    uint8_t* a = static_cast<uint8_t*>(PoolAllocator::Allocate(64));
+    ASSERT_NE(nullptr, a);
+
+    EXPECT_TRUE(PoolAllocator::Free(nullptr));
+    EXPECT_FALSE(PoolAllocator::Free(other));                       // Not from a class
+    EXPECT_FALSE(PoolAllocator::Free(a + 8));                       // Not the start of a block
+    EXPECT_EQ(1, Stats(1).inUse);
+
+    EXPECT_TRUE(PoolAllocator::Free(a));
+    EXPECT_FALSE(PoolAllocator::Free(a));                           // None in use
+    EXPECT_EQ(0, Stats(1).inUse);
+}
+
+
+// Host side benchmark: latency of each allocate and free, pool versus
+// heap_4.c, with the same random sequence of sizes and lifetimes. Prints
+// the distributions, does not fail on timing. Disabled: run with
+// --gtest_also_run_disabled_tests.
+struct Latency
+{
+    double median;
+    double p99;
+    double max;
+};
+
+static Latency Distribution(std::vector<double>& samples)
+{
+    std::sort(samples.begin(), samples.end());
+    return Latency { samples[samples.size() / 2], samples[(samples.size() * 99) / 100], samples.back() };
+}
+
+template <typename Allocate, typename Free>
+static void RunSequence(Allocate allocate, Free release, std::vector<double>& allocNs, std::vector<double>& freeNs)
+{
+    static constexpr uint32_t ROUNDS = 20000;
+    static constexpr size_t   LIVE   = 24;
+    static constexpr size_t   SIZES[] = { 8, 12, 24, 40, 60, 100, 160, 240 };
+
+    std::mt19937 random(42);
+    void* live[LIVE] = {};
+
+    for (uint32_t r = 0; r < ROUNDS; r++)
+    {
+        const size_t slot = random() % LIVE;
+        if (live[slot] != nullptr)
+        {
+            const auto start = std::chrono::steady_clock::now();
+            release(live[slot]);
+            const auto end = std::chrono::steady_clock::now();
+            freeNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            live[slot] = nullptr;
+        }
+        else
+        {
+            const size_t size = SIZES[random() % (sizeof(SIZES) / sizeof(SIZES[0]))];
+            const auto start = std::chrono::steady_clock::now();
+            live[slot] = allocate(size);
+            const auto end = std::chrono::steady_clock::now();
+            allocNs.push_back(std::chrono::duration<double, std::nano>(end - start).count());
+            ASSERT_NE(nullptr, live[slot]);
+        }
+    }
+    for (auto& block : live) { release(block); }
+}
+
+// The benchmark sequence itself: no failures, everything freed again.
+TEST(PoolAllocator_Benchmark, Sequence_versus_heap_4)
+{
+    static PoolBlocks<16, 24>  pool16;
+    static PoolBlocks<64, 24>  pool64;
+    static PoolBlocks<256, 24> pool256;
+    const PoolClass classes[] = { pool16.GetClass(), pool64.GetClass(), pool256.GetClass() };
+    ASSERT_TRUE(PoolAllocator::Init(classes, 3));
+
+    std::vector<double> poolAlloc, poolFree, heapAlloc, heapFree;
+    RunSequence(PoolAllocator::Allocate, PoolAllocator::Free, poolAlloc, poolFree);
+    RunSequence(pvPortMalloc, vPortFree, heapAlloc, heapFree);
+
+    // Everything freed: heap_4 coalesced back into a single free block
+    HeapStats_t heapStats;
+    vPortGetHeapStats(&heapStats);
+    EXPECT_EQ(1, heapStats.xNumberOfFreeBlocks);
+    EXPECT_EQ(0, PoolAllocator::GetFailureCount());
+    for (uint8_t i = 0; i < 3; i++)
+    {
+        PoolStats stats;
+        ASSERT_TRUE(PoolAllocator::GetStatistics(i, stats));
+        EXPECT_EQ(0, stats.inUse);
+    }
+}
+
+TEST(PoolAllocator_Benchmark, DISABLED_Latency_versus_heap_4)
+{
+    static PoolBlocks<16, 24>  pool16;
+    static PoolBlocks<64, 24>  pool64;
+    static PoolBlocks<256, 24> pool256;
+    const PoolClass classes[] = { pool16.GetClass(), pool64.GetClass(), pool256.GetClass() };
+    ASSERT_TRUE(PoolAllocator::Init(classes, 3));
+
+    std::vector<double> poolAlloc, poolFree, heapAlloc, heapFree;
+    RunSequence(PoolAllocator::Allocate, PoolAllocator::Free, poolAlloc, poolFree);
+    RunSequence(pvPortMalloc, vPortFree, heapAlloc, heapFree);
+
+    const Latency pa = Distribution(poolAlloc);
+    const Latency pf = Distribution(poolFree);
+    const Latency ha = Distribution(heapAlloc);
+    const Latency hf = Distribution(heapFree);
+
+    std::printf("[ BENCH    ] pool   alloc: median %.0f ns, p99 %.0f ns, max %.0f ns; free: median %.0f ns, p99 %.0f ns, max %.0f ns\n",
+                pa.median, pa.p99, pa.max, pf.median, pf.p99, pf.max);
+    std::printf("[ BENCH    ] heap_4 alloc: median %.0f ns, p99 %.0f ns, max %.0f ns; free: median %.0f ns, p99 %.0f ns, max %.0f ns\n",
+                ha.median, ha.p99, ha.max, hf.median, hf.p99, hf.max);
+    RecordProperty("pool_alloc_p99_ns",   std::to_string(pa.p99));
+    RecordProperty("heap_4_alloc_p99_ns", std::to_string(ha.p99));
+}
+
+
+} // namespace
@@ -0,0 +1,238 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+// Fixture, the fake DWT cycle counter is set by hand: it serves as clock.
+// The task handles are the addresses of dummy objects.
+class RunTimeStats_Test : public ::testing::Test
+{
+protected:
+    static constexpr uint32_t PERIOD = 1000;
+
+    uint8_t mTaskA = 0;
+    uint8_t mTaskB = 0;
+    uint8_t mIdle  = 0;
+
+    void SetUp() override
+    {
+        FakeHal_Reset();
+        ASSERT_TRUE(RunTimeStats::Init(PERIOD));
+    }
+
+    void At(uint32_t cycles) { DWT->CYCCNT = cycles; }
+
+    void Switch(const void* handle, const char* name)
+    {
+        RunTimeStats::TaskSwitchedOut();
+        RunTimeStats::TaskSwitchedIn(handle, name);
+    }
+};
+
+
+TEST_F(RunTimeStats_Test, Init)
+{
+    EXPECT_TRUE(CoreDebug->DEMCR & CoreDebug_DEMCR_TRCENA_Msk);
+    EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+    EXPECT_EQ(0, RunTimeStats::GetEntryCount());
+    EXPECT_FALSE(RunTimeStats::IsUpdated());
+
+    EXPECT_FALSE(RunTimeStats::Init(0));
+    EXPECT_FALSE(RunTimeStats::Init(0x80000000));
+}
+
+TEST_F(RunTimeStats_Test, Tasks_isr_and_idle)
+{
+    const uint8_t isr = RunTimeStats::RegisterIsr("EXTI0");
+    RunTimeEntryStats stats;
+
+    At(0);   RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(100); RunTimeStats::IsrEnter(isr);
+    At(130); RunTimeStats::IsrExit(isr);            // Not charged to task A
+    At(300); Switch(&mIdle, "IDLE");
+    At(400); RunTimeStats::IdleHook();
+    EXPECT_FALSE(RunTimeStats::IsUpdated());
+
+    At(1000); RunTimeStats::IdleHook();             // Closes the period
+    EXPECT_TRUE(RunTimeStats::IsUpdated());
+    EXPECT_EQ(3, RunTimeStats::GetEntryCount());
+    EXPECT_EQ(2, RunTimeStats::GetContextSwitches());
+    EXPECT_EQ(700, RunTimeStats::GetIdlePermille());
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(isr, stats));
+    EXPECT_STREQ("EXTI0", stats.name);
+    EXPECT_EQ(RunTimeKind::Isr, stats.kind);
+    EXPECT_EQ(30, stats.cycles);
+    EXPECT_EQ(1, stats.count);
+    EXPECT_EQ(30, stats.permille);
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(1, stats));
+    EXPECT_STREQ("A", stats.name);
+    EXPECT_EQ(RunTimeKind::Task, stats.kind);
+    EXPECT_EQ(270, stats.cycles);
+    EXPECT_EQ(270, stats.permille);
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(2, stats));
+    EXPECT_EQ(RunTimeKind::Idle, stats.kind);
+    EXPECT_EQ(700, stats.cycles);
+
+    // Next period: only idle ran, not switched in again
+    At(2000); RunTimeStats::IdleHook();
+    EXPECT_EQ(1000, RunTimeStats::GetIdlePermille());
+    EXPECT_EQ(0, RunTimeStats::GetContextSwitches());
+    ASSERT_TRUE(RunTimeStats::GetStatistics(2, stats));
+    EXPECT_EQ(0, stats.count);
+
+    EXPECT_FALSE(RunTimeStats::GetStatistics(3, stats));
+}
+
+TEST_F(RunTimeStats_Test, Task_switches)
+{
+    At(0);   RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(100); Switch(&mTaskB, "B");
+    At(150); Switch(&mTaskA, "A");
+    At(250); Switch(&mTaskB, "B");
+    At(400); Switch(&mIdle, "IDLE");
+    At(1000); RunTimeStats::IdleHook();
+
+    RunTimeEntryStats stats;
+    EXPECT_EQ(3, RunTimeStats::GetEntryCount());
+    EXPECT_EQ(5, RunTimeStats::GetContextSwitches());
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(0, stats));
+    EXPECT_EQ(200, stats.cycles);
+    EXPECT_EQ(2, stats.count);
+    ASSERT_TRUE(RunTimeStats::GetStatistics(1, stats));
+    EXPECT_EQ(200, stats.cycles);
+    EXPECT_EQ(2, stats.count);
+    EXPECT_EQ(600, RunTimeStats::GetIdlePermille());
+}
+
+TEST_F(RunTimeStats_Test, Nested_isr)
+{
+    const uint8_t low  = RunTimeStats::RegisterIsr("Low");
+    const uint8_t high = RunTimeStats::RegisterIsr("High");
+    RunTimeEntryStats stats;
+
+    At(0);   RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(100); RunTimeStats::IsrEnter(low);
+    At(110); RunTimeStats::IsrEnter(high);
+    At(140); RunTimeStats::IsrExit(high);
+    At(200); RunTimeStats::IsrExit(low);
+    RunTimeStats::IsrExit(low);                     // Unbalanced exit is ignored
+    At(500); Switch(&mIdle, "IDLE");
+    At(1000); RunTimeStats::IdleHook();
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(low, stats));
+    EXPECT_EQ(100, stats.cycles);                   // Includes the nested ISR
+    EXPECT_EQ(1, stats.count);
+    ASSERT_TRUE(RunTimeStats::GetStatistics(high, stats));
+    EXPECT_EQ(30, stats.cycles);
+    ASSERT_TRUE(RunTimeStats::GetStatistics(2, stats));
+    EXPECT_EQ(400, stats.cycles);
+}
+
+TEST_F(RunTimeStats_Test, Counter_wraps)
+{
+    At(UINT32_MAX - 99);
+    ASSERT_TRUE(RunTimeStats::Init(PERIOD));
+
+    RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(400); Switch(&mIdle, "IDLE");
+    At(900); RunTimeStats::IdleHook();
+
+    RunTimeEntryStats stats;
+    ASSERT_TRUE(RunTimeStats::GetStatistics(0, stats));
+    EXPECT_EQ(500, stats.cycles);
+    EXPECT_EQ(500, RunTimeStats::GetIdlePermille());
+}
+
+// The cycle counter does not count while sleeping: the slept cycles are
+// charged to the idle task and lengthen the period.
+TEST_F(RunTimeStats_Test, Slept_charged_to_idle)
+{
+    RunTimeEntryStats stats;
+
+    At(0);   RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(200); Switch(&mIdle, "IDLE");
+    At(300); RunTimeStats::IdleHook();
+    At(400); RunTimeStats::Slept(600);
+    At(500); RunTimeStats::IdleHook();              // 1100 cycles passed: closes the period
+
+    EXPECT_TRUE(RunTimeStats::IsUpdated());
+    EXPECT_EQ(818, RunTimeStats::GetIdlePermille());
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(1, stats));
+    EXPECT_EQ(RunTimeKind::Idle, stats.kind);
+    EXPECT_EQ(900, stats.cycles);
+
+    ASSERT_TRUE(RunTimeStats::GetStatistics(0, stats));
+    EXPECT_EQ(200, stats.cycles);
+    EXPECT_EQ(181, stats.permille);
+}
+
+TEST_F(RunTimeStats_Test, Report)
+{
+    const uint8_t isr = RunTimeStats::RegisterIsr("EXTI0");
+
+    At(0);   RunTimeStats::TaskSwitchedIn(&mTaskA, "A");
+    At(100); RunTimeStats::IsrEnter(isr);
+    At(150); RunTimeStats::IsrExit(isr);
+    At(250); Switch(&mIdle, "IDLE");
+    At(1000); RunTimeStats::IdleHook();
+
+    uint8_t report[RUNTIME_STATS_REPORT_SIZE(RUNTIME_STATS_MAX_ENTRIES)] = {};
+    EXPECT_EQ(0, RunTimeStats::GetReport(nullptr, sizeof(report)));
+    EXPECT_EQ(0, RunTimeStats::GetReport(report, RUNTIME_STATS_REPORT_SIZE(3) - 1));
+    EXPECT_TRUE(RunTimeStats::IsUpdated());
+
+    ASSERT_EQ(RUNTIME_STATS_REPORT_SIZE(3), RunTimeStats::GetReport(report, sizeof(report)));
+    EXPECT_FALSE(RunTimeStats::IsUpdated());
+
+    const uint8_t expected[RUNTIME_STATS_REPORT_SIZE(3)] = {
+        RUNTIME_STATS_REPORT_ID, 3, 0xEE, 0x02,     // Idle 750 permille
+        0xE8, 0x03, 0x00, 0x00,                     // Period 1000 cycles
+        0x02, 0x00, 0x00, 0x00,                     // 2 context switches
+        0, 2, 50,   0x00, 1, 0, 0, 0,               // ISR:  50 permille, called once
+        1, 0, 200,  0x00, 1, 0, 0, 0,               // Task: 200 permille, switched in once
+        2, 1, 0xEE, 0x02, 1, 0, 0, 0,               // Idle: 750 permille, switched in once
+    };
+    for (size_t i = 0; i < sizeof(expected); i++)
+    {
+        EXPECT_EQ(expected[i], report[i]) << "at index " << i;
+    }
+}
+
+TEST_F(RunTimeStats_Test, Entries_full)
+{
+    uint8_t tasks[RUNTIME_STATS_MAX_ENTRIES + 1];
+
+    for (uint8_t i = 0; i < RUNTIME_STATS_MAX_ENTRIES; i++)
+    {
+        RunTimeStats::TaskSwitchedIn(&tasks[i], "T");
+    }
+    EXPECT_EQ(RUNTIME_STATS_MAX_ENTRIES, RunTimeStats::GetEntryCount());
+
+    // Further tasks and ISRs are not measured, but counted as switches
+    RunTimeStats::TaskSwitchedIn(&tasks[RUNTIME_STATS_MAX_ENTRIES], "T");
+    RunTimeStats::TaskSwitchedOut();
+    EXPECT_EQ(RUNTIME_STATS_INVALID, RunTimeStats::RegisterIsr("ISR"));
+    RunTimeStats::IsrEnter(RUNTIME_STATS_INVALID);
+    RunTimeStats::IsrExit(RUNTIME_STATS_INVALID);
+    EXPECT_EQ(RUNTIME_STATS_MAX_ENTRIES, RunTimeStats::GetEntryCount());
+
+    At(PERIOD);
+    RunTimeStats::Update();
+    EXPECT_EQ(RUNTIME_STATS_MAX_ENTRIES + 1, RunTimeStats::GetContextSwitches());
+}
+
+
+} // namespace
@@ -0,0 +1,252 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/SPI/SPI.hpp"
+
+// Supporting files
+#include "board/BoardConfig.hpp"
+#include "drivers/Pin/Pin.hpp"
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+// Test fixture for SPI - scatter-gather Transfer.
+class SPI_Test : public ::testing::Test
+{
+protected:
+    SPI_Test() :
+        mSubject(SPIInstance::SPI_1),
+        mChipSelect(PIN_SPI1_CS)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+    }
+
+    void InitWithDma()
+    {
+        EXPECT_TRUE(mSubject.Init(SPI::Config(5, SPI::Mode::_3, 1000000)));
+        mSubject.GetDmaTxHandle() = &mDmaTx;
+        mSubject.GetDmaRxHandle() = &mDmaRx;
+    }
+
+    void Done() { mHandlerCount++; }
+    void Done(bool result) { mHandlerCount++; mResult = result; }
+
+    SPI               mSubject;
+    Pin               mChipSelect;
+    DMA_HandleTypeDef mDmaTx = {};
+    DMA_HandleTypeDef mDmaRx = {};
+    uint32_t          mHandlerCount = 0;
+    bool              mResult = false;
+};
+
+
+TEST_F(SPI_Test, Transfer_not_initialized)
+{
+    uint8_t address = 0x28;
+    SPISegment segments[] = { SPISegment::Write(&address, 1) };
+
+    EXPECT_FALSE(mSubject.Transfer(segments, 1, [this](bool result) { this->Done(result); }));
+    EXPECT_EQ(0, FakeHal_GetEventCount());
+}
+
+TEST_F(SPI_Test, Transfer_without_dma)
+{
+    EXPECT_TRUE(mSubject.Init(SPI::Config(5, SPI::Mode::_3, 1000000)));
+
+    uint8_t address = 0x28;
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_FALSE(mSubject.Transfer(segments, 3, [this](bool result) { this->Done(result); }));
+    EXPECT_EQ(0, FakeHal_GetEventCount());      // Rejected before the ChipSelect is touched
+}
+
+TEST_F(SPI_Test, Transfer_chip_select_only)
+{
+    InitWithDma();
+
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    // No data segment: rejected, the handler would run within Transfer()
+    EXPECT_FALSE(mSubject.Transfer(segments, 2, [this](bool result) { this->Done(result); }));
+    EXPECT_EQ(0, FakeHal_GetEventCount());
+    EXPECT_EQ(0, mHandlerCount);
+
+    // Not busy afterwards
+    uint8_t address = 0x28;
+    SPISegment write[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                           SPISegment::Write(&address, 1),
+                           SPISegment::ChipSelectDeassert(mChipSelect) };
+    EXPECT_TRUE(mSubject.Transfer(write, 3, [this](bool result) { this->Done(result); }));
+    FakeHal_CompleteSpiDma();
+    EXPECT_EQ(1, mHandlerCount);
+}
+
+TEST_F(SPI_Test, Transfer_register_read)
+{
+    InitWithDma();
+
+    const uint8_t fifo[6] = { 0x01, 0x02, 0x03, 0x04, 0x05, 0x06 };
+    FakeHal_SetSpiRxData(fifo, sizeof(fifo));
+
+    uint8_t address = 0xA8;
+    uint8_t data[6] = {};
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::Read(data, sizeof(data)),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+
+    // ChipSelect low, address write started
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_GPIO_WRITE_PIN,   FakeHal_GetEvent(0).call);
+    EXPECT_EQ(GPIO_PIN_RESET,            FakeHal_GetEvent(0).value);
+    EXPECT_EQ(FAKE_HAL_SPI_TRANSMIT_DMA, FakeHal_GetEvent(1).call);
+    EXPECT_EQ(0xA8,                      FakeHal_GetEvent(1).value);
+    EXPECT_EQ(1,                         FakeHal_GetEvent(1).length);
+    EXPECT_EQ(0, mHandlerCount);
+
+    // A second Transfer is rejected while busy
+    EXPECT_FALSE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+
+    // Address written: read started from the interrupt
+    FakeHal_CompleteSpiDma();
+    ASSERT_EQ(3, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_SPI_RECEIVE_DMA, FakeHal_GetEvent(2).call);
+    EXPECT_EQ(6,                        FakeHal_GetEvent(2).length);
+    EXPECT_EQ(0, mHandlerCount);
+
+    // Data read: ChipSelect high, handler called
+    FakeHal_CompleteSpiDma();
+    ASSERT_EQ(4, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_GPIO_WRITE_PIN, FakeHal_GetEvent(3).call);
+    EXPECT_EQ(GPIO_PIN_SET,            FakeHal_GetEvent(3).value);
+    EXPECT_EQ(1, mHandlerCount);
+    EXPECT_TRUE(mResult);
+
+    for (uint8_t i = 0; i < sizeof(data); i++)
+    {
+        EXPECT_EQ(fifo[i], data[i]);
+    }
+
+    // Not busy anymore
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+    FakeHal_CompleteSpiDma();
+    FakeHal_CompleteSpiDma();
+    EXPECT_TRUE(mResult);
+}
+
+TEST_F(SPI_Test, Transfer_start_failure_releases_chip_select)
+{
+    InitWithDma();
+
+    // Occupy the fake DMA, the Transfer cannot start its data segment
+    uint8_t other = 0x55;
+    EXPECT_TRUE(mSubject.WriteDMA(&other, 1, nullptr));
+
+    uint8_t address = 0xA8;
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_FALSE(mSubject.Transfer(segments, 3, [this](bool result) { this->Done(result); }));
+
+    ASSERT_EQ(3, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_RESET, FakeHal_GetEvent(1).value);
+    EXPECT_EQ(GPIO_PIN_SET,   FakeHal_GetEvent(2).value);
+    EXPECT_EQ(0, mHandlerCount);
+}
+
+TEST_F(SPI_Test, Transfer_failure_from_interrupt_calls_handler)
+{
+    InitWithDma();
+
+    uint8_t address = 0xA8;
+    uint8_t data[6] = {};
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::Read(data, sizeof(data)),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+
+    // Address written, the read cannot start: ChipSelect high, failure reported
+    FakeHal_FailSpiDmaStarts(1);
+    FakeHal_CompleteSpiDma();
+    ASSERT_EQ(3, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_SET, FakeHal_GetEvent(2).value);
+    EXPECT_EQ(1, mHandlerCount);
+    EXPECT_FALSE(mResult);
+
+    // Not busy anymore
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+    FakeHal_CompleteSpiDma();
+    FakeHal_CompleteSpiDma();
+    EXPECT_TRUE(mResult);
+}
+
+TEST_F(SPI_Test, Transfer_error_callback_calls_handler)
+{
+    InitWithDma();
+
+    uint8_t address = 0xA8;
+    uint8_t data[6] = {};
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::Read(data, sizeof(data)),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+    FakeHal_CompleteSpiDma();
+
+    // DMA error during the read: ChipSelect high, failure reported
+    FakeHal_ErrorSpiDma();
+    ASSERT_EQ(4, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_SET, FakeHal_GetEvent(3).value);
+    EXPECT_EQ(1, mHandlerCount);
+    EXPECT_FALSE(mResult);
+
+    EXPECT_TRUE(mSubject.Transfer(segments, 4, [this](bool result) { this->Done(result); }));
+    FakeHal_CompleteSpiDma();
+    FakeHal_CompleteSpiDma();
+    EXPECT_TRUE(mResult);
+}
+
+TEST_F(SPI_Test, Sleep_during_transfer_calls_handler)
+{
+    InitWithDma();
+
+    uint8_t address = 0xA8;
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mChipSelect),
+                              SPISegment::Write(&address, 1),
+                              SPISegment::ChipSelectDeassert(mChipSelect) };
+
+    EXPECT_TRUE(mSubject.Transfer(segments, 3, [this](bool result) { this->Done(result); }));
+    EXPECT_TRUE(mSubject.Sleep());
+    EXPECT_EQ(1, mHandlerCount);
+    EXPECT_FALSE(mResult);
+}
+
+TEST_F(SPI_Test, WriteReadDMA_handler_called)
+{
+    InitWithDma();
+
+    uint8_t src[2]  = { 0x8F, 0x00 };
+    uint8_t dest[2] = {};
+
+    EXPECT_TRUE(mSubject.WriteReadDMA(src, dest, sizeof(src), [this]() { this->Done(); }));
+    EXPECT_EQ(0, mHandlerCount);
+
+    FakeHal_CompleteSpiDma();
+    EXPECT_EQ(1, mHandlerCount);
+}
+
+
+} // namespace
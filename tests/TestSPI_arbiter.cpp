@@ -0,0 +1,303 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "arbiters/SPI/SPI_arbiter.hpp"
+
+// Supporting files
+#include "board/BoardConfig.hpp"
+#include "drivers/Pin/Pin.hpp"
+#include "drivers/SPI/SPI.hpp"
+#include "stm32f4xx_hal.h"
+#include <cstdio>
+#include <vector>
+
+
+namespace {
+
+
+// Constants
+static constexpr uint32_t CHUNK_TICKS  = 100;     // Duration of a display chunk on the bus
+static constexpr uint32_t MOTION_TICKS = 10;      // Duration of an accelerometer read on the bus
+static constexpr uint32_t CHUNKS       = 30;      // Display chunks per frame
+
+
+// Fake clock for the wait time counters.
+static uint32_t fakeClock = 0;
+
+
+// Test fixture for SPI_arbiter - three devices on a single bus.
+class SPI_arbiter_Test : public ::testing::Test
+{
+protected:
+    SPI_arbiter_Test() :
+        mSpi(SPIInstance::SPI_1),
+        mMotionCS(PIN_SPI1_CS),
+        mDisplayCS(PIN_SPI2_CS),
+        mOtherCS(PIN_LED_RED),
+        mSubject(mSpi, []() { return fakeClock; }),
+        mMotion(mSubject, SPI_arbiter::Priority::High, &mMotionCS),
+        mDisplay(mSubject, SPI_arbiter::Priority::Low, &mDisplayCS),
+        mOther(mSubject, SPI_arbiter::Priority::Normal, &mOtherCS)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+        fakeClock = 0;
+
+        EXPECT_TRUE(mSpi.Init(SPI::Config(5, SPI::Mode::_3, 1000000)));
+        mSpi.GetDmaTxHandle() = &mDmaTx;
+        mSpi.GetDmaRxHandle() = &mDmaRx;
+    }
+
+    // Order in which the ChipSelects went low, as GPIO pin numbers.
+    std::vector<uint16_t> GrantOrder() const
+    {
+        std::vector<uint16_t> order;
+        for (uint32_t i = 0; i < FakeHal_GetEventCount(); i++)
+        {
+            FakeHalEvent event = FakeHal_GetEvent(i);
+            if ((event.call == FAKE_HAL_GPIO_WRITE_PIN) && (event.value == GPIO_PIN_RESET))
+            {
+                order.push_back(event.length);
+            }
+        }
+        return order;
+    }
+
+    // Request the next display chunk, the done handler streams the rest.
+    bool StreamChunk()
+    {
+        return mDisplay.WriteDMA(mFrame, sizeof(mFrame), Delegate<void()>::Create<SPI_arbiter_Test, &SPI_arbiter_Test::DisplayChunkDone>(this));
+    }
+
+    void DisplayChunkDone()
+    {
+        if (++mDisplayDone < CHUNKS)
+        {
+            EXPECT_TRUE(StreamChunk());
+        }
+    }
+
+    SPI                 mSpi;
+    DMA_HandleTypeDef   mDmaTx = {};
+    DMA_HandleTypeDef   mDmaRx = {};
+    Pin                 mMotionCS;
+    Pin                 mDisplayCS;
+    Pin                 mOtherCS;
+    SPI_arbiter         mSubject;
+    SPI_arbiter::Client mMotion;
+    SPI_arbiter::Client mDisplay;
+    SPI_arbiter::Client mOther;
+
+    uint8_t  mFrame[64]     = {};
+    uint8_t  mAxes[6]       = {};
+    uint8_t  mCommand[2]    = { 0x0C, 0x01 };
+    uint32_t mMotionDone    = 0;
+    uint32_t mDisplayDone   = 0;
+    uint32_t mOtherDone     = 0;
+};
+
+
+TEST_F(SPI_arbiter_Test, Free_bus_starts_immediately)
+{
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+    EXPECT_TRUE(mSubject.IsBusy());
+
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_GPIO_WRITE_PIN,   FakeHal_GetEvent(0).call);
+    EXPECT_EQ(GPIO_PIN_RESET,            FakeHal_GetEvent(0).value);
+    EXPECT_EQ(GPIO_PIN_12,               FakeHal_GetEvent(0).length);
+    EXPECT_EQ(FAKE_HAL_SPI_TRANSMIT_DMA, FakeHal_GetEvent(1).call);
+    EXPECT_EQ(64,                        FakeHal_GetEvent(1).length);
+
+    FakeHal_CompleteSpiDma();
+
+    ASSERT_EQ(3, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_SET, FakeHal_GetEvent(2).value);
+    EXPECT_EQ(GPIO_PIN_12,  FakeHal_GetEvent(2).length);
+    EXPECT_EQ(1, mDisplayDone);
+    EXPECT_FALSE(mSubject.IsBusy());
+    EXPECT_EQ(0, __get_PRIMASK());      // Interrupts restored
+}
+
+TEST_F(SPI_arbiter_Test, Priority_order)
+{
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+
+    // Queued while the display holds the bus, High priority last
+    EXPECT_TRUE(mOther.WriteDMA(mCommand, sizeof(mCommand), [this]() { mOtherDone++; }));
+    EXPECT_TRUE(mMotion.ReadDMA(mAxes, sizeof(mAxes), [this]() { mMotionDone++; }));
+    EXPECT_EQ(2, mSubject.GetQueueDepth());
+
+    FakeHal_CompleteSpiDma();       // Display done: Motion granted
+    FakeHal_CompleteSpiDma();       // Motion done: Other granted
+    FakeHal_CompleteSpiDma();       // Other done: bus free
+
+    const std::vector<uint16_t> expected = { GPIO_PIN_12, GPIO_PIN_3, GPIO_PIN_14 };
+    EXPECT_EQ(expected, GrantOrder());
+    EXPECT_EQ(1, mDisplayDone);
+    EXPECT_EQ(1, mMotionDone);
+    EXPECT_EQ(1, mOtherDone);
+    EXPECT_EQ(0, mSubject.GetQueueDepth());
+    EXPECT_EQ(2, mSubject.GetMaxQueueDepth());
+    EXPECT_FALSE(mSubject.IsBusy());
+}
+
+TEST_F(SPI_arbiter_Test, Second_request_rejected_while_pending)
+{
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+    EXPECT_FALSE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+
+    EXPECT_EQ(1, mDisplay.GetStatistics().requests);
+    EXPECT_EQ(1, mDisplay.GetStatistics().rejected);
+
+    FakeHal_CompleteSpiDma();
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+}
+
+TEST_F(SPI_arbiter_Test, Transfer_with_client_chip_select)
+{
+    uint8_t address = 0xA8;
+    SPISegment segments[] = { SPISegment::Write(&address, 1),
+                              SPISegment::Read(mAxes, sizeof(mAxes)) };
+
+    EXPECT_TRUE(mMotion.Transfer(segments, 2, [this](bool) { mMotionDone++; }));
+
+    FakeHal_CompleteSpiDma();       // Address written
+    EXPECT_EQ(0, mMotionDone);
+    FakeHal_CompleteSpiDma();       // Data read
+
+    ASSERT_EQ(4, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_RESET,            FakeHal_GetEvent(0).value);
+    EXPECT_EQ(FAKE_HAL_SPI_TRANSMIT_DMA, FakeHal_GetEvent(1).call);
+    EXPECT_EQ(FAKE_HAL_SPI_RECEIVE_DMA,  FakeHal_GetEvent(2).call);
+    EXPECT_EQ(GPIO_PIN_SET,              FakeHal_GetEvent(3).value);
+    EXPECT_EQ(1, mMotionDone);
+}
+
+TEST_F(SPI_arbiter_Test, Transfer_without_data_rejected)
+{
+    SPISegment segments[] = { SPISegment::ChipSelectAssert(mOtherCS),
+                              SPISegment::ChipSelectDeassert(mOtherCS) };
+
+    // Also while the bus is busy: not queued, the handler is never called
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+    EXPECT_FALSE(mMotion.Transfer(segments, 2, [this](bool) { mMotionDone++; }));
+
+    FakeHal_CompleteSpiDma();
+    EXPECT_EQ(1, mDisplayDone);
+    EXPECT_EQ(0, mMotionDone);
+    EXPECT_EQ(0, mMotion.GetStatistics().requests);
+    EXPECT_FALSE(mSubject.IsBusy());
+}
+
+TEST_F(SPI_arbiter_Test, Blocking_waits_for_free_bus_then_queue_continues)
+{
+    EXPECT_TRUE(mOther.WriteBlocking(mCommand, sizeof(mCommand)));
+
+    ASSERT_EQ(3, FakeHal_GetEventCount());
+    EXPECT_EQ(GPIO_PIN_RESET,        FakeHal_GetEvent(0).value);
+    EXPECT_EQ(FAKE_HAL_SPI_TRANSMIT, FakeHal_GetEvent(1).call);
+    EXPECT_EQ(GPIO_PIN_SET,          FakeHal_GetEvent(2).value);
+    EXPECT_FALSE(mSubject.IsBusy());
+
+    EXPECT_TRUE(mMotion.ReadDMA(mAxes, sizeof(mAxes), [this]() { mMotionDone++; }));
+    FakeHal_CompleteSpiDma();
+    EXPECT_EQ(1, mMotionDone);
+}
+
+TEST_F(SPI_arbiter_Test, Failed_start_releases_bus)
+{
+    mSpi.GetDmaRxHandle() = nullptr;        // ReadDMA cannot start
+
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+    EXPECT_TRUE(mMotion.ReadDMA(mAxes, sizeof(mAxes), [this]() { mMotionDone++; }));
+    EXPECT_TRUE(mOther.WriteDMA(mCommand, sizeof(mCommand), [this]() { mOtherDone++; }));
+
+    FakeHal_CompleteSpiDma();       // Display done: Motion fails, Other granted
+    FakeHal_CompleteSpiDma();       // Other done
+
+    EXPECT_EQ(1, mMotionDone);      // Told it is done, counted as failed
+    EXPECT_EQ(1, mMotion.GetStatistics().failed);
+    EXPECT_EQ(1, mOtherDone);
+    EXPECT_FALSE(mSubject.IsBusy());
+
+    // Motion ChipSelect released after the failure
+    const std::vector<uint16_t> expected = { GPIO_PIN_12, GPIO_PIN_3, GPIO_PIN_14 };
+    EXPECT_EQ(expected, GrantOrder());
+}
+
+TEST_F(SPI_arbiter_Test, Queued_transfer_failure_calls_handler)
+{
+    uint8_t address = 0xA8;
+    SPISegment segments[] = { SPISegment::Write(&address, 1),
+                              SPISegment::Read(mAxes, sizeof(mAxes)) };
+    bool result = true;
+
+    EXPECT_TRUE(mDisplay.WriteDMA(mFrame, sizeof(mFrame), [this]() { mDisplayDone++; }));
+    EXPECT_TRUE(mMotion.Transfer(segments, 2, [this, &result](bool ok) { mMotionDone++; result = ok; }));
+
+    FakeHal_FailSpiDmaStarts(1);
+    FakeHal_CompleteSpiDma();       // Display done: Motion Transfer fails to start
+
+    EXPECT_EQ(1, mMotionDone);
+    EXPECT_FALSE(result);
+    EXPECT_EQ(1, mMotion.GetStatistics().failed);
+    EXPECT_FALSE(mSubject.IsBusy());
+}
+
+TEST_F(SPI_arbiter_Test, Replay_display_streaming_bounds_motion_latency)
+{
+    // The display streams a frame in chunks, the next chunk is requested
+    // from the done handler (ISR context). Meanwhile the accelerometer reads
+    // every 3rd chunk and the other client writes every 5th chunk, at some
+    // moment within the chunk on the bus.
+    EXPECT_TRUE(StreamChunk());
+
+    for (uint32_t step = 0; mSubject.IsBusy(); step++)
+    {
+        const bool displayOnBus = (GrantOrder().back() == GPIO_PIN_12);
+
+        if (displayOnBus)
+        {
+            const uint32_t offset = (step * 37) % CHUNK_TICKS;
+
+            fakeClock += offset;
+            if ((step % 3) == 0) { EXPECT_TRUE(mMotion.ReadDMA(mAxes, sizeof(mAxes), [this]() { mMotionDone++; })); }
+            if ((step % 5) == 0) { EXPECT_TRUE(mOther.WriteDMA(mCommand, sizeof(mCommand), [this]() { mOtherDone++; })); }
+            fakeClock += CHUNK_TICKS - offset;
+        }
+        else
+        {
+            fakeClock += MOTION_TICKS;
+        }
+
+        FakeHal_CompleteSpiDma();
+    }
+
+    EXPECT_EQ(CHUNKS, mDisplayDone);
+    EXPECT_EQ(mMotion.GetStatistics().requests, mMotionDone);
+    EXPECT_EQ(mOther.GetStatistics().requests, mOtherDone);
+    EXPECT_LT(0, mMotionDone);
+    EXPECT_LT(0, mOtherDone);
+
+    // High priority: never waits longer than the single chunk on the bus
+    EXPECT_GE(1, mMotion.GetStatistics().maxWaitGrants);
+    EXPECT_GE(CHUNK_TICKS, mMotion.GetStatistics().maxWait);
+
+    // Normal priority: may also wait for the accelerometer
+    EXPECT_GE(2, mOther.GetStatistics().maxWaitGrants);
+    EXPECT_GE(CHUNK_TICKS + MOTION_TICKS, mOther.GetStatistics().maxWait);
+
+    EXPECT_EQ(0, mDisplay.GetStatistics().rejected);
+    EXPECT_EQ(0, __get_PRIMASK());
+
+    std::printf("[ STATS    ] motion: %u requests, max wait %u ticks, mean wait %u ticks\n",
+                mMotion.GetStatistics().requests, mMotion.GetStatistics().maxWait,
+                mMotion.GetStatistics().totalWait / mMotion.GetStatistics().requests);
+    std::printf("[ STATS    ] other:  %u requests, max wait %u ticks, max queue depth %u\n",
+                mOther.GetStatistics().requests, mOther.GetStatistics().maxWait, mSubject.GetMaxQueueDepth());
+}
+
+
+} // namespace
@@ -0,0 +1,184 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/StackPainting/stack_monitor.h"
+
+// Supporting files
+#include <algorithm>
+
+
+// Linker symbols of the main stack, not used by the tests
+extern "C" { uint32_t _ebss; uint32_t _estack; }
+
+
+namespace {
+
+
+// A task is its name and painted stack, the handle is its address
+struct FakeTask
+{
+    const char* name;
+    uint32_t    stack[256];
+};
+
+static FakeTask* runningTask = nullptr;
+
+
+// Fixture: the 'idle' task calls the idle hook, 'task' is monitored.
+class StackMonitor_Test : public ::testing::Test
+{
+protected:
+    FakeTask mIdle = { "IDLE", {} };
+    FakeTask mTask = { "Task", {} };
+
+    void SetUp() override
+    {
+        std::fill(std::begin(mIdle.stack), std::end(mIdle.stack), STACK_MONITOR_TASK_FILL);
+        std::fill(std::begin(mTask.stack), std::end(mTask.stack), STACK_MONITOR_TASK_FILL);
+        runningTask = &mIdle;
+        stack_monitor_init();
+    }
+
+    // Use the top 'words' of the stack
+    void Use(FakeTask& task, uint32_t words)
+    {
+        std::fill(std::end(task.stack) - words, std::end(task.stack), 0x20001234);
+    }
+
+    // Run the idle hook until 'index' completed a pass, returns the calls needed
+    uint32_t Scan(uint8_t index)
+    {
+        stack_usage_t usage;
+        uint32_t calls = 0;
+        do
+        {
+            stack_monitor_idle_hook();
+            calls++;
+            EXPECT_TRUE(stack_monitor_get_usage(index, &usage));
+        } while (!usage.scanned && (calls < 1000));
+        return calls;
+    }
+
+    // Run the idle hook 'calls' times
+    void Run(uint32_t calls)
+    {
+        for (uint32_t i = 0; i < calls; i++) { stack_monitor_idle_hook(); }
+    }
+
+    stack_usage_t Usage(uint8_t index)
+    {
+        stack_usage_t usage = {};
+        EXPECT_TRUE(stack_monitor_get_usage(index, &usage));
+        return usage;
+    }
+};
+
+
+TEST_F(StackMonitor_Test, Add)
+{
+    EXPECT_TRUE(stack_monitor_add_task(reinterpret_cast<TaskHandle_t>(&mTask), 256));
+    EXPECT_EQ(1, stack_monitor_get_count());
+
+    // The idle task adds itself, with the minimal stack size
+    stack_monitor_idle_hook();
+    EXPECT_EQ(2, stack_monitor_get_count());
+    EXPECT_STREQ("IDLE", Usage(1).name);
+    EXPECT_EQ(configMINIMAL_STACK_SIZE * 4, Usage(1).size);
+
+    const stack_usage_t usage = Usage(0);
+    EXPECT_STREQ("Task", usage.name);
+    EXPECT_EQ(256 * 4, usage.size);
+    EXPECT_FALSE(usage.scanned);
+
+    uint32_t region[4];
+    EXPECT_FALSE(stack_monitor_add_region("None", nullptr, 4, 0));
+    EXPECT_FALSE(stack_monitor_add_region("Empty", region, 0, 0));
+    while (stack_monitor_get_count() < STACK_MONITOR_MAX_ENTRIES)
+    {
+        EXPECT_TRUE(stack_monitor_add_region("Region", region, 4, 0));
+    }
+    EXPECT_FALSE(stack_monitor_add_region("Full", region, 4, 0));
+
+    stack_usage_t none;
+    EXPECT_FALSE(stack_monitor_get_usage(STACK_MONITOR_MAX_ENTRIES, &none));
+}
+
+TEST_F(StackMonitor_Test, Pass_in_slices)
+{
+    ASSERT_TRUE(stack_monitor_add_task(reinterpret_cast<TaskHandle_t>(&mTask), 256));
+    Use(mTask, 40);
+
+    // 216 painted words: 4 slices of at most STACK_MONITOR_SLICE_WORDS
+    EXPECT_EQ(4, Scan(0));
+
+    const stack_usage_t usage = Usage(0);
+    EXPECT_TRUE(usage.scanned);
+    EXPECT_EQ(40 * 4, usage.used);
+    EXPECT_EQ(216 * 4, usage.headroom);
+}
+
+TEST_F(StackMonitor_Test, High_water_only_grows)
+{
+    ASSERT_TRUE(stack_monitor_add_task(reinterpret_cast<TaskHandle_t>(&mTask), 256));
+    Use(mTask, 40);
+    Scan(0);
+
+    // Deeper call with a painted hole above it: the lowest used word counts
+    mTask.stack[256 - 100] = 0;
+    Run(20);                            // Passes over the idle task and the task
+    EXPECT_EQ(100 * 4, Usage(0).used);
+
+    // Stack unwound and painted again: the mark stays
+    std::fill(std::begin(mTask.stack), std::end(mTask.stack), STACK_MONITOR_TASK_FILL);
+    Run(20);
+    EXPECT_EQ(100 * 4, Usage(0).used);
+}
+
+TEST_F(StackMonitor_Test, Overflow)
+{
+    ASSERT_TRUE(stack_monitor_add_task(reinterpret_cast<TaskHandle_t>(&mTask), 256));
+    Use(mTask, 256);
+
+    EXPECT_EQ(1, Scan(0));
+    EXPECT_EQ(0, Usage(0).headroom);
+}
+
+TEST_F(StackMonitor_Test, Report)
+{
+    ASSERT_TRUE(stack_monitor_add_task(reinterpret_cast<TaskHandle_t>(&mTask), 256));
+    Use(mTask, 16);
+    Scan(0);
+
+    uint8_t report[STACK_MONITOR_REPORT_SIZE(2)] = {};
+    EXPECT_EQ(0, stack_monitor_get_report(report, STACK_MONITOR_REPORT_SIZE(2) - 1));
+    ASSERT_EQ(STACK_MONITOR_REPORT_SIZE(2), stack_monitor_get_report(report, sizeof(report)));
+
+    EXPECT_EQ(STACK_MONITOR_REPORT_ID, report[0]);
+    EXPECT_EQ(2, report[1]);
+    EXPECT_EQ(0, report[2]);            // Task
+    EXPECT_EQ(1, report[3]);            // Scanned
+    EXPECT_EQ(256, report[4] | (report[5] << 8));
+    EXPECT_EQ(240, report[6] | (report[7] << 8));
+    EXPECT_EQ(1, report[8]);            // Idle, not scanned yet
+    EXPECT_EQ(0, report[9]);
+    EXPECT_EQ(configMINIMAL_STACK_SIZE, report[10] | (report[11] << 8));
+}
+
+
+} // namespace
+
+
+// Fake of FreeRTOS: the handle is the task, NULL the running task
+extern "C" void vTaskGetInfo(TaskHandle_t xTask, TaskStatus_t* pxTaskStatus, BaseType_t xGetFreeStackSpace, eTaskState eState)
+{
+    (void)(xGetFreeStackSpace);
+
+    FakeTask* task = (xTask != nullptr) ? reinterpret_cast<FakeTask*>(xTask) : runningTask;
+
+    *pxTaskStatus = TaskStatus_t();
+    pxTaskStatus->xHandle       = reinterpret_cast<TaskHandle_t>(task);
+    pxTaskStatus->pcTaskName    = task->name;
+    pxTaskStatus->pxStackBase   = task->stack;
+    pxTaskStatus->eCurrentState = eState;
+}
@@ -0,0 +1,210 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/TelemetryStreamer/TelemetryStreamer.hpp"
+
+// Supporting files
+#include <cstring>
+#include <vector>
+
+
+namespace {
+
+
+// USART of which the DMA transfers are completed by the test.
+class FakeUsart : public IUSART
+{
+public:
+    bool WriteDma(const uint8_t* src, uint16_t length, const Delegate<void()>& handler) override
+    {
+        if (!mAccept) { return false; }
+
+        mFrames.emplace_back(src, src + length);
+        mHandler = handler;
+        return true;
+    }
+    bool ReadDma(uint8_t*, uint16_t, const Delegate<void(uint16_t)>&, bool) override        { return false; }
+    bool WriteInterrupt(const uint8_t*, uint16_t, const Delegate<void()>&) override         { return false; }
+    bool ReadInterrupt(uint8_t*, uint16_t, const Delegate<void(uint16_t)>&, bool) override  { return false; }
+    bool WriteBlocking(const uint8_t*, uint16_t) override                                   { return false; }
+    bool ReadBlocking(uint8_t*, uint16_t) override                                          { return false; }
+
+    void Complete() { Delegate<void()> handler = mHandler; mHandler = nullptr; if (handler) { handler(); } }
+
+    std::vector<std::vector<uint8_t>> mFrames;
+    Delegate<void()>                  mHandler;
+    bool                              mAccept = true;
+};
+
+// CRC-32 as calculated by the STM32F4 CRC unit: polynomial 0x04C11DB7, word wise.
+class SoftwareCrc : public ICRC
+{
+public:
+    uint32_t Calculate(uint32_t* buffer, uint32_t length) override
+    {
+        uint32_t crc = 0xFFFFFFFF;
+        for (uint32_t i = 0; i < length; i++)
+        {
+            crc ^= buffer[i];
+            for (uint8_t bit = 0; bit < 32; bit++)
+            {
+                crc = (crc & 0x80000000) ? ((crc << 1) ^ 0x04C11DB7) : (crc << 1);
+            }
+        }
+        return crc;
+    }
+};
+
+
+// Test fixture for TelemetryStreamer.
+class TelemetryStreamer_Test : public ::testing::Test
+{
+protected:
+    TelemetryStreamer_Test() :
+        mSubject(mUsart, mCrc)
+    { }
+
+    uint16_t FrameLength(size_t frame)    { return mUsart.mFrames[frame][2] | (mUsart.mFrames[frame][3] << 8); }
+    uint32_t FrameSequence(size_t frame)  { uint32_t value; std::memcpy(&value, &mUsart.mFrames[frame][4], 4); return value; }
+
+    FakeUsart         mUsart;
+    SoftwareCrc       mCrc;
+    TelemetryStreamer mSubject;
+};
+
+
+TEST_F(TelemetryStreamer_Test, Write_invalid)
+{
+    const uint8_t record[TELEMETRY_PAYLOAD_SIZE + 1] = {};
+
+    EXPECT_FALSE(mSubject.Write(nullptr, 1));
+    EXPECT_FALSE(mSubject.Write(record, 0));
+    EXPECT_FALSE(mSubject.Write(record, sizeof(record)));
+    EXPECT_EQ(0, mSubject.GetPending());
+
+    EXPECT_TRUE(mSubject.Flush());                      // Nothing to send
+    EXPECT_EQ(0, mUsart.mFrames.size());
+}
+
+TEST_F(TelemetryStreamer_Test, Frame_layout)
+{
+    const uint8_t first[6]  = { 1, 2, 3, 4, 5, 6 };
+    const uint8_t second[3] = { 7, 8, 9 };
+
+    EXPECT_TRUE(mSubject.Write(first, sizeof(first)));
+    EXPECT_TRUE(mSubject.Write(second, sizeof(second)));
+    EXPECT_EQ(9, mSubject.GetPending());
+    EXPECT_EQ(0, mUsart.mFrames.size());                // Batched until flushed
+
+    EXPECT_TRUE(mSubject.Flush());
+    EXPECT_TRUE(mSubject.IsBusy());
+    EXPECT_EQ(0, mSubject.GetPending());
+
+    // Header, payload padded to 12 bytes, CRC
+    ASSERT_EQ(1, mUsart.mFrames.size());
+    const std::vector<uint8_t>& frame = mUsart.mFrames[0];
+    ASSERT_EQ(TELEMETRY_HEADER_SIZE + 12 + TELEMETRY_CRC_SIZE, frame.size());
+
+    EXPECT_EQ(0x5A, frame[0]);
+    EXPECT_EQ(0xA5, frame[1]);
+    EXPECT_EQ(9, FrameLength(0));
+    EXPECT_EQ(0, FrameSequence(0));
+    EXPECT_EQ(0, std::memcmp(&frame[8],  first,  sizeof(first)));
+    EXPECT_EQ(0, std::memcmp(&frame[14], second, sizeof(second)));
+    EXPECT_EQ(0, frame[17] | frame[18] | frame[19]);    // Padding
+
+    uint32_t words[5];
+    uint32_t crc;
+    std::memcpy(words, frame.data(), sizeof(words));
+    std::memcpy(&crc, &frame[20], sizeof(crc));
+    EXPECT_EQ(mCrc.Calculate(words, 5), crc);
+
+    mUsart.Complete();
+    EXPECT_FALSE(mSubject.IsBusy());
+}
+
+TEST_F(TelemetryStreamer_Test, Double_buffer)
+{
+    const uint8_t record[6] = { 1, 2, 3, 4, 5, 6 };
+
+    EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    EXPECT_TRUE(mSubject.Flush());
+
+    // Filling continues while the first frame is sent
+    EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    EXPECT_FALSE(mSubject.Flush());
+    EXPECT_EQ(1, mSubject.GetStatistics().busyFlushes);
+    EXPECT_EQ(6, mSubject.GetPending());
+
+    mUsart.Complete();
+    EXPECT_TRUE(mSubject.Flush());
+
+    ASSERT_EQ(2, mUsart.mFrames.size());
+    EXPECT_EQ(1, FrameSequence(1));
+    EXPECT_EQ(2, mSubject.GetStatistics().framesSent);
+    EXPECT_EQ(2 * (TELEMETRY_HEADER_SIZE + 8 + TELEMETRY_CRC_SIZE), mSubject.GetStatistics().bytesSent);
+}
+
+TEST_F(TelemetryStreamer_Test, Full_frame_is_sent)
+{
+    const uint8_t record[6] = { 1, 2, 3, 4, 5, 6 };
+    const uint16_t perFrame = TELEMETRY_PAYLOAD_SIZE / sizeof(record);
+
+    for (uint16_t i = 0; i < perFrame; i++)
+    {
+        EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    }
+    EXPECT_EQ(0, mUsart.mFrames.size());
+
+    // Does not fit: the full frame is sent, the record starts the next frame
+    EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    ASSERT_EQ(1, mUsart.mFrames.size());
+    EXPECT_EQ(perFrame * sizeof(record), FrameLength(0));
+    EXPECT_EQ(sizeof(record), mSubject.GetPending());
+}
+
+TEST_F(TelemetryStreamer_Test, Backpressure_drops_records)
+{
+    const uint8_t record[6] = { 1, 2, 3, 4, 5, 6 };
+    const uint16_t perFrame = TELEMETRY_PAYLOAD_SIZE / sizeof(record);
+
+    // First frame being sent, second frame filled
+    for (uint16_t i = 0; i < 2 * perFrame; i++)
+    {
+        EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    }
+    EXPECT_TRUE(mSubject.IsBusy());
+
+    EXPECT_FALSE(mSubject.Write(record, sizeof(record)));
+    EXPECT_FALSE(mSubject.Write(record, sizeof(record)));
+
+    TelemetryStats stats = mSubject.GetStatistics();
+    EXPECT_EQ(2, stats.recordsDropped);
+    EXPECT_EQ(2 * sizeof(record), stats.bytesDropped);
+    EXPECT_EQ(1, stats.framesSent);
+
+    // Producer continues once the USART caught up
+    mUsart.Complete();
+    EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    EXPECT_EQ(2, mUsart.mFrames.size());
+}
+
+TEST_F(TelemetryStreamer_Test, Transfer_not_started_keeps_records)
+{
+    const uint8_t record[6] = { 1, 2, 3, 4, 5, 6 };
+
+    mUsart.mAccept = false;
+    EXPECT_TRUE(mSubject.Write(record, sizeof(record)));
+    EXPECT_FALSE(mSubject.Flush());
+    EXPECT_FALSE(mSubject.IsBusy());
+    EXPECT_EQ(6, mSubject.GetPending());
+
+    mUsart.mAccept = true;
+    EXPECT_TRUE(mSubject.Flush());
+    ASSERT_EQ(1, mUsart.mFrames.size());
+    EXPECT_EQ(0, FrameSequence(0));
+}
+
+
+} // namespace
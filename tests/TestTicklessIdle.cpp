@@ -0,0 +1,302 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "utility/TicklessIdle/TicklessIdle.hpp"
+
+// Supporting files
+#include "utility/RunTimeStats/RunTimeStats.hpp"
+#include "stm32f4xx_hal.h"
+
+
+namespace {
+
+
+// 1 MHz core clock and 1 kHz tick: 1000 cycles per tick. With the LSI at
+// 32 kHz a sub second of the RTC is 250 us, the wakeup timer runs at 2 kHz.
+static constexpr uint32_t CORE_CLOCK  = 1000000;
+static constexpr uint32_t TICK_RATE   = 1000;
+static constexpr uint32_t RTC_CLOCK   = 32000;
+static constexpr uint32_t SUB_SECONDS = 4000;
+
+// What happens while sleeping, see 'SleepHook()'.
+static uint32_t sleepCycles     = 0;        // Sleep mode: SysTick counts passed
+static bool     sleepTickFired  = false;    // Sleep mode: the SysTick reached 0
+static uint32_t sleepReload     = 0;        // Sleep mode: SysTick reload used
+static uint32_t stopSubSeconds  = 0;        // Stop mode: RTC sub seconds passed
+static uint32_t restoreCount    = 0;
+
+static bool RestoreClock()
+{
+    restoreCount++;
+    return true;
+}
+
+static uint32_t ToBcd(uint32_t value) { return ((value / 10) << 4) | (value % 10); }
+static uint32_t FromBcd(uint32_t bcd) { return ((bcd >> 4) * 10) + (bcd & 0x0F); }
+
+static void SetRtc(uint32_t seconds, uint32_t ssr)
+{
+    RTC->TR  = ToBcd(seconds);
+    RTC->SSR = ssr;
+}
+
+// The RTC sub seconds count down, at 0 the seconds increment.
+static void AdvanceRtc(uint32_t subSeconds)
+{
+    uint32_t seconds = FromBcd(RTC->TR & 0x7F);
+    uint32_t ssr     = RTC->SSR;
+
+    for (uint32_t i = 0; i < subSeconds; i++)
+    {
+        if (ssr == 0) { ssr = SUB_SECONDS - 1; seconds = (seconds + 1) % 60; }
+        else          { ssr--; }
+    }
+    SetRtc(seconds, ssr);
+}
+
+static void SleepHook(FakeHalCall call)
+{
+    if (call == FAKE_HAL_WFI)
+    {
+        // Counts down from the reload, after reaching 0 from the reload again
+        sleepReload  = SysTick->LOAD;
+        SysTick->VAL = sleepReload - sleepCycles;
+        if (sleepTickFired) { SysTick->CTRL |= SysTick_CTRL_COUNTFLAG_Msk; }
+    }
+    else if (call == FAKE_HAL_PWR_ENTER_STOP)
+    {
+        AdvanceRtc(stopSubSeconds);
+
+        // The HSE and PLL stop, the HSI is selected. The fake clocks are ready
+        // at once: the ready and status bits stay set.
+        RCC->CR   &= ~(RCC_CR_HSEON | RCC_CR_PLLON);
+        RCC->CFGR  = (RCC->CFGR & ~RCC_CFGR_SW) | RCC_CFGR_SW_HSI;
+    }
+}
+
+
+// Fixture, the SysTick and RTC are advanced by the sleep hook.
+class TicklessIdle_Test : public ::testing::Test
+{
+protected:
+    TicklessIdle mTicklessIdle;
+
+    void SetUp() override
+    {
+        FakeHal_Reset();
+        SystemCoreClock = CORE_CLOCK;
+        FakeHal_SetSleepHook(SleepHook);
+
+        sleepCycles    = 0;
+        sleepTickFired = false;
+        sleepReload    = 0;
+        stopSubSeconds = 0;
+        restoreCount   = 0;
+
+        TicklessIdle::Config config(15, TICK_RATE, RestoreClock, 10, RTC_CLOCK);
+        ASSERT_TRUE(mTicklessIdle.Init(config));
+
+        // Wakeup timer writable, running from the PLL on the HSE
+        RTC->ISR  = RTC_ISR_WUTWF;
+        RCC->CR   = RCC_CR_HSEON | RCC_CR_HSERDY | RCC_CR_PLLON | RCC_CR_PLLRDY;
+        RCC->CFGR = RCC_CFGR_SW_PLL | (RCC_CFGR_SW_PLL << RCC_CFGR_SWS_Pos);
+
+        SysTick->LOAD = (CORE_CLOCK / TICK_RATE) - 1;
+        SysTick->CTRL = SysTick_CTRL_ENABLE_Msk | SysTick_CTRL_TICKINT_Msk | SysTick_CTRL_CLKSOURCE_Msk;
+    }
+
+    bool Called(FakeHalCall call)
+    {
+        for (uint32_t i = 0; i < FakeHal_GetEventCount(); i++)
+        {
+            if (FakeHal_GetEvent(i).call == call) { return true; }
+        }
+        return false;
+    }
+};
+
+
+TEST_F(TicklessIdle_Test, Init)
+{
+    EXPECT_EQ(RTC_CLOCK, mTicklessIdle.GetRtcClock());
+    EXPECT_EQ((7u << 16) | (SUB_SECONDS - 1), RTC->PRER);
+    EXPECT_TRUE(DWT->CTRL & DWT_CTRL_CYCCNTENA_Msk);
+    EXPECT_FALSE(mTicklessIdle.IsUpdated());
+
+    TicklessIdle ticklessIdle;
+    EXPECT_EQ(0, ticklessIdle.Sleep(10));        // Not initialized
+    EXPECT_FALSE(ticklessIdle.Init(TicklessIdle::Config(15, 0, RestoreClock, 10, RTC_CLOCK)));
+    EXPECT_FALSE(ticklessIdle.Init(TicklessIdle::Config(15, TICK_RATE, RestoreClock, 1, RTC_CLOCK)));
+    EXPECT_FALSE(ticklessIdle.Init(TicklessIdle::Config(15, TICK_RATE, RestoreClock, 10, 8)));
+    EXPECT_FALSE(ticklessIdle.Init(TicklessIdle::Config(15, CORE_CLOCK * 2, RestoreClock, 10, RTC_CLOCK)));
+}
+
+TEST_F(TicklessIdle_Test, Sleep_woken_by_interrupt)
+{
+    // 400 cycles left in the current tick, 5 ticks idle: Sleep mode
+    SysTick->VAL = 400;
+    sleepCycles  = 2500;
+
+    EXPECT_EQ(3, mTicklessIdle.Sleep(5));        // Ticks at 400, 1400 and 2400 cycles
+    EXPECT_EQ(400 + 4000 - TICKLESS_MISSED_COUNTS, sleepReload);
+    EXPECT_TRUE(Called(FAKE_HAL_WFI));
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+    EXPECT_TRUE(Called(FAKE_HAL_SUSPEND_TICK));
+    EXPECT_TRUE(Called(FAKE_HAL_RESUME_TICK));
+
+    // Restarted at the regular period
+    EXPECT_EQ(999, SysTick->LOAD);
+    EXPECT_TRUE(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk);
+    EXPECT_EQ(0, restoreCount);
+}
+
+TEST_F(TicklessIdle_Test, Sleep_woken_by_tick)
+{
+    SysTick->VAL   = 400;
+    sleepCycles    = 300;
+    sleepTickFired = true;
+
+    EXPECT_EQ(4, mTicklessIdle.Sleep(5));        // The pending tick interrupt processes the 5th
+    EXPECT_FALSE(SysTick->CTRL & SysTick_CTRL_COUNTFLAG_Msk);
+    EXPECT_TRUE(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk);
+}
+
+TEST_F(TicklessIdle_Test, Sleep_limited_by_SysTick)
+{
+    // Stop locked, the SysTick reload (24 bits) limits the sleep
+    mTicklessIdle.LockStop();
+    SysTick->VAL   = 400;
+    sleepTickFired = true;
+
+    const uint32_t maxTicks = 0xFFFFFF / 1000;
+    EXPECT_EQ(maxTicks - 1, mTicklessIdle.Sleep(20000));
+    EXPECT_EQ(400 + ((maxTicks - 1) * 1000) - TICKLESS_MISSED_COUNTS, sleepReload);
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+}
+
+TEST_F(TicklessIdle_Test, Stop_woken_by_rtc)
+{
+    SysTick->VAL   = 400;
+    SetRtc(5, 1000);
+    stopSubSeconds = 396;                       // 99 ms
+
+    EXPECT_EQ(99, mTicklessIdle.Sleep(100));    // 600 + 99000 cycles since the tick
+    EXPECT_TRUE(Called(FAKE_HAL_PWR_ENTER_STOP));
+    EXPECT_FALSE(Called(FAKE_HAL_WFI));
+    EXPECT_EQ(1, restoreCount);
+
+    // Wakeup timer at 2 kHz: a tick early, 99 ms. Stopped after waking.
+    EXPECT_EQ(197, RTC->WUTR);
+    EXPECT_EQ(0, RTC->CR & (RTC_CR_WUTE | RTC_CR_WUTIE));
+
+    // Over the minute boundary, woken early by an interrupt
+    SetRtc(59, 20);
+    stopSubSeconds = 40;                        // 10 ms
+    EXPECT_EQ(10, mTicklessIdle.Sleep(100));
+    EXPECT_EQ(2, restoreCount);
+}
+
+// Without restore method the HSE and PLL are restarted, the PLL selected again.
+TEST_F(TicklessIdle_Test, Stop_restores_clock)
+{
+    TicklessIdle ticklessIdle;
+    ASSERT_TRUE(ticklessIdle.Init(TicklessIdle::Config(15, TICK_RATE, nullptr, 10, RTC_CLOCK)));
+    SetRtc(5, 1000);
+    stopSubSeconds = 396;
+
+    EXPECT_EQ(99, ticklessIdle.Sleep(100));
+    EXPECT_TRUE(Called(FAKE_HAL_PWR_ENTER_STOP));
+    EXPECT_EQ(RCC_CR_HSEON | RCC_CR_PLLON, RCC->CR & (RCC_CR_HSEON | RCC_CR_PLLON));
+    EXPECT_EQ(RCC_CFGR_SW_PLL, RCC->CFGR & RCC_CFGR_SW);
+    EXPECT_EQ(0, restoreCount);
+}
+
+// The wakeup timer cannot be written: no Stop mode, no endless wait with the
+// interrupts disabled.
+TEST_F(TicklessIdle_Test, Stop_wakeup_timer_timeout)
+{
+    RTC->ISR     = 0;
+    SysTick->VAL = 400;
+
+    EXPECT_EQ(0, mTicklessIdle.Sleep(100));
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+    EXPECT_EQ(0, RTC->CR & RTC_CR_WUTE);
+    EXPECT_EQ(999, SysTick->LOAD);
+    EXPECT_TRUE(SysTick->CTRL & SysTick_CTRL_ENABLE_Msk);
+}
+
+// The slept cycles are credited to the idle task: the cycle counter does not
+// count while sleeping.
+TEST_F(TicklessIdle_Test, Sleep_credited_to_run_time_stats)
+{
+    uint8_t idle = 0;
+    ASSERT_TRUE(RunTimeStats::Init(CORE_CLOCK / 10));
+    RunTimeStats::TaskSwitchedIn(&idle, "IDLE");
+    RunTimeStats::IdleHook();
+
+    SetRtc(5, 1000);
+    stopSubSeconds = 396;                       // 99 ms, 99000 cycles
+    DWT->CYCCNT   += 1000;
+
+    EXPECT_EQ(99, mTicklessIdle.Sleep(100));
+    RunTimeStats::IdleHook();                   // Closes the 100 ms period
+
+    ASSERT_TRUE(RunTimeStats::IsUpdated());
+    EXPECT_EQ(1000, RunTimeStats::GetIdlePermille());
+
+    RunTimeEntryStats stats;
+    ASSERT_TRUE(RunTimeStats::GetStatistics(0, stats));
+    EXPECT_EQ(1000 + 99000, stats.cycles);
+}
+
+TEST_F(TicklessIdle_Test, Stop_only_when_allowed)
+{
+    SetRtc(0, 3999);
+
+    // Below the threshold
+    mTicklessIdle.Sleep(9);
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+
+    // DMA transfer running
+    DMA2_Stream0->CR |= DMA_SxCR_EN;
+    mTicklessIdle.Sleep(100);
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+    DMA2_Stream0->CR &= ~DMA_SxCR_EN;
+
+    // Locked, twice
+    mTicklessIdle.LockStop();
+    mTicklessIdle.LockStop();
+    mTicklessIdle.UnlockStop();
+    mTicklessIdle.Sleep(100);
+    EXPECT_FALSE(Called(FAKE_HAL_PWR_ENTER_STOP));
+
+    mTicklessIdle.UnlockStop();
+    mTicklessIdle.Sleep(100);
+    EXPECT_TRUE(Called(FAKE_HAL_PWR_ENTER_STOP));
+}
+
+TEST_F(TicklessIdle_Test, Statistics)
+{
+    SetRtc(0, 3999);
+    stopSubSeconds = 396;                       // 99000 cycles asleep
+
+    // Each round 10000 cycles awake: after 10 rounds more than a second passed
+    for (uint32_t i = 1; i <= 10; i++)
+    {
+        EXPECT_FALSE(mTicklessIdle.IsUpdated());
+        DWT->CYCCNT += 10000;
+        mTicklessIdle.Sleep(100);
+    }
+    EXPECT_TRUE(mTicklessIdle.IsUpdated());
+
+    const TicklessStats stats = mTicklessIdle.GetStatistics();
+    EXPECT_FALSE(mTicklessIdle.IsUpdated());
+    EXPECT_NEAR(100000.0f * 100.0f / 1090000.0f, stats.wakePercentage, 0.01f);
+    EXPECT_EQ(10, stats.stopCount);
+    EXPECT_EQ(0, stats.sleepCount);
+    EXPECT_EQ(10 * 99, stats.suppressedTicks);
+}
+
+
+} // namespace
@@ -0,0 +1,416 @@
+#include "gtest/gtest.h"
+
+
+// Test subject
+#include "drivers/Usart/Usart.hpp"
+
+// Supporting files
+#include "stm32f4xx_hal.h"
+#include <utility>
+#include <vector>
+
+
+extern "C" void USART2_IRQHandler(void);
+
+
+namespace {
+
+
+// Test fixture for Usart - baud rate and circular DMA reception.
+class Usart_Test : public ::testing::Test
+{
+protected:
+    Usart_Test() :
+        mSubject(UsartInstance::USART_2)
+    {
+        // Initialize test matter
+        FakeHal_Reset();
+
+        mDmaRx.Instance  = &mDmaStream;
+        mDmaRx.Init.Mode = DMA_CIRCULAR;
+    }
+
+    void Init()
+    {
+        EXPECT_TRUE(mSubject.Init(Usart::Config(10, false, Usart::Baudrate::_115K2)));
+        mSubject.GetDmaRxHandle() = &mDmaRx;
+    }
+
+    void InitCircular()
+    {
+        Init();
+        EXPECT_TRUE(mSubject.ReadCircularDma(mBuffer, sizeof(mBuffer), [this](uint16_t offset, uint16_t length) { this->mSpans.emplace_back(offset, length); }));
+    }
+
+    UART_HandleTypeDef* Handle() { return const_cast<UART_HandleTypeDef*>(mSubject.GetPeripheralHandle()); }
+
+    // Bytes 'first', 'first + 1', ... received by the DMA.
+    void Receive(uint8_t first, uint16_t length)
+    {
+        std::vector<uint8_t> data;
+        for (uint16_t i = 0; i < length; i++) { data.push_back(first + i); }
+        FakeHal_UartDmaReceive(Handle(), data.data(), length);
+    }
+
+    void Idle()
+    {
+        FakeHal_UartIdle(Handle());
+        USART2_IRQHandler();
+    }
+
+    using Span = std::pair<uint16_t, uint16_t>;
+
+    std::vector<Span>  mSpans;
+    uint8_t            mBuffer[16] = {};
+    DMA_Stream_TypeDef mDmaStream = {};
+    DMA_HandleTypeDef  mDmaRx = {};
+    Usart              mSubject;
+};
+
+
+// Expected divider and achieved baud rate, for a clock and baud rate.
+struct BaudrateCase
+{
+    uint32_t            clock;
+    uint32_t            baudrate;
+    Usart::OverSampling overSampling;
+    bool                valid;
+    uint16_t            brr;
+    uint32_t            achieved;
+    uint32_t            errorPpm;
+};
+
+static const BaudrateCase baudrateCases[] =
+{
+    // clock    baudrate  over sampling                     valid  BRR     achieved  error
+    { 16000000,    9600, Usart::OverSampling::_16_TIMES,  true, 0x0683,     9598,   200 },
+    { 16000000,  115200, Usart::OverSampling::_16_TIMES,  true, 0x008B,   115108,   799 },
+    { 16000000,  115200, Usart::OverSampling::_8_TIMES,   true, 0x0113,   115108,   799 },
+    { 16000000,  921600, Usart::OverSampling::_8_TIMES,  false, 0x0021,   941176, 21242 },     // Error too large
+    { 16000000, 2000000, Usart::OverSampling::_8_TIMES,   true, 0x0010,  2000000,     0 },
+    { 16000000, 2000000, Usart::OverSampling::_16_TIMES, false,      0,        0,     0 },     // Too fast
+    { 36000000,  115200, Usart::OverSampling::_16_TIMES,  true, 0x0139,   115016,  1597 },
+    { 36000000, 1000000, Usart::OverSampling::_8_TIMES,   true, 0x0044,  1000000,     0 },
+    { 36000000, 4000000, Usart::OverSampling::_8_TIMES,   true, 0x0011,  4000000,     0 },
+    { 42000000,    1200, Usart::OverSampling::_8_TIMES,  false,      0,        0,     0 },     // Too slow
+    { 42000000,    1200, Usart::OverSampling::_16_TIMES,  true, 0x88B8,     1200,     0 },
+    { 42000000,  115200, Usart::OverSampling::_8_TIMES,   true, 0x02D5,   115068,  1142 },
+    { 42000000,  921600, Usart::OverSampling::_8_TIMES,   true, 0x0056,   913043,  9284 },
+    { 42000000, 4000000, Usart::OverSampling::_8_TIMES,  false, 0x0013,  3818182, 45455 },     // Error too large
+    { 84000000,  115200, Usart::OverSampling::_16_TIMES,  true, 0x02D9,   115226,   229 },
+    { 84000000,  921600, Usart::OverSampling::_8_TIMES,   true, 0x00B3,   923077,  1603 },
+    { 84000000, 4000000, Usart::OverSampling::_16_TIMES,  true, 0x0015,  4000000,     0 },
+};
+
+
+TEST(Usart_Baudrate_Test, CalculateBaudrate_table)
+{
+    for (const BaudrateCase& c : baudrateCases)
+    {
+        SCOPED_TRACE(::testing::Message() << c.clock << " Hz, " << c.baudrate << " baud");
+
+        Usart::BaudrateSetting setting;
+        EXPECT_EQ(c.valid,    Usart::CalculateBaudrate(c.clock, c.baudrate, c.overSampling, setting));
+        EXPECT_EQ(c.brr,      setting.mBrr);
+        EXPECT_EQ(c.achieved, setting.mBaudrate);
+        EXPECT_EQ(c.errorPpm, setting.mErrorPpm);
+    }
+}
+
+TEST(Usart_Baudrate_Test, CalculateBaudrate_invalid)
+{
+    Usart::BaudrateSetting setting;
+
+    EXPECT_FALSE(Usart::CalculateBaudrate(0, 115200, Usart::OverSampling::_8_TIMES, setting));
+    EXPECT_FALSE(Usart::CalculateBaudrate(42000000, 0, Usart::OverSampling::_8_TIMES, setting));
+}
+
+TEST_F(Usart_Test, Init_baudrate)
+{
+    EXPECT_EQ(0, mSubject.GetBaudrate());
+
+    // Any baud rate, USART2 runs from PCLK1
+    EXPECT_TRUE(mSubject.Init(Usart::Config(10, false, 1000000)));
+    EXPECT_EQ(1000000, mSubject.GetBaudrate());
+    EXPECT_EQ(0,       mSubject.GetBaudrateError());
+    EXPECT_EQ(0x52,    USART2->BRR);
+
+    EXPECT_TRUE(mSubject.Init(Usart::Config(10, false, Usart::Baudrate::_921K6)));
+    EXPECT_EQ(913043,  mSubject.GetBaudrate());
+    EXPECT_EQ(9284,    mSubject.GetBaudrateError());
+
+    // Beyond the tolerance
+    FakeHal_SetPclkFreq(16000000, 84000000);
+    EXPECT_FALSE(mSubject.Init(Usart::Config(10, false, Usart::Baudrate::_921K6)));
+}
+
+TEST_F(Usart_Test, Init_baudrate_apb2)
+{
+    Usart usart(UsartInstance::USART_6);
+
+    // USART6 runs from PCLK2
+    FakeHal_SetPclkFreq(16000000, 84000000);
+    EXPECT_TRUE(usart.Init(Usart::Config(10, false, Usart::Baudrate::_921K6)));
+    EXPECT_EQ(923077, usart.GetBaudrate());
+    EXPECT_EQ(0xB3,   USART6->BRR);
+}
+
+TEST_F(Usart_Test, ReadCircularDma_invalid)
+{
+    auto handler = [this](uint16_t offset, uint16_t length) { this->mSpans.emplace_back(offset, length); };
+
+    EXPECT_FALSE(mSubject.ReadCircularDma(mBuffer, sizeof(mBuffer), handler));     // Not initialized
+
+    EXPECT_TRUE(mSubject.Init(Usart::Config(10, false, Usart::Baudrate::_115K2)));
+    EXPECT_FALSE(mSubject.ReadCircularDma(mBuffer, sizeof(mBuffer), handler));     // No DMA
+
+    mSubject.GetDmaRxHandle() = &mDmaRx;
+    mDmaRx.Init.Mode = DMA_NORMAL;
+    EXPECT_FALSE(mSubject.ReadCircularDma(mBuffer, sizeof(mBuffer), handler));     // DMA not circular
+
+    mDmaRx.Init.Mode = DMA_CIRCULAR;
+    EXPECT_FALSE(mSubject.ReadCircularDma(nullptr, sizeof(mBuffer), handler));
+    EXPECT_FALSE(mSubject.ReadCircularDma(mBuffer, 0, handler));
+    EXPECT_EQ(0, FakeHal_GetEventCount());
+
+    EXPECT_TRUE(mSubject.ReadCircularDma(mBuffer, sizeof(mBuffer), handler));
+    ASSERT_EQ(1, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_UART_RECEIVE_DMA, FakeHal_GetEvent(0).call);
+    EXPECT_EQ(sizeof(mBuffer),           FakeHal_GetEvent(0).length);
+}
+
+TEST_F(Usart_Test, Spans_on_half_and_complete)
+{
+    InitCircular();
+
+    Receive(0, 8);
+    ASSERT_EQ(1, mSpans.size());
+    EXPECT_EQ(Span(0, 8), mSpans[0]);
+
+    Receive(8, 8);
+    ASSERT_EQ(2, mSpans.size());
+    EXPECT_EQ(Span(8, 8), mSpans[1]);
+
+    // The stream continues at the start of the buffer
+    Receive(16, 8);
+    ASSERT_EQ(3, mSpans.size());
+    EXPECT_EQ(Span(0, 8), mSpans[2]);
+    EXPECT_EQ(16, mBuffer[0]);
+    EXPECT_EQ(1, FakeHal_GetEventCount());      // Never restarted
+}
+
+TEST_F(Usart_Test, Spans_on_idle)
+{
+    InitCircular();
+
+    Receive(0, 3);
+    EXPECT_EQ(0, mSpans.size());
+
+    Idle();
+    ASSERT_EQ(1, mSpans.size());
+    EXPECT_EQ(Span(0, 3), mSpans[0]);
+
+    // Idle without new data
+    Idle();
+    EXPECT_EQ(1, mSpans.size());
+
+    // Half transfer reports the rest of the first half only
+    Receive(3, 6);
+    ASSERT_EQ(2, mSpans.size());
+    EXPECT_EQ(Span(3, 5), mSpans[1]);
+
+    Idle();
+    ASSERT_EQ(3, mSpans.size());
+    EXPECT_EQ(Span(8, 1), mSpans[2]);
+    EXPECT_EQ(1, FakeHal_GetEventCount());      // Not aborted on IDLE
+}
+
+TEST_F(Usart_Test, Wrapped_data_reported_as_two_spans)
+{
+    InitCircular();
+
+    Receive(0, 12);
+    Idle();
+    ASSERT_EQ(2, mSpans.size());
+    EXPECT_EQ(Span(8, 4), mSpans[1]);
+
+    // The transfer complete interrupt is late: the DMA already wrapped around
+    for (uint8_t i = 12; i < 18; i++) { mBuffer[i % sizeof(mBuffer)] = i; }
+    mDmaStream.NDTR = sizeof(mBuffer) - 2;
+
+    HAL_UART_RxCpltCallback(Handle());
+    ASSERT_EQ(4, mSpans.size());
+    EXPECT_EQ(Span(12, 4), mSpans[2]);
+    EXPECT_EQ(Span(0, 2),  mSpans[3]);
+
+    Idle();
+    EXPECT_EQ(4, mSpans.size());
+}
+
+TEST_F(Usart_Test, ReadAcquire_zero_copy)
+{
+    InitCircular();
+
+    const uint8_t* data = nullptr;
+    EXPECT_EQ(0, mSubject.ReadAcquire(data));
+    EXPECT_EQ(nullptr, data);
+
+    Receive(0, 12);
+    Idle();
+
+    ASSERT_EQ(12, mSubject.ReadAcquire(data));
+    EXPECT_EQ(&mBuffer[0], data);
+    mSubject.ReadRelease(10);
+
+    // Wrapped data: the part until the end of the buffer first
+    Receive(12, 8);
+    Idle();
+
+    ASSERT_EQ(6, mSubject.ReadAcquire(data));
+    EXPECT_EQ(&mBuffer[10], data);
+    EXPECT_EQ(10, data[0]);
+    mSubject.ReadRelease(6);
+
+    ASSERT_EQ(4, mSubject.ReadAcquire(data));
+    EXPECT_EQ(&mBuffer[0], data);
+    EXPECT_EQ(16, data[0]);
+    mSubject.ReadRelease(4);
+
+    EXPECT_EQ(0, mSubject.ReadAcquire(data));
+    EXPECT_EQ(0, mSubject.GetRxOverruns());
+}
+
+TEST_F(Usart_Test, ReadAcquire_overrun)
+{
+    InitCircular();
+
+    const uint8_t* data = nullptr;
+
+    // Reader did not keep up: unreleased data is overwritten
+    Receive(0, 20);
+    Idle();
+
+    EXPECT_EQ(0, mSubject.ReadAcquire(data));
+    EXPECT_EQ(1, mSubject.GetRxOverruns());
+
+    // Continues with new data
+    Receive(20, 2);
+    Idle();
+
+    ASSERT_EQ(2, mSubject.ReadAcquire(data));
+    EXPECT_EQ(20, data[0]);
+}
+
+TEST_F(Usart_Test, Error_restarts_reception)
+{
+    InitCircular();
+
+    Receive(0, 5);
+    FakeHal_UartError(Handle(), HAL_UART_ERROR_ORE);
+
+    // Data before the error reported, the DMA started again
+    ASSERT_EQ(1, mSpans.size());
+    EXPECT_EQ(Span(0, 5), mSpans[0]);
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_UART_RECEIVE_DMA, FakeHal_GetEvent(1).call);
+    EXPECT_EQ(sizeof(mBuffer),           FakeHal_GetEvent(1).length);
+    EXPECT_EQ(1, mSubject.GetRxErrors());
+
+    // Reception continues at the start of the buffer
+    Receive(10, 3);
+    Idle();
+    ASSERT_EQ(2, mSpans.size());
+    EXPECT_EQ(Span(0, 3), mSpans[1]);
+    EXPECT_EQ(10, mBuffer[0]);
+
+    FakeHal_UartError(Handle(), HAL_UART_ERROR_FE);
+    Receive(20, 9);
+    ASSERT_EQ(3, mSpans.size());
+    EXPECT_EQ(Span(0, 8), mSpans[2]);               // Half transfer
+    EXPECT_EQ(2, mSubject.GetRxErrors());
+}
+
+TEST_F(Usart_Test, Tx_error_keeps_reception)
+{
+    InitCircular();
+
+    Receive(0, 5);
+    FakeHal_UartTxDmaError(Handle());
+
+    // Not a reception error: no restart, the DMA continues
+    EXPECT_EQ(1, FakeHal_GetEventCount());
+    EXPECT_EQ(0, mSubject.GetRxErrors());
+    EXPECT_EQ(0, mSpans.size());
+
+    Receive(5, 3);
+    Idle();
+    ASSERT_EQ(1, mSpans.size());
+    EXPECT_EQ(Span(0, 8), mSpans[0]);
+
+    const uint8_t* data = nullptr;
+    ASSERT_EQ(8, mSubject.ReadAcquire(data));
+    EXPECT_EQ(&mBuffer[0], data);
+    EXPECT_EQ(7, data[7]);
+}
+
+TEST_F(Usart_Test, ReadAcquire_after_error)
+{
+    InitCircular();
+
+    const uint8_t* data = nullptr;
+
+    Receive(0, 5);
+    Idle();
+    ASSERT_EQ(5, mSubject.ReadAcquire(data));
+    mSubject.ReadRelease(2);
+
+    // Not released data is discarded, the reader continues at the restart
+    FakeHal_UartError(Handle(), HAL_UART_ERROR_NE);
+    Receive(10, 3);
+    Idle();
+
+    ASSERT_EQ(3, mSubject.ReadAcquire(data));
+    EXPECT_EQ(&mBuffer[0], data);
+    EXPECT_EQ(10, data[0]);
+    mSubject.ReadRelease(3);
+
+    EXPECT_EQ(0, mSubject.ReadAcquire(data));
+    EXPECT_EQ(0, mSubject.GetRxOverruns());
+}
+
+TEST_F(Usart_Test, StopCircularRead)
+{
+    EXPECT_FALSE(mSubject.StopCircularRead());
+
+    InitCircular();
+    Receive(0, 3);
+
+    EXPECT_TRUE(mSubject.StopCircularRead());
+    ASSERT_EQ(2, FakeHal_GetEventCount());
+    EXPECT_EQ(FAKE_HAL_UART_ABORT_RECEIVE, FakeHal_GetEvent(1).call);
+
+    Idle();
+    EXPECT_EQ(0, mSpans.size());
+
+    const uint8_t* data = nullptr;
+    EXPECT_EQ(0, mSubject.ReadAcquire(data));
+    EXPECT_FALSE(mSubject.StopCircularRead());
+}
+
+TEST_F(Usart_Test, Sleep_stops_circular_read)
+{
+    InitCircular();
+    Receive(0, 3);
+
+    EXPECT_TRUE(mSubject.Sleep());
+
+    // No callbacks after sleep: an error does not restart the reception
+    FakeHal_UartError(Handle(), HAL_UART_ERROR_ORE);
+    Idle();
+    EXPECT_EQ(0, mSpans.size());
+    EXPECT_EQ(0, mSubject.GetRxErrors());
+    EXPECT_EQ(FAKE_HAL_UART_ABORT_RECEIVE, FakeHal_GetEvent(FakeHal_GetEventCount() - 1).call);
+}
+
+
+} // namespace